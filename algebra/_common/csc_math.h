@@ -47,6 +47,24 @@ void csc_lmult_diag(OSQPCscMatrix* A, const OSQPFloat* L);
 // A = A*diag(R)
 void csc_rmult_diag(OSQPCscMatrix* A, const OSQPFloat* R);
 
+// A[k] = sc*L[i]*A[k]*R[j] for the entries k = idx[0..len-1] at (i,j),
+// or for the first len entries if idx is OSQP_NULL
+void csc_scale_entries(OSQPCscMatrix*   A,
+                       const OSQPInt*   idx,
+                       OSQPInt          len,
+                       const OSQPFloat* L,
+                       const OSQPFloat* R,
+                       OSQPFloat        sc);
+
+// A[k] = sc*L[i]*A[k]*R[j] for all entries, together with the infinity norms
+// of the columns (cn) and rows (rn) of the scaled matrix if not OSQP_NULL
+void csc_scale_entries_norm_inf(OSQPCscMatrix*   A,
+                                const OSQPFloat* L,
+                                const OSQPFloat* R,
+                                OSQPFloat        sc,
+                                OSQPFloat*       cn,
+                                OSQPFloat*       rn);
+
 // d = diag(At*diag(D)*A)
 void csc_AtDA_extract_diag(const OSQPCscMatrix* A,
                            const OSQPFloat*     D,
@@ -59,6 +77,14 @@ void csc_Axpy_sym_triu(const OSQPCscMatrix* A,
                              OSQPFloat      alpha,
                              OSQPFloat      beta);
 
+//y = alpha*A*x + beta*y, where A is symmetric and both triangles are stored.
+//Each entry of y is formed as the dot product of a column of A with x
+void csc_Axpy_sym_full(const OSQPCscMatrix* A,
+                       const OSQPFloat*     x,
+                             OSQPFloat*     y,
+                             OSQPFloat      alpha,
+                             OSQPFloat      beta);
+
 //y = alpha*A*x + beta*y
 void csc_Axpy(const OSQPCscMatrix* A,
               const OSQPFloat*     x,
@@ -73,6 +99,33 @@ void csc_Atxpy(const OSQPCscMatrix* A,
                      OSQPFloat      alpha,
                      OSQPFloat      beta);
 
+/* Versions of the products above that use the single precision values Axs
+ * in place of A->x, accumulating the result in OSQPFloat */
+
+//y = alpha*A*x + beta*y, where A is symmetric and only triu is stored
+void csc_Axpy_sym_triu_single(const OSQPCscMatrix* A,
+                              const float*         Axs,
+                              const OSQPFloat*     x,
+                                    OSQPFloat*     y,
+                                    OSQPFloat      alpha,
+                                    OSQPFloat      beta);
+
+//y = alpha*A*x + beta*y
+void csc_Axpy_single(const OSQPCscMatrix* A,
+                     const float*         Axs,
+                     const OSQPFloat*     x,
+                           OSQPFloat*     y,
+                           OSQPFloat      alpha,
+                           OSQPFloat      beta);
+
+//y = alpha*A^T*x + beta*y
+void csc_Atxpy_single(const OSQPCscMatrix* A,
+                      const float*         Axs,
+                      const OSQPFloat*     x,
+                            OSQPFloat*     y,
+                            OSQPFloat      alpha,
+                            OSQPFloat      beta);
+
 // // returns 1/2 x'*P*x
 // OSQPFloat csc_quad_form(const csc *P, const OSQPFloat *x);
 
@@ -85,6 +138,28 @@ void csc_row_norm_inf(const OSQPCscMatrix* M, OSQPFloat* E);
 // E[i] = inf_norm(M(i,:)), where M stores triu part only
 void csc_row_norm_inf_sym_triu(const OSQPCscMatrix* M, OSQPFloat* E);
 
+#if OSQP_EMBEDDED_MODE != 1
+
+// E[i] = 2_norm(M(:,i))
+void csc_col_norm_2(const OSQPCscMatrix* M, OSQPFloat* E);
+
+// E[i] = 2_norm(M(i,:))
+void csc_row_norm_2(const OSQPCscMatrix* M, OSQPFloat* E);
+
+// E[i] = 2_norm(M(i,:)), where M stores triu part only
+void csc_row_norm_2_sym_triu(const OSQPCscMatrix* M, OSQPFloat* E);
+
+#endif /* if OSQP_EMBEDDED_MODE != 1 */
+
+// E[i] = min |M(j,i)| over the nonzeros of M(:,i), OSQP_INFTY if there are none
+void csc_col_min_abs(const OSQPCscMatrix* M, OSQPFloat* E);
+
+// E[i] = min |M(i,j)| over the nonzeros of M(i,:), OSQP_INFTY if there are none
+void csc_row_min_abs(const OSQPCscMatrix* M, OSQPFloat* E);
+
+// E[i] = min |M(i,j)| over the nonzeros of M(i,:), where M stores triu part only
+void csc_row_min_abs_sym_triu(const OSQPCscMatrix* M, OSQPFloat* E);
+
 #ifdef __cplusplus
 }
 #endif
@@ -200,6 +200,36 @@ static OSQPInt permute_KKT(OSQPCscMatrix** KKT,
 }
 
 
+OSQPInt kkt_fill_qdldl(const OSQPMatrix* P,
+                       const OSQPMatrix* A) {
+
+    OSQPInt        lnz = -1;
+    OSQPInt*       perm;
+    OSQPFloat*     info;
+    OSQPCscMatrix* KKT;
+
+    // Only the pattern matters, any positive parameters do
+    KKT  = form_KKT(P->csc, A->csc, 0, 1.0, OSQP_NULL, 1.0, OSQP_NULL, OSQP_NULL, OSQP_NULL);
+    perm = (OSQPInt *)c_malloc((P->csc->n + A->csc->m) * sizeof(OSQPInt));
+    info = (OSQPFloat *)c_malloc(AMD_INFO * sizeof(OSQPFloat));
+
+    if (KKT && perm && info) {
+#ifdef OSQP_USE_LONG
+        if (amd_l_order(KKT->n, KKT->p, KKT->i, perm, (OSQPFloat *)OSQP_NULL, info) >= 0)
+#else
+        if (amd_order(KKT->n, KKT->p, KKT->i, perm, (OSQPFloat *)OSQP_NULL, info) >= 0)
+#endif
+            lnz = (OSQPInt)info[AMD_LNZ];
+    }
+
+    csc_spfree(KKT);
+    c_free(perm);
+    c_free(info);
+
+    return lnz;
+}
+
+
 // Initialize LDL Factorization structure
 OSQPInt init_linsys_solver_qdldl(qdldl_solver**      sp,
                                  const OSQPMatrix*   P,
@@ -248,8 +278,8 @@ OSQPInt init_linsys_solver_qdldl(qdldl_solver**      sp,
 
 #if OSQP_EMBEDDED_MODE != 1
     s->update_matrices = &update_linsys_solver_matrices_qdldl;
-    s->update_rho_vec  = &update_linsys_solver_rho_vec_qdldl;
 #endif
+    s->update_rho_vec  = &update_linsys_solver_rho_vec_qdldl;
 
     // Assign type
     s->type = OSQP_DIRECT_SOLVER;
@@ -413,6 +443,10 @@ OSQPInt solve_linsys_qdldl(qdldl_solver* s,
   } else {
 #endif
     /* stores solution to the KKT system in s->sol */
+#ifdef OSQP_EMBEDDED_MODE
+    if (s->ldl_solve) s->ldl_solve(s, s->sol, bv);
+    else
+#endif
     LDLSolve(s->sol, bv, s->L, s->Dinv, s->P, s->bp);
 
     /* copy x_tilde from s->sol */
@@ -494,6 +528,33 @@ OSQPInt update_linsys_solver_rho_vec_qdldl(qdldl_solver*      s,
         s->etree, s->bwork, s->iwork, s->fwork) < 0);
 }
 
+#else /* OSQP_EMBEDDED_MODE == 1 */
+
+OSQPInt update_linsys_solver_rho_vec_qdldl(qdldl_solver*      s,
+                                           const OSQPVectorf* rho_vec,
+                                           OSQPFloat          rho_sc) {
+
+    OSQPInt k;
+
+    // Look for the precomputed factorization of rho_sc
+    for (k = 0; k < s->rho_ladder_n; k++) {
+      if (s->rho_ladder[k] == rho_sc) break;
+    }
+    if (k == s->rho_ladder_n) return 1;
+
+    s->L->x = s->Lx_ladder[k];
+    s->Dinv = s->Dinv_ladder[k];
+
+    if (s->rho_inv_vec) {
+      s->rho_inv_vec = s->rho_inv_vec_ladder[k];
+    }
+    else {
+      s->rho_inv = 1. / rho_sc;
+    }
+
+    return 0;
+}
+
 #endif
 
 #ifndef OSQP_EMBEDDED_MODE
@@ -663,13 +724,39 @@ static void _adj_assemble_csc(OSQPCscMatrix*     D,
 
 }
 
-OSQPInt adjoint_derivative_qdldl(qdldl_solver*      s,
-                                 const OSQPMatrix*  P_full,
-                                 const OSQPMatrix*  G,
-                                 const OSQPMatrix*  A_eq,
-                                 const OSQPMatrix*  GDiagLambda,
-                                 const OSQPVectorf* slacks,
-                                 const OSQPVectorf* rhs) {
+void adjoint_derivative_free_qdldl(qdldl_adjoint_solver* s) {
+
+    if (s) {
+        csc_spfree(s->adj);
+        csc_spfree(s->adj_perm);
+        if (s->adj_matrix) OSQPMatrix_free(s->adj_matrix);
+        c_free(s->adjtoperm);
+        c_free(s->P);
+        c_free(s->Pinv);
+        c_free(s->etree);
+        c_free(s->Lnz);
+        c_free(s->Lp);
+        c_free(s->Li);
+        c_free(s->Lx);
+        c_free(s->D);
+        c_free(s->Dinv);
+        c_free(s->iwork);
+        c_free(s->bwork);
+        c_free(s->fwork);
+        c_free(s->x_work);
+        if (s->sol)      OSQPVectorf_free(s->sol);
+        if (s->residual) OSQPVectorf_free(s->residual);
+        c_free(s);
+    }
+}
+
+// Assemble the system matrix, order it and compute the elimination tree
+static OSQPInt _adj_symbolic(qdldl_adjoint_solver* s,
+                             const OSQPMatrix*     P_full,
+                             const OSQPMatrix*     G,
+                             const OSQPMatrix*     A_eq,
+                             const OSQPMatrix*     GDiagLambda,
+                             const OSQPVectorf*    slacks) {
 
     OSQPInt n = OSQPMatrix_get_m(P_full);
     OSQPInt n_ineq = OSQPMatrix_get_m(G);
@@ -689,131 +776,158 @@ OSQPInt adjoint_derivative_qdldl(qdldl_solver*      s,
                    A_eq_nnz +                    // Number of nonzeros in A_eq'
                    n + n_ineq + n_eq;            // Number of -eps entries on diagonal
 
-    OSQPInt dim = 2 * (n + n_ineq + n_eq);
-    OSQPCscMatrix* adj = csc_spalloc(dim, dim, nnzKKT, 1, 0);
-    if (!adj) return OSQP_NULL;
-    _adj_assemble_csc(adj, P_full, G, A_eq, GDiagLambda, slacks);
-
-    OSQPMatrix *adj_matrix = OSQPMatrix_new_from_csc(adj, 1);
-
-    _adj_perturb(adj, 1e-6);
+    OSQPInt   dim = s->dim;
+    QDLDL_int sumLnz;
+    OSQPInt   amd_status;
+
+    s->adj = csc_spalloc(dim, dim, nnzKKT, 1, 0);
+    if (!s->adj) return OSQP_MEM_ALLOC_ERROR;
+    _adj_assemble_csc(s->adj, P_full, G, A_eq, GDiagLambda, slacks);
+
+    // Iterative refinement runs against the unperturbed matrix
+    s->adj_matrix = OSQPMatrix_new_from_csc(s->adj, 1);
+    _adj_perturb(s->adj, 1e-6);
+
+    s->adjtoperm = (OSQPInt*)c_malloc(sizeof(OSQPInt)*nnzKKT);
+    s->P         = (QDLDL_int*)c_malloc(sizeof(QDLDL_int)*dim);
+    s->etree     = (QDLDL_int*)c_malloc(sizeof(QDLDL_int)*dim);
+    s->Lnz       = (QDLDL_int*)c_malloc(sizeof(QDLDL_int)*dim);
+    s->Lp        = (QDLDL_int*)c_malloc(sizeof(QDLDL_int)*(dim+1));
+    s->D         = (QDLDL_float*)c_malloc(sizeof(QDLDL_float)*dim);
+    s->Dinv      = (QDLDL_float*)c_malloc(sizeof(QDLDL_float)*dim);
+    s->iwork     = (QDLDL_int*)c_malloc(sizeof(QDLDL_int)*(3*dim));
+    s->bwork     = (QDLDL_bool*)c_malloc(sizeof(QDLDL_bool)*dim);
+    s->fwork     = (QDLDL_float*)c_malloc(sizeof(QDLDL_float)*dim);
+    s->x_work    = (QDLDL_float*)c_malloc(sizeof(QDLDL_float)*dim);
+    s->sol       = OSQPVectorf_malloc(dim);
+    s->residual  = OSQPVectorf_malloc(dim);
+
+    if (!s->adj_matrix || !s->adjtoperm || !s->P || !s->etree || !s->Lnz ||
+        !s->Lp || !s->D || !s->Dinv || !s->iwork || !s->bwork || !s->fwork ||
+        !s->x_work || !s->sol || !s->residual) {
+        return OSQP_MEM_ALLOC_ERROR;
+    }
 
-    // ----------------------------
-    // QDLDL formulation + solve
-    // ----------------------------
-    const QDLDL_int   An   = dim;
-    QDLDL_int i; // Counter
-
-    //data for L and D factors
-    QDLDL_int Ln = An;
-    QDLDL_int *Lp;
-    QDLDL_int *Li;
-    QDLDL_float *Lx;
-    QDLDL_float *D;
-    QDLDL_float *Dinv;
-
-    //permutation
-    QDLDL_int   *P;
-    QDLDL_int   *Pinv;
-
-    //data for elim tree calculation
-    QDLDL_int *etree;
-    QDLDL_int *Lnz;
-    QDLDL_int  sumLnz;
-
-    //working data for factorisation
-    QDLDL_int   *iwork;
-    QDLDL_bool  *bwork;
-    QDLDL_float *fwork;
-
-    //Data for results of A\b
-    QDLDL_float *x;
-    QDLDL_float *x_work;
-
-    etree = (QDLDL_int*)malloc(sizeof(QDLDL_int)*An);
-    Lnz   = (QDLDL_int*)malloc(sizeof(QDLDL_int)*An);
-
-    Lp    = (QDLDL_int*)malloc(sizeof(QDLDL_int)*(An+1));
-    D     = (QDLDL_float*)malloc(sizeof(QDLDL_float)*An);
-    Dinv  = (QDLDL_float*)malloc(sizeof(QDLDL_float)*An);
-
-    iwork = (QDLDL_int*)malloc(sizeof(QDLDL_int)*(3*An));
-    bwork = (QDLDL_bool*)malloc(sizeof(QDLDL_bool)*An);
-    fwork = (QDLDL_float*)malloc(sizeof(QDLDL_float)*An);
-
-    P = (QDLDL_int*)malloc(sizeof(QDLDL_int)*(An));
-    Pinv = (QDLDL_int*)malloc(sizeof(QDLDL_int)*(An));
-
-    OSQPInt amd_status;
 #ifdef OSQP_USE_LONG
-    amd_status = amd_l_order(An, adj->p, adj->i, P, (OSQPFloat *)OSQP_NULL, (OSQPFloat *)OSQP_NULL);
+    amd_status = amd_l_order(dim, s->adj->p, s->adj->i, s->P, (OSQPFloat *)OSQP_NULL, (OSQPFloat *)OSQP_NULL);
 #else
-    amd_status = amd_order(An, adj->p, adj->i, P, (OSQPFloat *)OSQP_NULL, (OSQPFloat *)OSQP_NULL);
+    amd_status = amd_order(dim, s->adj->p, s->adj->i, s->P, (OSQPFloat *)OSQP_NULL, (OSQPFloat *)OSQP_NULL);
 #endif
-    if (amd_status < 0) {
-        return amd_status;
-    }
+    if (amd_status < 0) return OSQP_LINSYS_SOLVER_INIT_ERROR;
 
     // Inverse of the permutation vector
-    Pinv = csc_pinv(P, An);
+    s->Pinv = csc_pinv(s->P, dim);
+    if (!s->Pinv) return OSQP_MEM_ALLOC_ERROR;
 
-    OSQPCscMatrix* adj_permuted;
-    adj_permuted = csc_symperm(adj, Pinv, OSQP_NULL, 1);
+    // The mapping lets a numeric refactorization permute new values in place
+    s->adj_perm = csc_symperm(s->adj, s->Pinv, s->adjtoperm, 1);
+    if (!s->adj_perm) return OSQP_MEM_ALLOC_ERROR;
 
-    sumLnz = QDLDL_etree(An, adj_permuted->p, adj_permuted->i, iwork, Lnz, etree);
+    sumLnz = QDLDL_etree(dim, s->adj_perm->p, s->adj_perm->i, s->iwork, s->Lnz, s->etree);
+    if (sumLnz < 0) return OSQP_LINSYS_SOLVER_INIT_ERROR;
 
-    Li    = (QDLDL_int*)malloc(sizeof(QDLDL_int)*sumLnz);
-    Lx    = (QDLDL_float*)malloc(sizeof(QDLDL_float)*sumLnz);
+    s->Li = (QDLDL_int*)c_malloc(sizeof(QDLDL_int)*c_max(sumLnz, 1));
+    s->Lx = (QDLDL_float*)c_malloc(sizeof(QDLDL_float)*c_max(sumLnz, 1));
+    if (!s->Li || !s->Lx) return OSQP_MEM_ALLOC_ERROR;
 
-    QDLDL_factor(An, adj_permuted->p, adj_permuted->i, adj_permuted->x, Lp, Li, Lx, D, Dinv, Lnz, etree, bwork, iwork, fwork);
+    return 0;
+}
 
-    x = (QDLDL_float*)malloc(sizeof(QDLDL_float)*An);
-    x_work = (QDLDL_float*)malloc(sizeof(QDLDL_float)*An);
+// Refresh the values of the system matrix, keeping its ordering
+static void _adj_numeric(qdldl_adjoint_solver* s,
+                         const OSQPMatrix*     P_full,
+                         const OSQPMatrix*     G,
+                         const OSQPMatrix*     A_eq,
+                         const OSQPMatrix*     GDiagLambda,
+                         const OSQPVectorf*    slacks) {
 
-    //when solving A\b, start with x = b
-    for (i = 0 ; i < An ; i++) x_work[i] = rhs->values[P[i]];
-    QDLDL_solve(Ln, Lp, Li, Lx, Dinv, x_work);
-    for (i = 0 ; i < An ; i++) x[P[i]] = x_work[i];
+    OSQPInt k;
+    OSQPInt nnz = s->adj->p[s->dim];
 
-    OSQPVectorf *sol = OSQPVectorf_new(x, An);
-    OSQPVectorf *residual = OSQPVectorf_malloc(An);
+    _adj_assemble_csc(s->adj, P_full, G, A_eq, GDiagLambda, slacks);
+    OSQPMatrix_update_values(s->adj_matrix, s->adj->x, OSQP_NULL, nnz);
+    _adj_perturb(s->adj, 1e-6);
 
-    OSQPInt k;
-    for (k=0; k<200; k++) {
-        OSQPVectorf_copy(residual, rhs);
-        OSQPMatrix_Axpy(adj_matrix, sol, residual, 1, -1);
-        if (OSQPVectorf_norm_2(residual) < 1e-12) break;
+    for (k = 0; k < nnz; k++) {
+        s->adj_perm->x[s->adjtoperm[k]] = s->adj->x[k];
+    }
+}
+
+OSQPInt adjoint_derivative_qdldl(qdldl_adjoint_solver** sp,
+                                 const OSQPMatrix*      P_full,
+                                 const OSQPMatrix*      G,
+                                 const OSQPMatrix*      A_eq,
+                                 const OSQPMatrix*      GDiagLambda,
+                                 const OSQPVectorf*     slacks,
+                                 OSQPVectorf*           rhs,
+                                 OSQPInt                nrhs,
+                                 OSQPInt                ld,
+                                 OSQPInt                new_structure) {
+
+    OSQPInt n = OSQPMatrix_get_m(P_full);
+    OSQPInt n_ineq = OSQPMatrix_get_m(G);
+    OSQPInt n_eq = OSQPMatrix_get_m(A_eq);
+    OSQPInt dim = 2 * (n + n_ineq + n_eq);
 
-        for (i = 0 ; i < An ; i++) x_work[i] = residual->values[P[i]];
-        QDLDL_solve(Ln, Lp, Li, Lx, Dinv, x_work);
-        for (i = 0 ; i < An ; i++) residual->values[P[i]] = x_work[i];
+    qdldl_adjoint_solver* s = *sp;
+    OSQPFloat* b;
+    OSQPInt exitflag;
+    OSQPInt i, j, k;
 
-        OSQPVectorf_minus(sol, sol, residual);
+    if (s && (new_structure || s->dim != dim)) {
+        adjoint_derivative_free_qdldl(s);
+        s = OSQP_NULL;
     }
 
-    OSQPVectorf_copy(rhs, sol);
+    if (!s) {
+        s = c_calloc(1, sizeof(qdldl_adjoint_solver));
+        *sp = s;
+        if (!s) return OSQP_MEM_ALLOC_ERROR;
+
+        s->dim = dim;
+        exitflag = _adj_symbolic(s, P_full, G, A_eq, GDiagLambda, slacks);
+        if (exitflag) {
+            adjoint_derivative_free_qdldl(s);
+            *sp = OSQP_NULL;
+            return exitflag;
+        }
+    }
+    else {
+        _adj_numeric(s, P_full, G, A_eq, GDiagLambda, slacks);
+    }
 
-    c_free(Lp);
-    c_free(Li);
-    c_free(Lx);
-    c_free(D);
-    c_free(Dinv);
-    c_free(P);
-    c_free(Pinv);
-    c_free(etree);
-    c_free(Lnz);
-    c_free(iwork);
-    c_free(bwork);
-    c_free(fwork);
-    c_free(x);
-    c_free(x_work);
-
-    csc_spfree(adj_permuted);
-    OSQPMatrix_free(adj_matrix);
-    csc_spfree(adj);
-
-    OSQPVectorf_free(sol);
-    OSQPVectorf_free(residual);
+    // ----------------------------
+    // QDLDL factorization + solve
+    // ----------------------------
+    if (QDLDL_factor(dim, s->adj_perm->p, s->adj_perm->i, s->adj_perm->x,
+                     s->Lp, s->Li, s->Lx, s->D, s->Dinv, s->Lnz, s->etree,
+                     s->bwork, s->iwork, s->fwork) < 0) {
+        return OSQP_NONCVX_ERROR;
+    }
+
+    // Every right-hand side is solved with the same factors
+    for (j = 0; j < nrhs; j++) {
+        b = rhs->values + j * ld;
+
+        //when solving A\b, start with x = b
+        for (i = 0 ; i < dim ; i++) s->x_work[i] = b[s->P[i]];
+        QDLDL_solve(dim, s->Lp, s->Li, s->Lx, s->Dinv, s->x_work);
+        for (i = 0 ; i < dim ; i++) s->sol->values[s->P[i]] = s->x_work[i];
+
+        for (k=0; k<200; k++) {
+            for (i = 0 ; i < dim ; i++) s->residual->values[i] = b[i];
+            OSQPMatrix_Axpy(s->adj_matrix, s->sol, s->residual, 1, -1);
+            if (OSQPVectorf_norm_2(s->residual) < 1e-12) break;
+
+            for (i = 0 ; i < dim ; i++) s->x_work[i] = s->residual->values[s->P[i]];
+            QDLDL_solve(dim, s->Lp, s->Li, s->Lx, s->Dinv, s->x_work);
+            for (i = 0 ; i < dim ; i++) s->residual->values[s->P[i]] = s->x_work[i];
+
+            OSQPVectorf_minus(s->sol, s->sol, s->residual);
+        }
+
+        for (i = 0 ; i < dim ; i++) b[i] = s->sol->values[i];
+    }
 
     return 0;
 }
@@ -49,14 +49,21 @@ struct qdldl {
                                const  OSQPMatrix* A,
                                const  OSQPInt*    Ax_new_idx,
                                       OSQPInt     A_new_n);   ///< Update solver matrices
+#endif
 
     OSQPInt (*update_rho_vec)(struct qdldl*       self,
                               const  OSQPVectorf* rho_vec,
                                      OSQPFloat    rho_sc);    ///< Update rho_vec parameter
-#endif
 
     OSQPInt nthreads;
 
+#ifdef OSQP_EMBEDDED_MODE
+    /* After the members shared with LinSysSolver */
+    void (*ldl_solve)(struct qdldl*    self,
+                      OSQPFloat*       x,
+                      const OSQPFloat* b);    ///< Generated solve of P'LDL'P x = b (OSQP_NULL to use QDLDL_solve)
+#endif
+
     /** @} */
 
     /**
@@ -95,10 +102,50 @@ struct qdldl {
     OSQPCscMatrix* adj;
 #endif
 
+#if OSQP_EMBEDDED_MODE == 1
+    // Factorizations precomputed for the rho values of the ladder
+    OSQPInt     rho_ladder_n;         ///< number of rho values (0 without a ladder)
+    OSQPFloat*  rho_ladder;           ///< increasing rho values
+    OSQPFloat** Lx_ladder;            ///< values of L for every rho value
+    OSQPFloat** Dinv_ladder;          ///< Dinv for every rho value
+    OSQPFloat** rho_inv_vec_ladder;   ///< rho_inv_vec for every rho value (OSQP_NULL for scalar rho)
+#endif
+
     /** @} */
 };
 
 
+#ifndef OSQP_EMBEDDED_MODE
+/**
+ * Workspace of the linear system of the adjoint derivatives
+ */
+typedef struct qdldl_adjoint qdldl_adjoint_solver;
+
+struct qdldl_adjoint {
+    OSQPInt        dim;         ///< dimension 2(n + n_ineq + n_eq) of the system
+    OSQPCscMatrix* adj;         ///< perturbed system matrix (upper triangular part)
+    OSQPMatrix*    adj_matrix;  ///< unperturbed system matrix for iterative refinement
+    OSQPCscMatrix* adj_perm;    ///< permuted system matrix that is factored
+    OSQPInt*       adjtoperm;   ///< index of the elements of adj in adj_perm
+    QDLDL_int*     P;           ///< fill-reducing ordering
+    QDLDL_int*     Pinv;        ///< inverse of the ordering
+    QDLDL_int*     etree;       ///< elimination tree
+    QDLDL_int*     Lnz;         ///< nonzeros in every column of L
+    QDLDL_int*     Lp;
+    QDLDL_int*     Li;
+    QDLDL_float*   Lx;
+    QDLDL_float*   D;
+    QDLDL_float*   Dinv;
+    QDLDL_int*     iwork;
+    QDLDL_bool*    bwork;
+    QDLDL_float*   fwork;
+    QDLDL_float*   x_work;
+    OSQPVectorf*   sol;         ///< solution of the system
+    OSQPVectorf*   residual;    ///< residual of the iterative refinement
+};
+#endif
+
+
 
 /**
  * Initialize QDLDL Solver
@@ -118,6 +165,19 @@ OSQPInt init_linsys_solver_qdldl(qdldl_solver**      sp,
                                  const OSQPSettings* settings,
                                  OSQPInt             polishing);
 
+#ifndef OSQP_EMBEDDED_MODE
+/**
+ * Number of nonzeros of the factor of the KKT matrix of P and A with the
+ * AMD ordering, from the symbolic analysis only
+ *
+ * @param  P  Objective function matrix (upper triangular form)
+ * @param  A  Constraints matrix
+ * @return    Nonzeros of L, -1 on error
+ */
+OSQPInt kkt_fill_qdldl(const OSQPMatrix* P,
+                       const OSQPMatrix* A);
+#endif
+
 /**
  * Get the user-friendly name of the QDLDL solver.
  * @return The user-friendly name
@@ -165,8 +225,14 @@ OSQPInt update_linsys_solver_matrices_qdldl(qdldl_solver*     s,
 
 
 
+#endif
+
 /**
  * Update rho_vec parameter in linear system solver structure
+ *
+ * In embedded mode 1 there is no refactorization and rho_sc must be one of
+ * the rho values of the ladder, whose precomputed factorization is used.
+ *
  * @param  s        Linear system solver structure
  * @param  rho_vec  new rho_vec value
  * @return          exitflag
@@ -175,8 +241,6 @@ OSQPInt update_linsys_solver_rho_vec_qdldl(qdldl_solver*      s,
                                            const OSQPVectorf* rho_vec,
                                            OSQPFloat          rho_sc);
 
-#endif
-
 #ifndef OSQP_EMBEDDED_MODE
 /**
  * Free linear system solver
@@ -184,13 +248,41 @@ OSQPInt update_linsys_solver_rho_vec_qdldl(qdldl_solver*      s,
  */
 void free_linsys_solver_qdldl(qdldl_solver* s);
 
-OSQPInt adjoint_derivative_qdldl(qdldl_solver*      s,
-                                 const OSQPMatrix*  P,
-                                 const OSQPMatrix*  G,
-                                 const OSQPMatrix*  A_eq,
-                                 const OSQPMatrix*  GDiagLambda,
-                                 const OSQPVectorf* slacks,
-                                 const OSQPVectorf* rhs);
+/**
+ * Solve the linear system of the adjoint derivatives
+ *
+ * The workspace is kept between calls. When the structure of the system is
+ * the same as in the previous call, the ordering and the elimination tree
+ * are reused and only the numeric factorization is computed.
+ *
+ * @param  sp            Pointer to the workspace, allocated on the first call
+ * @param  P_full        Full cost matrix
+ * @param  G             Inequality constraint matrix
+ * @param  A_eq          Equality constraint matrix
+ * @param  GDiagLambda   G scaled by the multipliers of the inequalities
+ * @param  slacks        Slacks of the inequalities
+ * @param  rhs           Right-hand sides, overwritten with the solutions
+ * @param  nrhs          Number of right-hand sides
+ * @param  ld            Offset between consecutive right-hand sides in rhs
+ * @param  new_structure 1 if the structure of G or A_eq changed, 0 otherwise
+ * @return               Exitflag
+ */
+OSQPInt adjoint_derivative_qdldl(qdldl_adjoint_solver** sp,
+                                 const OSQPMatrix*      P_full,
+                                 const OSQPMatrix*      G,
+                                 const OSQPMatrix*      A_eq,
+                                 const OSQPMatrix*      GDiagLambda,
+                                 const OSQPVectorf*     slacks,
+                                 OSQPVectorf*           rhs,
+                                 OSQPInt                nrhs,
+                                 OSQPInt                ld,
+                                 OSQPInt                new_structure);
+
+/**
+ * Free the workspace of the adjoint derivatives
+ * @param s workspace
+ */
+void adjoint_derivative_free_qdldl(qdldl_adjoint_solver* s);
 
 #endif
 
@@ -38,6 +38,15 @@ typedef enum OSQPMatrix_symmetry_type {NONE,TRIU} OSQPMatrix_symmetry_type;
 struct OSQPMatrix_ {
   OSQPCscMatrix*           csc;
   OSQPMatrix_symmetry_type symmetry;
+  float*                   xs;        /* single precision copy of csc->x used in Axpy/Atxpy (OSQP_NULL if unused) */
+  OSQPInt                  use_xs;    /* boolean; use xs in the matrix-vector products */
+  OSQPCscMatrix*           full;      /* both triangles of a TRIU matrix used in Axpy/Atxpy (OSQP_NULL if unused) */
+  OSQPInt*                 full_map;  /* entry k of full holds entry full_map[k] of csc */
+#ifdef OSQP_EMBEDDED_MODE
+  /* products generated for the sparsity of csc (OSQP_NULL if not generated) */
+  void (*Axpy)(const OSQPFloat* x, OSQPFloat* y, OSQPFloat alpha, OSQPFloat beta);
+  void (*Atxpy)(const OSQPFloat* x, OSQPFloat* y, OSQPFloat alpha, OSQPFloat beta);
+#endif
 };
 
 #ifdef __cplusplus
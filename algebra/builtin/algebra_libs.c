@@ -57,16 +57,29 @@ OSQPInt osqp_algebra_init_linsys_solver(LinSysSolver**      s,
   }
 }
 
-OSQPInt adjoint_derivative_linsys_solver(LinSysSolver**      s,
+OSQPInt osqp_algebra_kkt_fill(const OSQPMatrix* P,
+                              const OSQPMatrix* A) {
+  return kkt_fill_qdldl(P, A);
+}
+
+OSQPInt adjoint_derivative_linsys_solver(AdjLinSysSolver**   s,
                                          const OSQPSettings* settings,
                                          const OSQPMatrix*   P,
                                          const OSQPMatrix*   G,
                                          const OSQPMatrix*   A_eq,
-                                         OSQPMatrix*         GDiagLambda,
-                                         OSQPVectorf*        slacks,
-                                         OSQPVectorf*        rhs) {
+                                         const OSQPMatrix*   GDiagLambda,
+                                         const OSQPVectorf*  slacks,
+                                         OSQPVectorf*        rhs,
+                                         OSQPInt             nrhs,
+                                         OSQPInt             ld,
+                                         OSQPInt             new_structure) {
+
+  return adjoint_derivative_qdldl((qdldl_adjoint_solver **)s, P, G, A_eq, GDiagLambda, slacks,
+                                  rhs, nrhs, ld, new_structure);
+}
 
-return adjoint_derivative_qdldl((qdldl_solver **)s, P, G, A_eq, GDiagLambda, slacks, rhs);
+void adjoint_derivative_linsys_free(AdjLinSysSolver* s) {
+  adjoint_derivative_free_qdldl((qdldl_adjoint_solver *)s);
 }
 
 #endif
@@ -6,6 +6,28 @@
 #include "printing.h"
 
 
+/* Refresh the copies of the values used in the products after M->csc->x changed */
+static void sync_values(OSQPMatrix* M) {
+
+  OSQPInt i;
+  OSQPInt nnz;
+
+  if (M->xs) {
+    nnz = M->csc->p[M->csc->n];
+    for (i = 0; i < nnz; i++) {
+      M->xs[i] = (float)M->csc->x[i];
+    }
+  }
+
+  if (M->full) {
+    nnz = M->full->p[M->full->n];
+    for (i = 0; i < nnz; i++) {
+      M->full->x[i] = M->csc->x[M->full_map[i]];
+    }
+  }
+}
+
+
 #ifndef OSQP_EMBEDDED_MODE
 
 /*  logical test functions ----------------------------------------------------*/
@@ -31,7 +53,11 @@ OSQPMatrix* OSQPMatrix_new_from_csc(const OSQPCscMatrix* A,
   if(is_triu) out->symmetry = TRIU;
   else        out->symmetry = NONE;
 
-  out->csc = csc_copy(A);
+  out->csc      = csc_copy(A);
+  out->xs       = OSQP_NULL;
+  out->use_xs   = 0;
+  out->full     = OSQP_NULL;
+  out->full_map = OSQP_NULL;
 
   if(!out->csc){
     c_free(out);
@@ -50,7 +76,11 @@ OSQPMatrix* OSQPMatrix_copy_new(const OSQPMatrix* A) {
     if(!out) return OSQP_NULL;
 
     out->symmetry = A->symmetry;
-    out->csc = csc_copy(A->csc);
+    out->csc      = csc_copy(A->csc);
+    out->xs       = OSQP_NULL;
+    out->use_xs   = 0;
+    out->full     = OSQP_NULL;
+    out->full_map = OSQP_NULL;
 
     if(!out->csc){
         c_free(out);
@@ -69,7 +99,11 @@ OSQPMatrix* OSQPMatrix_triu_to_symm(const OSQPMatrix* A) {
         if(!out) return OSQP_NULL;
 
         out->symmetry = NONE;
-        out->csc = triu_to_csc(A->csc);
+        out->csc      = triu_to_csc(A->csc);
+        out->xs       = OSQP_NULL;
+        out->use_xs   = 0;
+        out->full     = OSQP_NULL;
+        out->full_map = OSQP_NULL;
 
         if (!out->csc) {
             c_free(out);
@@ -90,7 +124,11 @@ OSQPMatrix* OSQPMatrix_vstack(const OSQPMatrix* A,
         if(!out) return OSQP_NULL;
 
         out->symmetry = NONE;
-        out->csc = vstack(A->csc, B->csc);
+        out->csc      = vstack(A->csc, B->csc);
+        out->xs       = OSQP_NULL;
+        out->use_xs   = 0;
+        out->full     = OSQP_NULL;
+        out->full_map = OSQP_NULL;
 
         if (!out->csc) {
             c_free(out);
@@ -104,8 +142,90 @@ OSQPMatrix* OSQPMatrix_vstack(const OSQPMatrix* A,
     }
 }
 
+OSQPInt OSQPMatrix_init_single_values(OSQPMatrix* M) {
+
+#ifndef OSQP_USE_FLOAT
+  if (!M->xs) {
+    /* Allocate at least one entry so that an empty matrix still counts as initialized */
+    M->xs = (float*) c_malloc(c_max(M->csc->p[M->csc->n], 1) * sizeof(float));
+    if (!M->xs) return 1;
+  }
+  sync_values(M);
+  M->use_xs = 1;
+#endif /* ifndef OSQP_USE_FLOAT */
+
+  /* Nothing to do when OSQPFloat is already single precision */
+  return 0;
+}
+
+OSQPInt OSQPMatrix_init_symm_full(OSQPMatrix* M) {
+
+  OSQPInt        i, j, k, z, n;
+  OSQPInt*       src;
+  OSQPInt*       TtoC;
+  OSQPCscMatrix* T;
+
+  if (M->symmetry != TRIU || M->full) return 0;
+
+  n = M->csc->n;
+
+  // Triplets of both triangles with the entry of csc each one comes from
+  T    = csc_spalloc(n, n, 2 * M->csc->p[n], 1, 1);
+  src  = (OSQPInt*) c_malloc(c_max(2 * M->csc->p[n], 1) * sizeof(OSQPInt));
+  TtoC = (OSQPInt*) c_malloc(c_max(2 * M->csc->p[n], 1) * sizeof(OSQPInt));
+  if (!T || !src || !TtoC) {
+    csc_spfree(T);
+    c_free(src);
+    c_free(TtoC);
+    return 1;
+  }
+
+  z = 0;
+  for (j = 0; j < n; j++) {
+    for (k = M->csc->p[j]; k < M->csc->p[j+1]; k++) {
+      i = M->csc->i[k];
+      T->i[z] = i;
+      T->p[z] = j;
+      T->x[z] = M->csc->x[k];
+      src[z++] = k;
+      if (i < j) {
+        T->i[z] = j;
+        T->p[z] = i;
+        T->x[z] = M->csc->x[k];
+        src[z++] = k;
+      }
+    }
+  }
+  T->nz = z;
+
+  M->full     = triplet_to_csc(T, TtoC);
+  M->full_map = (OSQPInt*) c_malloc(c_max(z, 1) * sizeof(OSQPInt));
+  if (M->full && M->full_map) {
+    for (k = 0; k < z; k++) M->full_map[TtoC[k]] = src[k];
+  }
+
+  csc_spfree(T);
+  c_free(src);
+  c_free(TtoC);
+
+  if (!M->full || !M->full_map) {
+    csc_spfree(M->full);
+    c_free(M->full_map);
+    M->full     = OSQP_NULL;
+    M->full_map = OSQP_NULL;
+    return 1;
+  }
+
+  return 0;
+}
+
 #endif //OSQP_EMBEDDED_MODE
 
+void OSQPMatrix_use_single_values(OSQPMatrix* M,
+                                  OSQPInt     use) {
+  M->use_xs = (use && M->xs) ? 1 : 0;
+}
+
 /*  direct data access functions ---------------------------------------------*/
 
 void OSQPMatrix_update_values(OSQPMatrix*      M,
@@ -113,6 +233,7 @@ void OSQPMatrix_update_values(OSQPMatrix*      M,
                               const OSQPInt*   Mx_new_idx,
                               OSQPInt          M_new_n) {
   csc_update_values(M->csc, Mx_new, Mx_new_idx, M_new_n);
+  sync_values(M);
 }
 
 /* Matrix dimensions and data access */
@@ -129,18 +250,51 @@ OSQPInt    OSQPMatrix_get_nz(const OSQPMatrix* M) {return M->csc->p[M->csc->n];}
 void OSQPMatrix_mult_scalar(OSQPMatrix *A,
                             OSQPFloat   sc){
   csc_scale(A->csc,sc);
+  sync_values(A);
 }
 
 void OSQPMatrix_lmult_diag(OSQPMatrix*        A,
                            const OSQPVectorf* L) {
   csc_lmult_diag(A->csc, OSQPVectorf_data(L));
+  sync_values(A);
 }
 
 void OSQPMatrix_rmult_diag(OSQPMatrix* A,
                            const OSQPVectorf* R) {
   csc_rmult_diag(A->csc, R->values);
+  sync_values(A);
+}
+
+#if OSQP_EMBEDDED_MODE != 1
+
+void OSQPMatrix_scale_entries(OSQPMatrix*        A,
+                              const OSQPInt*     idx,
+                              OSQPInt            len,
+                              const OSQPVectorf* L,
+                              const OSQPVectorf* R,
+                              OSQPFloat          sc) {
+  csc_scale_entries(A->csc, idx, len, L->values, R->values, sc);
+  sync_values(A);
 }
 
+void OSQPMatrix_scale_entries_norm_inf(OSQPMatrix*        A,
+                                       const OSQPVectorf* L,
+                                       const OSQPVectorf* R,
+                                       OSQPFloat          sc,
+                                       OSQPVectorf*       col_norms,
+                                       OSQPVectorf*       row_norms) {
+  //the rows of a symmetric matrix are also found in its upper triangle
+  OSQPInt sym = A->symmetry != NONE;
+
+  csc_scale_entries_norm_inf(A->csc, L->values, R->values, sc,
+                             col_norms ? OSQPVectorf_data(col_norms) : OSQP_NULL,
+                             row_norms && !sym ? OSQPVectorf_data(row_norms) : OSQP_NULL);
+  sync_values(A);
+  if (sym && row_norms) OSQPMatrix_row_norm_inf(A, row_norms);
+}
+
+#endif /* if OSQP_EMBEDDED_MODE != 1 */
+
 void OSQPMatrix_AtDA_extract_diag(const OSQPMatrix*  A,
                                   const OSQPVectorf* D,
                                         OSQPVectorf* d) {
@@ -159,7 +313,24 @@ void OSQPMatrix_Axpy(const OSQPMatrix*  A,
                            OSQPFloat    alpha,
                            OSQPFloat    beta) {
 
-  if(A->symmetry == NONE){
+#ifdef OSQP_EMBEDDED_MODE
+  if(A->Axpy){
+    //product generated for the sparsity pattern of A
+    A->Axpy(x->values, y->values, alpha, beta);
+    return;
+  }
+#endif
+
+  if(A->use_xs){
+    //single precision values, OSQPFloat accumulation
+    if(A->symmetry == NONE) csc_Axpy_single(A->csc, A->xs, x->values, y->values, alpha, beta);
+    else           csc_Axpy_sym_triu_single(A->csc, A->xs, x->values, y->values, alpha, beta);
+  }
+  else if(A->full){
+    //symmetric matrix with both triangles stored
+    csc_Axpy_sym_full(A->full, x->values, y->values, alpha, beta);
+  }
+  else if(A->symmetry == NONE){
     //full matrix
     csc_Axpy(A->csc, x->values, y->values, alpha, beta);
   }
@@ -175,7 +346,19 @@ void OSQPMatrix_Atxpy(const OSQPMatrix*  A,
                             OSQPFloat    alpha,
                             OSQPFloat    beta) {
 
-   if(A->symmetry == NONE) csc_Atxpy(A->csc, x->values, y->values, alpha, beta);
+#ifdef OSQP_EMBEDDED_MODE
+   if(A->Atxpy){
+     A->Atxpy(x->values, y->values, alpha, beta);
+     return;
+   }
+#endif
+
+   if(A->use_xs){
+     if(A->symmetry == NONE) csc_Atxpy_single(A->csc, A->xs, x->values, y->values, alpha, beta);
+     else    csc_Axpy_sym_triu_single(A->csc, A->xs, x->values, y->values, alpha, beta);
+   }
+   else if(A->full)             csc_Axpy_sym_full(A->full, x->values, y->values, alpha, beta);
+   else if(A->symmetry == NONE) csc_Atxpy(A->csc, x->values, y->values, alpha, beta);
    else            csc_Axpy_sym_triu(A->csc, x->values, y->values, alpha, beta);
 }
 
@@ -202,12 +385,41 @@ void OSQPMatrix_row_norm_inf(const OSQPMatrix*  M,
    else                    csc_row_norm_inf_sym_triu(M->csc, OSQPVectorf_data(E));
 }
 
+void OSQPMatrix_col_norm_2(const OSQPMatrix*  M,
+                                 OSQPVectorf* E) {
+   if(M->symmetry == NONE) csc_col_norm_2(M->csc, OSQPVectorf_data(E));
+   else                    csc_row_norm_2_sym_triu(M->csc, OSQPVectorf_data(E));
+}
+
+void OSQPMatrix_row_norm_2(const OSQPMatrix*  M,
+                                 OSQPVectorf* E) {
+   if(M->symmetry == NONE) csc_row_norm_2(M->csc, OSQPVectorf_data(E));
+   else                    csc_row_norm_2_sym_triu(M->csc, OSQPVectorf_data(E));
+}
+
+void OSQPMatrix_col_min_abs(const OSQPMatrix*  M,
+                                  OSQPVectorf* E) {
+   if(M->symmetry == NONE) csc_col_min_abs(M->csc, OSQPVectorf_data(E));
+   else                    csc_row_min_abs_sym_triu(M->csc, OSQPVectorf_data(E));
+}
+
+void OSQPMatrix_row_min_abs(const OSQPMatrix*  M,
+                                  OSQPVectorf* E) {
+   if(M->symmetry == NONE) csc_row_min_abs(M->csc, OSQPVectorf_data(E));
+   else                    csc_row_min_abs_sym_triu(M->csc, OSQPVectorf_data(E));
+}
+
 #endif // endef OSQP_EMBEDDED_MODE
 
 #ifndef OSQP_EMBEDDED_MODE
 
 void OSQPMatrix_free(OSQPMatrix* M){
-  if (M) csc_spfree(M->csc);
+  if (M) {
+    csc_spfree(M->csc);
+    if (M->xs) c_free(M->xs);
+    if (M->full) csc_spfree(M->full);
+    if (M->full_map) c_free(M->full_map);
+  }
   c_free(M);
 }
 
@@ -237,6 +449,10 @@ OSQPMatrix* OSQPMatrix_submatrix_byrows(const OSQPMatrix*  A,
 
   out->symmetry = NONE;
   out->csc      = M;
+  out->xs       = OSQP_NULL;
+  out->use_xs   = 0;
+  out->full     = OSQP_NULL;
+  out->full_map = OSQP_NULL;
 
   return out;
 
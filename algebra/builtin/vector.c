@@ -4,6 +4,18 @@
 
 /* VECTOR FUNCTIONS ----------------------------------------------------------*/
 
+/* The loops over the entries of a vector run in blocks of VEC_BLOCK entries.
+ * Generated code with fixed dimensions sets it through OSQP_CODEGEN_BLOCK to
+ * gcd(n, m), which divides the length of every vector of its problem. The
+ * inner loops then have a compile-time trip count that the compiler can
+ * unroll and vectorize.
+ */
+#ifdef OSQP_CODEGEN_BLOCK
+# define VEC_BLOCK OSQP_CODEGEN_BLOCK
+#else
+# define VEC_BLOCK 1
+#endif
+
 #ifndef OSQP_EMBEDDED_MODE
 
 OSQPInt OSQPVectorf_is_eq(const OSQPVectorf* A,
@@ -235,6 +247,65 @@ void OSQPVectorf_view_free(OSQPVectorf* a) {
   c_free(a);
 }
 
+OSQPInt OSQPVectorf_align_offset(const OSQPVectorf* a) {
+  size_t rem = (size_t)(a->values) % OSQP_VECTOR_ALIGNMENT;
+  return rem ? (OSQPInt)((OSQP_VECTOR_ALIGNMENT - rem) / sizeof(OSQPFloat)) : 0;
+}
+
+void OSQPVectorf_bounds_partition(OSQPVectori*       idx,
+                                  OSQPInt*           n_fixed,
+                                  OSQPInt*           n_bounded,
+                                  const OSQPVectorf* l,
+                                  const OSQPVectorf* u,
+                                  OSQPFloat          infval) {
+
+  OSQPInt i;
+  OSQPInt k;
+  OSQPInt length = l->length;
+
+  OSQPInt*   idxv = idx->values;
+  OSQPFloat* lv   = l->values;
+  OSQPFloat* uv   = u->values;
+
+  // Fixed rows first
+  k = 0;
+  for (i = 0; i < length; i++) {
+    if (lv[i] == uv[i]) idxv[k++] = i;
+  }
+  *n_fixed = k;
+
+  // Then every row with a finite bound
+  for (i = 0; i < length; i++) {
+    if (lv[i] != uv[i] && ((lv[i] >= -infval) || (uv[i] <= infval))) idxv[k++] = i;
+  }
+  *n_bounded = k - *n_fixed;
+}
+
+void OSQPVectorf_ew_bound_vec_part(OSQPVectorf*       x,
+                                   const OSQPVectorf* l,
+                                   const OSQPVectorf* u,
+                                   const OSQPVectori* idx,
+                                   OSQPInt            n_fixed,
+                                   OSQPInt            n_bounded) {
+
+  OSQPInt k, i;
+
+  OSQPFloat* xv   = x->values;
+  OSQPFloat* lv   = l->values;
+  OSQPFloat* uv   = u->values;
+  OSQPInt*   idxv = idx->values;
+
+  for (k = 0; k < n_fixed; k++) {
+    i     = idxv[k];
+    xv[i] = lv[i];
+  }
+
+  for (k = n_fixed; k < n_fixed + n_bounded; k++) {
+    i     = idxv[k];
+    xv[i] = c_min(c_max(xv[i], lv[i]), uv[i]);
+  }
+}
+
 OSQPFloat OSQPVectorf_norm_2(const OSQPVectorf* v) {
     OSQPInt i;
     OSQPInt length  = v->length;
@@ -270,56 +341,66 @@ void OSQPVectorf_copy(OSQPVectorf*       b,
 
 void OSQPVectorf_from_raw(OSQPVectorf*     b,
                           const OSQPFloat* av) {
-  OSQPInt    i;
+  OSQPInt    i, k;
   OSQPInt    length = b->length;
   OSQPFloat* bv  = b->values;
 
-  for (i = 0; i < length; i++) {
-    bv[i] = av[i];
+  for (k = 0; k < length; k += VEC_BLOCK) {
+    for (i = k; i < k + VEC_BLOCK; i++) {
+      bv[i] = av[i];
+    }
   }
 }
 
 void OSQPVectori_from_raw(OSQPVectori*   b,
                           const OSQPInt* av) {
-  OSQPInt  i;
+  OSQPInt  i, k;
   OSQPInt  length = b->length;
   OSQPInt* bv = b->values;
 
-  for (i = 0; i < length; i++) {
-    bv[i] = av[i];
+  for (k = 0; k < length; k += VEC_BLOCK) {
+    for (i = k; i < k + VEC_BLOCK; i++) {
+      bv[i] = av[i];
+    }
   }
 }
 
 void OSQPVectorf_to_raw(OSQPFloat*         bv,
                         const OSQPVectorf* a) {
-  OSQPInt    i;
+  OSQPInt    i, k;
   OSQPInt    length = a->length;
   OSQPFloat* av = a->values;
 
-  for (i = 0; i < length; i++) {
-    bv[i] = av[i];
+  for (k = 0; k < length; k += VEC_BLOCK) {
+    for (i = k; i < k + VEC_BLOCK; i++) {
+      bv[i] = av[i];
+    }
   }
 }
 
 void OSQPVectori_to_raw(OSQPInt*           bv,
                         const OSQPVectori* a) {
-  OSQPInt  i;
+  OSQPInt  i, k;
   OSQPInt  length = a->length;
   OSQPInt* av = a->values;
 
-  for (i = 0; i < length; i++) {
-    bv[i] = av[i];
+  for (k = 0; k < length; k += VEC_BLOCK) {
+    for (i = k; i < k + VEC_BLOCK; i++) {
+      bv[i] = av[i];
+    }
   }
 }
 
 void OSQPVectorf_set_scalar(OSQPVectorf* a,
                             OSQPFloat    sc) {
-  OSQPInt    i;
+  OSQPInt    i, k;
   OSQPInt    length = a->length;
   OSQPFloat* av  = a->values;
 
-  for (i = 0; i < length; i++) {
-    av[i] = sc;
+  for (k = 0; k < length; k += VEC_BLOCK) {
+    for (i = k; i < k + VEC_BLOCK; i++) {
+      av[i] = sc;
+    }
   }
 }
 
@@ -329,34 +410,38 @@ void OSQPVectorf_set_scalar_conditional(OSQPVectorf*       a,
                                         OSQPFloat          sc_if_neg,
                                         OSQPFloat          sc_if_zero,
                                         OSQPFloat          sc_if_pos) {
-  OSQPInt    i;
+  OSQPInt    i, k;
   OSQPInt    length = a->length;
   OSQPFloat* av     = a->values;
   OSQPInt*   testv  = test->values;
 
-  for (i = 0; i < length; i++) {
+  for (k = 0; k < length; k += VEC_BLOCK) {
+    for (i = k; i < k + VEC_BLOCK; i++) {
       if (testv[i] == 0)      av[i] = sc_if_zero;
       else if (testv[i] > 0)  av[i] = sc_if_pos;
       else                    av[i] = sc_if_neg;
+    }
   }
 }
 
 
 void OSQPVectorf_mult_scalar(OSQPVectorf* a,
                              OSQPFloat    sc) {
-  OSQPInt    i;
+  OSQPInt    i, k;
   OSQPInt    length = a->length;
   OSQPFloat* av = a->values;
 
-  for (i = 0; i < length; i++) {
-    av[i] *= sc;
+  for (k = 0; k < length; k += VEC_BLOCK) {
+    for (i = k; i < k + VEC_BLOCK; i++) {
+      av[i] *= sc;
+    }
   }
 }
 
 void OSQPVectorf_plus(OSQPVectorf*      x,
                      const OSQPVectorf* a,
                      const OSQPVectorf* b) {
-  OSQPInt i;
+  OSQPInt i, k;
   OSQPInt length = a->length;
 
   OSQPFloat* av = a->values;
@@ -364,13 +449,17 @@ void OSQPVectorf_plus(OSQPVectorf*      x,
   OSQPFloat* xv = x->values;
 
   if (x == a){
-    for (i = 0; i < length; i++) {
-      xv[i] += bv[i];
+    for (k = 0; k < length; k += VEC_BLOCK) {
+      for (i = k; i < k + VEC_BLOCK; i++) {
+        xv[i] += bv[i];
+      }
     }
   }
   else {
-    for (i = 0; i < length; i++) {
-      xv[i] = av[i] + bv[i];
+    for (k = 0; k < length; k += VEC_BLOCK) {
+      for (i = k; i < k + VEC_BLOCK; i++) {
+        xv[i] = av[i] + bv[i];
+      }
     }
   }
 }
@@ -378,7 +467,7 @@ void OSQPVectorf_plus(OSQPVectorf*      x,
 void OSQPVectorf_minus(OSQPVectorf*       x,
                        const OSQPVectorf* a,
                        const OSQPVectorf* b) {
-  OSQPInt i;
+  OSQPInt i, k;
   OSQPInt length = a->length;
 
   OSQPFloat* av = a->values;
@@ -386,13 +475,17 @@ void OSQPVectorf_minus(OSQPVectorf*       x,
   OSQPFloat* xv = x->values;
 
   if (x == a) {
-    for (i = 0; i < length; i++) {
-      xv[i] -= bv[i];
+    for (k = 0; k < length; k += VEC_BLOCK) {
+      for (i = k; i < k + VEC_BLOCK; i++) {
+        xv[i] -= bv[i];
+      }
     }
   }
   else {
-    for (i = 0; i < length; i++) {
-      xv[i] = av[i] - bv[i];
+    for (k = 0; k < length; k += VEC_BLOCK) {
+      for (i = k; i < k + VEC_BLOCK; i++) {
+        xv[i] = av[i] - bv[i];
+      }
     }
   }
 }
@@ -402,7 +495,7 @@ void OSQPVectorf_add_scaled(OSQPVectorf*       x,
                             const OSQPVectorf* a,
                             OSQPFloat          scb,
                             const OSQPVectorf* b) {
-  OSQPInt i;
+  OSQPInt i, k;
   OSQPInt length = x->length;
 
   OSQPFloat* av = a->values;
@@ -411,13 +504,17 @@ void OSQPVectorf_add_scaled(OSQPVectorf*       x,
 
   /* shorter version when incrementing */
   if (x == a && sca == 1.){
-    for (i = 0; i < length; i++) {
-      xv[i] += scb * bv[i];
+    for (k = 0; k < length; k += VEC_BLOCK) {
+      for (i = k; i < k + VEC_BLOCK; i++) {
+        xv[i] += scb * bv[i];
+      }
     }
   }
   else {
-    for (i = 0; i < length; i++) {
-      xv[i] = sca * av[i] + scb * bv[i];
+    for (k = 0; k < length; k += VEC_BLOCK) {
+      for (i = k; i < k + VEC_BLOCK; i++) {
+        xv[i] = sca * av[i] + scb * bv[i];
+      }
     }
   }
 }
@@ -429,7 +526,7 @@ void OSQPVectorf_add_scaled3(OSQPVectorf*       x,
                              const OSQPVectorf* b,
                              OSQPFloat          scc,
                              const OSQPVectorf* c) {
-  OSQPInt i;
+  OSQPInt i, k;
   OSQPInt length = x->length;
 
   OSQPFloat* av = a->values;
@@ -439,13 +536,17 @@ void OSQPVectorf_add_scaled3(OSQPVectorf*       x,
 
   /* shorter version when incrementing */
   if (x == a && sca == 1.){
-    for (i = 0; i < length; i++) {
-      xv[i] += scb * bv[i] + scc * cv[i];
+    for (k = 0; k < length; k += VEC_BLOCK) {
+      for (i = k; i < k + VEC_BLOCK; i++) {
+        xv[i] += scb * bv[i] + scc * cv[i];
+      }
     }
   }
   else {
-    for (i = 0; i < length; i++) {
-      xv[i] =  sca * av[i] + scb * bv[i] + scc * cv[i];
+    for (k = 0; k < length; k += VEC_BLOCK) {
+      for (i = k; i < k + VEC_BLOCK; i++) {
+        xv[i] =  sca * av[i] + scb * bv[i] + scc * cv[i];
+      }
     }
   }
 }
@@ -453,16 +554,18 @@ void OSQPVectorf_add_scaled3(OSQPVectorf*       x,
 
 OSQPFloat OSQPVectorf_norm_inf(const OSQPVectorf* v) {
 
-  OSQPInt i;
+  OSQPInt i, k;
   OSQPInt length  = v->length;
 
   OSQPFloat  absval;
   OSQPFloat  normval = 0.0;
   OSQPFloat* vv      = v->values;
 
-  for (i = 0; i < length; i++) {
-    absval = c_absval(vv[i]);
-    if (absval > normval) normval = absval;
+  for (k = 0; k < length; k += VEC_BLOCK) {
+    for (i = k; i < k + VEC_BLOCK; i++) {
+      absval = c_absval(vv[i]);
+      if (absval > normval) normval = absval;
+    }
   }
   return normval;
 }
@@ -483,7 +586,7 @@ OSQPFloat OSQPVectorf_norm_inf(const OSQPVectorf* v) {
 OSQPFloat OSQPVectorf_scaled_norm_inf(const OSQPVectorf* S,
                                       const OSQPVectorf* v) {
 
-  OSQPInt i;
+  OSQPInt i, k;
   OSQPInt length = v->length;
 
   OSQPFloat* vv  = v->values;
@@ -491,9 +594,11 @@ OSQPFloat OSQPVectorf_scaled_norm_inf(const OSQPVectorf* S,
   OSQPFloat  absval;
   OSQPFloat  normval = 0.0;
 
-  for (i = 0; i < length; i++) {
-    absval = c_absval(Sv[i] * vv[i]);
-    if (absval > normval) normval = absval;
+  for (k = 0; k < length; k += VEC_BLOCK) {
+    for (i = k; i < k + VEC_BLOCK; i++) {
+      absval = c_absval(Sv[i] * vv[i]);
+      if (absval > normval) normval = absval;
+    }
   }
   return normval;
 }
@@ -514,7 +619,7 @@ OSQPFloat OSQPVectorf_scaled_norm_inf(const OSQPVectorf* S,
 
 OSQPFloat OSQPVectorf_norm_inf_diff(const OSQPVectorf* a,
                                     const OSQPVectorf* b) {
-  OSQPInt i;
+  OSQPInt i, k;
   OSQPInt length = a->length;
 
   OSQPFloat* av   = a->values;
@@ -522,9 +627,11 @@ OSQPFloat OSQPVectorf_norm_inf_diff(const OSQPVectorf* a,
   OSQPFloat  absval;
   OSQPFloat  normDiff = 0.0;
 
-  for (i = 0; i < length; i++) {
-    absval = c_absval(av[i] - bv[i]);
-    if (absval > normDiff) normDiff = absval;
+  for (k = 0; k < length; k += VEC_BLOCK) {
+    for (i = k; i < k + VEC_BLOCK; i++) {
+      absval = c_absval(av[i] - bv[i]);
+      if (absval > normDiff) normDiff = absval;
+    }
   }
   return normDiff;
 }
@@ -561,15 +668,17 @@ OSQPFloat OSQPVectorf_norm_inf_diff(const OSQPVectorf* a,
 OSQPFloat OSQPVectorf_dot_prod(const OSQPVectorf* a,
                                const OSQPVectorf* b) {
 
-  OSQPInt   i;
+  OSQPInt   i, k;
   OSQPInt   length = a->length;
 
   OSQPFloat* av   = a->values;
   OSQPFloat* bv   = b->values;
   OSQPFloat dotprod = 0.0;
 
-  for (i = 0; i < length; i++) {
-    dotprod += av[i] * bv[i];
+  for (k = 0; k < length; k += VEC_BLOCK) {
+    for (i = k; i < k + VEC_BLOCK; i++) {
+      dotprod += av[i] * bv[i];
+    }
   }
   return dotprod;
 }
@@ -578,7 +687,7 @@ OSQPFloat OSQPVectorf_dot_prod_signed(const OSQPVectorf* a,
                                       const OSQPVectorf* b,
                                             OSQPInt      sign) {
 
-  OSQPInt   i;
+  OSQPInt   i, k;
   OSQPInt   length = a->length;
 
   OSQPFloat* av = a->values;
@@ -586,13 +695,17 @@ OSQPFloat OSQPVectorf_dot_prod_signed(const OSQPVectorf* a,
   OSQPFloat  dotprod = 0.0;
 
   if (sign == 1) {  /* dot with positive part of b */
-    for (i = 0; i < length; i++) {
-      dotprod += av[i] * c_max(bv[i], 0.);
+    for (k = 0; k < length; k += VEC_BLOCK) {
+      for (i = k; i < k + VEC_BLOCK; i++) {
+        dotprod += av[i] * c_max(bv[i], 0.);
+      }
     }
   }
   else if (sign == -1){  /* dot with negative part of b */
-    for (i = 0; i < length; i++) {
-      dotprod += av[i] * c_min(bv[i],0.);
+    for (k = 0; k < length; k += VEC_BLOCK) {
+      for (i = k; i < k + VEC_BLOCK; i++) {
+        dotprod += av[i] * c_min(bv[i],0.);
+      }
     }
   }
   else{
@@ -606,7 +719,7 @@ void OSQPVectorf_ew_prod(OSQPVectorf*       c,
                          const OSQPVectorf* a,
                          const OSQPVectorf* b) {
 
-  OSQPInt i;
+  OSQPInt i, k;
   OSQPInt length = a->length;
 
   OSQPFloat* av = a->values;
@@ -615,13 +728,17 @@ void OSQPVectorf_ew_prod(OSQPVectorf*       c,
 
 
   if (c == a) {
-    for (i = 0; i < length; i++) {
-      cv[i] *= bv[i];
+    for (k = 0; k < length; k += VEC_BLOCK) {
+      for (i = k; i < k + VEC_BLOCK; i++) {
+        cv[i] *= bv[i];
+      }
     }
   }
   else {
-    for (i = 0; i < length; i++) {
-      cv[i] = av[i] * bv[i];
+    for (k = 0; k < length; k += VEC_BLOCK) {
+      for (i = k; i < k + VEC_BLOCK; i++) {
+        cv[i] = av[i] * bv[i];
+      }
     }
   }
 }
@@ -629,14 +746,16 @@ void OSQPVectorf_ew_prod(OSQPVectorf*       c,
 OSQPInt OSQPVectorf_all_leq(const OSQPVectorf* l,
                             const OSQPVectorf* u) {
 
-  OSQPInt i;
+  OSQPInt i, k;
   OSQPInt length = l->length;
 
   OSQPFloat* lv = l->values;
   OSQPFloat* uv = u->values;
 
-  for (i = 0; i < length; i++) {
-    if (lv[i] > uv[i]) return 0;
+  for (k = 0; k < length; k += VEC_BLOCK) {
+    for (i = k; i < k + VEC_BLOCK; i++) {
+      if (lv[i] > uv[i]) return 0;
+    }
   }
   return 1;
 }
@@ -646,7 +765,7 @@ void OSQPVectorf_ew_bound_vec(OSQPVectorf*       x,
                               const OSQPVectorf* l,
                               const OSQPVectorf* u) {
 
-  OSQPInt i;
+  OSQPInt i, k;
   OSQPInt length = x->length;
 
   OSQPFloat* xv = x->values;
@@ -654,8 +773,10 @@ void OSQPVectorf_ew_bound_vec(OSQPVectorf*       x,
   OSQPFloat* lv = l->values;
   OSQPFloat* uv = u->values;
 
-  for (i = 0; i < length; i++) {
-    xv[i] = c_min(c_max(zv[i], lv[i]), uv[i]);
+  for (k = 0; k < length; k += VEC_BLOCK) {
+    for (i = k; i < k + VEC_BLOCK; i++) {
+      xv[i] = c_min(c_max(zv[i], lv[i]), uv[i]);
+    }
   }
 }
 
@@ -664,25 +785,27 @@ void OSQPVectorf_project_polar_reccone(OSQPVectorf*       y,
                                        const OSQPVectorf* u,
                                        OSQPFloat          infval) {
 
-  OSQPInt i; // Index for loops
+  OSQPInt i, k; // Index for loops
   OSQPInt length = y->length;
 
   OSQPFloat* yv = y->values;
   OSQPFloat* lv = l->values;
   OSQPFloat* uv = u->values;
 
-  for (i = 0; i < length; i++) {
-    if (uv[i]   > +infval) {       // Infinite upper bound
-      if (lv[i] < -infval) {       // Infinite lower bound
-        // Both bounds infinite
-        yv[i] = 0.0;
-      } else {
-        // Only upper bound infinite
-        yv[i] = c_min(yv[i], 0.0);
+  for (k = 0; k < length; k += VEC_BLOCK) {
+    for (i = k; i < k + VEC_BLOCK; i++) {
+      if (uv[i]   > +infval) {       // Infinite upper bound
+        if (lv[i] < -infval) {       // Infinite lower bound
+          // Both bounds infinite
+          yv[i] = 0.0;
+        } else {
+          // Only upper bound infinite
+          yv[i] = c_min(yv[i], 0.0);
+        }
+      } else if (lv[i] < -infval) {  // Infinite lower bound
+        // Only lower bound infinite
+        yv[i] = c_max(yv[i], 0.0);
       }
-    } else if (lv[i] < -infval) {  // Infinite lower bound
-      // Only lower bound infinite
-      yv[i] = c_max(yv[i], 0.0);
     }
   }
 }
@@ -693,20 +816,22 @@ OSQPInt OSQPVectorf_in_reccone(const OSQPVectorf* y,
                                      OSQPFloat    infval,
                                      OSQPFloat    tol){
 
-  OSQPInt i; // Index for loops
+  OSQPInt i, k; // Index for loops
   OSQPInt length = y->length;
 
   OSQPFloat* yv = y->values;
   OSQPFloat* lv = l->values;
   OSQPFloat* uv = u->values;
 
-  for (i = 0; i < length; i++) {
-    if (((uv[i] < +infval) &&
-         (yv[i] > +tol)) ||
-        ((lv[i] > -infval) &&
-         (yv[i] < -tol))) {
-      // At least one condition not satisfied -> not dual infeasible
-      return 0;
+  for (k = 0; k < length; k += VEC_BLOCK) {
+    for (i = k; i < k + VEC_BLOCK; i++) {
+      if (((uv[i] < +infval) &&
+           (yv[i] > +tol)) ||
+          ((lv[i] > -infval) &&
+           (yv[i] < -tol))) {
+        // At least one condition not satisfied -> not dual infeasible
+        return 0;
+      }
     }
   }
   return 1;
@@ -89,3 +89,9 @@ OSQPInt osqp_algebra_init_linsys_solver(LinSysSolver**      s,
     return init_linsys_solver_cudapcg((cudapcg_solver **)s, P, A, rho_vec, settings, scaled_prim_res, scaled_dual_res, polishing);
   }
 }
+
+OSQPInt osqp_algebra_kkt_fill(const OSQPMatrix* P,
+                              const OSQPMatrix* A) {
+  /* No factorization with the PCG solver */
+  return -1;
+}
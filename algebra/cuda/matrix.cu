@@ -56,6 +56,20 @@ OSQPMatrix* OSQPMatrix_new_from_csc(const OSQPCscMatrix* M,
   return out;
 }
 
+/* Single precision value storage is not implemented on the GPU; the
+   products are always computed in full precision */
+OSQPInt OSQPMatrix_init_single_values(OSQPMatrix* M) {
+  return 0;
+}
+
+void OSQPMatrix_use_single_values(OSQPMatrix* M,
+                                  OSQPInt     use) {}
+
+/* P is always stored with both triangles on the GPU */
+OSQPInt OSQPMatrix_init_symm_full(OSQPMatrix* M) {
+  return 0;
+}
+
 void OSQPMatrix_update_values(OSQPMatrix*      mat,
                               const OSQPFloat* Mx_new,
                               const OSQPInt*   Mx_new_idx,
@@ -94,6 +108,37 @@ void OSQPMatrix_rmult_diag(OSQPMatrix*        mat,
   cuda_mat_rmult_diag(mat->S, mat->At, D->d_val);
 }
 
+void OSQPMatrix_scale_entries(OSQPMatrix*        mat,
+                              const OSQPInt*     idx,
+                              OSQPInt            len,
+                              const OSQPVectorf* L,
+                              const OSQPVectorf* R,
+                              OSQPFloat          sc) {
+
+  /* Scaling a subset of the entries is not implemented on the GPU */
+  if (idx || len != OSQPMatrix_get_nz(mat)) {
+    c_eprint("scaling a subset of the matrix entries is not supported");
+    return;
+  }
+
+  cuda_mat_lmult_diag(mat->S, mat->At, L->d_val);
+  cuda_mat_rmult_diag(mat->S, mat->At, R->d_val);
+  cuda_mat_mult_sc(mat->S, mat->At, sc);
+}
+
+void OSQPMatrix_scale_entries_norm_inf(OSQPMatrix*        mat,
+                                       const OSQPVectorf* L,
+                                       const OSQPVectorf* R,
+                                       OSQPFloat          sc,
+                                       OSQPVectorf*       col_norms,
+                                       OSQPVectorf*       row_norms) {
+
+  /* The GPU kernels take the norms in passes of their own */
+  OSQPMatrix_scale_entries(mat, OSQP_NULL, OSQPMatrix_get_nz(mat), L, R, sc);
+  if (col_norms) OSQPMatrix_col_norm_inf(mat, col_norms);
+  if (row_norms) OSQPMatrix_row_norm_inf(mat, row_norms);
+}
+
 void OSQPMatrix_Axpy(const OSQPMatrix*  mat,
                      const OSQPVectorf* x,
                            OSQPVectorf* y,
@@ -141,6 +186,28 @@ void OSQPMatrix_row_norm_inf(const OSQPMatrix*  mat,
   cuda_mat_row_norm_inf(mat->S, res->d_val);
 }
 
+/* Only the infinity norm scaling is available with CUDA (see validate_settings) */
+
+void OSQPMatrix_col_norm_2(const OSQPMatrix*  mat,
+                                 OSQPVectorf* res) {
+  c_eprint("2-norms of matrix columns are not implemented for CUDA");
+}
+
+void OSQPMatrix_row_norm_2(const OSQPMatrix*  mat,
+                                 OSQPVectorf* res) {
+  c_eprint("2-norms of matrix rows are not implemented for CUDA");
+}
+
+void OSQPMatrix_col_min_abs(const OSQPMatrix*  mat,
+                                  OSQPVectorf* res) {
+  c_eprint("minimum magnitudes of matrix columns are not implemented for CUDA");
+}
+
+void OSQPMatrix_row_min_abs(const OSQPMatrix*  mat,
+                                  OSQPVectorf* res) {
+  c_eprint("minimum magnitudes of matrix rows are not implemented for CUDA");
+}
+
 void OSQPMatrix_free(OSQPMatrix *mat){
   if (mat) {
     cuda_mat_free(mat->S);
@@ -183,6 +183,32 @@ void OSQPVectorf_view_free(OSQPVectorf* a) {
   c_free(a);
 }
 
+OSQPInt OSQPVectorf_align_offset(const OSQPVectorf* a) {
+  size_t rem = (size_t)(a->d_val) % OSQP_VECTOR_ALIGNMENT;
+  return rem ? (OSQPInt)((OSQP_VECTOR_ALIGNMENT - rem) / sizeof(OSQPFloat)) : 0;
+}
+
+/* The GPU projection kernel is already branch free and coalesced; keep
+   every row in a single bounded block and project the whole vector */
+void OSQPVectorf_bounds_partition(OSQPVectori*       idx,
+                                  OSQPInt*           n_fixed,
+                                  OSQPInt*           n_bounded,
+                                  const OSQPVectorf* l,
+                                  const OSQPVectorf* u,
+                                  OSQPFloat          infval) {
+  *n_fixed   = 0;
+  *n_bounded = l->length;
+}
+
+void OSQPVectorf_ew_bound_vec_part(OSQPVectorf*       x,
+                                   const OSQPVectorf* l,
+                                   const OSQPVectorf* u,
+                                   const OSQPVectori* idx,
+                                   OSQPInt            n_fixed,
+                                   OSQPInt            n_bounded) {
+  OSQPVectorf_ew_bound_vec(x, x, l, u);
+}
+
 OSQPInt OSQPVectorf_length(const OSQPVectorf* a) {return a->length;}
 OSQPInt OSQPVectori_length(const OSQPVectori* a) {return a->length;}
 
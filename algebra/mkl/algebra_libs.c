@@ -78,3 +78,9 @@ OSQPInt osqp_algebra_init_linsys_solver(LinSysSolver**      s,
                                  polishing);
     }
 }
+
+OSQPInt osqp_algebra_kkt_fill(const OSQPMatrix* P,
+                              const OSQPMatrix* A) {
+  /* Pardiso does not expose its symbolic analysis before the factorization */
+  return -1;
+}
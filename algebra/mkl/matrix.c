@@ -112,6 +112,20 @@ OSQPMatrix* OSQPMatrix_new_from_csc(const OSQPCscMatrix* A,
   return out;
 }
 
+/* The MKL sparse BLAS handle is bound to the OSQPFloat values, so the
+   products are always computed in full precision */
+OSQPInt OSQPMatrix_init_single_values(OSQPMatrix* M) {
+  return 0;
+}
+
+void OSQPMatrix_use_single_values(OSQPMatrix* M,
+                                  OSQPInt     use) {}
+
+/* The symmetric products are left to the MKL sparse BLAS */
+OSQPInt OSQPMatrix_init_symm_full(OSQPMatrix* M) {
+  return 0;
+}
+
 /*  direct data access functions ---------------------------------------------*/
 
 void OSQPMatrix_update_values(OSQPMatrix*    M,
@@ -193,6 +207,31 @@ void OSQPMatrix_rmult_diag(OSQPMatrix*        A,
   csc_rmult_diag(A->csc, OSQPVectorf_data(R));
 }
 
+void OSQPMatrix_scale_entries(OSQPMatrix*        A,
+                              const OSQPInt*     idx,
+                              OSQPInt            len,
+                              const OSQPVectorf* L,
+                              const OSQPVectorf* R,
+                              OSQPFloat          sc) {
+  /* Same assumption on the shadow csc matrix as in OSQPMatrix_lmult_diag */
+  csc_scale_entries(A->csc, idx, len, OSQPVectorf_data(L), OSQPVectorf_data(R), sc);
+}
+
+void OSQPMatrix_scale_entries_norm_inf(OSQPMatrix*        A,
+                                       const OSQPVectorf* L,
+                                       const OSQPVectorf* R,
+                                       OSQPFloat          sc,
+                                       OSQPVectorf*       col_norms,
+                                       OSQPVectorf*       row_norms) {
+  /* Same assumption on the shadow csc matrix as in OSQPMatrix_lmult_diag */
+  OSQPInt sym = A->symmetry != NONE;
+
+  csc_scale_entries_norm_inf(A->csc, OSQPVectorf_data(L), OSQPVectorf_data(R), sc,
+                             col_norms ? OSQPVectorf_data(col_norms) : OSQP_NULL,
+                             row_norms && !sym ? OSQPVectorf_data(row_norms) : OSQP_NULL);
+  if (sym && row_norms) OSQPMatrix_row_norm_inf(A, row_norms);
+}
+
 void OSQPMatrix_AtDA_extract_diag(const OSQPMatrix*  A,
                                   const OSQPVectorf* D,
                                         OSQPVectorf* d) {
@@ -273,6 +312,32 @@ void OSQPMatrix_row_norm_inf(const OSQPMatrix*  M,
    else                    csc_row_norm_inf_sym_triu(M->csc, OSQPVectorf_data(E));
 }
 
+/* The norms below make the same assumption on the shadow csc matrix as above */
+
+void OSQPMatrix_col_norm_2(const OSQPMatrix*  M,
+                                 OSQPVectorf* E) {
+   if(M->symmetry == NONE) csc_col_norm_2(M->csc, OSQPVectorf_data(E));
+   else                    csc_row_norm_2_sym_triu(M->csc, OSQPVectorf_data(E));
+}
+
+void OSQPMatrix_row_norm_2(const OSQPMatrix*  M,
+                                 OSQPVectorf* E) {
+   if(M->symmetry == NONE) csc_row_norm_2(M->csc, OSQPVectorf_data(E));
+   else                    csc_row_norm_2_sym_triu(M->csc, OSQPVectorf_data(E));
+}
+
+void OSQPMatrix_col_min_abs(const OSQPMatrix*  M,
+                                  OSQPVectorf* E) {
+   if(M->symmetry == NONE) csc_col_min_abs(M->csc, OSQPVectorf_data(E));
+   else                    csc_row_min_abs_sym_triu(M->csc, OSQPVectorf_data(E));
+}
+
+void OSQPMatrix_row_min_abs(const OSQPMatrix*  M,
+                                  OSQPVectorf* E) {
+   if(M->symmetry == NONE) csc_row_min_abs(M->csc, OSQPVectorf_data(E));
+   else                    csc_row_min_abs_sym_triu(M->csc, OSQPVectorf_data(E));
+}
+
 void OSQPMatrix_free(OSQPMatrix* M) {
   if (M) {
     if(M->mkl_mat)
@@ -168,6 +168,65 @@ void OSQPVectorf_view_free(OSQPVectorf* a) {
   c_free(a);
 }
 
+OSQPInt OSQPVectorf_align_offset(const OSQPVectorf* a) {
+  size_t rem = (size_t)(a->values) % OSQP_VECTOR_ALIGNMENT;
+  return rem ? (OSQPInt)((OSQP_VECTOR_ALIGNMENT - rem) / sizeof(OSQPFloat)) : 0;
+}
+
+void OSQPVectorf_bounds_partition(OSQPVectori*       idx,
+                                  OSQPInt*           n_fixed,
+                                  OSQPInt*           n_bounded,
+                                  const OSQPVectorf* l,
+                                  const OSQPVectorf* u,
+                                  OSQPFloat          infval) {
+
+  OSQPInt i;
+  OSQPInt k;
+  OSQPInt length = l->length;
+
+  OSQPInt*   idxv = idx->values;
+  OSQPFloat* lv   = l->values;
+  OSQPFloat* uv   = u->values;
+
+  // Fixed rows first
+  k = 0;
+  for (i = 0; i < length; i++) {
+    if (lv[i] == uv[i]) idxv[k++] = i;
+  }
+  *n_fixed = k;
+
+  // Then every row with a finite bound
+  for (i = 0; i < length; i++) {
+    if (lv[i] != uv[i] && ((lv[i] >= -infval) || (uv[i] <= infval))) idxv[k++] = i;
+  }
+  *n_bounded = k - *n_fixed;
+}
+
+void OSQPVectorf_ew_bound_vec_part(OSQPVectorf*       x,
+                                   const OSQPVectorf* l,
+                                   const OSQPVectorf* u,
+                                   const OSQPVectori* idx,
+                                   OSQPInt            n_fixed,
+                                   OSQPInt            n_bounded) {
+
+  OSQPInt k, i;
+
+  OSQPFloat* xv   = x->values;
+  OSQPFloat* lv   = l->values;
+  OSQPFloat* uv   = u->values;
+  OSQPInt*   idxv = idx->values;
+
+  for (k = 0; k < n_fixed; k++) {
+    i     = idxv[k];
+    xv[i] = lv[i];
+  }
+
+  for (k = n_fixed; k < n_fixed + n_bounded; k++) {
+    i     = idxv[k];
+    xv[i] = c_min(c_max(xv[i], lv[i]), uv[i]);
+  }
+}
+
 
 OSQPInt OSQPVectorf_length(const OSQPVectorf* a) {return a->length;}
 OSQPInt OSQPVectori_length(const OSQPVectori *a) {return a->length;}
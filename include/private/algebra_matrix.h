@@ -46,8 +46,27 @@ OSQPMatrix* OSQPMatrix_triu_to_symm(const OSQPMatrix* A);
 // Vertically stack two matrices
 OSQPMatrix* OSQPMatrix_vstack(const OSQPMatrix* A, const OSQPMatrix* B);
 
+/* Keep a single precision copy of the values of M and use it in Axpy/Atxpy,
+ * with the products still accumulated in OSQPFloat. The copy is refreshed
+ * whenever the values of M change. Algebras that do not support this keep
+ * computing in full precision. Returns 0 on success. */
+OSQPInt OSQPMatrix_init_single_values(OSQPMatrix* M);
+
+/* Keep both triangles of a symmetric matrix stored as triu, so that Axpy and
+ * Atxpy form each output entry as a dot product instead of scattering into
+ * the output. The triu storage is unchanged and the copy is refreshed
+ * whenever the values of M change. No-op for non-symmetric matrices and for
+ * algebras that do not need it. Returns 0 on success. */
+OSQPInt OSQPMatrix_init_symm_full(OSQPMatrix* M);
+
 #endif //OSQP_EMBEDDED_MODE
 
+/* Switch Axpy/Atxpy between the single precision copy of the values
+ * (use = 1) and the full precision ones (use = 0). No-op if
+ * OSQPMatrix_init_single_values has not been called */
+void OSQPMatrix_use_single_values(OSQPMatrix* M,
+                                  OSQPInt     use);
+
 
 /*  direct data access functions ---------------------------------------------*/
 
@@ -94,6 +113,30 @@ void OSQPMatrix_lmult_diag(OSQPMatrix*        A,
 void OSQPMatrix_rmult_diag(OSQPMatrix*        A,
                            const OSQPVectorf* R);
 
+#if OSQP_EMBEDDED_MODE != 1
+
+//A[k] = sc*L[i]*A[k]*R[j] for the entries k = idx[0..len-1] at (i,j), or for
+//the first len entries if idx is OSQP_NULL. Indices refer to the entries
+//given in OSQPMatrix_new_from_csc, as in OSQPMatrix_update_values
+void OSQPMatrix_scale_entries(OSQPMatrix*        A,
+                              const OSQPInt*     idx,
+                              OSQPInt            len,
+                              const OSQPVectorf* L,
+                              const OSQPVectorf* R,
+                              OSQPFloat          sc);
+
+//A = sc*diag(L)*A*diag(R) in the same pass as the infinity norms of the
+//columns and rows of the result, as in OSQPMatrix_col_norm_inf and
+//OSQPMatrix_row_norm_inf. Either norm vector can be OSQP_NULL
+void OSQPMatrix_scale_entries_norm_inf(OSQPMatrix*        A,
+                                       const OSQPVectorf* L,
+                                       const OSQPVectorf* R,
+                                       OSQPFloat          sc,
+                                       OSQPVectorf*       col_norms,
+                                       OSQPVectorf*       row_norms);
+
+#endif /* if OSQP_EMBEDDED_MODE != 1 */
+
 // d = diag(At*diag(D)*A)
 void OSQPMatrix_AtDA_extract_diag(const OSQPMatrix*  A,
                                   const OSQPVectorf* D,
@@ -128,6 +171,19 @@ void OSQPMatrix_col_norm_inf(const OSQPMatrix*  M,
 void OSQPMatrix_row_norm_inf(const OSQPMatrix*  M,
                                    OSQPVectorf* E);
 
+void OSQPMatrix_col_norm_2(const OSQPMatrix*  M,
+                                 OSQPVectorf* E);
+
+void OSQPMatrix_row_norm_2(const OSQPMatrix*  M,
+                                 OSQPVectorf* E);
+
+/* Smallest nonzero magnitude of each column/row, OSQP_INFTY if there is none */
+void OSQPMatrix_col_min_abs(const OSQPMatrix*  M,
+                                  OSQPVectorf* E);
+
+void OSQPMatrix_row_min_abs(const OSQPMatrix*  M,
+                                  OSQPVectorf* E);
+
 #endif /* if OSQP_EMBEDDED_MODE != 1 */
 
 #ifndef OSQP_EMBEDDED_MODE
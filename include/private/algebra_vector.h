@@ -90,6 +90,36 @@ void OSQPVectorf_view_update(OSQPVectorf* a, const OSQPVectorf* b, OSQPInt head,
 /* Free a view of a float vector */
 void OSQPVectorf_view_free(OSQPVectorf* a);
 
+/* Byte alignment of the views carved out of the solver workspace block */
+#  define OSQP_VECTOR_ALIGNMENT (64)
+
+/* Number of entries to skip from the start of a so that the following
+ * entry is aligned to OSQP_VECTOR_ALIGNMENT bytes */
+OSQPInt OSQPVectorf_align_offset(const OSQPVectorf* a);
+
+/* Partition the rows of the box [l,u] for OSQPVectorf_ew_bound_vec_part.
+ * idx is filled with the n_fixed rows where l == u, followed by the
+ * n_bounded remaining rows with at least one bound within +/- infval.
+ * Rows with both bounds beyond +/- infval are left out.
+ */
+void OSQPVectorf_bounds_partition(OSQPVectori*       idx,
+                                  OSQPInt*           n_fixed,
+                                  OSQPInt*           n_bounded,
+                                  const OSQPVectorf* l,
+                                  const OSQPVectorf* u,
+                                  OSQPFloat          infval);
+
+/* In-place projection x = min(max(x,l),u) using the partition computed by
+ * OSQPVectorf_bounds_partition: fixed rows are set to l, bounded rows are
+ * clamped and the rows left out of idx are not touched.
+ */
+void OSQPVectorf_ew_bound_vec_part(OSQPVectorf*       x,
+                                   const OSQPVectorf* l,
+                                   const OSQPVectorf* u,
+                                   const OSQPVectori* idx,
+                                   OSQPInt            n_fixed,
+                                   OSQPInt            n_bounded);
+
 # endif /* ifndef OSQP_EMBEDDED_MODE */
 
 
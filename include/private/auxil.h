@@ -10,21 +10,26 @@ extern "C" {
 /***********************************************************
 * Auxiliary functions needed to evaluate ADMM iterations * *
 ***********************************************************/
-# if OSQP_EMBEDDED_MODE != 1
 
 /**
- * Compute rho estimate from residuals
+ * Adapt rho value based on current unscaled primal/dual residuals
+ *
+ * In embedded mode 1 rho moves to the closest value of the ladder with a
+ * precomputed factorization, and stays put if there is no ladder.
+ *
  * @param solver Solver
- * @return       rho estimate
+ * @return       Exitflag
  */
-OSQPFloat compute_rho_estimate(const OSQPSolver* solver);
+OSQPInt adapt_rho(OSQPSolver* solver);
+
+# if OSQP_EMBEDDED_MODE != 1
 
 /**
- * Adapt rho value based on current unscaled primal/dual residuals
+ * Compute rho estimate from residuals
  * @param solver Solver
- * @return       Exitflag
+ * @return       rho estimate
  */
-OSQPInt adapt_rho(OSQPSolver* solver);
+OSQPFloat compute_rho_estimate(const OSQPSolver* solver);
 
 /**
  * Set values of rho vector based on constraint types.
@@ -71,6 +76,41 @@ void update_xz_tilde(OSQPSolver* solver,
 void update_x(OSQPSolver* solver);
 
 
+# ifndef OSQP_EMBEDDED_MODE
+
+/**
+ * Recompute the partition of the constraints used when projecting z
+ * (call whenever l or u change)
+ * @param solver Solver
+ */
+void set_proj_partition(OSQPSolver* solver);
+
+/* Structure of the cost matrix P */
+#  define OSQP_P_ZERO    (0)
+#  define OSQP_P_DIAG    (1)
+#  define OSQP_P_GENERAL (2)
+
+/**
+ * Detect whether P is zero, diagonal or general from its sparsity pattern
+ * and allocate the diagonal storage used for the products with P if it is
+ * diagonal.
+ * @param solver Solver
+ * @param P      Upper triangular part of the cost matrix in csc format
+ * @return       Exitflag
+ */
+OSQPInt init_P_struct(OSQPSolver*          solver,
+                      const OSQPCscMatrix* P);
+
+/**
+ * Refresh the stored diagonal of a diagonal P
+ * (call whenever the values or the scaling of P change)
+ * @param solver Solver
+ */
+void update_P_diag(OSQPSolver* solver);
+
+# endif /* ifndef OSQP_EMBEDDED_MODE */
+
+
 /**
  * Update z (third ADMM step)
  * @param solver Solver
@@ -121,6 +161,19 @@ void update_info(OSQPSolver* solver,
                  OSQPInt     polishing);
 
 
+# ifndef OSQP_EMBEDDED_MODE
+
+/**
+ * Recompute the residuals with the full precision matrix values and store
+ * their deviation from the single precision ones in info->spmv_res_error
+ * (only meaningful if settings->spmv_single is set)
+ * @param solver             Solver
+ */
+void update_spmv_res_error(OSQPSolver* solver);
+
+# endif /* ifndef OSQP_EMBEDDED_MODE */
+
+
 /**
  * Reset solver information (after problem updates)
  * @param info               Information structure
@@ -0,0 +1,50 @@
+/* Linear system solver keeping constraints on a single variable out of the KKT matrix */
+#ifndef BOUNDS_H
+#define BOUNDS_H
+
+
+#include "osqp.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initialize the linear system solver of the ADMM iterations so that the
+ * rows of A with a single nonzero entry are not part of the KKT matrix.
+ *
+ * A singleton row a_i x_j with penalty rho_i is eliminated from the KKT
+ * system by adding rho_i a_i^2 to the diagonal entry j of P and
+ * rho_i a_i rhs_i to the right-hand side of x_j. The remaining system is
+ * solved by the linear system solver chosen in the settings and the
+ * z_tilde entries of the singleton rows are recovered as a_i x_tilde_j.
+ *
+ * The inner solver keeps the rho of the setup. A rho update scales the
+ * inner rows of A instead, so that it refactors the inner solver once.
+ *
+ * If A has no singleton rows, the linear system solver from the settings
+ * is returned directly.
+ *
+ * @param  sp              Pointer to the linear system solver to allocate
+ * @param  P               Upper triangular part of the cost matrix
+ * @param  A               Constraint matrix
+ * @param  rho_vec         Vector of the rho parameters (OSQP_NULL for scalar rho)
+ * @param  settings        Solver settings
+ * @param  scaled_prim_res Pointer to the scaled primal residual
+ * @param  scaled_dual_res Pointer to the scaled dual residual
+ * @return                 Exitflag of the linear system solver initialization
+ */
+OSQPInt init_linsys_solver_bounds(LinSysSolver**      sp,
+                                  const OSQPMatrix*   P,
+                                  const OSQPMatrix*   A,
+                                  const OSQPVectorf*  rho_vec,
+                                  const OSQPSettings* settings,
+                                  OSQPFloat*          scaled_prim_res,
+                                  OSQPFloat*          scaled_dual_res);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ifndef BOUNDS_H */
@@ -7,16 +7,18 @@
 extern "C" {
 #endif
 
-OSQPInt codegen_inc(OSQPSolver* solver,
-                    const char* output_dir,
-                    const char* file_prefix);
-
-OSQPInt codegen_src(OSQPSolver* solver,
-                    const char* output_dir,
-                    const char* file_prefix,
-                    OSQPInt     embedded);
-
-OSQPInt codegen_defines(const char*         output_dir,
+OSQPInt codegen_inc(OSQPSolver*               solver,
+                    const char*               output_dir,
+                    const char*               file_prefix,
+                    const OSQPCodegenDefines* defines);
+
+OSQPInt codegen_src(OSQPSolver*               solver,
+                    const char*               output_dir,
+                    const char*               file_prefix,
+                    const OSQPCodegenDefines* defines);
+
+OSQPInt codegen_defines(OSQPSolver*         solver,
+                        const char*         output_dir,
                         OSQPCodegenDefines* defines);
 
 OSQPInt codegen_example(const char* output_dir,
@@ -0,0 +1,151 @@
+/* Independent blocks of a QP solved as separate problems */
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+
+#include "osqp.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Find the independent blocks of a QP.
+ *
+ * Two variables belong to the same block if an entry of P or a row of A
+ * couples them, so the blocks are the connected components of the graph of
+ * the KKT matrix. Every row of A goes with the block of its variables and
+ * the empty rows with the first block. Consecutive blocks are packed into
+ * subproblems of similar size so that small blocks do not each pay for the
+ * setup of a solver.
+ *
+ * If comp->n_comp is 1 on return the problem does not split and the
+ * structure can be released.
+ *
+ * @param  compp Pointer to the components structure to allocate
+ * @param  P     Upper triangular part of the cost matrix
+ * @param  A     Constraint matrix
+ * @param  m     Number of constraints
+ * @param  n     Number of variables
+ * @return       Exitflag: 0 on success, 1 if out of memory
+ */
+OSQPInt components_setup(OSQPComponents**     compp,
+                         const OSQPCscMatrix* P,
+                         const OSQPCscMatrix* A,
+                         OSQPInt              m,
+                         OSQPInt              n);
+
+/**
+ * Set up a solver for every subproblem.
+ *
+ * The subproblems use the given settings without split_components and
+ * without printing.
+ *
+ * @param  comp     Components structure
+ * @param  P        Upper triangular part of the cost matrix
+ * @param  q        Linear cost vector
+ * @param  A        Constraint matrix
+ * @param  l        Lower bound vector
+ * @param  u        Upper bound vector
+ * @param  settings Solver settings
+ * @return          Exitflag of the first setup that failed, 0 on success
+ */
+OSQPInt components_setup_solvers(OSQPComponents*      comp,
+                                 const OSQPCscMatrix* P,
+                                 const OSQPFloat*     q,
+                                 const OSQPCscMatrix* A,
+                                 const OSQPFloat*     l,
+                                 const OSQPFloat*     u,
+                                 const OSQPSettings*  settings);
+
+/**
+ * Free the components structure and the solvers of the subproblems.
+ * @param comp Components structure
+ */
+void components_free(OSQPComponents* comp);
+
+/**
+ * Solve all subproblems and combine their results.
+ *
+ * The subproblems are solved in parallel when the library is built with
+ * OpenMP. Each of them terminates on its own, and the status of the problem
+ * is the worst status of the subproblems. The solution is stitched back
+ * together, and so are the infeasibility certificates, which are zero on the
+ * subproblems that do not have one. The solve time is the time taken to
+ * solve all subproblems, polishing included.
+ *
+ * @param  solver Solver holding the components structure
+ * @return        Exitflag of the first solve that failed, 0 on success
+ */
+OSQPInt components_solve(OSQPSolver* solver);
+
+/**
+ * Warm start the subproblems.
+ * @param  comp Components structure
+ * @param  x    Primal point (size n) or OSQP_NULL
+ * @param  y    Dual point (size m) or OSQP_NULL
+ * @return      Exitflag
+ */
+OSQPInt components_warm_start(OSQPComponents*  comp,
+                              const OSQPFloat* x,
+                              const OSQPFloat* y);
+
+/**
+ * Cold start the subproblems.
+ * @param comp Components structure
+ */
+void components_cold_start(OSQPComponents* comp);
+
+/**
+ * Update the vectors of the subproblems.
+ * @param  comp  Components structure
+ * @param  q_new New linear cost (size n) or OSQP_NULL
+ * @param  l_new New lower bound (size m) or OSQP_NULL
+ * @param  u_new New upper bound (size m) or OSQP_NULL
+ * @return       Exitflag of the first update that failed, 0 on success
+ */
+OSQPInt components_update_data_vec(OSQPComponents*  comp,
+                                   const OSQPFloat* q_new,
+                                   const OSQPFloat* l_new,
+                                   const OSQPFloat* u_new);
+
+/**
+ * Update the matrix values of the subproblems.
+ *
+ * The arguments are the ones of osqp_update_data_mat for the full problem.
+ * Every subproblem is updated with its own new entries only.
+ *
+ * @return Exitflag of osqp_update_data_mat
+ */
+OSQPInt components_update_data_mat(OSQPComponents*  comp,
+                                   const OSQPFloat* Px_new,
+                                   const OSQPInt*   Px_new_idx,
+                                   OSQPInt          P_new_n,
+                                   const OSQPFloat* Ax_new,
+                                   const OSQPInt*   Ax_new_idx,
+                                   OSQPInt          A_new_n);
+
+/**
+ * Update the settings of the subproblems.
+ * @param  comp     Components structure
+ * @param  settings Updated settings of the problem
+ * @return          Exitflag of the first update that failed, 0 on success
+ */
+OSQPInt components_update_settings(OSQPComponents*     comp,
+                                   const OSQPSettings* settings);
+
+/**
+ * Update rho in the subproblems.
+ * @param  comp    Components structure
+ * @param  rho_new New rho
+ * @return         Exitflag of the first update that failed, 0 on success
+ */
+OSQPInt components_update_rho(OSQPComponents* comp,
+                              OSQPFloat       rho_new);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ifndef COMPONENTS_H */
@@ -0,0 +1,50 @@
+/* Linear system solver keeping dense rows and columns of A out of the KKT matrix */
+#ifndef DENSE_H
+#define DENSE_H
+
+
+#include "osqp.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initialize the linear system solver of the ADMM iterations so that the
+ * dense rows and columns of A are not part of the factored KKT matrix.
+ *
+ * The duals of the dense rows and the dense variables are eliminated with
+ * a Schur complement. The KKT system of the remaining rows and variables is
+ * solved by the linear system solver chosen in the settings, once per
+ * dense row and column at every factorization and once per solve, and the
+ * small dense Schur complement is factored with partial pivoting.
+ *
+ * The treatment is only applied with the direct solver and only if it
+ * reduces the nonzeros of the factor (when the backend can tell), otherwise
+ * the linear system solver from the settings is returned directly.
+ *
+ * @param  sp              Pointer to the linear system solver to allocate
+ * @param  P               Upper triangular part of the cost matrix
+ * @param  A               Constraint matrix
+ * @param  rho_vec         Vector of the rho parameters (OSQP_NULL for scalar rho)
+ * @param  settings        Solver settings
+ * @param  scaled_prim_res Pointer to the scaled primal residual
+ * @param  scaled_dual_res Pointer to the scaled dual residual
+ * @param  dense           Dense rows and columns kept out and the factor fill
+ * @return                 Exitflag of the linear system solver initialization
+ */
+OSQPInt init_linsys_solver_dense(LinSysSolver**      sp,
+                                 const OSQPMatrix*   P,
+                                 const OSQPMatrix*   A,
+                                 const OSQPVectorf*  rho_vec,
+                                 const OSQPSettings* settings,
+                                 OSQPFloat*          scaled_prim_res,
+                                 OSQPFloat*          scaled_dual_res,
+                                 OSQPDense*          dense);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ifndef DENSE_H */
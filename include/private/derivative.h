@@ -9,20 +9,50 @@
 extern "C" {
 #endif
 
+/**
+ * Derivatives of P and A for the first n_seeds seeds of the last computation.
+ * dP and dA are arrays of n_seeds matrices.
+ */
 OSQPInt adjoint_derivative_get_mat(OSQPSolver *solver,
+                                   OSQPInt        n_seeds,
                                    OSQPCscMatrix* dP,
                                    OSQPCscMatrix* dA);
 
+/**
+ * Derivatives of q, l and u for the first n_seeds seeds of the last
+ * computation, stored one seed after the other.
+ */
 OSQPInt adjoint_derivative_get_vec(OSQPSolver *solver,
+                                   OSQPInt        n_seeds,
                                    OSQPFloat*     dq,
                                    OSQPFloat*     dl,
                                    OSQPFloat*     du);
 
+/**
+ * Solve the adjoint system for n_seeds seeds with a single factorization.
+ * The seeds are stored one after the other in dx, dy_l and dy_u.
+ */
 OSQPInt adjoint_derivative_compute(OSQPSolver *solver,
+                                   OSQPInt        n_seeds,
                                    OSQPFloat*     dx,
                                    OSQPFloat*     dy_l,
                                    OSQPFloat*     dy_u);
 
+/**
+ * Forward derivatives of the solution along n_dirs perturbations of the data.
+ * The directions are stored one after the other; dP and dA are arrays of
+ * n_dirs matrices. Any of the perturbations may be OSQP_NULL.
+ */
+OSQPInt forward_derivative_compute(OSQPSolver*          solver,
+                                   OSQPInt              n_dirs,
+                                   const OSQPCscMatrix* dP,
+                                   const OSQPFloat*     dq,
+                                   const OSQPCscMatrix* dA,
+                                   const OSQPFloat*     dl,
+                                   const OSQPFloat*     du,
+                                   OSQPFloat*           dx,
+                                   OSQPFloat*           dy);
+
 #ifdef __cplusplus
 }
 #endif
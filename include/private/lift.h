@@ -0,0 +1,111 @@
+/* Lifting of a factor model cost P = F F' + D into a sparse problem */
+#ifndef LIFT_H
+#define LIFT_H
+
+
+#include "osqp.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Build the lifted problem of a QP with the cost matrix P = F F' + D.
+ *
+ * The auxiliary variables t = F' x are appended to x and the constraints
+ * F' x - t = 0 to the constraints, so that the cost becomes
+ * 1/2 x' D x + 1/2 t' t + q' x and P is never formed.
+ *
+ * The lifted matrices are stored in the returned structure and must be
+ * released with lift_free_data once they have been copied.
+ *
+ * @param  liftp Pointer to the lift structure to allocate
+ * @param  F     Factor of the cost matrix (size n x k, csc format)
+ * @param  D     Diagonal of the cost matrix (size n), OSQP_NULL for zero
+ * @param  q     Linear cost vector
+ * @param  A     Constraint matrix
+ * @param  l     Lower bound vector
+ * @param  u     Upper bound vector
+ * @param  m     Number of constraints
+ * @param  n     Number of variables
+ * @return       Exitflag: 0 on success, 1 if out of memory
+ */
+OSQPInt lift_setup(OSQPLift**           liftp,
+                   const OSQPCscMatrix* F,
+                   const OSQPFloat*     D,
+                   const OSQPFloat*     q,
+                   const OSQPCscMatrix* A,
+                   const OSQPFloat*     l,
+                   const OSQPFloat*     u,
+                   OSQPInt              m,
+                   OSQPInt              n);
+
+/**
+ * Free the lifted matrices held by the lift structure.
+ * @param lift Lift structure
+ */
+void lift_free_data(OSQPLift* lift);
+
+/**
+ * Free the lift structure.
+ * @param lift Lift structure
+ */
+void lift_free(OSQPLift* lift);
+
+/**
+ * Copy the solution of the user problem out of the solution of the lifted
+ * problem held in lift->sol.
+ *
+ * The objective of the lifted problem has t' t in place of x' F F' x. If
+ * obj_val is given, it is corrected by the difference, which vanishes
+ * with the residual of t = F' x.
+ *
+ * @param lift     Lift structure
+ * @param solution Solution of the user problem
+ * @param obj_val  Objective value of the lifted problem or OSQP_NULL
+ */
+void lift_solution(const OSQPLift* lift,
+                   OSQPSolution*   solution,
+                   OSQPFloat*      obj_val);
+
+/**
+ * Map a primal and dual point of the user problem to the lifted problem.
+ *
+ * The auxiliary variables are set to F' x and so are the duals of their
+ * constraints, which equal t at the optimum. These duals are written into
+ * y_lift whenever x is given, so y_lift must persist between the calls for
+ * a dual point given on its own to use the last primal point. Either of the
+ * user vectors can be OSQP_NULL, in which case the matching part of the
+ * lifted vectors is not written.
+ *
+ * @param lift    Lift structure
+ * @param x       User primal point (size n) or OSQP_NULL
+ * @param y       User dual point (size m) or OSQP_NULL
+ * @param x_lift  Lifted primal point (size n + k)
+ * @param y_lift  Lifted dual point (size m + k)
+ */
+void lift_point(const OSQPLift*  lift,
+                const OSQPFloat* x,
+                const OSQPFloat* y,
+                OSQPFloat*       x_lift,
+                OSQPFloat*       y_lift);
+
+/**
+ * Copy new user vectors into the lifted vectors and point the arguments to
+ * the lifted ones. Vectors passed as OSQP_NULL are left untouched.
+ * @param lift  Lift structure
+ * @param q_new Pointer to the new linear cost (size n) or OSQP_NULL
+ * @param l_new Pointer to the new lower bound (size m) or OSQP_NULL
+ * @param u_new Pointer to the new upper bound (size m) or OSQP_NULL
+ */
+void lift_vectors(OSQPLift*         lift,
+                  const OSQPFloat** q_new,
+                  const OSQPFloat** l_new,
+                  const OSQPFloat** u_new);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ifndef LIFT_H */
@@ -52,17 +52,56 @@ OSQPInt osqp_algebra_init_linsys_solver(LinSysSolver**      s,
                                         OSQPFloat*          scaled_dual_res,
                                         OSQPInt             polishing);
 
+#ifndef OSQP_EMBEDDED_MODE
+/**
+ * Number of nonzeros in the factor of the KKT matrix of P and A that the
+ * direct solver of the backend would compute, without factoring it
+ * @param   P  Objective function matrix
+ * @param   A  Constraint matrix
+ * @return     Nonzeros of the factor, -1 if the backend cannot tell
+ */
+OSQPInt osqp_algebra_kkt_fill(const OSQPMatrix* P,
+                              const OSQPMatrix* A);
+#endif
+
 
 #ifdef OSQP_ALGEBRA_BUILTIN
 #ifndef OSQP_EMBEDDED_MODE
-OSQPInt adjoint_derivative_linsys_solver(LinSysSolver**      s,
+/**
+ * Solve the linear system of the adjoint derivatives
+ *
+ * The solver is allocated on the first call and kept for the next ones.
+ * Unless new_structure is set, the symbolic analysis of the previous call
+ * is reused and only a numeric factorization is computed. All right-hand
+ * sides are solved with the same factorization.
+ *
+ * @param   s              Pointer to the adjoint linear system solver
+ * @param   settings       Solver settings
+ * @param   P              Full cost matrix
+ * @param   G              Inequality constraint matrix
+ * @param   A_eq           Equality constraint matrix
+ * @param   GDiagLambda    G scaled by the multipliers of the inequalities
+ * @param   slacks         Slacks of the inequalities
+ * @param   rhs            Right-hand sides, overwritten with the solutions
+ * @param   nrhs           Number of right-hand sides
+ * @param   ld             Offset between consecutive right-hand sides in rhs
+ * @param   new_structure  1 if the structure of G or A_eq changed
+ * @return                 Exitflag for error (0 if no errors)
+ */
+OSQPInt adjoint_derivative_linsys_solver(AdjLinSysSolver**   s,
                                          const OSQPSettings* settings,
                                          const OSQPMatrix*   P,
                                          const OSQPMatrix*   G,
                                          const OSQPMatrix*   A_eq,
-                                         OSQPMatrix*         GDiagLambda,
-                                         OSQPVectorf*        slacks,
-                                         OSQPVectorf*        rhs);
+                                         const OSQPMatrix*   GDiagLambda,
+                                         const OSQPVectorf*  slacks,
+                                         OSQPVectorf*        rhs,
+                                         OSQPInt             nrhs,
+                                         OSQPInt             ld,
+                                         OSQPInt             new_structure);
+
+/* Free the adjoint linear system solver */
+void adjoint_derivative_linsys_free(AdjLinSysSolver* s);
 
 #endif
 #endif
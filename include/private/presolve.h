@@ -0,0 +1,96 @@
+/* Problem reductions applied before the setup and their postsolve */
+#ifndef PRESOLVE_H
+#define PRESOLVE_H
+
+
+#include "osqp.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Reduce the problem before the setup.
+ *
+ * Variables fixed by singleton constraints with equal bounds are removed
+ * together with those constraints. Constraints that are empty or free after
+ * that are removed, and constraints that are multiples of another one
+ * (including singleton constraints on the same variable) are merged into it.
+ * The singleton constraints left become bounds on their variable with a
+ * unit coefficient.
+ *
+ * The reduced problem data are stored in the returned structure and must be
+ * released with presolve_free_data once they have been copied.
+ *
+ * @param  presolvep Pointer to the presolve structure to allocate
+ * @param  P         Upper triangular part of the cost matrix
+ * @param  q         Linear cost vector
+ * @param  A         Constraint matrix
+ * @param  l         Lower bound vector
+ * @param  u         Upper bound vector
+ * @return           Exitflag: 0 on success, 1 if out of memory
+ */
+OSQPInt presolve_setup(OSQPPresolve**       presolvep,
+                       const OSQPCscMatrix* P,
+                       const OSQPFloat*     q,
+                       const OSQPCscMatrix* A,
+                       const OSQPFloat*     l,
+                       const OSQPFloat*     u);
+
+/**
+ * Reduce a cost vector of the user problem and update the constant cost of
+ * the fixed variables. The reductions do not depend on the cost vector.
+ * @param presolve Presolve structure
+ * @param q        User cost vector (size n)
+ * @param q_red    Reduced cost vector (size n_red)
+ */
+void presolve_q(OSQPPresolve*    presolve,
+                const OSQPFloat* q,
+                OSQPFloat*       q_red);
+
+/**
+ * Free the reduced problem data held by the presolve structure.
+ * @param presolve Presolve structure
+ */
+void presolve_free_data(OSQPPresolve* presolve);
+
+/**
+ * Free the presolve structure.
+ * @param presolve Presolve structure
+ */
+void presolve_free(OSQPPresolve* presolve);
+
+/**
+ * Map a primal and dual point of the user problem to the reduced problem.
+ *
+ * Either of the user vectors can be OSQP_NULL, in which case the matching
+ * reduced vector is not written.
+ *
+ * @param presolve Presolve structure
+ * @param x        User primal point (size n) or OSQP_NULL
+ * @param y        User dual point (size m) or OSQP_NULL
+ * @param x_red    Reduced primal point (size n_red)
+ * @param y_red    Reduced dual point (size m_red)
+ */
+void presolve_point(const OSQPPresolve* presolve,
+                    const OSQPFloat*    x,
+                    const OSQPFloat*    y,
+                    OSQPFloat*          x_red,
+                    OSQPFloat*          y_red);
+
+/**
+ * Recover the solution and the infeasibility certificates of the user
+ * problem from the ones of the reduced problem, which are stored in the
+ * leading entries of the solution vectors.
+ * @param presolve Presolve structure
+ * @param solution Solution of the reduced problem
+ */
+void presolve_solution(OSQPPresolve* presolve,
+                       OSQPSolution* solution);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ifndef PRESOLVE_H */
@@ -0,0 +1,94 @@
+/* Bandwidth reducing reordering of the variables and constraints */
+#ifndef REORDER_H
+#define REORDER_H
+
+
+#include "osqp.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Compute a reverse Cuthill-McKee ordering of the graph of the KKT matrix
+ * [P A'; A 0] and form the permuted problem matrices.
+ *
+ * The permuted matrices are stored in the returned structure and must be
+ * released with reorder_free_data once they have been copied.
+ *
+ * @param  reorderp Pointer to the reordering structure to allocate
+ * @param  P        Upper triangular part of the cost matrix
+ * @param  A        Constraint matrix
+ * @return          Exitflag: 0 on success, 1 if out of memory
+ */
+OSQPInt reorder_setup(OSQPReorder**        reorderp,
+                      const OSQPCscMatrix* P,
+                      const OSQPCscMatrix* A);
+
+/**
+ * Free the permuted problem matrices held by the reordering structure.
+ * @param reorder Reordering structure
+ */
+void reorder_free_data(OSQPReorder* reorder);
+
+/**
+ * Free the reordering structure.
+ * @param reorder Reordering structure
+ */
+void reorder_free(OSQPReorder* reorder);
+
+/**
+ * Permute a user vector into the internal ordering, i.e. dst[i] = src[perm[i]].
+ * @param dst  Internally ordered vector
+ * @param src  User ordered vector
+ * @param perm Permutation (xperm or cperm)
+ * @param len  Vector length
+ */
+void reorder_gather(OSQPFloat*       dst,
+                    const OSQPFloat* src,
+                    const OSQPInt*   perm,
+                    OSQPInt          len);
+
+/**
+ * Map the new values of a partial or full matrix update to the internal
+ * ordering of the matrix entries.
+ *
+ * With an index vector only the indices are mapped, and the values are used
+ * as they are. Without one the values are permuted into val_work.
+ *
+ * @param  map      Entry map (Pmap or Amap)
+ * @param  Mx_new   New values in the user ordering
+ * @param  Mx_idx   Indices of the new values (user ordering), or OSQP_NULL
+ * @param  M_new_n  Number of new values
+ * @param  idx_work Storage for the mapped indices (at least M_new_n)
+ * @param  val_work Storage for the permuted values (at least M_new_n)
+ * @param  Mx_idx_p Mapped indices, or OSQP_NULL
+ * @return          Values to pass on to the internally ordered matrix
+ */
+const OSQPFloat* reorder_mat_values(const OSQPInt*   map,
+                                    const OSQPFloat* Mx_new,
+                                    const OSQPInt*   Mx_idx,
+                                    OSQPInt          M_new_n,
+                                    OSQPInt*         idx_work,
+                                    OSQPFloat*       val_work,
+                                    const OSQPInt**  Mx_idx_p);
+
+/**
+ * Restore the user ordering of the solution and of the infeasibility
+ * certificates.
+ * @param reorder  Reordering structure
+ * @param solution Solution in the internal ordering
+ * @param n        Number of variables
+ * @param m        Number of constraints
+ */
+void reorder_solution(OSQPReorder*  reorder,
+                      OSQPSolution* solution,
+                      OSQPInt       n,
+                      OSQPInt       m);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ifndef REORDER_H */
@@ -0,0 +1,53 @@
+/* Linear system solver for problems with a stage structure */
+#ifndef RICCATI_H
+#define RICCATI_H
+
+
+#include "osqp.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initialize the Riccati linear system solver of the ADMM iterations.
+ *
+ * The variables are split into consecutive stages. Every entry of P and
+ * every row of A may only couple the variables of one stage or of two
+ * consecutive stages, as the dynamics constraints of an optimal control
+ * problem do. The reduced KKT matrix
+ *
+ *   H = P + sigma I + A' diag(rho) A
+ *
+ * is then block tridiagonal and is factored by the backward recursion
+ *
+ *   S_N = H_NN,  S_k = H_kk - H_k,k+1 S_k+1^-1 H_k+1,k
+ *
+ * with the Cholesky factors of every S_k, which is the Riccati recursion of
+ * the penalized problem. The factorization and the solves take time and
+ * memory linear in the number of stages and touch the blocks of a stage
+ * contiguously.
+ *
+ * @param  sp       Pointer to the linear system solver to allocate
+ * @param  P        Upper triangular part of the cost matrix
+ * @param  A        Constraint matrix
+ * @param  rho_vec  Vector of the rho parameters (OSQP_NULL for scalar rho)
+ * @param  settings Solver settings
+ * @param  n_stages Number of stages
+ * @param  stage_n  Number of variables of every stage
+ * @return          Exitflag of the linear system solver initialization
+ */
+OSQPInt init_linsys_solver_riccati(LinSysSolver**      sp,
+                                   const OSQPMatrix*   P,
+                                   const OSQPMatrix*   A,
+                                   const OSQPVectorf*  rho_vec,
+                                   const OSQPSettings* settings,
+                                   OSQPInt             n_stages,
+                                   const OSQPInt*      stage_n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ifndef RICCATI_H */
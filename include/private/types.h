@@ -21,6 +21,11 @@ extern "C" {
 
 typedef struct linsys_solver LinSysSolver;
 
+/**
+ * Linear system solver of the adjoint derivatives (defined by the algebra)
+ */
+typedef struct adjoint_linsys_solver AdjLinSysSolver;
+
 /**
  * OSQP Timer for statistics
  */
@@ -58,6 +63,132 @@ typedef struct {
   OSQPFloat    prim_res;      ///< primal residual at polished solution
   OSQPFloat    dual_res;      ///< dual residual at polished solution
 } OSQPPolish;
+
+/**
+ * Reordering of the variables and constraints
+ */
+
+typedef struct {
+  OSQPInt*       xperm;    ///< internal variable i is user variable xperm[i]
+  OSQPInt*       cperm;    ///< internal constraint i is user constraint cperm[i]
+  OSQPInt*       Pmap;     ///< user entry k of P is internal entry Pmap[k]
+  OSQPInt*       Amap;     ///< user entry k of A is internal entry Amap[k]
+  OSQPCscMatrix* P;        ///< reordered P, only held during setup
+  OSQPCscMatrix* A;        ///< reordered A, only held during setup
+  OSQPInt*       idx_work; ///< mapped update indices, size nnz(P) + nnz(A)
+  OSQPFloat*     val_work; ///< reordered vectors and values, size max(n, m, nnz(P), nnz(A))
+} OSQPReorder;
+
+/**
+ * Problem reductions made by the presolve
+ */
+
+typedef struct {
+  OSQPInt        n;          ///< number of variables of the user problem
+  OSQPInt        m;          ///< number of constraints of the user problem
+  OSQPInt        n_red;      ///< number of variables of the reduced problem
+  OSQPInt        m_red;      ///< number of constraints of the reduced problem
+
+  OSQPInt        n_fixed;     ///< fixed variables removed
+  OSQPInt        n_singleton; ///< singleton constraints removed with the variables they fix
+  OSQPInt        n_empty;     ///< empty constraints removed
+  OSQPInt        n_free;      ///< constraints with infinite bounds removed
+  OSQPInt        n_dup;       ///< constraints merged into a multiple of them
+  OSQPInt        n_bound;     ///< singleton constraints kept as bounds with unit coefficient
+
+  OSQPInt*       col_map;    ///< reduced index of every user variable, -1 if fixed
+  OSQPInt*       row_map;    ///< reduced index of every user constraint, -1 if removed
+  OSQPInt*       row_rep;    ///< user constraint a merged constraint is a multiple of, -1 otherwise
+  OSQPFloat*     row_ratio;  ///< a_i = row_ratio[i] * (reduced constraint) for kept and merged constraints, the coefficient for removed singletons
+  OSQPInt*       lo_src;     ///< user constraint giving the lower bound of every reduced constraint
+  OSQPInt*       up_src;     ///< user constraint giving the upper bound of every reduced constraint
+  OSQPInt*       fix_lo_src; ///< singleton constraint giving the lower bound of every fixed variable
+  OSQPInt*       fix_up_src; ///< singleton constraint giving the upper bound of every fixed variable
+  OSQPFloat*     x_fix;      ///< values of the fixed variables
+  OSQPFloat      obj_const;  ///< objective contribution of the fixed variables
+
+  OSQPCscMatrix* P_user;     ///< user P, kept to recover the duals of the singletons of fixed variables
+  OSQPCscMatrix* A_user;     ///< user A, kept to recover the duals of the singletons of fixed variables
+  OSQPFloat*     q_user;     ///< user q, kept to recover the duals of the singletons of fixed variables
+  OSQPFloat*     Px_fix;     ///< P times the fixed variables, to reduce the cost vector
+
+  OSQPCscMatrix* P;          ///< reduced P, only held during setup
+  OSQPCscMatrix* A;          ///< reduced A, only held during setup
+  OSQPFloat*     q;          ///< reduced q, only held during setup
+  OSQPFloat*     l;          ///< reduced l, only held during setup
+  OSQPFloat*     u;          ///< reduced u, only held during setup
+
+  OSQPFloat*     x_work;     ///< working vector, size n
+  OSQPFloat*     y_work;     ///< working vector, size m
+} OSQPPresolve;
+
+/**
+ * Lifting of a factor model cost P = F F' + D
+ *
+ * The lifted problem has the variables (x, t) with t = F' x, which is added
+ * as the last k constraints, and the diagonal cost matrix diag(D, I).
+ */
+
+typedef struct {
+  OSQPInt        n;      ///< number of variables of the user problem
+  OSQPInt        m;      ///< number of constraints of the user problem
+  OSQPInt        k;      ///< number of columns of F
+  OSQPCscMatrix* F;      ///< copy of F, used to map points to the lifted problem
+  OSQPCscMatrix* P;      ///< lifted P, only held during setup
+  OSQPCscMatrix* A;      ///< lifted A, only held during setup
+  OSQPFloat*     q;      ///< lifted q, size n + k
+  OSQPFloat*     l;      ///< lifted l, size m + k
+  OSQPFloat*     u;      ///< lifted u, size m + k
+  OSQPFloat*     x_work; ///< lifted primal point of the warm start, size n + k
+  OSQPFloat*     y_work; ///< lifted dual point of the warm start, size m + k
+  OSQPSolution   sol;    ///< solution of the lifted problem, before it is cut to the user dimensions
+} OSQPLift;
+
+/**
+ * Dense rows and columns of A kept out of the KKT matrix
+ */
+
+typedef struct {
+  OSQPInt n_rows;    ///< number of dense rows of A
+  OSQPInt n_cols;    ///< number of dense columns of A
+  OSQPInt fill;      ///< nonzeros of the factor of the KKT matrix without them and of their coupling, -1 if unknown
+  OSQPInt fill_full; ///< nonzeros of the factor of the full KKT matrix, -1 if unknown
+  OSQPInt declined;  ///< number of dense rows and columns left in the KKT matrix since keeping them out does not pay
+} OSQPDense;
+
+/**
+ * Independent blocks of the problem solved as separate QPs
+ *
+ * The variables and constraints of every subproblem keep their relative
+ * order, so the vectors of all subproblems are stored one after the other
+ * and the position of a variable is var_start[var_comp[j]] + var_idx[j].
+ */
+
+typedef struct {
+  OSQPInt      n;         ///< number of variables of the user problem
+  OSQPInt      m;         ///< number of constraints of the user problem
+  OSQPInt      n_comp;    ///< number of subproblems
+  OSQPInt*     var_comp;  ///< subproblem of every variable, size n
+  OSQPInt*     var_idx;   ///< index of every variable in its subproblem, size n
+  OSQPInt*     var_start; ///< first position of the variables of every subproblem, size n_comp + 1
+  OSQPInt*     con_comp;  ///< subproblem of every constraint, size m
+  OSQPInt*     con_idx;   ///< index of every constraint in its subproblem, size m
+  OSQPInt*     con_start; ///< first position of the constraints of every subproblem, size n_comp + 1
+  OSQPInt*     P_comp;    ///< subproblem of every entry of P, size nnz(P)
+  OSQPInt*     P_idx;     ///< index of every entry of P in its subproblem, size nnz(P)
+  OSQPInt*     P_start;   ///< first position of the entries of P of every subproblem, size n_comp + 1
+  OSQPInt*     A_comp;    ///< subproblem of every entry of A, size nnz(A)
+  OSQPInt*     A_idx;     ///< index of every entry of A in its subproblem, size nnz(A)
+  OSQPInt*     A_start;   ///< first position of the entries of A of every subproblem, size n_comp + 1
+  OSQPSolver** solvers;   ///< solvers of the subproblems, size n_comp
+  OSQPInt*     flags;     ///< exitflags of the last solve of every subproblem, size n_comp
+  OSQPFloat*   x_work;    ///< variable vector split by subproblem, size n
+  OSQPFloat*   y_work;    ///< constraint vector split by subproblem, size m
+  OSQPFloat*   z_work;    ///< constraint vector split by subproblem, size m
+  OSQPFloat*   val_work;  ///< new matrix values split by subproblem, size nnz(P) + nnz(A)
+  OSQPInt*     idx_work;  ///< indices of the new matrix values, size nnz(P) + nnz(A)
+  OSQPInt*     cnt_work;  ///< counts of the new matrix values, size 2 * (n_comp + 1)
+} OSQPComponents;
 # endif // ifndef OSQP_EMBEDDED_MODE
 
 
@@ -84,10 +215,31 @@ typedef struct {
     OSQPInt n_eq;      ///< number of equalities where l == u
     OSQPVectorf *y_l;  ///< for internal use, size m
     OSQPVectorf *y_u;  ///< for internal use, size m
-    OSQPVectorf *ryl;  ///< for internal use, size m
-    OSQPVectorf *ryu;  ///< for internal use, size m
+    OSQPVectorf *ryl;  ///< for internal use, size m per seed
+    OSQPVectorf *ryu;  ///< for internal use, size m per seed
     OSQPVectorf *rhs;  ///< rhs of linear system to solve for derivatives; length 2*(n + n_ineq_l + n_ineq_u + n_eq)
-                       ///< conservatively allocated with length 2(n + 2m) in `osqp_setup`
+                       ///< conservatively allocated with length 2(n + 2m) per seed
+    OSQPInt n_seeds;   ///< number of seeds of the last computation
+    OSQPInt max_seeds; ///< number of seeds rhs, ryl and ryu have room for
+
+    // Workspace kept between calls
+    OSQPInt      mat_valid;   ///< 1 if P_full and the partition matrices hold the current problem matrices
+    OSQPMatrix  *P_full;      ///< scaled cost matrix with both triangles
+    OSQPVectorf *x;           ///< primal solution, size n
+    OSQPVectorf *x_scaled;    ///< scaled primal solution, size n
+    OSQPVectorf *y;           ///< dual solution, size m
+    OSQPInt     *row_type;    ///< kind of every constraint in the partition, size m
+    OSQPInt     *ineq_l_idx;  ///< rows of the inequalities with a finite lower bound, size m
+    OSQPInt     *ineq_u_idx;  ///< rows of the inequalities with a finite upper bound, size m
+    OSQPInt     *eq_idx;      ///< rows of the equalities, size m
+    OSQPInt     *nu_sign;     ///< sign of the multiplier of every equality, size m
+    OSQPMatrix  *G;           ///< stacked rows -A_ineq_l and A_ineq_u of the scaled A
+    OSQPMatrix  *A_eq;        ///< rows of the equalities of the scaled A
+    OSQPMatrix  *GDiagLambda; ///< G scaled by the multipliers of the inequalities
+    OSQPVectorf *lambda;      ///< scaled multipliers of the inequalities, size n_ineq_l + n_ineq_u
+    OSQPVectorf *slacks;      ///< scaled slacks of the inequalities, size n_ineq_l + n_ineq_u
+    OSQPVectorf *Adx;         ///< product dA x of the forward derivatives, size m
+    AdjLinSysSolver *adj_solver; ///< factorization of the derivative system
 } OSQPDerivativeData;
 
 /**
@@ -104,6 +256,34 @@ struct OSQPWorkspace_ {
 # ifndef OSQP_EMBEDDED_MODE
   /// Polish structure
   OSQPPolish* pol;
+
+  /// Single aligned block holding rho_vec, rho_inv_vec and the iterate and
+  /// residual vectors below, which are views into it
+  OSQPVectorf* slab;
+
+  /// Reordering of the variables and constraints (OSQP_NULL if disabled)
+  OSQPReorder* reorder;
+
+  /// Reductions of the user problem (OSQP_NULL if presolve is disabled)
+  OSQPPresolve* presolve;
+
+  /// Lifting of a factor model cost (OSQP_NULL unless set up by osqp_setup_factor)
+  OSQPLift* lift;
+
+  /// Structure of P: zero (0), diagonal (1) or general (2), see auxil.h
+  OSQPInt P_struct;
+
+  /// Diagonal of the scaled P, OSQP_NULL unless P is diagonal
+  OSQPVectorf* P_diag;
+
+  /// Dense rows and columns of A kept out of the KKT matrix (split_dense only)
+  OSQPDense dense;
+
+  /// Independent subproblems (OSQP_NULL unless split_components found several)
+  OSQPComponents* comp;
+
+  /// Solver of one of these subproblems, which leaves the interrupt listener to its parent
+  OSQPInt is_component;
 # endif // ifndef OSQP_EMBEDDED_MODE
 
   /**
@@ -119,6 +299,18 @@ struct OSQPWorkspace_ {
   OSQPVectori* constr_type; ///< Type of constraints: loose (-1), equality (1), inequality (0)
 # endif // if OSQP_EMBEDDED_MODE != 1
 
+# ifndef OSQP_EMBEDDED_MODE
+  /**
+   * @name Constraint partition used when projecting z onto [l,u]
+   * @{
+   */
+  OSQPVectori* proj_idx;       ///< rows with l == u, followed by rows with a finite bound
+  OSQPInt      proj_n_fixed;   ///< number of rows with l == u
+  OSQPInt      proj_n_bounded; ///< number of remaining rows with a finite bound
+
+  /** @} */
+# endif // ifndef OSQP_EMBEDDED_MODE
+
   /**
    * @name Iterates
    * @{
@@ -190,6 +382,23 @@ struct OSQPWorkspace_ {
   /// Reciprocal of rho
   OSQPFloat rho_inv;
 
+# if OSQP_EMBEDDED_MODE == 1
+  /// @name Ladder of rho values with a precomputed factorization
+  /// Adaptive rho moves along the ladder since there is no refactorization
+  /// in embedded mode 1.
+  /// @{
+  OSQPInt     rho_ladder_n;        ///< number of rho values (0 without a ladder)
+  OSQPInt     rho_ladder_k;        ///< index of the rho value in use
+  OSQPFloat*  rho_ladder;          ///< increasing rho values
+  OSQPFloat** rho_vec_ladder;      ///< rho_vec for every rho value (OSQP_NULL for scalar rho)
+  OSQPFloat** rho_inv_vec_ladder;  ///< rho_inv_vec for every rho value (OSQP_NULL for scalar rho)
+  /// @}
+
+  /// ADMM step of a generated solver in fixed point, which replaces the
+  /// updates of xz_tilde, x, z and y (OSQP_NULL to run them in floating point)
+  void (*admm_step)(OSQPWorkspace* work, const OSQPSettings* settings);
+# endif // if OSQP_EMBEDDED_MODE == 1
+
 # ifdef OSQP_ENABLE_PROFILING
   OSQPTimer* timer;       ///< timer object
 
@@ -251,11 +460,12 @@ struct linsys_solver {
                              const OSQPMatrix* A,            //   and A in the solver
                              const OSQPInt*    Ax_new_idx,
                              OSQPInt           A_new_n);
+# endif // if OSQP_EMBEDDED_MODE != 1
 
+  /// Update rho_vec (in embedded mode 1 only to a rho of the precomputed ladder)
   OSQPInt (*update_rho_vec)(LinSysSolver*      self,
                             const OSQPVectorf* rho_vec,
-                            OSQPFloat          rho_sc);  ///< Update rho_vec
-# endif // if OSQP_EMBEDDED_MODE != 1
+                            OSQPFloat          rho_sc);
 
   OSQPInt nthreads; ///< number of threads active
 };
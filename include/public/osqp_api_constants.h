@@ -58,6 +58,7 @@ enum osqp_linsys_solver_type {
     OSQP_UNKNOWN_SOLVER = 0,    /* Start from 0 for unknown solver because we index an array*/
     OSQP_DIRECT_SOLVER,
     OSQP_INDIRECT_SOLVER,
+    OSQP_RICCATI_SOLVER,        /* Stage-wise solver for optimal control problems, see osqp_setup_stages */
 };
 
 /*********************************
@@ -68,6 +69,16 @@ typedef enum {
     OSQP_DIAGONAL_PRECONDITIONER,    /* Diagonal (Jacobi) preconditioner */
 } osqp_precond_type;
 
+/**********************************
+* Data scaling (equilibration)   *
+**********************************/
+typedef enum {
+    OSQP_SCALING_RUIZ_INF = 0,  /* Modified Ruiz equilibration with infinity norms */
+    OSQP_SCALING_RUIZ_2,        /* Modified Ruiz equilibration with 2-norms */
+    OSQP_SCALING_GEOMETRIC,     /* Geometric mean of the largest and smallest entries */
+    OSQP_SCALING_HYBRID,        /* Geometric mean passes followed by Ruiz infinity norm passes */
+} osqp_scaling_type;
+
 /******************
 * Solver Errors  *
 ******************/
@@ -84,6 +95,7 @@ enum osqp_error_type {
     OSQP_CODEGEN_DEFINES_ERROR,
     OSQP_DATA_NOT_INITIALIZED,
     OSQP_FUNC_NOT_IMPLEMENTED,      /**< Function not implemented in this library */
+    OSQP_ITERATIVE_SOLVE_ERROR,     /**< Iterative solve did not reach its tolerance */
     OSQP_LAST_ERROR_PLACE,          /* This must always be the last item in the enum */
 };
 extern const char * OSQP_ERROR_MESSAGE[];
@@ -152,6 +164,16 @@ extern const char * OSQP_ERROR_MESSAGE[];
 #  define OSQP_DELTA                (1E-6)
 #  define OSQP_POLISH_REFINE_ITER   (3)
 
+# define OSQP_PRESOLVE              (0)
+# define OSQP_SPLIT_BOUNDS          (0)
+# define OSQP_SPLIT_DENSE           (0)
+# define OSQP_SPLIT_COMPONENTS      (0)
+# define OSQP_SPMV_SINGLE           (0)
+# define OSQP_REORDER               (0)
+# define OSQP_SPMV_FULL             (0)
+# define OSQP_FREEZE_SCALING        (0)
+# define OSQP_DERIVATIVE_ITERATIVE  (0)
+
 
 /*********************************
 * Hard-coded values and settings *
@@ -183,6 +205,7 @@ extern const char * OSQP_ERROR_MESSAGE[];
 
 # define OSQP_MIN_SCALING   (1e-04) ///< minimum scaling value
 # define OSQP_MAX_SCALING   (1e+04) ///< maximum scaling value
+# define OSQP_SCALING_TOL   (1e-04) ///< stop scaling when the equilibration changes less than this
 
 # define OSQP_CG_TOL_MIN    (1E-7)
 # define OSQP_CG_POLISH_TOL (1e-5)
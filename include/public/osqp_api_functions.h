@@ -90,6 +90,118 @@ OSQP_API OSQPInt osqp_setup(OSQPSolver**         solverp,
                             OSQPInt              n,
                             const OSQPSettings*  settings);
 
+/**
+ * Initialize OSQP solver for a problem with a stage structure, such as the
+ * QP of a model predictive controller.
+ *
+ * The variables are split into n_stages consecutive stages of stage_n[k]
+ * variables. With the OSQP_RICCATI_SOLVER linear system solver, every
+ * entry of P and every row of A may only couple the variables of one stage
+ * or of two consecutive stages, e.g. x_k+1 = A_k x_k + B_k u_k with the
+ * stages (u_k, x_k+1). The KKT system is then solved stage by stage with a
+ * Riccati recursion in time linear in the number of stages.
+ *
+ * The other linear system solvers ignore the stages.
+ *
+ * @param  solverp   Solver pointer
+ * @param  P         Problem data (upper triangular part of quadratic cost term, csc format)
+ * @param  q         Problem data (linear cost term)
+ * @param  A         Problem data (constraint matrix, csc format)
+ * @param  l         Problem data (constraint lower bound)
+ * @param  u         Problem data (constraint upper bound)
+ * @param  m         Problem data (number of constraints)
+ * @param  n         Problem data (number of variables)
+ * @param  settings  Solver settings
+ * @param  n_stages  Number of stages
+ * @param  stage_n   Number of variables of every stage (size n_stages, summing to n)
+ * @return           Exitflag for errors (0 if no errors)
+ */
+OSQP_API OSQPInt osqp_setup_stages(OSQPSolver**         solverp,
+                                   const OSQPCscMatrix* P,
+                                   const OSQPFloat*     q,
+                                   const OSQPCscMatrix* A,
+                                   const OSQPFloat*     l,
+                                   const OSQPFloat*     u,
+                                   OSQPInt              m,
+                                   OSQPInt              n,
+                                   const OSQPSettings*  settings,
+                                   OSQPInt              n_stages,
+                                   const OSQPInt*       stage_n);
+
+/**
+ * Initialize OSQP solver for a problem with the factor model cost matrix
+ * P = F F' + D, without forming P.
+ *
+ * The problem is lifted with the auxiliary variables t = F' x and the
+ * constraints F' x - t = 0, so that the cost matrix becomes diag(D, I) and
+ * the KKT matrix stays as sparse as F. The products with P in the
+ * residuals, the objective and the polishing are then D x + F (F' x).
+ *
+ * The solution, the objective value and the problem dimensions are those
+ * of the user problem, while the residuals in the info structure are the
+ * ones of the lifted problem that the termination is decided on.
+ * Vector data updates and warm starting take the user dimensions, while
+ * matrix updates are not supported.
+ *
+ * @param  solverp   Solver pointer
+ * @param  F         Problem data (factor of the quadratic cost term, size n x k, csc format)
+ * @param  D         Problem data (diagonal of the quadratic cost term, size n); OSQP_NULL for zero
+ * @param  q         Problem data (linear cost term)
+ * @param  A         Problem data (constraint matrix, csc format)
+ * @param  l         Problem data (constraint lower bound)
+ * @param  u         Problem data (constraint upper bound)
+ * @param  m         Problem data (number of constraints)
+ * @param  n         Problem data (number of variables)
+ * @param  settings  Solver settings
+ * @return           Exitflag for errors (0 if no errors)
+ */
+OSQP_API OSQPInt osqp_setup_factor(OSQPSolver**         solverp,
+                                   const OSQPCscMatrix* F,
+                                   const OSQPFloat*     D,
+                                   const OSQPFloat*     q,
+                                   const OSQPCscMatrix* A,
+                                   const OSQPFloat*     l,
+                                   const OSQPFloat*     u,
+                                   OSQPInt              m,
+                                   OSQPInt              n,
+                                   const OSQPSettings*  settings);
+
+/**
+ * Initialize OSQP solver for a problem with box bounds lx <= x <= ux on the
+ * variables in addition to the constraints l <= A x <= u.
+ *
+ * The bounds are kept out of the KKT matrix with the setting split_bounds,
+ * which is turned on for this solver. They are the last n constraints of
+ * the solver, so y holds the m duals of the constraints followed by the n
+ * duals of the bounds, and the bound vectors of osqp_update_data_vec take
+ * the m + n entries [l; lx] and [u; ux]. Infinite bounds leave a variable
+ * unbounded.
+ *
+ * @param  solverp   Solver pointer
+ * @param  P         Problem data (upper triangular part of quadratic cost term, csc format)
+ * @param  q         Problem data (linear cost term)
+ * @param  A         Problem data (constraint matrix, csc format)
+ * @param  l         Problem data (constraint lower bound)
+ * @param  u         Problem data (constraint upper bound)
+ * @param  lx        Problem data (variable lower bound)
+ * @param  ux        Problem data (variable upper bound)
+ * @param  m         Problem data (number of constraints)
+ * @param  n         Problem data (number of variables)
+ * @param  settings  Solver settings
+ * @return           Exitflag for errors (0 if no errors)
+ */
+OSQP_API OSQPInt osqp_setup_box(OSQPSolver**         solverp,
+                                const OSQPCscMatrix* P,
+                                const OSQPFloat*     q,
+                                const OSQPCscMatrix* A,
+                                const OSQPFloat*     l,
+                                const OSQPFloat*     u,
+                                const OSQPFloat*     lx,
+                                const OSQPFloat*     ux,
+                                OSQPInt              m,
+                                OSQPInt              n,
+                                const OSQPSettings*  settings);
+
 # endif /* ifndef OSQP_EMBEDDED_MODE */
 
 /**
@@ -317,6 +429,129 @@ OSQP_API OSQPInt osqp_adjoint_derivative_get_vec(OSQPSolver*    solver,
                                                  OSQPFloat* dl,
                                                  OSQPFloat* du);
 
+/**
+ * Compute the adjoint derivatives for several seeds at once.
+ *
+ * The derivative system is factored once and solved for every seed, which is
+ * much cheaper than a call to @c osqp_adjoint_derivative_compute per seed.
+ * The seeds are stored one after the other: seed k is dx[k*n ... k*n+n-1],
+ * dy_l[k*m ... k*m+m-1] and dy_u[k*m ... k*m+m-1].
+ *
+ * @note An optimal solution must be obtained before calling this function.
+ *
+ * @param[in] solver  Solver
+ * @param[in] n_seeds Number of seeds K
+ * @param[in] dx      Vector of dx values of length K*n
+ * @param[in] dy_l    Vector of dy_l values of length K*m
+ * @param[in] dy_u    Vector of dy_u values of length K*m
+ * @return            Exitflag for errors (0 if no errors)
+ */
+OSQP_API OSQPInt osqp_adjoint_derivative_compute_batch(OSQPSolver* solver,
+                                                       OSQPInt     n_seeds,
+                                                       OSQPFloat*  dx,
+                                                       OSQPFloat*  dy_l,
+                                                       OSQPFloat*  dy_u);
+
+/**
+ * Calculate adjoint derivatives of P/A for several seeds.
+ *
+ * @note @c osqp_adjoint_derivative_compute_batch must be called first with
+ * at least @p n_seeds seeds.
+ *
+ * @param[in]  solver  Solver
+ * @param[in]  n_seeds Number of seeds K
+ * @param[out] dP      Array of K matrices of dP values (n x n)
+ * @param[out] dA      Array of K matrices of dA values (m x n)
+ * @return             Exitflag for errors (0 if no errors; dP, dA are filled in)
+ */
+OSQP_API OSQPInt osqp_adjoint_derivative_get_mat_batch(OSQPSolver*    solver,
+                                                       OSQPInt        n_seeds,
+                                                       OSQPCscMatrix* dP,
+                                                       OSQPCscMatrix* dA);
+
+/**
+ * Calculate adjoint derivatives of q/l/u for several seeds.
+ *
+ * The derivatives of seed k are dq[k*n ... k*n+n-1], dl[k*m ... k*m+m-1] and
+ * du[k*m ... k*m+m-1].
+ *
+ * @note @c osqp_adjoint_derivative_compute_batch must be called first with
+ * at least @p n_seeds seeds.
+ *
+ * @param[in]  solver  Solver
+ * @param[in]  n_seeds Number of seeds K
+ * @param[out] dq      Vector of dq values of length K*n
+ * @param[out] dl      Vector of dl values of length K*m
+ * @param[out] du      Vector of du values of length K*m
+ * @return             Exitflag for errors (0 if no errors; dq, dl, du are filled in)
+ */
+OSQP_API OSQPInt osqp_adjoint_derivative_get_vec_batch(OSQPSolver* solver,
+                                                       OSQPInt     n_seeds,
+                                                       OSQPFloat*  dq,
+                                                       OSQPFloat*  dl,
+                                                       OSQPFloat*  du);
+
+/**
+ * Compute the forward derivatives of the solution along a perturbation of the data.
+ *
+ * The directional derivatives (dx, dy) of the solution (x, y) are computed for
+ * the perturbation (dP, dq, dA, dl, du) of the problem data. dP is upper
+ * triangular like P. Any of the perturbations may be OSQP_NULL, in which case
+ * that part of the data is not perturbed. The derivative system is the one of
+ * the adjoint derivatives, which are invalidated by this call.
+ *
+ * @note An optimal solution must be obtained before calling this function.
+ *
+ * @param[in]  solver Solver
+ * @param[in]  dP     Perturbation of P (n x n, upper triangular) or OSQP_NULL
+ * @param[in]  dq     Perturbation of q of length n or OSQP_NULL
+ * @param[in]  dA     Perturbation of A (m x n) or OSQP_NULL
+ * @param[in]  dl     Perturbation of l of length m or OSQP_NULL
+ * @param[in]  du     Perturbation of u of length m or OSQP_NULL
+ * @param[out] dx     Derivative of x of length n
+ * @param[out] dy     Derivative of y of length m
+ * @return            Exitflag for errors (0 if no errors)
+ */
+OSQP_API OSQPInt osqp_forward_derivative_compute(OSQPSolver*          solver,
+                                                 const OSQPCscMatrix* dP,
+                                                 const OSQPFloat*     dq,
+                                                 const OSQPCscMatrix* dA,
+                                                 const OSQPFloat*     dl,
+                                                 const OSQPFloat*     du,
+                                                 OSQPFloat*           dx,
+                                                 OSQPFloat*           dy);
+
+/**
+ * Compute the forward derivatives of the solution along several perturbations.
+ *
+ * The derivative system is factored once for all K directions. The
+ * directions are stored one after the other: direction k is dP[k],
+ * dq[k*n ... k*n+n-1], dA[k], dl[k*m ... k*m+m-1] and du[k*m ... k*m+m-1],
+ * and its derivatives are dx[k*n ... k*n+n-1] and dy[k*m ... k*m+m-1].
+ *
+ * @note An optimal solution must be obtained before calling this function.
+ *
+ * @param[in]  solver Solver
+ * @param[in]  n_dirs Number of directions K
+ * @param[in]  dP     Array of K perturbations of P or OSQP_NULL
+ * @param[in]  dq     Perturbations of q of length K*n or OSQP_NULL
+ * @param[in]  dA     Array of K perturbations of A or OSQP_NULL
+ * @param[in]  dl     Perturbations of l of length K*m or OSQP_NULL
+ * @param[in]  du     Perturbations of u of length K*m or OSQP_NULL
+ * @param[out] dx     Derivatives of x of length K*n
+ * @param[out] dy     Derivatives of y of length K*m
+ * @return            Exitflag for errors (0 if no errors)
+ */
+OSQP_API OSQPInt osqp_forward_derivative_compute_batch(OSQPSolver*          solver,
+                                                       OSQPInt              n_dirs,
+                                                       const OSQPCscMatrix* dP,
+                                                       const OSQPFloat*     dq,
+                                                       const OSQPCscMatrix* dA,
+                                                       const OSQPFloat*     dl,
+                                                       const OSQPFloat*     du,
+                                                       OSQPFloat*           dx,
+                                                       OSQPFloat*           dy);
+
 /** @} */
 
 /* ------------------ Code generation functions ----------------- */
@@ -83,6 +83,26 @@ typedef struct {
   // polishing parameters
   OSQPFloat delta;                  ///< regularization parameter for polishing
   OSQPInt   polish_refine_iter;     ///< number of iterative refinement steps in polishing
+
+  // problem reductions
+  OSQPInt   presolve;               ///< boolean; remove fixed variables and redundant constraints before the setup
+  OSQPInt   split_bounds;           ///< boolean; keep constraints on a single variable out of the KKT matrix
+  OSQPInt   split_dense;            ///< boolean; keep dense rows and columns of A out of the KKT matrix
+  OSQPInt   split_components;       ///< boolean; solve independent blocks of the problem as separate QPs
+
+  // matrix storage
+  OSQPInt   spmv_single;            ///< boolean; keep P and A values in single precision for the matrix-vector products
+  OSQPInt   reorder;                ///< boolean; reorder variables and constraints to reduce the bandwidth of the KKT matrix
+  OSQPInt   spmv_full;              ///< boolean; store both triangles of P for the matrix-vector products
+
+  // data updates
+  OSQPInt   freeze_scaling;         ///< boolean; keep the setup scaling when updating the matrices and scale only the new entries
+
+  // derivatives
+  OSQPInt   derivative_iterative;   ///< boolean; solve the derivative system by GMRES preconditioned with the KKT factorization
+
+  // scaling strategy
+  osqp_scaling_type scaling_type;   ///< data scaling strategy
 } OSQPSettings;
 
 
@@ -111,6 +131,12 @@ typedef struct {
   OSQPFloat update_time; ///< Update phase time (seconds)
   OSQPFloat polish_time; ///< Polish phase time (seconds)
   OSQPFloat run_time;    ///< Total solve time (seconds)
+
+  // single precision matrix values
+  OSQPFloat spmv_res_error; ///< Change of the residuals when recomputed with full precision matrix values (spmv_single only)
+
+  // data scaling
+  OSQPInt   scaling_iter;   ///< Number of data scaling iterations run
 } OSQPInfo;
 
 
@@ -147,12 +173,16 @@ typedef struct {
  * Structure to hold the settings for the generated code
  */
 typedef struct {
-  OSQPInt embedded_mode;      ///< Embedded mode (1 = vector update, 2 = vector + matrix update)
-  OSQPInt float_type;         ///< Use floats if 1, doubles if 0
-  OSQPInt printing_enable;    ///< Enable printing if 1
-  OSQPInt profiling_enable;   ///< Enable timing of code sections if 1
-  OSQPInt interrupt_enable;   ///< Enable interrupt checking if 1
-  OSQPInt derivatives_enable; ///< Enable deriatives if 1
+  OSQPInt embedded_mode;       ///< Embedded mode (1 = vector update, 2 = vector + matrix update)
+  OSQPInt float_type;          ///< Use floats if 1, doubles if 0
+  OSQPInt printing_enable;     ///< Enable printing if 1
+  OSQPInt profiling_enable;    ///< Enable timing of code sections if 1
+  OSQPInt interrupt_enable;    ///< Enable interrupt checking if 1
+  OSQPInt derivatives_enable;  ///< Enable deriatives if 1
+  OSQPInt unroll_enable;       ///< Generate straight-line code for the KKT solve and the products with P and A if 1
+  OSQPInt fixed_dims_enable;   ///< Make the problem dimensions compile-time constants of the vector operations if 1
+  OSQPInt rho_ladder_size;     ///< Number of rho values with a precomputed factorization for adaptive rho in embedded mode 1 (0 = no adaptive rho)
+  OSQPInt fixed_point_enable;  ///< Run the ADMM steps and the products with P and A of the straight-line code in fixed-point arithmetic if 1 (embedded mode 1 only)
 } OSQPCodegenDefines;
 
 #endif /* ifndef OSQP_API_TYPES_H */
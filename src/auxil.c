@@ -6,25 +6,24 @@
 #include "printing.h"
 #include "timing.h"
 
+#ifndef OSQP_EMBEDDED_MODE
+# include "lift.h"
+# include "presolve.h"
+# include "reorder.h"
+#endif
+
 /***********************************************************
 * Auxiliary functions needed to compute ADMM iterations * *
 ***********************************************************/
-#if OSQP_EMBEDDED_MODE != 1
 
-OSQPFloat compute_rho_estimate(const OSQPSolver* solver) {
+// Ratio of the normalized primal and dual residuals
+static OSQPFloat compute_res_ratio(const OSQPSolver* solver) {
 
-  OSQPInt   n, m;                         // Dimensions
   OSQPFloat prim_res, dual_res;           // Primal and dual residuals
   OSQPFloat prim_res_norm, dual_res_norm; // Normalization for the residuals
   OSQPFloat temp_res_norm;                // Temporary residual norm
-  OSQPFloat rho_estimate;                 // Rho estimate value
 
-  OSQPSettings*  settings = solver->settings;
-  OSQPWorkspace* work     = solver->work;
-
-  // Get problem dimensions
-  n = work->data->n;
-  m = work->data->m;
+  OSQPWorkspace* work = solver->work;
 
   // Get primal and dual residuals
   prim_res = work->scaled_prim_res;
@@ -44,8 +43,17 @@ OSQPFloat compute_rho_estimate(const OSQPSolver* solver) {
   dual_res_norm = c_max(dual_res_norm, temp_res_norm);  // max(||q||,||A' y||,||P x||)
   dual_res     /= (dual_res_norm + OSQP_DIVISION_TOL);
 
+  return prim_res / dual_res;
+}
+
+#if OSQP_EMBEDDED_MODE != 1
+
+OSQPFloat compute_rho_estimate(const OSQPSolver* solver) {
+
+  OSQPFloat rho_estimate;                 // Rho estimate value
+
   // Return rho estimate
-  rho_estimate = settings->rho * c_sqrt(prim_res / dual_res);
+  rho_estimate = solver->settings->rho * c_sqrt(compute_res_ratio(solver));
   rho_estimate = c_min(c_max(rho_estimate, OSQP_RHO_MIN), OSQP_RHO_MAX);
 
   return rho_estimate;
@@ -77,6 +85,61 @@ OSQPInt adapt_rho(OSQPSolver* solver) {
   return exitflag;
 }
 
+#else /* OSQP_EMBEDDED_MODE == 1 */
+
+OSQPInt adapt_rho(OSQPSolver* solver) {
+
+  OSQPInt   exitflag; // Exitflag
+  OSQPInt   k;        // Index of the new rho value in the ladder
+  OSQPFloat est2;     // Square of the rho estimate
+  OSQPFloat rho2;     // Square of the current rho
+  OSQPFloat tol2;     // Square of the adaptive rho tolerance
+
+  OSQPInfo*      info     = solver->info;
+  OSQPSettings*  settings = solver->settings;
+  OSQPWorkspace* work     = solver->work;
+  OSQPFloat*     ladder   = work->rho_ladder;
+
+  exitflag = 0;     // Initialize exitflag to 0
+
+  // Without a ladder there is no other factorization to switch to
+  if (work->rho_ladder_n == 0) return exitflag;
+
+  // Compare squares to avoid the square root of the estimate
+  rho2 = settings->rho * settings->rho;
+  tol2 = settings->adaptive_rho_tolerance * settings->adaptive_rho_tolerance;
+  est2 = rho2 * compute_res_ratio(solver);
+
+  // Closest rho of the ladder on a logarithmic scale
+  k = 0;
+  while (k < work->rho_ladder_n - 1 && est2 > ladder[k] * ladder[k+1]) k++;
+
+  // Set the rho of the ladder as estimate in info
+  info->rho_estimate = ladder[k];
+
+  // Check if the estimate is large or small enough and switch in case
+  if (k != work->rho_ladder_k &&
+      ((est2 > rho2 * tol2) || (est2 < rho2 / tol2))) {
+    settings->rho = ladder[k];
+    work->rho_inv = 1. / ladder[k];
+    work->rho_ladder_k = k;
+    if (settings->rho_is_vec) {
+      OSQPVectorf_from_raw(work->rho_vec, work->rho_vec_ladder[k]);
+      OSQPVectorf_from_raw(work->rho_inv_vec, work->rho_inv_vec_ladder[k]);
+    }
+    exitflag = work->linsys_solver->update_rho_vec(work->linsys_solver,
+                                                   work->rho_vec,
+                                                   settings->rho);
+    info->rho_updates += 1;
+  }
+
+  return exitflag;
+}
+
+#endif // OSQP_EMBEDDED_MODE == 1
+
+#if OSQP_EMBEDDED_MODE != 1
+
 OSQPInt set_rho_vec(OSQPSolver* solver) {
 
   OSQPInt constr_types_changed = 0;
@@ -187,6 +250,58 @@ void update_x(OSQPSolver* solver) {
   OSQPVectorf_minus(work->delta_x,work->x,work->x_prev);
 }
 
+#ifndef OSQP_EMBEDDED_MODE
+
+void set_proj_partition(OSQPSolver* solver) {
+
+  OSQPWorkspace* work = solver->work;
+
+  OSQPVectorf_bounds_partition(work->proj_idx,
+                               &work->proj_n_fixed,
+                               &work->proj_n_bounded,
+                               work->data->l,
+                               work->data->u,
+                               OSQP_INFTY * OSQP_MIN_SCALING);
+}
+
+OSQPInt init_P_struct(OSQPSolver*          solver,
+                      const OSQPCscMatrix* P) {
+
+  OSQPInt j, k;
+  OSQPWorkspace* work = solver->work;
+
+  work->P_diag = OSQP_NULL;
+
+  if (P->p[P->n] == 0) {
+    work->P_struct = OSQP_P_ZERO;
+    return 0;
+  }
+
+  for (j = 0; j < P->n; j++) {
+    for (k = P->p[j]; k < P->p[j+1]; k++) {
+      if (P->i[k] != j) {
+        work->P_struct = OSQP_P_GENERAL;
+        return 0;
+      }
+    }
+  }
+
+  work->P_struct = OSQP_P_DIAG;
+  work->P_diag   = OSQPVectorf_malloc(P->n);
+  if (!work->P_diag) return 1;
+
+  return 0;
+}
+
+void update_P_diag(OSQPSolver* solver) {
+
+  OSQPWorkspace* work = solver->work;
+
+  if (work->P_diag) OSQPMatrix_extract_diag(work->data->P, work->P_diag);
+}
+
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
 void update_z(OSQPSolver* solver) {
 
   OSQPSettings*  settings = solver->settings;
@@ -208,7 +323,14 @@ void update_z(OSQPSolver* solver) {
   }
 
   // project z onto C = [l,u]
+#ifndef OSQP_EMBEDDED_MODE
+  // equality rows are assigned, loose rows are skipped
+  OSQPVectorf_ew_bound_vec_part(work->z, work->data->l, work->data->u,
+                                work->proj_idx, work->proj_n_fixed,
+                                work->proj_n_bounded);
+#else
   OSQPVectorf_ew_bound_vec(work->z, work->z, work->data->l, work->data->u);
+#endif /* ifndef OSQP_EMBEDDED_MODE */
 }
 
 void update_y(OSQPSolver* solver) {
@@ -239,16 +361,43 @@ OSQPFloat compute_obj_val(const OSQPSolver*  solver,
   OSQPWorkspace* work = solver->work;
 
   /* NB: The function is always called after dual_res is computed */
-  obj_val = 0.5 * OSQPVectorf_dot_prod(work->Px, x) +
-            OSQPVectorf_dot_prod(work->data->q, x);
+  obj_val = OSQPVectorf_dot_prod(work->data->q, x);
+#ifndef OSQP_EMBEDDED_MODE
+  if (work->P_struct != OSQP_P_ZERO)
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+    obj_val += 0.5 * OSQPVectorf_dot_prod(work->Px, x);
 
   if (solver->settings->scaling) {
     obj_val *= work->scaling->cinv;
   }
 
+#ifndef OSQP_EMBEDDED_MODE
+  // Cost of the variables fixed by the presolve
+  if (work->presolve) obj_val += work->presolve->obj_const;
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
   return obj_val;
 }
 
+/* Px = P * x, skipping the sparse product when P is zero or diagonal */
+static void compute_Px(const OSQPWorkspace* work,
+                       const OSQPVectorf*   x,
+                       OSQPVectorf*         Px) {
+
+#ifndef OSQP_EMBEDDED_MODE
+  if (work->P_struct == OSQP_P_ZERO) {
+    OSQPVectorf_set_scalar(Px, 0.0);
+    return;
+  }
+  if (work->P_struct == OSQP_P_DIAG) {
+    OSQPVectorf_ew_prod(Px, work->P_diag, x);
+    return;
+  }
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
+  OSQPMatrix_Axpy(work->data->P, x, Px, 1.0, 0.0);
+}
+
 static OSQPFloat compute_prim_res(OSQPSolver*        solver,
                                   const OSQPVectorf* x,
                                   const OSQPVectorf* z) {
@@ -328,7 +477,7 @@ static OSQPFloat compute_dual_res(OSQPSolver*        solver,
   OSQPVectorf_copy(work->x_prev, work->data->q);
 
   // Px = P * x
-  OSQPMatrix_Axpy(work->data->P, x, work->Px, 1.0, 0.0);
+  compute_Px(work, x, work->Px);
 
   // dr += Px
   OSQPVectorf_plus(work->x_prev, work->x_prev, work->Px);
@@ -492,7 +641,7 @@ OSQPInt is_dual_infeasible(OSQPSolver* solver,
     // Check first if q'*delta_x < 0
     if (OSQPVectorf_dot_prod(work->data->q, work->delta_x) < 0.0) {
       // Compute product P * delta_x
-      OSQPMatrix_Axpy(work->data->P, work->delta_x, work->Pdelta_x, 1.0, 0.0);
+      compute_Px(work, work->delta_x, work->Pdelta_x);
 
       // Scale if necessary
       if (settings->scaling && !settings->scaled_termination) {
@@ -550,6 +699,10 @@ void store_solution(OSQPSolver *solver) {
   OSQPSettings*  settings = solver->settings;
   OSQPWorkspace* work     = solver->work;
 
+#ifndef OSQP_EMBEDDED_MODE
+  // The lifted solution is cut to the user problem at the end
+  if (work->lift) solution = &work->lift->sol;
+#endif /* ifndef OSQP_EMBEDDED_MODE */
 
   if (has_solution(info)) {
     // Unscale solution if scaling has been performed
@@ -612,6 +765,20 @@ void store_solution(OSQPSolver *solver) {
 
 #endif /* ifndef OSQP_EMBEDDED_MODE */
   }
+
+#ifndef OSQP_EMBEDDED_MODE
+  // Return the solution in the user ordering of variables and constraints
+  if (work->reorder) reorder_solution(work->reorder, solution, work->data->n, work->data->m);
+
+  // Recover the solution of the problem before the presolve
+  if (work->presolve) presolve_solution(work->presolve, solution);
+
+  // Solution and objective of the factor model problem
+  if (work->lift) {
+    lift_solution(work->lift, solver->solution,
+                  has_solution(info) ? &info->obj_val : OSQP_NULL);
+  }
+#endif /* ifndef OSQP_EMBEDDED_MODE */
 }
 
 void update_info(OSQPSolver* solver,
@@ -692,6 +859,33 @@ void update_info(OSQPSolver* solver,
 }
 
 
+#ifndef OSQP_EMBEDDED_MODE
+
+void update_spmv_res_error(OSQPSolver* solver) {
+
+  OSQPFloat prim_res, dual_res;
+
+  OSQPInfo*      info = solver->info;
+  OSQPWorkspace* work = solver->work;
+
+  // Recompute the residuals at the current iterate with full precision values
+  OSQPMatrix_use_single_values(work->data->P, 0);
+  OSQPMatrix_use_single_values(work->data->A, 0);
+
+  prim_res = work->data->m ? compute_prim_res(solver, work->x, work->z) : 0.;
+  dual_res = compute_dual_res(solver, work->x, work->y);
+
+  OSQPMatrix_use_single_values(work->data->P, 1);
+  OSQPMatrix_use_single_values(work->data->A, 1);
+
+  // The reported residuals stay the ones the termination was decided on
+  info->spmv_res_error = c_max(c_absval(prim_res - info->prim_res),
+                               c_absval(dual_res - info->dual_res));
+}
+
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
+
 void reset_info(OSQPInfo *info) {
 #ifdef OSQP_ENABLE_PROFILING
 
@@ -940,6 +1134,13 @@ OSQPInt validate_linsys_solver(OSQPInt linsys_solver) {
     return 0;
   }
 
+#if !defined(OSQP_EMBEDDED_MODE) && !defined(OSQP_ALGEBRA_CUDA)
+  /* The Riccati solver works on the CSC matrices of the host algebras */
+  if (linsys_solver == OSQP_RICCATI_SOLVER) {
+    return 0;
+  }
+#endif
+
   // Invalid solver
   return 1;
 }
@@ -976,6 +1177,22 @@ OSQPInt validate_settings(const OSQPSettings* settings,
     return 1;
   }
 
+  if (from_setup &&
+      settings->scaling_type != OSQP_SCALING_RUIZ_INF &&
+      settings->scaling_type != OSQP_SCALING_RUIZ_2 &&
+      settings->scaling_type != OSQP_SCALING_GEOMETRIC &&
+      settings->scaling_type != OSQP_SCALING_HYBRID) {
+    c_eprint("scaling_type not recognized");
+    return 1;
+  }
+
+#ifdef OSQP_ALGEBRA_CUDA
+  if (from_setup && settings->scaling_type != OSQP_SCALING_RUIZ_INF) {
+    c_eprint("scaling_type other than OSQP_SCALING_RUIZ_INF is not supported with the CUDA algebra");
+    return 1;
+  }
+#endif
+
   if (settings->polishing != 0 &&
       settings->polishing != 1) {
     c_eprint("polishing must be either 0 or 1");
@@ -1100,5 +1317,96 @@ OSQPInt validate_settings(const OSQPSettings* settings,
     return 1;
   }
 
+  if (from_setup &&
+      settings->presolve != 0 &&
+      settings->presolve != 1) {
+    c_eprint("presolve must be either 0 or 1");
+    return 1;
+  }
+
+  if (from_setup &&
+      settings->split_bounds != 0 &&
+      settings->split_bounds != 1) {
+    c_eprint("split_bounds must be either 0 or 1");
+    return 1;
+  }
+
+#ifdef OSQP_ALGEBRA_CUDA
+  if (from_setup && settings->split_bounds) {
+    c_eprint("split_bounds is not supported with the CUDA algebra");
+    return 1;
+  }
+#endif
+
+  if (from_setup &&
+      settings->split_dense != 0 &&
+      settings->split_dense != 1) {
+    c_eprint("split_dense must be either 0 or 1");
+    return 1;
+  }
+
+#ifdef OSQP_ALGEBRA_CUDA
+  if (from_setup && settings->split_dense) {
+    c_eprint("split_dense is not supported with the CUDA algebra");
+    return 1;
+  }
+#endif
+
+  if (from_setup &&
+      settings->split_components != 0 &&
+      settings->split_components != 1) {
+    c_eprint("split_components must be either 0 or 1");
+    return 1;
+  }
+
+  /* The stages of the Riccati solver refer to the variables and the full KKT system */
+  if (from_setup &&
+      settings->linsys_solver == OSQP_RICCATI_SOLVER &&
+      (settings->presolve || settings->reorder ||
+       settings->split_bounds || settings->split_dense || settings->split_components)) {
+    c_eprint("the Riccati solver does not support presolve, reorder, split_bounds, split_dense or split_components");
+    return 1;
+  }
+
+  if (from_setup &&
+      settings->spmv_single != 0 &&
+      settings->spmv_single != 1) {
+    c_eprint("spmv_single must be either 0 or 1");
+    return 1;
+  }
+
+  if (from_setup &&
+      settings->reorder != 0 &&
+      settings->reorder != 1) {
+    c_eprint("reorder must be either 0 or 1");
+    return 1;
+  }
+
+  if (from_setup &&
+      settings->spmv_full != 0 &&
+      settings->spmv_full != 1) {
+    c_eprint("spmv_full must be either 0 or 1");
+    return 1;
+  }
+
+  if (settings->freeze_scaling != 0 &&
+      settings->freeze_scaling != 1) {
+    c_eprint("freeze_scaling must be either 0 or 1");
+    return 1;
+  }
+
+#ifdef OSQP_ALGEBRA_CUDA
+  if (settings->freeze_scaling) {
+    c_eprint("freeze_scaling is not supported with the CUDA algebra");
+    return 1;
+  }
+#endif
+
+  if (settings->derivative_iterative != 0 &&
+      settings->derivative_iterative != 1) {
+    c_eprint("derivative_iterative must be either 0 or 1");
+    return 1;
+  }
+
   return 0;
 }
@@ -0,0 +1,467 @@
+#include "bounds.h"
+#include "lin_alg.h"
+#include "csc_utils.h"
+
+/**
+ * Linear system solver wrapping the solver of the KKT system without the
+ * singleton rows of A. The function pointers follow the layout of LinSysSolver.
+ */
+typedef struct bounds bounds_solver;
+
+struct bounds {
+  enum osqp_linsys_solver_type type;
+
+  const char* (*name)(struct bounds* self);
+
+  OSQPInt (*solve)(struct bounds* self,
+                   OSQPVectorf*   b,
+                   OSQPInt        admm_iter);
+
+  void (*update_settings)(struct bounds*      self,
+                          const OSQPSettings* settings);
+
+  void (*warm_start)(struct bounds*     self,
+                     const OSQPVectorf* x);
+
+  OSQPInt (*adjoint_derivative)(struct bounds* self);
+
+  void (*free)(struct bounds* self);
+
+  OSQPInt (*update_matrices)(struct bounds*    self,
+                             const OSQPMatrix* P,
+                             const OSQPInt*    Px_new_idx,
+                             OSQPInt           P_new_n,
+                             const OSQPMatrix* A,
+                             const OSQPInt*    Ax_new_idx,
+                             OSQPInt           A_new_n);
+
+  OSQPInt (*update_rho_vec)(struct bounds*     self,
+                            const OSQPVectorf* rho_vec,
+                            OSQPFloat          rho_sc);
+
+  OSQPInt nthreads;
+
+  LinSysSolver* inner;     ///< solver of the KKT system without the singleton rows
+  OSQPInt       n;         ///< number of variables
+  OSQPInt       m;         ///< number of constraints
+  OSQPInt       n_single;  ///< number of singleton rows
+  OSQPInt*      row_map;   ///< row of the inner A of every row of A, -1 for singleton rows
+  OSQPInt*      s_row;     ///< row of A of every singleton row
+  OSQPInt*      s_col;     ///< variable of every singleton row
+  OSQPInt*      s_ent;     ///< entry of A holding the coefficient of every singleton row
+  OSQPFloat*    s_coef;    ///< coefficient of every singleton row
+  OSQPFloat*    s_rho;     ///< rho of every singleton row
+  OSQPMatrix*   P;         ///< P with the diagonal P_jj + sum rho_i a_i^2 stored last in every column
+  OSQPMatrix*   A;         ///< A without the singleton rows
+  OSQPInt*      Pmap;      ///< entry of the inner P of every entry of P
+  OSQPInt*      Pdiag;     ///< diagonal entry of the inner P of every column
+  OSQPFloat*    Pd;        ///< diagonal of P
+  OSQPInt*      Amap;      ///< entry of the inner A of every entry of A, -1 in singleton rows
+  OSQPVectorf*  rho_vec;   ///< rho of the inner rows at the setup (OSQP_NULL for scalar rho)
+  OSQPFloat     rho_sc;    ///< scalar rho at the setup
+  OSQPFloat*    row_sc;    ///< sqrt(rho / rho at the setup) of every inner row
+  OSQPFloat*    Ax;        ///< values of the inner A before the row scaling
+  OSQPVectorf*  b;         ///< right-hand side of the inner KKT system
+  OSQPInt*      idx_work;  ///< size max(n, nnz(P), nnz(A))
+  OSQPFloat*    val_work;  ///< size max(n, nnz(P), nnz(A))
+};
+
+
+/* Write P_jj + sum rho_i a_i^2 on the diagonal of the inner P */
+static void set_diag(bounds_solver* s) {
+
+  OSQPInt j, k;
+
+  for (j = 0; j < s->n; j++) {
+    s->val_work[j] = s->Pd[j];
+  }
+  for (k = 0; k < s->n_single; k++) {
+    s->val_work[s->s_col[k]] += s->s_rho[k] * s->s_coef[k] * s->s_coef[k];
+  }
+  OSQPMatrix_update_values(s->P, s->val_work, s->Pdiag, s->n);
+}
+
+/* Write the values of the inner A, with every row scaled by row_sc */
+static void set_A_values(bounds_solver* s) {
+
+  OSQPInt k;
+
+  const OSQPInt* Ai   = OSQPMatrix_get_i(s->A);
+  OSQPInt        nnzA = OSQPMatrix_get_nz(s->A);
+
+  for (k = 0; k < nnzA; k++) {
+    s->val_work[k] = s->Ax[k] * s->row_sc[Ai[k]];
+  }
+  OSQPMatrix_update_values(s->A, s->val_work, OSQP_NULL, nnzA);
+}
+
+/* Copy the values of P and A into the inner matrices */
+static void set_values(bounds_solver*    s,
+                       const OSQPMatrix* P,
+                       const OSQPMatrix* A) {
+
+  OSQPInt j, k, cnt;
+
+  const OSQPInt*   Pp = OSQPMatrix_get_p(P);
+  const OSQPInt*   Pi = OSQPMatrix_get_i(P);
+  const OSQPFloat* Px = OSQPMatrix_get_x(P);
+  const OSQPFloat* Ax = OSQPMatrix_get_x(A);
+  OSQPInt          nnzA = OSQPMatrix_get_nz(A);
+
+  // Off-diagonal entries of P, the diagonal is rebuilt by set_diag
+  cnt = 0;
+  for (j = 0; j < s->n; j++) {
+    s->Pd[j] = 0.0;
+    for (k = Pp[j]; k < Pp[j + 1]; k++) {
+      if (Pi[k] == j) {
+        s->Pd[j] += Px[k];
+      }
+      else {
+        s->idx_work[cnt] = s->Pmap[k];
+        s->val_work[cnt] = Px[k];
+        cnt++;
+      }
+    }
+  }
+  OSQPMatrix_update_values(s->P, s->val_work, s->idx_work, cnt);
+
+  // Entries of the inner rows of A
+  for (k = 0; k < nnzA; k++) {
+    if (s->Amap[k] >= 0) s->Ax[s->Amap[k]] = Ax[k];
+  }
+  set_A_values(s);
+
+  // Coefficients of the singleton rows
+  for (k = 0; k < s->n_single; k++) {
+    s->s_coef[k] = Ax[s->s_ent[k]];
+  }
+
+  set_diag(s);
+}
+
+/**
+ * Split the rho parameters between the singleton rows and the inner rows.
+ *
+ * The inner solver keeps the rho of the setup. A new rho of an inner row is
+ * passed as the scaling t = sqrt(rho / rho_setup) of the row of A and of
+ * its right-hand side, since the KKT system with the row t a_i and the
+ * penalty rho_setup has the same solution x and the dual t nu_i.
+ */
+static void set_rho(bounds_solver*     s,
+                    const OSQPVectorf* rho_vec,
+                    OSQPFloat          rho_sc) {
+
+  OSQPInt i, k, r;
+
+  const OSQPFloat* rho = rho_vec ? OSQPVectorf_data(rho_vec) : OSQP_NULL;
+  const OSQPFloat* rho_setup = s->rho_vec ? OSQPVectorf_data(s->rho_vec) : OSQP_NULL;
+
+  for (k = 0; k < s->n_single; k++) {
+    s->s_rho[k] = rho ? rho[s->s_row[k]] : rho_sc;
+  }
+
+  for (i = 0; i < s->m; i++) {
+    r = s->row_map[i];
+    if (r < 0) continue;
+    s->row_sc[r] = rho ? c_sqrt(rho[i] / rho_setup[r]) : c_sqrt(rho_sc / s->rho_sc);
+  }
+}
+
+
+static const char* name_linsys_solver_bounds(bounds_solver* s) {
+  return s->inner->name(s->inner);
+}
+
+static OSQPInt solve_linsys_bounds(bounds_solver* s,
+                                   OSQPVectorf*   b,
+                                   OSQPInt        admm_iter) {
+
+  OSQPInt i, j, k, r;
+  OSQPInt exitflag;
+  OSQPInt n = s->n;
+
+  OSQPFloat* bv = OSQPVectorf_data(b);
+  OSQPFloat* sb = OSQPVectorf_data(s->b);
+
+  // Right-hand side of the inner system, the singleton rows enter the x part
+  for (j = 0; j < n; j++) {
+    sb[j] = bv[j];
+  }
+  for (i = 0; i < s->m; i++) {
+    r = s->row_map[i];
+    if (r >= 0) sb[n + r] = s->row_sc[r] * bv[n + i];
+  }
+  for (k = 0; k < s->n_single; k++) {
+    sb[s->s_col[k]] += s->s_rho[k] * s->s_coef[k] * bv[n + s->s_row[k]];
+  }
+
+  exitflag = s->inner->solve(s->inner, s->b, admm_iter);
+
+  // x_tilde and z_tilde of the inner rows, z_tilde = a_i x_tilde_j for the singleton rows
+  for (j = 0; j < n; j++) {
+    bv[j] = sb[j];
+  }
+  for (i = 0; i < s->m; i++) {
+    r = s->row_map[i];
+    if (r >= 0) bv[n + i] = sb[n + r] / s->row_sc[r];
+  }
+  for (k = 0; k < s->n_single; k++) {
+    bv[n + s->s_row[k]] = s->s_coef[k] * sb[s->s_col[k]];
+  }
+
+  return exitflag;
+}
+
+static void update_settings_linsys_solver_bounds(bounds_solver*      s,
+                                                 const OSQPSettings* settings) {
+  s->inner->update_settings(s->inner, settings);
+}
+
+static void warm_start_linsys_solver_bounds(bounds_solver*     s,
+                                            const OSQPVectorf* x) {
+  s->inner->warm_start(s->inner, x);
+}
+
+static OSQPInt adjoint_derivative_bounds(bounds_solver* s) {
+  return s->inner->adjoint_derivative(s->inner);
+}
+
+static void free_linsys_solver_bounds(bounds_solver* s) {
+
+  if (s) {
+    if (s->inner && s->inner->free) s->inner->free(s->inner);
+    OSQPMatrix_free(s->P);
+    OSQPMatrix_free(s->A);
+    OSQPVectorf_free(s->rho_vec);
+    OSQPVectorf_free(s->b);
+    c_free(s->row_map);
+    c_free(s->s_row);
+    c_free(s->s_col);
+    c_free(s->s_ent);
+    c_free(s->s_coef);
+    c_free(s->s_rho);
+    c_free(s->Pmap);
+    c_free(s->Pdiag);
+    c_free(s->Pd);
+    c_free(s->Amap);
+    c_free(s->row_sc);
+    c_free(s->Ax);
+    c_free(s->idx_work);
+    c_free(s->val_work);
+  }
+  c_free(s);
+}
+
+static OSQPInt update_linsys_solver_matrices_bounds(bounds_solver*    s,
+                                                    const OSQPMatrix* P,
+                                                    const OSQPInt*    Px_new_idx,
+                                                    OSQPInt           P_new_n,
+                                                    const OSQPMatrix* A,
+                                                    const OSQPInt*    Ax_new_idx,
+                                                    OSQPInt           A_new_n) {
+
+  // A new coefficient of a singleton row changes the diagonal of P,
+  // so all values are refreshed
+  set_values(s, P, A);
+
+  return s->inner->update_matrices(s->inner,
+                                   s->P, OSQP_NULL, OSQPMatrix_get_nz(s->P),
+                                   s->A, OSQP_NULL, OSQPMatrix_get_nz(s->A));
+}
+
+static OSQPInt update_linsys_solver_rho_vec_bounds(bounds_solver*     s,
+                                                   const OSQPVectorf* rho_vec,
+                                                   OSQPFloat          rho_sc) {
+
+  // The new rho enters the diagonal of P and the scaling of the inner rows,
+  // so the inner solver is refactored once
+  set_rho(s, rho_vec, rho_sc);
+  set_diag(s);
+  set_A_values(s);
+
+  return s->inner->update_matrices(s->inner,
+                                   s->P, s->Pdiag, s->n,
+                                   s->A, OSQP_NULL, OSQPMatrix_get_nz(s->A));
+}
+
+
+OSQPInt init_linsys_solver_bounds(LinSysSolver**      sp,
+                                  const OSQPMatrix*   P,
+                                  const OSQPMatrix*   A,
+                                  const OSQPVectorf*  rho_vec,
+                                  const OSQPSettings* settings,
+                                  OSQPFloat*          scaled_prim_res,
+                                  OSQPFloat*          scaled_dual_res) {
+
+  OSQPInt i, j, k, ptr, nz, n_work;
+  OSQPInt exitflag;
+
+  OSQPInt n    = OSQPMatrix_get_n(A);
+  OSQPInt m    = OSQPMatrix_get_m(A);
+  OSQPInt nnzP = OSQPMatrix_get_nz(P);
+  OSQPInt nnzA = OSQPMatrix_get_nz(A);
+
+  const OSQPInt* Pp = OSQPMatrix_get_p(P);
+  const OSQPInt* Pi = OSQPMatrix_get_i(P);
+  const OSQPInt* Ap = OSQPMatrix_get_p(A);
+  const OSQPInt* Ai = OSQPMatrix_get_i(A);
+
+  const OSQPFloat* rho;
+  OSQPFloat*       inner_rho;
+  OSQPInt*         rows;
+  OSQPVectori*     keep;
+  OSQPCscMatrix*   Pk;
+  bounds_solver*   s;
+
+  // Count the entries of every row
+  rows = (OSQPInt*) c_calloc(m + 1, sizeof(OSQPInt));
+  if (!rows) return OSQP_MEM_ALLOC_ERROR;
+  for (k = 0; k < nnzA; k++) rows[Ai[k]]++;
+
+  nz = 0;
+  for (i = 0; i < m; i++) {
+    if (rows[i] == 1) nz++;
+  }
+
+  // Nothing to split off
+  if (nz == 0) {
+    c_free(rows);
+    return osqp_algebra_init_linsys_solver(sp, P, A, rho_vec, settings,
+                                           scaled_prim_res, scaled_dual_res, 0);
+  }
+
+  s = c_calloc(1, sizeof(bounds_solver));
+  if (!s) {
+    c_free(rows);
+    return OSQP_MEM_ALLOC_ERROR;
+  }
+  *sp = (LinSysSolver*) s;
+
+  s->name               = &name_linsys_solver_bounds;
+  s->solve              = &solve_linsys_bounds;
+  s->update_settings    = &update_settings_linsys_solver_bounds;
+  s->warm_start         = &warm_start_linsys_solver_bounds;
+  s->adjoint_derivative = &adjoint_derivative_bounds;
+  s->free               = &free_linsys_solver_bounds;
+  s->update_matrices    = &update_linsys_solver_matrices_bounds;
+  s->update_rho_vec     = &update_linsys_solver_rho_vec_bounds;
+  s->type               = settings->linsys_solver;
+
+  s->n        = n;
+  s->m        = m;
+  s->n_single = nz;
+
+  n_work = c_max(n, c_max(nnzP, nnzA));
+
+  s->row_map  = (OSQPInt*) c_malloc(m * sizeof(OSQPInt));
+  s->s_row    = (OSQPInt*) c_malloc(nz * sizeof(OSQPInt));
+  s->s_col    = (OSQPInt*) c_malloc(nz * sizeof(OSQPInt));
+  s->s_ent    = (OSQPInt*) c_malloc(nz * sizeof(OSQPInt));
+  s->s_coef   = (OSQPFloat*) c_malloc(nz * sizeof(OSQPFloat));
+  s->s_rho    = (OSQPFloat*) c_malloc(nz * sizeof(OSQPFloat));
+  s->Pmap     = (OSQPInt*) c_malloc((nnzP + 1) * sizeof(OSQPInt));
+  s->Pdiag    = (OSQPInt*) c_malloc(n * sizeof(OSQPInt));
+  s->Pd       = (OSQPFloat*) c_malloc(n * sizeof(OSQPFloat));
+  s->Amap     = (OSQPInt*) c_malloc(nnzA * sizeof(OSQPInt));
+  s->idx_work = (OSQPInt*) c_malloc(n_work * sizeof(OSQPInt));
+  s->val_work = (OSQPFloat*) c_malloc(n_work * sizeof(OSQPFloat));
+  keep        = OSQPVectori_malloc(m);
+  if (!s->row_map || !s->s_row || !s->s_col || !s->s_ent || !s->s_coef || !s->s_rho ||
+      !s->Pmap || !s->Pdiag || !s->Pd || !s->Amap || !s->idx_work || !s->val_work || !keep) {
+    c_free(rows);
+    OSQPVectori_free(keep);
+    return OSQP_MEM_ALLOC_ERROR;
+  }
+
+  // Number the singleton rows and the inner rows
+  nz = 0;
+  k  = 0;
+  for (i = 0; i < m; i++) {
+    if (rows[i] == 1) {
+      s->s_row[k] = i;
+      s->row_map[i] = -1;
+      rows[i] = k++;
+    }
+    else {
+      s->row_map[i] = nz++;
+      rows[i] = -1;
+    }
+  }
+
+  // Entries of the inner A and the singleton rows
+  nz = 0;
+  for (j = 0; j < n; j++) {
+    for (ptr = Ap[j]; ptr < Ap[j + 1]; ptr++) {
+      k = rows[Ai[ptr]];
+      if (k >= 0) {
+        s->s_col[k] = j;
+        s->s_ent[k] = ptr;
+        s->Amap[ptr] = -1;
+      }
+      else {
+        s->Amap[ptr] = nz++;
+      }
+    }
+  }
+
+  // Inner A keeps the order of the entries of A
+  for (i = 0; i < m; i++) rows[i] = (s->row_map[i] >= 0);
+  OSQPVectori_from_raw(keep, rows);
+  c_free(rows);
+  s->A = OSQPMatrix_submatrix_byrows(A, keep);
+  OSQPVectori_free(keep);
+  if (!s->A) return OSQP_MEM_ALLOC_ERROR;
+
+  // Inner P has a diagonal entry in every column, stored last
+  Pk = csc_spalloc(n, n, nnzP + n, 1, 0);
+  if (!Pk) return OSQP_MEM_ALLOC_ERROR;
+  nz = 0;
+  for (j = 0; j < n; j++) {
+    Pk->p[j] = nz;
+    for (ptr = Pp[j]; ptr < Pp[j + 1]; ptr++) {
+      if (Pi[ptr] != j) {
+        Pk->i[nz] = Pi[ptr];
+        Pk->x[nz] = 0.0;
+        s->Pmap[ptr] = nz++;
+      }
+    }
+    Pk->i[nz] = j;
+    Pk->x[nz] = 0.0;
+    s->Pdiag[j] = nz;
+    for (ptr = Pp[j]; ptr < Pp[j + 1]; ptr++) {
+      if (Pi[ptr] == j) s->Pmap[ptr] = nz;
+    }
+    nz++;
+  }
+  Pk->p[n] = nz;
+  s->P = OSQPMatrix_new_from_csc(Pk, 1);
+  csc_spfree(Pk);
+  if (!s->P) return OSQP_MEM_ALLOC_ERROR;
+
+  // Inner vectors
+  s->b      = OSQPVectorf_calloc(n + OSQPMatrix_get_m(s->A));
+  s->row_sc = (OSQPFloat*) c_malloc((OSQPMatrix_get_m(s->A) + 1) * sizeof(OSQPFloat));
+  s->Ax     = (OSQPFloat*) c_malloc((OSQPMatrix_get_nz(s->A) + 1) * sizeof(OSQPFloat));
+  if (!s->b || !s->row_sc || !s->Ax) return OSQP_MEM_ALLOC_ERROR;
+
+  // Penalties of the inner rows at the setup
+  s->rho_sc = settings->rho;
+  if (rho_vec) {
+    s->rho_vec = OSQPVectorf_malloc(OSQPMatrix_get_m(s->A));
+    if (!s->rho_vec) return OSQP_MEM_ALLOC_ERROR;
+    inner_rho = OSQPVectorf_data(s->rho_vec);
+    rho       = OSQPVectorf_data(rho_vec);
+    for (i = 0; i < m; i++) {
+      if (s->row_map[i] >= 0) inner_rho[s->row_map[i]] = rho[i];
+    }
+  }
+
+  set_rho(s, rho_vec, settings->rho);
+  set_values(s, P, A);
+
+  exitflag = osqp_algebra_init_linsys_solver(&s->inner, s->P, s->A, s->rho_vec, settings,
+                                             scaled_prim_res, scaled_dual_res, 0);
+  if (s->inner) s->nthreads = s->inner->nthreads;
+
+  return exitflag;
+}
@@ -1,8 +1,10 @@
 #include <stdio.h>
 #include <ctype.h>  /* -> toupper */
 #include <time.h>   /* time, ctime */
+#include <math.h>   /* frexp, ldexp, floor */
 
 #include "error.h"
+#include "printing.h"
 #include "osqp_api_constants.h"
 #include "types.h"
 #include "algebra_impl.h"
@@ -25,23 +27,62 @@
   exitflag = f; \
   if (exitflag) { return _osqp_error_line(exitflag, __FUNCTION__, __FILE__, __LINE__); }
 
+/* Cast of a pointer to data in read-only memory for the fields of the structures */
+#define ROM_CAST(rom, type) ((rom) ? "(" type "*)" : "")
+
+/* Number of entries of the arrays of a structure in read-only and read-write
+ * memory, to report the footprint of the generated workspace. The arrays of
+ * types with the same size on every target are counted in bytes. */
+typedef struct {
+  OSQPInt rom_float;
+  OSQPInt rom_int;
+  OSQPInt ram_float;
+  OSQPInt ram_int;
+  OSQPInt ram_bytes;
+} codegen_footprint;
+
+/* Structures of the footprint report */
+enum {
+  FOOTPRINT_SOLUTION,
+  FOOTPRINT_DATA,
+  FOOTPRINT_RHO_LADDER,
+  FOOTPRINT_LINSYS,
+  FOOTPRINT_WORK,
+  FOOTPRINT_SCALING,
+  FOOTPRINT_COUNT
+};
+
+static const char* FOOTPRINT_NAME[FOOTPRINT_COUNT] = {
+  "solution",
+  "data",
+  "rho ladder",
+  "linear system solver",
+  "workspace vectors",
+  "scaling"
+};
+
 /*********
 * Vectors
 **********/
 
-static OSQPInt write_vecf(FILE*            f,
-                          const OSQPFloat* vecf,
-                          OSQPInt          n,
-                          const char*      name) {
+/* Data that never changes (rom) is written const, for read-only memory */
+static OSQPInt write_vecf(FILE*              f,
+                          const OSQPFloat*   vecf,
+                          OSQPInt            n,
+                          const char*        name,
+                          OSQPInt            rom,
+                          codegen_footprint* fp) {
 
   OSQPInt i;
 
   if (n && vecf) {
-    fprintf(f, "OSQPFloat %s[%d] = {\n", name, n);
+    fprintf(f, "%sOSQPFloat %s[%d] = {\n", rom ? "OSQP_CODEGEN_ROM const " : "", name, n);
     for (i = 0; i < n; i++) {
       fprintf(f, "  (OSQPFloat)%.20f,\n", vecf[i]);
     }
     fprintf(f, "};\n");
+    if (rom) fp->rom_float += n;
+    else     fp->ram_float += n;
   }
   else {
     fprintf(f, "#define %s (OSQP_NULL)\n", name);
@@ -50,19 +91,23 @@ static OSQPInt write_vecf(FILE*            f,
   return OSQP_NO_ERROR;
 }
 
-static OSQPInt write_veci(FILE*          f,
-                          const OSQPInt* veci,
-                          OSQPInt        n,
-                          const char*    name) {
+static OSQPInt write_veci(FILE*              f,
+                          const OSQPInt*     veci,
+                          OSQPInt            n,
+                          const char*        name,
+                          OSQPInt            rom,
+                          codegen_footprint* fp) {
 
   OSQPInt i;
 
   if (n && veci) {
-    fprintf(f, "OSQPInt %s[%d] = {\n", name, n);
+    fprintf(f, "%sOSQPInt %s[%d] = {\n", rom ? "OSQP_CODEGEN_ROM const " : "", name, n);
     for (i = 0; i < n; i++) {
       fprintf(f, "  %i,\n", veci[i]);
     }
     fprintf(f, "};\n");
+    if (rom) fp->rom_int += n;
+    else     fp->ram_int += n;
   }
   else {
     fprintf(f, "#define %s (OSQP_NULL)\n", name);
@@ -73,7 +118,9 @@ static OSQPInt write_veci(FILE*          f,
 
 static OSQPInt write_OSQPVectorf(FILE*              f,
                                  const OSQPVectorf* vec,
-                                 const char*        name) {
+                                 const char*        name,
+                                 OSQPInt            rom,
+                                 codegen_footprint* fp) {
   
   OSQPInt exitflag = OSQP_NO_ERROR;
   char vecf_name[MAX_VAR_LENGTH];
@@ -81,15 +128,16 @@ static OSQPInt write_OSQPVectorf(FILE*              f,
   if (!vec) return OSQP_DATA_NOT_INITIALIZED;
 
   sprintf(vecf_name, "%s_val", name);
-  PROPAGATE_ERROR(write_vecf(f, vec->values, vec->length, vecf_name))
-  fprintf(f, "OSQPVectorf %s = {\n  %s,\n  %d\n};\n", name, vecf_name, vec->length);
+  PROPAGATE_ERROR(write_vecf(f, vec->values, vec->length, vecf_name, rom, fp))
+  fprintf(f, "OSQPVectorf %s = {\n  %s%s,\n  %d\n};\n", name, ROM_CAST(rom, "OSQPFloat"), vecf_name, vec->length);
 
   return exitflag;
 }
 
 static OSQPInt write_OSQPVectori(FILE*              f,
                                  const OSQPVectori* vec,
-                                 const char*        name) {
+                                 const char*        name,
+                                 codegen_footprint* fp) {
   
   OSQPInt exitflag = OSQP_NO_ERROR;
   char veci_name[MAX_VAR_LENGTH];
@@ -97,7 +145,7 @@ static OSQPInt write_OSQPVectori(FILE*              f,
   if (!vec) return OSQP_DATA_NOT_INITIALIZED;
 
   sprintf(veci_name, "%s_val", name);
-  PROPAGATE_ERROR(write_veci(f, vec->values, vec->length, veci_name))
+  PROPAGATE_ERROR(write_veci(f, vec->values, vec->length, veci_name, 0, fp))
   fprintf(f, "OSQPVectori %s = {\n  %s,\n  %d\n};\n", name, veci_name, vec->length);
 
   return exitflag;
@@ -108,9 +156,13 @@ static OSQPInt write_OSQPVectori(FILE*              f,
 * Matrix
 **********/
 
+/* The sparsity pattern and the values can be in read-only memory separately */
 static OSQPInt write_csc(FILE*                f,
                          const OSQPCscMatrix* M,
-                         const char*          name) {
+                         const char*          name,
+                         OSQPInt              rom_pattern,
+                         OSQPInt              rom_values,
+                         codegen_footprint*   fp) {
 
   OSQPInt exitflag = OSQP_NO_ERROR;
   char vec_name[MAX_VAR_LENGTH];
@@ -118,17 +170,17 @@ static OSQPInt write_csc(FILE*                f,
   if (!M) return OSQP_DATA_NOT_INITIALIZED;
 
   sprintf(vec_name, "%s_p", name);
-  PROPAGATE_ERROR(write_veci(f, M->p, M->n+1, vec_name))
+  PROPAGATE_ERROR(write_veci(f, M->p, M->n+1, vec_name, rom_pattern, fp))
   sprintf(vec_name, "%s_i", name);
-  PROPAGATE_ERROR(write_veci(f, M->i, M->nzmax, vec_name))
+  PROPAGATE_ERROR(write_veci(f, M->i, M->nzmax, vec_name, rom_pattern, fp))
   sprintf(vec_name, "%s_x", name);
-  PROPAGATE_ERROR(write_vecf(f, M->x, M->nzmax, vec_name))
+  PROPAGATE_ERROR(write_vecf(f, M->x, M->nzmax, vec_name, rom_values, fp))
   fprintf(f, "OSQPCscMatrix %s = {\n", name);
   fprintf(f, "  %d,\n", M->m);
   fprintf(f, "  %d,\n", M->n);
-  fprintf(f, "  %s_p,\n", name);
-  fprintf(f, "  %s_i,\n", name);
-  fprintf(f, "  %s_x,\n", name);
+  fprintf(f, "  %s%s_p,\n", ROM_CAST(rom_pattern, "OSQPInt"), name);
+  fprintf(f, "  %s%s_i,\n", ROM_CAST(rom_pattern, "OSQPInt"), name);
+  fprintf(f, "  %s%s_x,\n", ROM_CAST(rom_values, "OSQPFloat"), name);
   fprintf(f, "  %d,\n", M->nzmax);
   fprintf(f, "  %d,\n", M->nz);
   fprintf(f, "};\n");
@@ -136,20 +188,304 @@ static OSQPInt write_csc(FILE*                f,
   return exitflag;
 }
 
-static OSQPInt write_OSQPMatrix(FILE*             f,
-                                const OSQPMatrix* mat,
-                                const char*       name) {
+/* Group the entries of the product y = M*x (y = M'*x if transpose, M stored
+ * as upper triangle if symmetric) by the entry of y they add to. The
+ * entries of y[r] are ygroup[yp[r]] to ygroup[yp[r+1]-1], and entry e
+ * multiplies value k[e] of M with x[xi[e]]. Within a group the entries
+ * keep the order in which the generic kernels accumulate them.
+ */
+static OSQPInt group_csc_entries(const OSQPCscMatrix* M,
+                                 OSQPInt              symmetric,
+                                 OSQPInt              transpose,
+                                 OSQPInt**            ypp,
+                                 OSQPInt**            kp,
+                                 OSQPInt**            xip) {
+
+  OSQPInt  j, k, r, e, ne;
+  OSQPInt  ny  = (symmetric || transpose) ? M->n : M->m;
+  OSQPInt  nnz = M->p[M->n];
+  OSQPInt* ey  = (OSQPInt*)c_malloc((2*nnz+1) * sizeof(OSQPInt));
+  OSQPInt* ex  = (OSQPInt*)c_malloc((2*nnz+1) * sizeof(OSQPInt));
+  OSQPInt* ek  = (OSQPInt*)c_malloc((2*nnz+1) * sizeof(OSQPInt));
+  OSQPInt* yp  = (OSQPInt*)c_calloc(ny+1, sizeof(OSQPInt));
+  OSQPInt* pos = (OSQPInt*)c_malloc((ny+1) * sizeof(OSQPInt));
+  OSQPInt* k_out  = (OSQPInt*)c_malloc((2*nnz+1) * sizeof(OSQPInt));
+  OSQPInt* xi_out = (OSQPInt*)c_malloc((2*nnz+1) * sizeof(OSQPInt));
+
+  if (!ey || !ex || !ek || !yp || !pos || !k_out || !xi_out) {
+    c_free(ey); c_free(ex); c_free(ek); c_free(yp);
+    c_free(pos); c_free(k_out); c_free(xi_out);
+    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  }
+
+  /* Entries in the order of the column sweep of the generic kernels */
+  ne = 0;
+  for (j = 0; j < M->n; j++) {
+    for (k = M->p[j]; k < M->p[j+1]; k++) {
+      r = M->i[k];
+      if (transpose) {
+        ey[ne] = j; ex[ne] = r; ek[ne++] = k;
+      }
+      else {
+        ey[ne] = r; ex[ne] = j; ek[ne++] = k;
+        if (symmetric && r != j) {
+          ey[ne] = j; ex[ne] = r; ek[ne++] = k;
+        }
+      }
+    }
+  }
+
+  /* Stable counting sort by the entry of y */
+  for (e = 0; e < ne; e++) yp[ey[e]+1]++;
+  for (r = 0; r < ny; r++) {
+    yp[r+1] += yp[r];
+    pos[r]   = yp[r];
+  }
+  for (e = 0; e < ne; e++) {
+    k_out[pos[ey[e]]]    = ek[e];
+    xi_out[pos[ey[e]]++] = ex[e];
+  }
+
+  c_free(ey);
+  c_free(ex);
+  c_free(ek);
+  c_free(pos);
+
+  *ypp = yp;
+  *kp  = k_out;
+  *xip = xi_out;
+
+  return OSQP_NO_ERROR;
+}
+
+/* Write y = alpha*M*x + beta*y (M' if transpose) as straight-line code with
+ * the sparsity pattern of M in constant indices. The values are read from the
+ * array of M so that matrix updates still apply to the generated product.
+ */
+static OSQPInt write_csc_Axpy_unrolled(FILE*                f,
+                                       const OSQPCscMatrix* M,
+                                       OSQPInt              symmetric,
+                                       OSQPInt              transpose,
+                                       const char*          values,
+                                       const char*          name) {
+
+  OSQPInt  exitflag = OSQP_NO_ERROR;
+  OSQPInt  r, e;
+  OSQPInt  ny = (symmetric || transpose) ? M->n : M->m;
+  OSQPInt* yp;
+  OSQPInt* k;
+  OSQPInt* xi;
+
+  PROPAGATE_ERROR(group_csc_entries(M, symmetric, transpose, &yp, &k, &xi))
+
+  fprintf(f, "static void %s(const OSQPFloat* x, OSQPFloat* y, OSQPFloat alpha, OSQPFloat beta) {\n", name);
+  if (yp[ny] > 0) {
+    fprintf(f, "  const OSQPFloat* Mx = %s;\n", values);
+    fprintf(f, "  OSQPFloat t;\n");
+  }
+  if (ny > 0) {
+    fprintf(f, "  OSQPInt i;\n\n");
+    fprintf(f, "  if (beta == 0) {\n");
+    fprintf(f, "    for (i = 0; i < %d; i++) y[i] = 0;\n", ny);
+    fprintf(f, "  }\n");
+  }
+  for (r = 0; r < ny; r++) {
+    if (yp[r] == yp[r+1]) {
+      fprintf(f, "  y[%d] *= beta;\n", r);
+      continue;
+    }
+    for (e = yp[r]; e < yp[r+1]; e++) {
+      fprintf(f, "  t %s Mx[%d]*x[%d];\n", e == yp[r] ? " =" : "+=", k[e], xi[e]);
+    }
+    fprintf(f, "  y[%d] = beta*y[%d] + alpha*t;\n", r, r);
+  }
+  fprintf(f, "}\n\n");
+
+  c_free(yp);
+  c_free(k);
+  c_free(xi);
+
+  return exitflag;
+}
+
+/* Smallest e with |a| <= 2^e, for a != 0 */
+static OSQPInt fixed_log2(OSQPFloat a) {
+
+  int    e;
+  double mant = frexp(c_absval(a), &e);
+
+  return (mant == 0.5) ? e - 1 : e;
+}
+
+/* Fraction bits of a fixed-point dot product with coefficients of largest
+ * magnitude cmax and magnitudes summing to csum, for inputs below 2^30 in
+ * magnitude. The coefficients fit in 31 bits and the sum in 63 bits. */
+static OSQPInt fixed_frac_bits(OSQPFloat cmax,
+                               OSQPFloat csum) {
+
+  OSQPInt F = 62;
+
+  if (cmax > 0 && 30 - fixed_log2(cmax) < F) F = 30 - fixed_log2(cmax);
+  if (csum > 0 && 32 - fixed_log2(csum) < F) F = 32 - fixed_log2(csum);
+
+  return F;
+}
+
+/* Coefficient a with F fraction bits, rounded to the nearest integer */
+static double fixed_coef(OSQPFloat a,
+                         OSQPInt   F) {
+  return floor(ldexp(a, F) + 0.5);
+}
+
+/* The fixed-point products convert their input vector to 32-bit integers
+ * with a power of two scale. The scale of every product is kept between
+ * calls, so it only moves by a few steps as the iterates converge.
+ */
+static void write_fixed_point_helpers(FILE*              f,
+                                      OSQPInt            nbuf,
+                                      codegen_footprint* fp) {
+
+  fprintf(f, "/* Fixed-point buffers of the products and the KKT solve */\n");
+  fprintf(f, "static int32_t fx_in[%d];\n", nbuf);
+  fprintf(f, "static int32_t fx_v[%d];\n\n", nbuf);
+  fp->ram_bytes += 2*4*nbuf;
+
+  fprintf(f, "/* Convert v to integers with the largest one in [2^29, 2^30) by updating\n");
+  fprintf(f, " * the power of two scale. Returns the inverse of the scale, 0 if v is zero */\n");
+  fprintf(f, "static OSQPFloat fx_to_q(const OSQPFloat* v, int32_t* q, OSQPInt n, OSQPFloat* scale) {\n");
+  fprintf(f, "  OSQPFloat a;\n");
+  fprintf(f, "  OSQPFloat vmax = 0;\n");
+  fprintf(f, "  OSQPInt   i;\n\n");
+  fprintf(f, "  for (i = 0; i < n; i++) {\n");
+  fprintf(f, "    a = v[i] < 0 ? -v[i] : v[i];\n");
+  fprintf(f, "    if (a > vmax) vmax = a;\n");
+  fprintf(f, "  }\n");
+  fprintf(f, "  if (vmax == 0) {\n");
+  fprintf(f, "    for (i = 0; i < n; i++) q[i] = 0;\n");
+  fprintf(f, "    return 0;\n");
+  fprintf(f, "  }\n");
+  fprintf(f, "  while (vmax*(*scale) >= (OSQPFloat)1073741824.0) *scale *= (OSQPFloat)0.5;\n");
+  fprintf(f, "  while (vmax*(*scale) <  (OSQPFloat)536870912.0 && *scale < (OSQPFloat)1e30) *scale *= 2;\n");
+  fprintf(f, "  for (i = 0; i < n; i++) q[i] = (int32_t)(v[i]*(*scale));\n");
+  fprintf(f, "  return 1 / *scale;\n");
+  fprintf(f, "}\n\n");
+}
+
+/* Write y = alpha*M*x + beta*y (M' if transpose) in fixed point. The values
+ * of M are coefficients of the code, with the fraction bits of every entry of
+ * y chosen from its row of M so that the sums cannot overflow.
+ */
+static OSQPInt write_csc_Axpy_fixed(FILE*                f,
+                                    const OSQPCscMatrix* M,
+                                    OSQPInt              symmetric,
+                                    OSQPInt              transpose,
+                                    const char*          name) {
+
+  OSQPInt   exitflag = OSQP_NO_ERROR;
+  OSQPInt   r, e, F;
+  OSQPInt   ny = (symmetric || transpose) ? M->n : M->m;
+  OSQPInt   nx = (symmetric || transpose) ? M->m : M->n;
+  OSQPFloat cmax, csum;
+  OSQPInt*  yp;
+  OSQPInt*  k;
+  OSQPInt*  xi;
+
+  PROPAGATE_ERROR(group_csc_entries(M, symmetric, transpose, &yp, &k, &xi))
+
+  fprintf(f, "static OSQPFloat %s_scale = 1;\n", name);
+  fprintf(f, "static void %s(const OSQPFloat* x, OSQPFloat* y, OSQPFloat alpha, OSQPFloat beta) {\n", name);
+  if (yp[ny] > 0) {
+    fprintf(f, "  OSQPFloat a = alpha*fx_to_q(x, fx_in, %d, &%s_scale);\n", nx, name);
+    fprintf(f, "  int64_t   t;\n");
+  }
+  if (ny > 0) {
+    fprintf(f, "  OSQPInt   i;\n\n");
+    fprintf(f, "  if (beta == 0) {\n");
+    fprintf(f, "    for (i = 0; i < %d; i++) y[i] = 0;\n", ny);
+    fprintf(f, "  }\n");
+  }
+  for (r = 0; r < ny; r++) {
+    if (yp[r] == yp[r+1]) {
+      fprintf(f, "  y[%d] *= beta;\n", r);
+      continue;
+    }
+    cmax = 0;
+    csum = 0;
+    for (e = yp[r]; e < yp[r+1]; e++) {
+      if (c_absval(M->x[k[e]]) > cmax) cmax = c_absval(M->x[k[e]]);
+      csum += c_absval(M->x[k[e]]);
+    }
+    F = fixed_frac_bits(cmax, csum);
+    for (e = yp[r]; e < yp[r+1]; e++) {
+      fprintf(f, "  t %s (int64_t)%.0f*fx_in[%d];\n", e == yp[r] ? " =" : "+=", fixed_coef(M->x[k[e]], F), xi[e]);
+    }
+    fprintf(f, "  y[%d] = beta*y[%d] + a*((OSQPFloat)t*(OSQPFloat)%.20e);\n", r, r, ldexp(1.0, -F));
+  }
+  fprintf(f, "}\n\n");
+
+  c_free(yp);
+  c_free(k);
+  c_free(xi);
+
+  return exitflag;
+}
+
+/* Only the values of the matrices of the problem can be updated */
+static OSQPInt write_OSQPMatrix(FILE*              f,
+                                const OSQPMatrix*  mat,
+                                const char*        name,
+                                OSQPInt            unroll,
+                                OSQPInt            fixed,
+                                OSQPInt            rom_values,
+                                codegen_footprint* fp) {
 
   OSQPInt exitflag = OSQP_NO_ERROR;
   char csc_name[MAX_VAR_LENGTH];
+  char values[MAX_VAR_LENGTH];
+  char Axpy_name[MAX_VAR_LENGTH];
+  char Atxpy_name[MAX_VAR_LENGTH];
 
   if (!mat) return OSQP_DATA_NOT_INITIALIZED;
 
   sprintf(csc_name, "%s_csc", name);
-  PROPAGATE_ERROR(write_csc(f, mat->csc, csc_name))
+  PROPAGATE_ERROR(write_csc(f, mat->csc, csc_name, 1, rom_values, fp))
+
+  if (unroll) {
+    /* A symmetric matrix is its own transpose, so it needs a single product */
+    sprintf(values,     "%s_x",     csc_name);
+    sprintf(Axpy_name,  "%s_Axpy",  name);
+    sprintf(Atxpy_name, "%s_Atxpy", name);
+    if (fixed) {
+      PROPAGATE_ERROR(write_csc_Axpy_fixed(f, mat->csc, mat->symmetry == TRIU, 0, Axpy_name))
+    }
+    else {
+      PROPAGATE_ERROR(write_csc_Axpy_unrolled(f, mat->csc, mat->symmetry == TRIU, 0, values, Axpy_name))
+    }
+    if (mat->symmetry == TRIU) {
+      sprintf(Atxpy_name, "%s_Axpy", name);
+    }
+    else if (fixed) {
+      PROPAGATE_ERROR(write_csc_Axpy_fixed(f, mat->csc, 0, 1, Atxpy_name))
+    }
+    else {
+      PROPAGATE_ERROR(write_csc_Axpy_unrolled(f, mat->csc, 0, 1, values, Atxpy_name))
+    }
+  }
+
   fprintf(f, "OSQPMatrix %s = {\n", name);
   fprintf(f, "  &%s,\n", csc_name);
-  fprintf(f, "  %d\n", mat->symmetry);
+  if (unroll) {
+    fprintf(f, "  %d,\n", mat->symmetry);
+    fprintf(f, "  OSQP_NULL,\n"); // xs
+    fprintf(f, "  0,\n");         // use_xs
+    fprintf(f, "  OSQP_NULL,\n"); // full
+    fprintf(f, "  OSQP_NULL,\n"); // full_map
+    fprintf(f, "  &%s,\n", Axpy_name);
+    fprintf(f, "  &%s\n",  Atxpy_name);
+  }
+  else {
+    fprintf(f, "  %d\n", mat->symmetry);
+  }
   fprintf(f, "};\n");
   
   return exitflag;
@@ -160,12 +496,18 @@ static OSQPInt write_OSQPMatrix(FILE*             f,
 * Settings
 ***********/
 
-static OSQPInt write_settings(FILE*               f,
-                              const OSQPSettings* settings,
-                              const char*         prefix) {
-  
+static OSQPInt write_settings(FILE*                     f,
+                              const OSQPSettings*       settings,
+                              const char*               prefix,
+                              const OSQPCodegenDefines* defines) {
+
+  OSQPInt adaptive_rho = settings ? settings->adaptive_rho : 0;
+
   if (!settings) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
 
+  /* Embedded mode 1 can only adapt rho along a ladder of factorizations */
+  if (defines->embedded_mode == 1 && defines->rho_ladder_size == 0) adaptive_rho = 0;
+
   fprintf(f, "/* Define the settings structure */\n");
   fprintf(f, "OSQPSettings %ssettings = {\n", prefix);
   fprintf(f, "  0,\n"); // device
@@ -182,7 +524,7 @@ static OSQPInt write_settings(FILE*               f,
   fprintf(f, "  %d,\n", settings->cg_tol_reduction);
   fprintf(f, "  (OSQPFloat)%.20f,\n", settings->cg_tol_fraction);
   fprintf(f, "  %d,\n", settings->cg_precond);
-  fprintf(f, "  %d,\n", settings->adaptive_rho);
+  fprintf(f, "  %d,\n", adaptive_rho);
   fprintf(f, "  %d,\n", settings->adaptive_rho_interval);
   fprintf(f, "  (OSQPFloat)%.20f,\n", settings->adaptive_rho_fraction);
   fprintf(f, "  (OSQPFloat)%.20f,\n", settings->adaptive_rho_tolerance);
@@ -196,6 +538,16 @@ static OSQPInt write_settings(FILE*               f,
   fprintf(f, "  (OSQPFloat)%.20f,\n", settings->time_limit);
   fprintf(f, "  (OSQPFloat)%.20f,\n", settings->delta);
   fprintf(f, "  %d,\n", settings->polish_refine_iter);
+  fprintf(f, "  0,\n"); // presolve
+  fprintf(f, "  0,\n"); // split_bounds
+  fprintf(f, "  0,\n"); // split_dense
+  fprintf(f, "  0,\n"); // split_components
+  fprintf(f, "  0,\n"); // spmv_single
+  fprintf(f, "  0,\n"); // reorder
+  fprintf(f, "  0,\n"); // spmv_full
+  fprintf(f, "  %d,\n", settings->freeze_scaling);
+  fprintf(f, "  0,\n"); // derivative_iterative
+  fprintf(f, "  %d,\n", settings->scaling_type);
   fprintf(f, "};\n\n");
 
   return OSQP_NO_ERROR;
@@ -228,6 +580,8 @@ static OSQPInt write_info(FILE*           f,
   fprintf(f, "  (OSQPFloat)0.0,\n"); // update_time
   fprintf(f, "  (OSQPFloat)0.0,\n"); // polish_time
   fprintf(f, "  (OSQPFloat)0.0,\n"); // run_time
+  fprintf(f, "  (OSQPFloat)0.0,\n"); // spmv_res_error
+  fprintf(f, "  %d,\n", info->scaling_iter);
   fprintf(f, "};\n\n");
 
   return OSQP_NO_ERROR;
@@ -238,13 +592,16 @@ static OSQPInt write_info(FILE*           f,
 * Solution
 ***********/
 
-static OSQPInt write_solution(FILE*       f,
-                              OSQPInt     n,
-                              OSQPInt     m,
-                              const char* prefix) {
+static OSQPInt write_solution(FILE*              f,
+                              OSQPInt            n,
+                              OSQPInt            m,
+                              const char*        prefix,
+                              codegen_footprint* fp) {
 
   /* No need to actually test anything here */
 
+  fp->ram_float += 2*n + 2*m;
+
   fprintf(f, "/* Define the solution structure */\n");
   fprintf(f, "OSQPFloat %ssol_x[%d];\n", prefix, n);
   if (m > 0) fprintf(f, "OSQPFloat %ssol_y[%d];\n", prefix, m);
@@ -267,9 +624,12 @@ static OSQPInt write_solution(FILE*       f,
 * Scaling
 **********/
 
+/* The scaling only changes with the matrices in embedded mode 2 */
 static OSQPInt write_scaling(FILE*              f,
                              const OSQPScaling* scaling,
-                             const char*        prefix) {
+                             const char*        prefix,
+                             OSQPInt            rom,
+                             codegen_footprint* fp) {
 
   OSQPInt exitflag = OSQP_NO_ERROR;
   char name[MAX_VAR_LENGTH];
@@ -278,13 +638,13 @@ static OSQPInt write_scaling(FILE*              f,
 
   fprintf(f, "\n/* Define the scaling structure */\n");
   sprintf(name, "%sscaling_D", prefix);
-  GENERATE_ERROR(write_OSQPVectorf(f, scaling->D,    name))
+  GENERATE_ERROR(write_OSQPVectorf(f, scaling->D,    name, rom, fp))
   sprintf(name, "%sscaling_E", prefix);
-  GENERATE_ERROR(write_OSQPVectorf(f, scaling->E,    name))
+  GENERATE_ERROR(write_OSQPVectorf(f, scaling->E,    name, rom, fp))
   sprintf(name, "%sscaling_Dinv", prefix);
-  GENERATE_ERROR(write_OSQPVectorf(f, scaling->Dinv, name))
+  GENERATE_ERROR(write_OSQPVectorf(f, scaling->Dinv, name, rom, fp))
   sprintf(name, "%sscaling_Einv", prefix);
-  GENERATE_ERROR(write_OSQPVectorf(f, scaling->Einv, name))
+  GENERATE_ERROR(write_OSQPVectorf(f, scaling->Einv, name, rom, fp))
   fprintf(f, "OSQPScaling %sscaling = {\n", prefix);
   fprintf(f, "  (OSQPFloat)%.20f,\n", scaling->c);
   fprintf(f, "  &%sscaling_D,\n", prefix);
@@ -302,9 +662,16 @@ static OSQPInt write_scaling(FILE*              f,
 * Data
 *******/
 
-static OSQPInt write_data(FILE*           f,
-                          const OSQPData* data,
-                          const char*     prefix) {
+/* The matrices only change in embedded mode 2, the vectors in both modes */
+static OSQPInt write_data(FILE*                     f,
+                          const OSQPData*           data,
+                          const char*               prefix,
+                          const OSQPCodegenDefines* defines,
+                          codegen_footprint*        fp) {
+
+  OSQPInt unroll     = defines->unroll_enable;
+  OSQPInt fixed      = defines->fixed_point_enable;
+  OSQPInt rom_values = defines->embedded_mode == 1;
 
   OSQPInt exitflag = OSQP_NO_ERROR;
   char name[MAX_VAR_LENGTH];
@@ -313,15 +680,15 @@ static OSQPInt write_data(FILE*           f,
 
   fprintf(f, "/* Define the data structure */\n");
   sprintf(name, "%sdata_P", prefix);
-  GENERATE_ERROR(write_OSQPMatrix(f,  data->P, name))
+  GENERATE_ERROR(write_OSQPMatrix(f,  data->P, name, unroll, fixed, rom_values, fp))
   sprintf(name, "%sdata_A", prefix);
-  GENERATE_ERROR(write_OSQPMatrix(f,  data->A, name))
+  GENERATE_ERROR(write_OSQPMatrix(f,  data->A, name, unroll, fixed, rom_values, fp))
   sprintf(name, "%sdata_q", prefix);
-  GENERATE_ERROR(write_OSQPVectorf(f, data->q, name))
+  GENERATE_ERROR(write_OSQPVectorf(f, data->q, name, 0, fp))
   sprintf(name, "%sdata_l", prefix);
-  GENERATE_ERROR(write_OSQPVectorf(f, data->l, name))
+  GENERATE_ERROR(write_OSQPVectorf(f, data->l, name, 0, fp))
   sprintf(name, "%sdata_u", prefix);
-  GENERATE_ERROR(write_OSQPVectorf(f, data->u, name))
+  GENERATE_ERROR(write_OSQPVectorf(f, data->u, name, 0, fp))
   fprintf(f, "OSQPData %sdata = {\n", prefix);
   fprintf(f, "  %d,\n", data->n);
   fprintf(f, "  %d,\n", data->m);
@@ -340,13 +707,562 @@ static OSQPInt write_data(FILE*           f,
 * Linear System Solver
 ***********************/
 
-static OSQPInt write_linsys(FILE*               f,
-                            const qdldl_solver* linsys,
-                            const OSQPData*     data,
-                            const char*         prefix,
-                            OSQPInt             embedded) {
+/* Write the solve of P'LDL'P x = b as straight-line code with the sparsity
+ * pattern of L and the permutation in constant indices. The forward
+ * substitution reads b through the permutation and the backward substitution
+ * writes x through it, so there are no separate permutation passes. The
+ * operations are the ones of QDLDL_solve in the same order.
+ */
+static OSQPInt write_ldl_solve_unrolled(FILE*               f,
+                                        const qdldl_solver* linsys,
+                                        const char*         prefix) {
+
+  OSQPInt        exitflag = OSQP_NO_ERROR;
+  OSQPInt        i, e;
+  OSQPCscMatrix* L  = linsys->L;
+  OSQPInt*       P  = linsys->P;
+  OSQPInt        nL = L->n;
+  OSQPInt*       rp;
+  OSQPInt*       rk;
+  OSQPInt*       rc;
+
+  /* Rows of L for the forward substitution (its columns are used directly) */
+  PROPAGATE_ERROR(group_csc_entries(L, 0, 0, &rp, &rk, &rc))
+
+  /* The factors are read through the solver, which may switch them */
+  fprintf(f, "static void %slinsys_ldl_solve(qdldl_solver* self, OSQPFloat* x, const OSQPFloat* b) {\n", prefix);
+  if (L->p[nL] > 0) {
+    fprintf(f, "  const OSQPFloat* Lx   = self->L->x;\n");
+  }
+  fprintf(f, "  const OSQPFloat* Dinv = self->Dinv;\n");
+  fprintf(f, "  OSQPFloat*       bp   = self->bp;\n\n");
+
+  fprintf(f, "  /* bp = L \\ P b */\n");
+  for (i = 0; i < nL; i++) {
+    fprintf(f, "  bp[%d] = b[%d]", i, P[i]);
+    for (e = rp[i]; e < rp[i+1]; e++) {
+      fprintf(f, "\n        - Lx[%d]*bp[%d]", rk[e], rc[e]);
+    }
+    fprintf(f, ";\n");
+  }
+
+  fprintf(f, "  /* x = P' (L' \\ D^-1 bp) */\n");
+  for (i = nL - 1; i >= 0; i--) {
+    fprintf(f, "  x[%d] = bp[%d]*Dinv[%d]", P[i], i, i);
+    for (e = L->p[i]; e < L->p[i+1]; e++) {
+      fprintf(f, "\n        - Lx[%d]*x[%d]", e, P[L->i[e]]);
+    }
+    fprintf(f, ";\n");
+  }
+  fprintf(f, "}\n\n");
+
+  c_free(rp);
+  c_free(rk);
+  c_free(rc);
+
+  return exitflag;
+}
+
+/* Largest magnitude of every entry of w = L \ b (of w = (LDL') \ b if ldl)
+ * over the vectors b with entries in [-1, 1], which is the 1-norm of the row
+ * of the inverse. The rows are found one at a time with the vector w.
+ */
+static void ldl_row_norms(const qdldl_solver* linsys,
+                          OSQPInt             ldl,
+                          OSQPFloat*          w,
+                          OSQPFloat*          norms) {
+
+  OSQPCscMatrix* L  = linsys->L;
+  OSQPInt        nL = L->n;
+  OSQPInt        i, j, k;
+
+  for (i = 0; i < nL; i++) {
+    for (j = 0; j < nL; j++) w[j] = 0;
+    w[i] = 1;
+    /* Row i of L^-1, or column i of (LDL')^-1 = L'^-1 D^-1 L^-1 */
+    if (ldl) {
+      for (j = i; j < nL; j++) {
+        for (k = L->p[j]; k < L->p[j+1]; k++) w[L->i[k]] -= L->x[k] * w[j];
+      }
+      for (j = 0; j < nL; j++) w[j] *= linsys->Dinv[j];
+    }
+    for (j = (ldl ? nL : i) - 1; j >= 0; j--) {
+      for (k = L->p[j]; k < L->p[j+1]; k++) w[j] -= L->x[k] * w[L->i[k]];
+    }
+    norms[i] = 0;
+    for (j = 0; j < nL; j++) norms[i] += c_absval(w[j]);
+  }
+}
+
+/* Exponents of power of two bounds on the entries of the forward (2^g) and
+ * the backward (2^h) substitution of the solve, for entries of b in [-1, 1] */
+static OSQPInt ldl_fixed_exponents(const qdldl_solver* linsys,
+                                   OSQPInt*            g,
+                                   OSQPInt*            h) {
+
+  OSQPInt    nL = linsys->L->n;
+  OSQPInt    i;
+  OSQPFloat* z  = (OSQPFloat*)c_malloc(nL * sizeof(OSQPFloat));
+  OSQPFloat* w  = (OSQPFloat*)c_malloc(nL * sizeof(OSQPFloat));
+
+  if (!z || !w) {
+    c_free(z);
+    c_free(w);
+    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  }
+
+  ldl_row_norms(linsys, 0, w, z);
+  for (i = 0; i < nL; i++) g[i] = fixed_log2(z[i]);
+  ldl_row_norms(linsys, 1, w, z);
+  for (i = 0; i < nL; i++) h[i] = fixed_log2(z[i]);
+
+  c_free(z);
+  c_free(w);
+
+  return OSQP_NO_ERROR;
+}
+
+/* Write the solve of P'LDL'P x = b in fixed point, from b in fx_in with
+ * entries below 2^30 in magnitude to x in fx_t. Every entry of the forward
+ * and backward substitutions is stored relative to a power of two bound on
+ * its magnitude, so that the entries cannot overflow, and the entries of x
+ * are then shifted back to the scale of b. The factors are coefficients of
+ * the code.
+ */
+static OSQPInt write_ldl_fixed(FILE*               f,
+                               const qdldl_solver* linsys) {
+
+  OSQPInt        exitflag = OSQP_NO_ERROR;
+  OSQPInt        i, e, c, F;
+  OSQPCscMatrix* L  = linsys->L;
+  OSQPInt*       P  = linsys->P;
+  OSQPInt        nL = L->n;
+  OSQPFloat      coef, cmax, csum;
+  OSQPInt*       rp;
+  OSQPInt*       rk;
+  OSQPInt*       rc;
+  OSQPInt*       g;
+  OSQPInt*       h;
+
+  PROPAGATE_ERROR(group_csc_entries(L, 0, 0, &rp, &rk, &rc))
+
+  g = (OSQPInt*)c_malloc(nL * sizeof(OSQPInt));
+  h = (OSQPInt*)c_malloc(nL * sizeof(OSQPInt));
+  if (!g || !h) {
+    exitflag = osqp_error(OSQP_MEM_ALLOC_ERROR);
+    goto exit;
+  }
+
+  exitflag = ldl_fixed_exponents(linsys, g, h);
+  if (exitflag) goto exit;
+
+  fprintf(f, "  /* fx_v = 2^-g (L \\ P b) */\n");
+  for (i = 0; i < nL; i++) {
+    cmax = 0;
+    csum = ldexp(1.0, -g[i]);
+    for (e = rp[i]; e < rp[i+1]; e++) {
+      coef = ldexp(L->x[rk[e]], g[rc[e]] - g[i]);
+      if (c_absval(coef) > cmax) cmax = c_absval(coef);
+      csum += c_absval(coef);
+    }
+    F = fixed_frac_bits(cmax, csum);
+    if (F < 1) {
+      exitflag = osqp_error(OSQP_LINSYS_SOLVER_INIT_ERROR);
+      goto exit;
+    }
+    if (F >= g[i]) fprintf(f, "  t  = (int64_t)fx_in[%d]*((int64_t)1 << %d);\n", P[i], F - g[i]);
+    else           fprintf(f, "  t  = (int64_t)fx_in[%d] >> %d;\n", P[i], g[i] - F);
+    for (e = rp[i]; e < rp[i+1]; e++) {
+      c = rc[e];
+      fprintf(f, "  t += (int64_t)%.0f*fx_v[%d];\n", fixed_coef(-ldexp(L->x[rk[e]], g[c] - g[i]), F), c);
+    }
+    fprintf(f, "  fx_v[%d] = (int32_t)((t + ((int64_t)1 << %d)) >> %d);\n", i, F - 1, F);
+  }
+
+  fprintf(f, "  /* fx_in = 2^-h (L' \\ D^-1 fx_v), fx_t = P' 2^h fx_in */\n");
+  for (i = nL - 1; i >= 0; i--) {
+    cmax = c_absval(ldexp(linsys->Dinv[i], g[i] - h[i]));
+    csum = cmax;
+    for (e = L->p[i]; e < L->p[i+1]; e++) {
+      coef = ldexp(L->x[e], h[L->i[e]] - h[i]);
+      if (c_absval(coef) > cmax) cmax = c_absval(coef);
+      csum += c_absval(coef);
+    }
+    F = fixed_frac_bits(cmax, csum);
+    /* The entries of x below 2^(30 + h) have to fit in 63 bits */
+    if (F < 1 || h[i] > 33) {
+      exitflag = osqp_error(OSQP_LINSYS_SOLVER_INIT_ERROR);
+      goto exit;
+    }
+    fprintf(f, "  t  = (int64_t)%.0f*fx_v[%d];\n", fixed_coef(ldexp(linsys->Dinv[i], g[i] - h[i]), F), i);
+    for (e = L->p[i]; e < L->p[i+1]; e++) {
+      c = L->i[e];
+      fprintf(f, "  t += (int64_t)%.0f*fx_in[%d];\n", fixed_coef(-ldexp(L->x[e], h[c] - h[i]), F), c);
+    }
+    fprintf(f, "  fx_in[%d] = (int32_t)((t + ((int64_t)1 << %d)) >> %d);\n", i, F - 1, F);
+    if (h[i] > 0)      fprintf(f, "  fx_t[%d] = (int64_t)fx_in[%d]*((int64_t)1 << %d);\n", P[i], i, h[i]);
+    else if (h[i] < 0) fprintf(f, "  fx_t[%d] = (int64_t)fx_in[%d] >> %d;\n", P[i], i, -h[i]);
+    else               fprintf(f, "  fx_t[%d] = fx_in[%d];\n", P[i], i);
+  }
+
+exit:
+  c_free(rp);
+  c_free(rk);
+  c_free(rc);
+  c_free(g);
+  c_free(h);
+
+  return exitflag;
+}
+
+/* Values of rho of the constraints, with the class of every constraint in
+ * cls. Returns the number of classes, at most m, or 1 for scalar rho. */
+static OSQPInt rho_classes(const OSQPSolver* solver,
+                           OSQPInt*          cls,
+                           OSQPFloat*        rho,
+                           OSQPFloat*        rinv) {
+
+  const OSQPWorkspace* work = solver->work;
+
+  OSQPInt nk = 0;
+  OSQPInt j, k;
+
+  if (!solver->settings->rho_is_vec) {
+    for (j = 0; j < work->data->m; j++) cls[j] = 0;
+    rho[0]  = solver->settings->rho;
+    rinv[0] = work->rho_inv;
+    return 1;
+  }
+
+  for (j = 0; j < work->data->m; j++) {
+    for (k = 0; k < nk && rho[k] != work->rho_vec->values[j]; k++) {}
+    if (k == nk) {
+      rho[nk]  = work->rho_vec->values[j];
+      rinv[nk] = work->rho_inv_vec->values[j];
+      nk++;
+    }
+    cls[j] = k;
+  }
+
+  return nk;
+}
+
+/* Write the shift of the vectors of the step by the exponent e */
+static void write_step_shift(FILE*       f,
+                             OSQPInt     n,
+                             OSQPInt     m,
+                             const char* e) {
+
+  fprintf(f, "  for (i = 0; i < %d; i++) fx_t[i] >>= %s;\n", n+m, e);
+  fprintf(f, "  for (i = 0; i < %d; i++) fx_xp[i] >>= %s;\n", n, e);
+  if (m > 0) {
+    fprintf(f, "  for (i = 0; i < %d; i++) fx_zp[i] >>= %s;\n", m, e);
+    fprintf(f, "  for (i = 0; i < %d; i++) fx_w[i] >>= %s;\n", m, e);
+  }
+}
+
+/* Write the ADMM step of osqp_solve in fixed point: the right-hand side, the
+ * KKT solve and the updates of x, z and y. The iterates and the scaled duals
+ * rho^-1 y are converted to 32-bit integers with a power of two scale, which
+ * is kept between calls like the scales of the products, and the integers are
+ * shifted down after the solve and after z tilde to keep the sums in 63 bits.
+ * Only the scale, the conversions, the projection onto [l, u] and the update
+ * of y stay in floating point. The step writes its results to the iterates,
+ * so the termination checks are the ones of the library.
+ */
+static OSQPInt write_admm_step_fixed(FILE*              f,
+                                     const OSQPSolver*  solver,
+                                     const char*        prefix,
+                                     codegen_footprint* fp) {
+
+  OSQPInt             exitflag = OSQP_NO_ERROR;
+  const qdldl_solver* linsys   = (qdldl_solver*)solver->work->linsys_solver;
+  OSQPFloat           sigma    = solver->settings->sigma;
+  OSQPInt             n        = solver->work->data->n;
+  OSQPInt             m        = solver->work->data->m;
+  OSQPInt             j, k, nk, B, FS;
+  OSQPInt*            cls;
+  OSQPInt*            F;
+  OSQPFloat*          rho;
+  OSQPFloat*          rinv;
+
+  /* The right-hand side sigma x_prev - q has to stay below 2^30 */
+  B = 30 - fixed_log2(1 + sigma);
+  if (B > 29) B = 29;
+  if (B < 16) return osqp_error(OSQP_LINSYS_SOLVER_INIT_ERROR);
+  FS = fixed_frac_bits(sigma, sigma);
+
+  cls  = (OSQPInt*)c_malloc((m + 1) * sizeof(OSQPInt));
+  F    = (OSQPInt*)c_malloc((m + 1) * sizeof(OSQPInt));
+  rho  = (OSQPFloat*)c_malloc((m + 1) * sizeof(OSQPFloat));
+  rinv = (OSQPFloat*)c_malloc((m + 1) * sizeof(OSQPFloat));
+  if (!cls || !F || !rho || !rinv) {
+    exitflag = osqp_error(OSQP_MEM_ALLOC_ERROR);
+    goto exit;
+  }
+  nk = rho_classes(solver, cls, rho, rinv);
+  for (k = 0; k < nk; k++) F[k] = fixed_frac_bits(rinv[k], rinv[k]);
+
+  fprintf(f, "/* Fixed-point buffers of the ADMM step */\n");
+  fprintf(f, "static int32_t fx_xp[%d];\n", n);
+  if (m > 0) {
+    fprintf(f, "static int32_t fx_zp[%d];\n", m);
+    fprintf(f, "static int32_t fx_w[%d];\n", m);
+  }
+  fprintf(f, "static int64_t fx_t[%d];\n\n", n+m);
+  fp->ram_bytes += 4*(n + 2*m) + 8*(n + m);
+
+  fprintf(f, "static OSQPFloat %sadmm_step_scale = 1;\n", prefix);
+  fprintf(f, "static void %sadmm_step(OSQPWorkspace* work, const OSQPSettings* settings) {\n", prefix);
+  fprintf(f, "  const OSQPFloat* xp = work->x_prev->values;\n");
+  fprintf(f, "  const OSQPFloat* q  = work->data->q->values;\n");
+  fprintf(f, "  OSQPFloat*       x  = work->x->values;\n");
+  fprintf(f, "  OSQPFloat*       dx = work->delta_x->values;\n");
+  if (m > 0) {
+    fprintf(f, "  const OSQPFloat* zp = work->z_prev->values;\n");
+    fprintf(f, "  const OSQPFloat* l  = work->data->l->values;\n");
+    fprintf(f, "  const OSQPFloat* u  = work->data->u->values;\n");
+    fprintf(f, "  OSQPFloat*       z  = work->z->values;\n");
+    fprintf(f, "  OSQPFloat*       y  = work->y->values;\n");
+    fprintf(f, "  OSQPFloat*       dy = work->delta_y->values;\n");
+    fprintf(f, "  OSQPFloat wmax[%d];\n", nk);
+    fprintf(f, "  OSQPFloat c[%d];\n", nk);
+  }
+  fprintf(f, "  OSQPFloat s    = %sadmm_step_scale;\n", prefix);
+  fprintf(f, "  OSQPFloat vmax = 0;\n");
+  fprintf(f, "  OSQPFloat a, si;\n");
+  fprintf(f, "  int64_t   fx_a, fx_max, fx_A, fx_B;\n");
+  fprintf(f, "  int64_t   t;\n");
+  fprintf(f, "  OSQPInt   %si;\n\n", m > 0 ? "fx_e, fx_k, " : "fx_e, ");
+
+  fprintf(f, "  /* Scale of x_prev, q, z_prev and rho^-1 y in [2^%d, 2^%d) */\n", B - 1, B);
+  fprintf(f, "  for (i = 0; i < %d; i++) {\n", n);
+  fprintf(f, "    a = xp[i] < 0 ? -xp[i] : xp[i];\n");
+  fprintf(f, "    if (a > vmax) vmax = a;\n");
+  fprintf(f, "    a = q[i] < 0 ? -q[i] : q[i];\n");
+  fprintf(f, "    if (a > vmax) vmax = a;\n");
+  fprintf(f, "  }\n");
+  if (m > 0) {
+    fprintf(f, "  for (i = 0; i < %d; i++) {\n", m);
+    fprintf(f, "    a = zp[i] < 0 ? -zp[i] : zp[i];\n");
+    fprintf(f, "    if (a > vmax) vmax = a;\n");
+    fprintf(f, "  }\n");
+    fprintf(f, "  for (i = 0; i < %d; i++) wmax[i] = 0;\n", nk);
+    for (j = 0; j < m; j++) {
+      fprintf(f, "  a = y[%d] < 0 ? -y[%d] : y[%d];\n", j, j, j);
+      fprintf(f, "  if (a > wmax[%d]) wmax[%d] = a;\n", cls[j], cls[j]);
+    }
+    for (k = 0; k < nk; k++) {
+      fprintf(f, "  a = wmax[%d]*(OSQPFloat)%.20e;\n", k, rinv[k]);
+      fprintf(f, "  if (a > vmax) vmax = a;\n");
+    }
+  }
+  fprintf(f, "  while (vmax*s >= (OSQPFloat)%.1f) s *= (OSQPFloat)0.5;\n", ldexp(1.0, B));
+  fprintf(f, "  while (vmax*s < (OSQPFloat)%.1f && vmax > 0 && s < (OSQPFloat)1e30) s *= 2;\n", ldexp(1.0, B - 1));
+  fprintf(f, "  %sadmm_step_scale = s;\n", prefix);
+  fprintf(f, "  a    = settings->alpha*(OSQPFloat)1073741824.0;\n");
+  fprintf(f, "  fx_A = (int64_t)a;\n");
+  fprintf(f, "  fx_B = (int64_t)1073741824 - fx_A;\n");
+  for (k = 0; k < nk && m > 0; k++) {
+    fprintf(f, "  c[%d] = (OSQPFloat)%.20e*s;\n", k, rinv[k]);
+  }
+
+  fprintf(f, "  /* fx_in = s (sigma x_prev - q, z_prev - rho^-1 y) */\n");
+  fprintf(f, "  for (i = 0; i < %d; i++) {\n", n);
+  fprintf(f, "    a = xp[i]*s;\n");
+  fprintf(f, "    fx_xp[i] = (int32_t)a;\n");
+  fprintf(f, "    a = q[i]*s;\n");
+  fprintf(f, "    t = (int64_t)%.0f*fx_xp[i];\n", fixed_coef(sigma, FS));
+  fprintf(f, "    fx_in[i] = (int32_t)((t + ((int64_t)1 << %d)) >> %d) - (int32_t)a;\n", FS - 1, FS);
+  fprintf(f, "  }\n");
+  if (m > 0) {
+    fprintf(f, "  for (i = 0; i < %d; i++) {\n", m);
+    fprintf(f, "    a = zp[i]*s;\n");
+    fprintf(f, "    fx_zp[i] = (int32_t)a;\n");
+    fprintf(f, "  }\n");
+    for (j = 0; j < m; j++) {
+      fprintf(f, "  a = y[%d]*c[%d];\n", j, cls[j]);
+      fprintf(f, "  fx_w[%d] = (int32_t)a;\n", j);
+      fprintf(f, "  fx_in[%d] = fx_zp[%d] - fx_w[%d];\n", n+j, j, j);
+    }
+  }
+
+  exitflag = write_ldl_fixed(f, linsys);
+  if (exitflag) goto exit;
+
+  fprintf(f, "  /* Shift everything by 2^-e for the solution below 2^29 */\n");
+  fprintf(f, "  fx_max = 0;\n");
+  fprintf(f, "  for (i = 0; i < %d; i++) {\n", n+m);
+  fprintf(f, "    fx_a = fx_t[i] < 0 ? -fx_t[i] : fx_t[i];\n");
+  fprintf(f, "    if (fx_a > fx_max) fx_max = fx_a;\n");
+  fprintf(f, "  }\n");
+  fprintf(f, "  fx_e = 0;\n");
+  fprintf(f, "  while ((fx_max >> fx_e) >= ((int64_t)1 << 29)) fx_e++;\n");
+  write_step_shift(f, n, m, "fx_e");
+
+  if (m > 0) {
+    fprintf(f, "  /* z tilde = z_prev - rho^-1 y + rho^-1 nu, and the same shift */\n");
+    for (j = 0; j < m; j++) {
+      k = cls[j];
+      fprintf(f, "  t = (int64_t)%.0f*fx_t[%d];\n", fixed_coef(rinv[k], F[k]), n+j);
+      fprintf(f, "  fx_t[%d] = fx_zp[%d] - fx_w[%d] + ((t + ((int64_t)1 << %d)) >> %d);\n", n+j, j, j, F[k] - 1, F[k]);
+    }
+    fprintf(f, "  fx_max = 0;\n");
+    fprintf(f, "  for (i = 0; i < %d; i++) {\n", m);
+    fprintf(f, "    fx_a = fx_t[%d+i] < 0 ? -fx_t[%d+i] : fx_t[%d+i];\n", n, n, n);
+    fprintf(f, "    if (fx_a > fx_max) fx_max = fx_a;\n");
+    fprintf(f, "  }\n");
+    fprintf(f, "  fx_k = 0;\n");
+    fprintf(f, "  while ((fx_max >> fx_k) >= ((int64_t)1 << 29)) fx_k++;\n");
+    write_step_shift(f, n, m, "fx_k");
+    fprintf(f, "  fx_e += fx_k;\n");
+  }
+
+  fprintf(f, "  /* Relaxation with alpha in 30 fraction bits, back to floating point */\n");
+  fprintf(f, "  fx_a = (int64_t)1 << fx_e;\n");
+  fprintf(f, "  si   = (OSQPFloat)fx_a/s;\n");
+  fprintf(f, "  for (i = 0; i < %d; i++) {\n", n);
+  fprintf(f, "    t = (fx_A*fx_t[i] + fx_B*fx_xp[i] + ((int64_t)1 << 29)) >> 30;\n");
+  fprintf(f, "    x[i] = (OSQPFloat)t*si;\n");
+  fprintf(f, "    t -= fx_xp[i];\n");
+  fprintf(f, "    dx[i] = (OSQPFloat)t*si;\n");
+  fprintf(f, "  }\n");
+  for (j = 0; j < m; j++) {
+    fprintf(f, "  t = ((fx_A*fx_t[%d] + fx_B*fx_zp[%d] + ((int64_t)1 << 29)) >> 30) + fx_w[%d];\n", n+j, j, j);
+    fprintf(f, "  a = (OSQPFloat)t*si;\n");
+    fprintf(f, "  z[%d] = a < l[%d] ? l[%d] : (a > u[%d] ? u[%d] : a);\n", j, j, j, j, j);
+    fprintf(f, "  a = (OSQPFloat)%.20e*(a - z[%d]);\n", rho[cls[j]], j);
+    fprintf(f, "  dy[%d] = a - y[%d];\n", j, j);
+    fprintf(f, "  y[%d] = a;\n", j);
+  }
+  fprintf(f, "}\n\n");
+
+exit:
+  c_free(cls);
+  c_free(F);
+  c_free(rho);
+  c_free(rinv);
+
+  return exitflag;
+}
+
+/* Precompute the factorizations of a ladder of rho values around the current
+ * one, spaced by the adaptive rho tolerance, so that the solver in embedded
+ * mode 1 can adapt rho without refactoring. The tables of L and Dinv are
+ * written for every rho of the ladder but the current one, whose factors are
+ * the ones of the linear system solver. The values of rho_vec and rho_inv_vec
+ * are written for all of them since the workspace copies them over its own,
+ * so the solver moves to every rho of the ladder, the current one included.
+ */
+static OSQPInt write_rho_ladder(FILE*                     f,
+                                OSQPSolver*               solver,
+                                const char*               prefix,
+                                const OSQPCodegenDefines* defines,
+                                OSQPInt*                  ladder_n,
+                                OSQPInt*                  ladder_k,
+                                codegen_footprint*        fp) {
+
+  OSQPInt        exitflag = OSQP_NO_ERROR;
+  OSQPInt        size     = defines->rho_ladder_size;
+  OSQPInt        c        = (size - 1) / 2;
+  OSQPInt        i, j, k;
+  OSQPFloat      rho      = solver->settings->rho;
+  OSQPFloat      tol      = solver->settings->adaptive_rho_tolerance;
+  OSQPFloat      rho_k;
+  OSQPFloat*     ladder;
+  OSQPWorkspace* work     = solver->work;
+  qdldl_solver*  linsys   = (qdldl_solver *)work->linsys_solver;
+  OSQPInt        n        = linsys->n;
+  OSQPInt        m        = linsys->m;
+  char name[MAX_VAR_LENGTH];
+
+  *ladder_n = 0;
+  *ladder_k = 0;
+
+  if (defines->embedded_mode != 1 || size == 0) return exitflag;
+
+  ladder = (OSQPFloat *)c_malloc(size * sizeof(OSQPFloat));
+  if (!ladder) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+
+  /* rho tol^(k - c) within the bounds of rho, without repeated values */
+  for (k = 0; k < size; k++) {
+    rho_k = rho;
+    for (j = k; j < c; j++) rho_k /= tol;
+    for (j = c; j < k; j++) rho_k *= tol;
+    rho_k = c_min(c_max(rho_k, OSQP_RHO_MIN), OSQP_RHO_MAX);
+
+    if (*ladder_n == 0 || rho_k > ladder[*ladder_n - 1]) {
+      ladder[(*ladder_n)++] = rho_k;
+    }
+    if (rho_k == rho) *ladder_k = *ladder_n - 1;
+  }
+
+  fprintf(f, "/* Define the factorizations of the rho ladder */\n");
+  sprintf(name, "%srho_ladder", prefix);
+  GENERATE_ERROR(write_vecf(f, ladder, *ladder_n, name, 1, fp))
+
+#ifdef OSQP_ENABLE_PROFILING
+  /* The updates below are not timed as updates of the user */
+  work->rho_update_from_solve = 1;
+#endif
+
+  for (i = 0; i < *ladder_n; i++) {
+    exitflag = osqp_update_rho(solver, ladder[i]);
+    if (exitflag) break;
+
+    if (i != *ladder_k) {
+      sprintf(name, "%srho_ladder_L_x_%d", prefix, i);
+      GENERATE_ERROR(write_vecf(f, linsys->L->x, linsys->L->nzmax, name, 1, fp))
+      sprintf(name, "%srho_ladder_Dinv_%d", prefix, i);
+      GENERATE_ERROR(write_vecf(f, linsys->Dinv, n+m, name, 1, fp))
+    }
+    if (solver->settings->rho_is_vec) {
+      sprintf(name, "%srho_ladder_rho_vec_%d", prefix, i);
+      GENERATE_ERROR(write_vecf(f, OSQPVectorf_data(work->rho_vec), m, name, 1, fp))
+      sprintf(name, "%srho_ladder_rho_inv_vec_%d", prefix, i);
+      GENERATE_ERROR(write_vecf(f, OSQPVectorf_data(work->rho_inv_vec), m, name, 1, fp))
+    }
+  }
+
+  /* Go back to the factorization of the current rho */
+  if (!exitflag) exitflag = osqp_update_rho(solver, rho);
+
+#ifdef OSQP_ENABLE_PROFILING
+  work->rho_update_from_solve = 0;
+#endif
+
+  c_free(ladder);
+  if (exitflag) return osqp_error(OSQP_LINSYS_SOLVER_INIT_ERROR);
+
+  if (solver->settings->rho_is_vec) {
+    fprintf(f, "OSQPFloat* %srho_ladder_rho_vec[%d] = {\n", prefix, *ladder_n);
+    for (i = 0; i < *ladder_n; i++) {
+      fprintf(f, "  (OSQPFloat*)%srho_ladder_rho_vec_%d,\n", prefix, i);
+    }
+    fprintf(f, "};\n");
+    fprintf(f, "OSQPFloat* %srho_ladder_rho_inv_vec[%d] = {\n", prefix, *ladder_n);
+    for (i = 0; i < *ladder_n; i++) {
+      fprintf(f, "  (OSQPFloat*)%srho_ladder_rho_inv_vec_%d,\n", prefix, i);
+    }
+    fprintf(f, "};\n");
+  }
+
+  return exitflag;
+}
+
+static OSQPInt write_linsys(FILE*                     f,
+                            const qdldl_solver*       linsys,
+                            const OSQPData*           data,
+                            const char*               prefix,
+                            const OSQPCodegenDefines* defines,
+                            OSQPInt                   ladder_n,
+                            OSQPInt                   ladder_k,
+                            codegen_footprint*        fp) {
 
   OSQPInt exitflag = OSQP_NO_ERROR;
+  OSQPInt embedded = defines->embedded_mode;
+  OSQPInt rom      = embedded == 1;   /* No refactorization in embedded mode 1 */
+  OSQPInt i;
   char name[MAX_VAR_LENGTH];
 
   if (!linsys) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
@@ -356,37 +1272,62 @@ static OSQPInt write_linsys(FILE*               f,
 
   fprintf(f, "/* Define the linear system solver structure */\n");
   sprintf(name, "%slinsys_L", prefix);
-  GENERATE_ERROR(write_csc(f, linsys->L, name))
+  GENERATE_ERROR(write_csc(f, linsys->L, name, rom, rom, fp))
   sprintf(name, "%slinsys_Dinv", prefix);
-  GENERATE_ERROR(write_vecf(f, linsys->Dinv, n+m, name))
+  GENERATE_ERROR(write_vecf(f, linsys->Dinv, n+m, name, rom, fp))
   sprintf(name, "%slinsys_P", prefix);
-  GENERATE_ERROR(write_veci(f, linsys->P, n+m, name))
+  GENERATE_ERROR(write_veci(f, linsys->P, n+m, name, 1, fp))
   fprintf(f, "OSQPFloat %slinsys_bp[%d];\n",  prefix, n+m);
   fprintf(f, "OSQPFloat %slinsys_sol[%d];\n", prefix, n+m);
+  fp->ram_float += 2*(n+m);
 
   if (linsys->rho_inv_vec) {
     sprintf(name, "%slinsys_rho_inv_vec", prefix);
-    GENERATE_ERROR(write_vecf(f, linsys->rho_inv_vec, m, name))
+    GENERATE_ERROR(write_vecf(f, linsys->rho_inv_vec, m, name, rom, fp))
   }
 
   if (embedded > 1) {
+    /* The factorization changes the values of the KKT matrix only */
     sprintf(name, "%slinsys_KKT", prefix);
-    GENERATE_ERROR(write_csc(f, linsys->KKT, name))
+    GENERATE_ERROR(write_csc(f, linsys->KKT, name, 1, 0, fp))
     sprintf(name, "%slinsys_PtoKKT", prefix);
-    GENERATE_ERROR(write_veci(f, linsys->PtoKKT, data->P->csc->p[n], name))
+    GENERATE_ERROR(write_veci(f, linsys->PtoKKT, data->P->csc->p[n], name, 1, fp))
     sprintf(name, "%slinsys_AtoKKT", prefix);
-    GENERATE_ERROR(write_veci(f, linsys->AtoKKT, data->A->csc->p[n], name))
+    GENERATE_ERROR(write_veci(f, linsys->AtoKKT, data->A->csc->p[n], name, 1, fp))
     sprintf(name, "%slinsys_rhotoKKT", prefix);
-    GENERATE_ERROR(write_veci(f, linsys->rhotoKKT, m, name))
+    GENERATE_ERROR(write_veci(f, linsys->rhotoKKT, m, name, 1, fp))
     sprintf(name, "%slinsys_D", prefix);
-    GENERATE_ERROR(write_vecf(f, linsys->D, n+m, name))
+    GENERATE_ERROR(write_vecf(f, linsys->D, n+m, name, 0, fp))
     sprintf(name, "%slinsys_etree", prefix);
-    GENERATE_ERROR(write_veci(f, linsys->etree, n+m, name))
+    GENERATE_ERROR(write_veci(f, linsys->etree, n+m, name, 1, fp))
     sprintf(name, "%slinsys_Lnz", prefix);
-    GENERATE_ERROR(write_veci(f, linsys->Lnz, n+m, name))
+    GENERATE_ERROR(write_veci(f, linsys->Lnz, n+m, name, 1, fp))
     fprintf(f, "QDLDL_int   %slinsys_iwork[%d];\n", prefix, 3*(n+m));
     fprintf(f, "QDLDL_bool  %slinsys_bwork[%d];\n", prefix, n+m);
     fprintf(f, "QDLDL_float %slinsys_fwork[%d];\n", prefix, n+m);
+    fp->ram_int   += 3*(n+m);
+    fp->ram_bytes += n+m;
+    fp->ram_float += n+m;
+  }
+
+  if (ladder_n > 0) {
+    fprintf(f, "OSQPFloat* %slinsys_L_x_ladder[%d] = {\n", prefix, ladder_n);
+    for (i = 0; i < ladder_n; i++) {
+      if (i == ladder_k) fprintf(f, "  (OSQPFloat*)%slinsys_L_x,\n", prefix);
+      else               fprintf(f, "  (OSQPFloat*)%srho_ladder_L_x_%d,\n", prefix, i);
+    }
+    fprintf(f, "};\n");
+    fprintf(f, "OSQPFloat* %slinsys_Dinv_ladder[%d] = {\n", prefix, ladder_n);
+    for (i = 0; i < ladder_n; i++) {
+      if (i == ladder_k) fprintf(f, "  (OSQPFloat*)%slinsys_Dinv,\n", prefix);
+      else               fprintf(f, "  (OSQPFloat*)%srho_ladder_Dinv_%d,\n", prefix, i);
+    }
+    fprintf(f, "};\n");
+  }
+
+  /* The fixed-point ADMM step of the workspace runs the solve itself */
+  if (defines->unroll_enable && !defines->fixed_point_enable) {
+    GENERATE_ERROR(write_ldl_solve_unrolled(f, linsys, prefix))
   }
 
   fprintf(f, "qdldl_solver %slinsys = {\n", prefix);
@@ -397,17 +1338,23 @@ static OSQPInt write_linsys(FILE*               f,
   fprintf(f, "  &warm_start_linsys_solver_qdldl,\n");
   if (embedded > 1) {
     fprintf(f, "  &update_linsys_solver_matrices_qdldl,\n");
-    fprintf(f, "  &update_linsys_solver_rho_vec_qdldl,\n");
   }
+  fprintf(f, "  &update_linsys_solver_rho_vec_qdldl,\n");
   fprintf(f, "  %d,\n", linsys->nthreads);
+  if (defines->unroll_enable && !defines->fixed_point_enable) {
+    fprintf(f, "  &%slinsys_ldl_solve,\n", prefix);
+  }
+  else {
+    fprintf(f, "  OSQP_NULL,\n");
+  }
   fprintf(f, "  &%slinsys_L,\n", prefix);
-  fprintf(f, "  %slinsys_Dinv,\n", prefix);
-  fprintf(f, "  %slinsys_P,\n", prefix);
+  fprintf(f, "  %s%slinsys_Dinv,\n", ROM_CAST(rom, "OSQPFloat"), prefix);
+  fprintf(f, "  (OSQPInt*)%slinsys_P,\n", prefix);
   fprintf(f, "  %slinsys_bp,\n", prefix);
   fprintf(f, "  %slinsys_sol,\n", prefix);
 
   if (linsys->rho_inv_vec) {
-    fprintf(f, "  %slinsys_rho_inv_vec,\n", prefix);
+    fprintf(f, "  %s%slinsys_rho_inv_vec,\n", ROM_CAST(rom, "OSQPFloat"), prefix);
   }
   else {
     fprintf(f, "  OSQP_NULL,\n", prefix);
@@ -419,16 +1366,37 @@ static OSQPInt write_linsys(FILE*               f,
   fprintf(f, "  %d,\n", m);
   if (embedded > 1) {
     fprintf(f, "  &%slinsys_KKT,\n", prefix);
-    fprintf(f, "  %slinsys_PtoKKT,\n", prefix);
-    fprintf(f, "  %slinsys_AtoKKT,\n", prefix);
-    fprintf(f, "  %slinsys_rhotoKKT,\n", prefix);
+    fprintf(f, "  (OSQPInt*)%slinsys_PtoKKT,\n", prefix);
+    fprintf(f, "  (OSQPInt*)%slinsys_AtoKKT,\n", prefix);
+    fprintf(f, "  (OSQPInt*)%slinsys_rhotoKKT,\n", prefix);
     fprintf(f, "  %slinsys_D,\n", prefix);
-    fprintf(f, "  %slinsys_etree,\n", prefix);
-    fprintf(f, "  %slinsys_Lnz,\n", prefix);
+    fprintf(f, "  (OSQPInt*)%slinsys_etree,\n", prefix);
+    fprintf(f, "  (OSQPInt*)%slinsys_Lnz,\n", prefix);
     fprintf(f, "  %slinsys_iwork,\n", prefix);
     fprintf(f, "  %slinsys_bwork,\n", prefix);
     fprintf(f, "  %slinsys_fwork,\n", prefix);
   }
+  if (embedded == 1) {
+    if (ladder_n > 0) {
+      fprintf(f, "  %d,\n", ladder_n);
+      fprintf(f, "  (OSQPFloat*)%srho_ladder,\n", prefix);
+      fprintf(f, "  %slinsys_L_x_ladder,\n", prefix);
+      fprintf(f, "  %slinsys_Dinv_ladder,\n", prefix);
+      if (linsys->rho_inv_vec) {
+        fprintf(f, "  %srho_ladder_rho_inv_vec,\n", prefix);
+      }
+      else {
+        fprintf(f, "  OSQP_NULL,\n");
+      }
+    }
+    else {
+      fprintf(f, "  0,\n");
+      fprintf(f, "  OSQP_NULL,\n");
+      fprintf(f, "  OSQP_NULL,\n");
+      fprintf(f, "  OSQP_NULL,\n");
+      fprintf(f, "  OSQP_NULL,\n");
+    }
+  }
   fprintf(f, "};\n\n");
 
   return exitflag;
@@ -439,41 +1407,57 @@ static OSQPInt write_linsys(FILE*               f,
 * Workspace
 ************/
 
-static OSQPInt write_workspace(FILE*             f,
-                               const OSQPSolver* solver,
-                               OSQPInt           n,
-                               OSQPInt           m,
-                               const char*       prefix,
-                               OSQPInt           embedded) {
+static OSQPInt write_workspace(FILE*                     f,
+                               OSQPSolver*               solver,
+                               OSQPInt                   n,
+                               OSQPInt                   m,
+                               const char*               prefix,
+                               const OSQPCodegenDefines* defines,
+                               codegen_footprint*        fp) {
 
   OSQPInt exitflag = OSQP_NO_ERROR;
+  OSQPInt embedded = defines->embedded_mode;
+  OSQPInt ladder_n, ladder_k;
+  OSQPInt rom_rho;
   char name[MAX_VAR_LENGTH];
   const OSQPWorkspace *work = solver->work;
 
   if (!work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
 
-  PROPAGATE_ERROR(write_data(f, work->data, prefix))
-  PROPAGATE_ERROR(write_linsys(f, (qdldl_solver *)work->linsys_solver, work->data, prefix, embedded))
+  if (defines->fixed_point_enable) {
+    write_fixed_point_helpers(f, n+m, &fp[FOOTPRINT_WORK]);
+  }
+
+  PROPAGATE_ERROR(write_data(f, work->data, prefix, defines, &fp[FOOTPRINT_DATA]))
+  PROPAGATE_ERROR(write_rho_ladder(f, solver, prefix, defines, &ladder_n, &ladder_k, &fp[FOOTPRINT_RHO_LADDER]))
+  PROPAGATE_ERROR(write_linsys(f, (qdldl_solver *)work->linsys_solver, work->data, prefix, defines, ladder_n, ladder_k, &fp[FOOTPRINT_LINSYS]))
+
+  /* rho_vec only changes in embedded mode 1 if rho moves along a ladder */
+  rom_rho = (embedded == 1) && (ladder_n == 0);
 
   if (solver->settings->rho_is_vec) {
     sprintf(name, "%swork_rho_vec", prefix);
-    GENERATE_ERROR(write_OSQPVectorf(f, work->rho_vec, name))
+    GENERATE_ERROR(write_OSQPVectorf(f, work->rho_vec, name, rom_rho, &fp[FOOTPRINT_WORK]))
     sprintf(name, "%swork_rho_inv_vec", prefix);
-    GENERATE_ERROR(write_OSQPVectorf(f, work->rho_inv_vec, name))
+    GENERATE_ERROR(write_OSQPVectorf(f, work->rho_inv_vec, name, rom_rho, &fp[FOOTPRINT_WORK]))
 
     if (embedded > 1) {
       sprintf(name, "%swork_constr_type", prefix);
-      GENERATE_ERROR(write_OSQPVectori(f, work->constr_type, name))
+      GENERATE_ERROR(write_OSQPVectori(f, work->constr_type, name, &fp[FOOTPRINT_WORK]))
     }
   }
 
   /* Initialize x,y,z as we usually want to warm start the iterates */
   sprintf(name, "%swork_x", prefix);
-  GENERATE_ERROR(write_OSQPVectorf(f, work->x, name))
+  GENERATE_ERROR(write_OSQPVectorf(f, work->x, name, 0, &fp[FOOTPRINT_WORK]))
   sprintf(name, "%swork_y", prefix);
-  GENERATE_ERROR(write_OSQPVectorf(f, work->y, name))
+  GENERATE_ERROR(write_OSQPVectorf(f, work->y, name, 0, &fp[FOOTPRINT_WORK]))
   sprintf(name, "%swork_z", prefix);
-  GENERATE_ERROR(write_OSQPVectorf(f, work->z, name))
+  GENERATE_ERROR(write_OSQPVectorf(f, work->z, name, 0, &fp[FOOTPRINT_WORK]))
+
+  /* Iterates and temporary vectors below */
+  fp[FOOTPRINT_WORK].ram_float += 7*n + 5*m;
+  if (embedded > 1) fp[FOOTPRINT_WORK].ram_float += 2*n + m;
 
   fprintf(f, "OSQPFloat   %swork_xz_tilde_val[%d];\n", prefix, n+m);
   fprintf(f, "OSQPVectorf %swork_xz_tilde = {\n  %swork_xz_tilde_val,\n  %d\n};\n", prefix, prefix, n+m);
@@ -530,7 +1514,11 @@ static OSQPInt write_workspace(FILE*             f,
   }
 
   if (solver->settings->scaling) {
-    PROPAGATE_ERROR(write_scaling(f, work->scaling, prefix))
+    PROPAGATE_ERROR(write_scaling(f, work->scaling, prefix, embedded == 1, &fp[FOOTPRINT_SCALING]))
+  }
+
+  if (defines->fixed_point_enable) {
+    PROPAGATE_ERROR(write_admm_step_fixed(f, solver, prefix, &fp[FOOTPRINT_WORK]))
   }
   
   fprintf(f, "/* Define the workspace structure */\n");
@@ -589,32 +1577,98 @@ static OSQPInt write_workspace(FILE*             f,
   fprintf(f, "  (OSQPFloat)0.0,\n"); // scaled_prim_res
   fprintf(f, "  (OSQPFloat)0.0,\n"); // scaled_dual_res
   fprintf(f, "  (OSQPFloat)%.20f,\n", work->rho_inv);
+  if (embedded == 1) {
+    fprintf(f, "  %d,\n", ladder_n);
+    fprintf(f, "  %d,\n", ladder_k);
+    if (ladder_n > 0) {
+      fprintf(f, "  (OSQPFloat*)%srho_ladder,\n", prefix);
+    }
+    else {
+      fprintf(f, "  OSQP_NULL,\n");
+    }
+    if (ladder_n > 0 && solver->settings->rho_is_vec) {
+      fprintf(f, "  %srho_ladder_rho_vec,\n", prefix);
+      fprintf(f, "  %srho_ladder_rho_inv_vec,\n", prefix);
+    }
+    else {
+      fprintf(f, "  OSQP_NULL,\n");
+      fprintf(f, "  OSQP_NULL,\n");
+    }
+    if (defines->fixed_point_enable) {
+      fprintf(f, "  &%sadmm_step,\n", prefix);
+    }
+    else {
+      fprintf(f, "  OSQP_NULL,\n");
+    }
+  }
   fprintf(f, "};\n\n");
 
   return exitflag;
 }
 
 
+/*********************
+* Memory footprint
+**********************/
+
+/* Report the arrays of every structure in read-only and in read-write memory.
+ * The sizes of OSQPFloat and OSQPInt are the ones of the target, so they are
+ * counted in entries and the bytes are left to the sizeof of the target.
+ */
+static void write_footprint(FILE*                    f,
+                            const codegen_footprint* fp) {
+
+  OSQPInt i;
+  codegen_footprint total = {0};
+
+  fprintf(f, "\n/*\n");
+  fprintf(f, " * Memory footprint of the arrays in numbers of OSQPFloat and OSQPInt entries,\n");
+  fprintf(f, " * and in bytes for the arrays of other types. The structures pointing to\n");
+  fprintf(f, " * them are not included.\n");
+  fprintf(f, " *\n");
+  fprintf(f, " *   %-22s %10s %10s %10s %10s %10s\n", "structure",
+          "ROM float", "ROM int", "RAM float", "RAM int", "RAM bytes");
+  for (i = 0; i < FOOTPRINT_COUNT; i++) {
+    total.rom_float += fp[i].rom_float;
+    total.rom_int   += fp[i].rom_int;
+    total.ram_float += fp[i].ram_float;
+    total.ram_int   += fp[i].ram_int;
+    total.ram_bytes += fp[i].ram_bytes;
+    fprintf(f, " *   %-22s %10d %10d %10d %10d %10d\n", FOOTPRINT_NAME[i],
+            fp[i].rom_float, fp[i].rom_int, fp[i].ram_float, fp[i].ram_int, fp[i].ram_bytes);
+  }
+  fprintf(f, " *   %-22s %10d %10d %10d %10d %10d\n", "total",
+          total.rom_float, total.rom_int, total.ram_float, total.ram_int, total.ram_bytes);
+  fprintf(f, " *\n");
+  fprintf(f, " * ROM bytes: %d * sizeof(OSQPFloat) + %d * sizeof(OSQPInt)\n",
+          total.rom_float, total.rom_int);
+  fprintf(f, " * RAM bytes: %d * sizeof(OSQPFloat) + %d * sizeof(OSQPInt) + %d\n",
+          total.ram_float, total.ram_int, total.ram_bytes);
+  fprintf(f, " */\n");
+}
+
+
 /*********
 * Solver
 **********/
 
-static OSQPInt write_solver(FILE*             f,
-                            const OSQPSolver* solver,
-                            const char*       prefix,
-                            OSQPInt           embedded) {
+static OSQPInt write_solver(FILE*                     f,
+                            OSQPSolver*               solver,
+                            const char*               prefix,
+                            const OSQPCodegenDefines* defines) {
 
   if (!solver) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
 
   OSQPInt exitflag = OSQP_NO_ERROR;
+  codegen_footprint fp[FOOTPRINT_COUNT] = {{0}};
 
   OSQPInt n = solver->work->data->n;
   OSQPInt m = solver->work->data->m;
 
-  PROPAGATE_ERROR(write_settings(f, solver->settings, prefix))
-  PROPAGATE_ERROR(write_solution(f, n, m, prefix))
+  PROPAGATE_ERROR(write_settings(f, solver->settings, prefix, defines))
+  PROPAGATE_ERROR(write_solution(f, n, m, prefix, &fp[FOOTPRINT_SOLUTION]))
   PROPAGATE_ERROR(write_info(f, solver->info, prefix))
-  PROPAGATE_ERROR(write_workspace(f, solver, n, m, prefix, embedded))
+  PROPAGATE_ERROR(write_workspace(f, solver, n, m, prefix, defines, fp))
 
   fprintf(f, "/* Define the solver structure */\n");
   fprintf(f, "OSQPSolver %ssolver = {\n", prefix);
@@ -624,6 +1678,8 @@ static OSQPInt write_solver(FILE*             f,
   fprintf(f, "  &%swork\n", prefix);
   fprintf(f, "};\n");
 
+  write_footprint(f, fp);
+
   return exitflag;
 }
 
@@ -632,14 +1688,142 @@ static OSQPInt write_solver(FILE*             f,
 * Codegen API
 **************/
 
-OSQPInt codegen_inc(OSQPSolver* solver,
-                    const char* output_dir,
-                    const char* file_prefix) {
+/* Operations of the straight-line product y = alpha*M*x + beta*y (M' if
+ * transpose) with ny entries of y and nx of x. A row of y with e entries
+ * takes 2e - 1 operations for its sum and 3 to update y, with the sum in
+ * integers and 4 in floating point in fixed point, and an empty row 1. The
+ * fixed-point product also converts x to integers.
+ */
+static void csc_product_ops(const OSQPCscMatrix* M,
+                            OSQPInt              symmetric,
+                            OSQPInt              transpose,
+                            OSQPInt              fixed,
+                            OSQPInt*             float_ops,
+                            OSQPInt*             int_ops) {
+
+  OSQPInt  ny = (symmetric || transpose) ? M->n : M->m;
+  OSQPInt  nx = (symmetric || transpose) ? M->m : M->n;
+  OSQPInt  ne = 0;
+  OSQPInt  nr = 0;
+  OSQPInt  j, k;
+  OSQPInt* row = (OSQPInt*)c_calloc(ny, sizeof(OSQPInt));
+
+  if (!row) return;
+
+  /* Entries and rows of y that have any, using the diagonal of a symmetric
+   * matrix once and its other entries twice */
+  for (j = 0; j < M->n; j++) {
+    for (k = M->p[j]; k < M->p[j+1]; k++) {
+      if (symmetric && M->i[k] != j) {
+        row[M->i[k]] = row[j] = 1;
+        ne += 2;
+      }
+      else {
+        row[transpose ? j : M->i[k]] = 1;
+        ne += 1;
+      }
+    }
+  }
+  for (j = 0; j < ny; j++) nr += row[j];
+  c_free(row);
+
+  if (fixed) {
+    *float_ops += 4*nr + (ny - nr);
+    *int_ops   += 2*ne - nr;
+    if (ne > 0) *float_ops += 1 + (nx + 3);
+  }
+  else {
+    *float_ops += 2*ne + 2*nr + (ny - nr);
+  }
+}
+
+/* Arithmetic operations of an ADMM step and of a product with each of P, A
+ * and A' in the generated code, counting the additions, subtractions,
+ * multiplications, divisions and shifts and not the comparisons and the
+ * conversions. The scales of fixed point count their loops once, as when they
+ * do not move. The floating-point step is the straight-line KKT solve and the
+ * vector operations of the library around it, 7n + 17m (one more m for
+ * rho_vec) and 3 for 1 - alpha. The test of the fixed-point option counts the
+ * same operations in the generated code.
+ */
+static OSQPInt codegen_ops(const OSQPSolver*         solver,
+                           const OSQPCodegenDefines* defines,
+                           OSQPInt*                  step_ops,
+                           OSQPInt*                  product_ops) {
+
+  const OSQPCscMatrix* P      = solver->work->data->P->csc;
+  const OSQPCscMatrix* A      = solver->work->data->A->csc;
+  const qdldl_solver*  linsys = (qdldl_solver*)solver->work->linsys_solver;
+
+  OSQPInt    exitflag = OSQP_NO_ERROR;
+  OSQPInt    n        = solver->work->data->n;
+  OSQPInt    m        = solver->work->data->m;
+  OSQPInt    nL       = linsys->L->n;
+  OSQPInt    nnzL     = linsys->L->p[nL];
+  OSQPInt    i, nk;
+  OSQPInt*   g;
+  OSQPInt*   h;
+  OSQPInt*   cls;
+  OSQPFloat* rho;
+  OSQPFloat* rinv;
+
+  step_ops[0] = step_ops[1] = 0;
+  product_ops[0] = product_ops[1] = 0;
+
+  csc_product_ops(P, 1, 0, defines->fixed_point_enable, &product_ops[0], &product_ops[1]);
+  csc_product_ops(A, 0, 0, defines->fixed_point_enable, &product_ops[0], &product_ops[1]);
+  csc_product_ops(A, 0, 1, defines->fixed_point_enable, &product_ops[0], &product_ops[1]);
+
+  if (!defines->fixed_point_enable) {
+    step_ops[0] = 4*nnzL + nL + 7*n + 17*m + 3;
+    if (solver->settings->rho_is_vec) step_ops[0] += m;
+    return exitflag;
+  }
+
+  g    = (OSQPInt*)c_malloc((nL + 1) * sizeof(OSQPInt));
+  h    = (OSQPInt*)c_malloc((nL + 1) * sizeof(OSQPInt));
+  cls  = (OSQPInt*)c_malloc((m + 1) * sizeof(OSQPInt));
+  rho  = (OSQPFloat*)c_malloc((m + 1) * sizeof(OSQPFloat));
+  rinv = (OSQPFloat*)c_malloc((m + 1) * sizeof(OSQPFloat));
+  if (!g || !h || !cls || !rho || !rinv) {
+    exitflag = osqp_error(OSQP_MEM_ALLOC_ERROR);
+    goto exit;
+  }
+  exitflag = ldl_fixed_exponents(linsys, g, h);
+  if (exitflag) goto exit;
+  nk = rho_classes(solver, cls, rho, rinv);
+
+  /* Scale, relaxation and output of x, z and y in floating point */
+  step_ops[0] = 4*n + 4;
+  if (m > 0) step_ops[0] += 6*m + 2*nk;
+
+  /* Right-hand side, substitutions, shifts, z tilde and relaxation */
+  step_ops[1] = 1 + 4*n + m + 4*nnzL + 6*nL + (1 + nL + n + 2*m) + 1 + 6*n + 6*m;
+  for (i = 0; i < nL; i++) step_ops[1] += (h[i] != 0);
+  if (m > 0) step_ops[1] += 5*m + (1 + nL + n + 2*m) + 1;
+
+exit:
+  c_free(g);
+  c_free(h);
+  c_free(cls);
+  c_free(rho);
+  c_free(rinv);
+
+  return exitflag;
+}
+
+OSQPInt codegen_inc(OSQPSolver*               solver,
+                    const char*               output_dir,
+                    const char*               file_prefix,
+                    const OSQPCodegenDefines* defines) {
 
   char fname[FILE_LENGTH], hfname[PATH_LENGTH], incGuard[FILE_LENGTH];
+  char opsPrefix[FILE_LENGTH];
   FILE *incFile;
   time_t now;
   OSQPInt i = 0;
+  OSQPInt exitflag;
+  OSQPInt step_ops[2], product_ops[2];
 
   sprintf(fname,  "%sworkspace", file_prefix);
   sprintf(hfname, "%s%s.h", output_dir, fname);
@@ -670,6 +1854,22 @@ OSQPInt codegen_inc(OSQPSolver* solver,
   /* Include required headers */
   fprintf(incFile, "#include \"osqp_api_types.h\"\n\n");
 
+  /* Cost of an iteration of the straight-line code, to compare the arithmetic options */
+  if (defines->unroll_enable) {
+    exitflag = codegen_ops(solver, defines, step_ops, product_ops);
+    if (exitflag) {
+      fclose(incFile);
+      return exitflag;
+    }
+    for (i = 0; file_prefix[i]; i++) opsPrefix[i] = toupper(file_prefix[i]);
+    opsPrefix[i] = 0;
+    fprintf(incFile, "/* Operations of an ADMM step and of a product with each of P, A and A' */\n");
+    fprintf(incFile, "#define %sSTEP_FLOAT_OPS %d\n", opsPrefix, step_ops[0]);
+    fprintf(incFile, "#define %sSTEP_INT_OPS %d\n", opsPrefix, step_ops[1]);
+    fprintf(incFile, "#define %sPRODUCT_FLOAT_OPS %d\n", opsPrefix, product_ops[0]);
+    fprintf(incFile, "#define %sPRODUCT_INT_OPS %d\n\n", opsPrefix, product_ops[1]);
+  }
+
   fprintf(incFile, "#ifdef __cplusplus\n");
   fprintf(incFile, "extern \"C\" {\n");
   fprintf(incFile, "#endif\n\n");
@@ -690,10 +1890,10 @@ OSQPInt codegen_inc(OSQPSolver* solver,
 }
 
 
-OSQPInt codegen_src(OSQPSolver* solver,
-                    const char* output_dir,
-                    const char* file_prefix,
-                    OSQPInt     embedded) {
+OSQPInt codegen_src(OSQPSolver*               solver,
+                    const char*               output_dir,
+                    const char*               file_prefix,
+                    const OSQPCodegenDefines* defines) {
 
   OSQPInt exitflag = OSQP_NO_ERROR;
   char fname[PATH_LENGTH], cfname[PATH_LENGTH];
@@ -717,12 +1917,22 @@ OSQPInt codegen_src(OSQPSolver* solver,
   fprintf(srcFile, " */\n\n");
 
   /* Include required headers */
+  if (defines->fixed_point_enable) {
+    fprintf(srcFile, "#include <stdint.h>\n\n");
+  }
   fprintf(srcFile, "#include \"types.h\"\n");
   fprintf(srcFile, "#include \"algebra_impl.h\"\n");
   fprintf(srcFile, "#include \"qdldl_interface.h\"\n\n");
 
+  /* Data that never changes is const and can go to a section of its own */
+  fprintf(srcFile, "/* Define OSQP_CODEGEN_ROM to place the constant data in a section, e.g.\n");
+  fprintf(srcFile, " * __attribute__((section(\".osqp_rom\"))) */\n");
+  fprintf(srcFile, "#ifndef OSQP_CODEGEN_ROM\n");
+  fprintf(srcFile, "#define OSQP_CODEGEN_ROM\n");
+  fprintf(srcFile, "#endif\n\n");
+
   /* Write the workspace variables to file */
-  exitflag = write_solver(srcFile, solver, file_prefix, embedded);
+  exitflag = write_solver(srcFile, solver, file_prefix, defines);
 
   /* Close header file */
   fclose(srcFile);
@@ -731,11 +1941,13 @@ OSQPInt codegen_src(OSQPSolver* solver,
 }
 
 
-OSQPInt codegen_defines(const char*         output_dir,
+OSQPInt codegen_defines(OSQPSolver*         solver,
+                        const char*         output_dir,
                         OSQPCodegenDefines* defines) {
   char cfname[PATH_LENGTH];
   FILE *incFile;
   time_t now;
+  OSQPInt block, r, t;
 
   sprintf(cfname,  "%sosqp_configure.h", output_dir);
 
@@ -782,6 +1994,26 @@ OSQPInt codegen_defines(const char*         output_dir,
     fprintf(incFile, "#define OSQP_ENABLE_INTERRUPT\n\n");
   }
 
+  /* Write out the dimensions, and gcd(n, m) as the block of the vector loops */
+  if (defines->fixed_dims_enable == 1) {
+    block = solver->work->data->n;
+    r     = solver->work->data->m;
+    while (r) {
+      t     = block % r;
+      block = r;
+      r     = t;
+    }
+    fprintf(incFile, "#define OSQP_CODEGEN_N %d\n", solver->work->data->n);
+    fprintf(incFile, "#define OSQP_CODEGEN_M %d\n", solver->work->data->m);
+    fprintf(incFile, "#define OSQP_CODEGEN_BLOCK %d\n\n", block);
+
+    /* Coprime dimensions leave nothing to unroll */
+    if (block == 1 && solver->settings->verbose) {
+      c_print("Fixed dimensions: n = %i and m = %i are coprime, ", (int)solver->work->data->n, (int)solver->work->data->m);
+      c_print("the vector loops run over blocks of 1 entry\n");
+    }
+  }
+
   /* Write out the type of floating-point number to use */
   if (defines->float_type == 1) {
     fprintf(incFile, "#define OSQP_USE_FLOAT\n\n");
@@ -0,0 +1,653 @@
+#include "components.h"
+#include "auxil.h"
+#include "csc_utils.h"
+#include "error.h"
+#include "printing.h"
+#include "util.h"
+
+#ifdef OSQP_ENABLE_PROFILING
+# include "timing.h"
+#endif
+
+#ifdef OSQP_ENABLE_INTERRUPT
+# include "interrupt.h"
+#endif
+
+/* The blocks are packed into at most this many subproblems */
+#define COMPONENTS_MAX (64)
+
+/* Statuses of the subproblems from the best to the worst one */
+static const OSQPInt status_order[] = {
+  OSQP_SOLVED,
+  OSQP_SOLVED_INACCURATE,
+  OSQP_MAX_ITER_REACHED,
+  OSQP_TIME_LIMIT_REACHED,
+  OSQP_SIGINT,
+  OSQP_DUAL_INFEASIBLE_INACCURATE,
+  OSQP_PRIMAL_INFEASIBLE_INACCURATE,
+  OSQP_DUAL_INFEASIBLE,
+  OSQP_PRIMAL_INFEASIBLE,
+  OSQP_NON_CVX,
+  OSQP_UNSOLVED
+};
+#define STATUS_COUNT ((OSQPInt)(sizeof(status_order) / sizeof(status_order[0])))
+
+
+static OSQPInt status_rank(OSQPInt status) {
+  OSQPInt k;
+
+  for (k = 0; k < STATUS_COUNT; k++) {
+    if (status_order[k] == status) return k;
+  }
+  return STATUS_COUNT;
+}
+
+static OSQPInt find_root(OSQPInt* parent,
+                         OSQPInt  j) {
+  OSQPInt r = j;
+  OSQPInt t;
+
+  while (parent[r] != r) r = parent[r];
+
+  // Path compression
+  while (parent[j] != r) {
+    t         = parent[j];
+    parent[j] = r;
+    j         = t;
+  }
+  return r;
+}
+
+/* Join the blocks of i and j, keeping the smallest variable as the root */
+static void join(OSQPInt* parent,
+                 OSQPInt  i,
+                 OSQPInt  j) {
+  i = find_root(parent, i);
+  j = find_root(parent, j);
+  if (i < j)      parent[j] = i;
+  else if (j < i) parent[i] = j;
+}
+
+/* Turn the counts in start[1..n_comp] into the first positions */
+static void counts_to_start(OSQPInt* start,
+                            OSQPInt  n_comp) {
+  OSQPInt c;
+
+  start[0] = 0;
+  for (c = 0; c < n_comp; c++) start[c + 1] += start[c];
+}
+
+/* Copy a vector of the full problem into the vectors of the subproblems */
+static void split_vec(const OSQPInt*   comp_of,
+                      const OSQPInt*   idx_of,
+                      const OSQPInt*   start,
+                      OSQPInt          len,
+                      const OSQPFloat* v,
+                      OSQPFloat*       v_split) {
+  OSQPInt j;
+
+  for (j = 0; j < len; j++) v_split[start[comp_of[j]] + idx_of[j]] = v[j];
+}
+
+/* Group new matrix values by subproblem. On return the values of subproblem c
+ * are in val[cnt[c]] to val[cnt[c+1]-1], with their indices in idx. */
+static void split_values(const OSQPInt*   comp_of,
+                         const OSQPInt*   idx_of,
+                         OSQPInt          n_comp,
+                         const OSQPFloat* x_new,
+                         const OSQPInt*   x_new_idx,
+                         OSQPInt          n_new,
+                         OSQPInt*         cnt,
+                         OSQPFloat*       val,
+                         OSQPInt*         idx) {
+  OSQPInt c, k, e;
+
+  for (c = 0; c <= n_comp; c++) cnt[c] = 0;
+  if (!x_new) return;
+
+  for (k = 0; k < n_new; k++) {
+    e = x_new_idx ? x_new_idx[k] : k;
+    cnt[comp_of[e] + 1]++;
+  }
+  counts_to_start(cnt, n_comp);
+
+  // cnt[c] is used as the insertion point and ends at the start of c + 1
+  for (k = 0; k < n_new; k++) {
+    e = x_new_idx ? x_new_idx[k] : k;
+    c = comp_of[e];
+    val[cnt[c]] = x_new[k];
+    idx[cnt[c]] = idx_of[e];
+    cnt[c]++;
+  }
+  for (c = n_comp; c > 0; c--) cnt[c] = cnt[c - 1];
+  cnt[0] = 0;
+}
+
+
+OSQPInt components_setup(OSQPComponents**     compp,
+                         const OSQPCscMatrix* P,
+                         const OSQPCscMatrix* A,
+                         OSQPInt              m,
+                         OSQPInt              n) {
+
+  OSQPInt i, j, k, c, g, size, target, n_blocks;
+  OSQPInt nnzP = P->p[n];
+  OSQPInt nnzA = A->p[n];
+  OSQPInt* parent;
+  OSQPInt* row_var;
+  OSQPComponents* comp;
+
+  comp = c_calloc(1, sizeof(OSQPComponents));
+  *compp = comp;
+  if (!comp) return 1;
+
+  comp->n = n;
+  comp->m = m;
+
+  comp->var_comp = (OSQPInt *) c_malloc(n * sizeof(OSQPInt));
+  comp->var_idx  = (OSQPInt *) c_malloc(n * sizeof(OSQPInt));
+  comp->con_comp = (OSQPInt *) c_malloc(m * sizeof(OSQPInt));
+  comp->con_idx  = (OSQPInt *) c_malloc(m * sizeof(OSQPInt));
+  parent  = (OSQPInt *) c_malloc(n * sizeof(OSQPInt));
+  row_var = (OSQPInt *) c_malloc(m * sizeof(OSQPInt));
+  if (!comp->var_comp || !comp->var_idx || !parent ||
+      (m && (!comp->con_comp || !comp->con_idx || !row_var))) {
+    c_free(parent);
+    c_free(row_var);
+    return 1;
+  }
+
+  // Join the variables coupled by an entry of P or by a row of A
+  for (j = 0; j < n; j++) parent[j] = j;
+  for (j = 0; j < n; j++) {
+    for (k = P->p[j]; k < P->p[j + 1]; k++) join(parent, P->i[k], j);
+  }
+  for (i = 0; i < m; i++) row_var[i] = -1;
+  for (j = 0; j < n; j++) {
+    for (k = A->p[j]; k < A->p[j + 1]; k++) {
+      i = A->i[k];
+      if (row_var[i] < 0) row_var[i] = j;
+      else                join(parent, row_var[i], j);
+    }
+  }
+
+  // Number the blocks in the order of their first variable. The roots are
+  // the first variables, so var_comp of a root is set before it is needed.
+  n_blocks = 0;
+  for (j = 0; j < n; j++) {
+    k = find_root(parent, j);
+    comp->var_comp[j] = (k == j) ? n_blocks++ : comp->var_comp[k];
+  }
+  for (i = 0; i < m; i++) {
+    comp->con_comp[i] = (row_var[i] >= 0) ? comp->var_comp[row_var[i]] : 0;
+  }
+
+  // Measure the blocks, reusing parent, and pack consecutive blocks into
+  // subproblems of at least target variables and constraints
+  for (c = 0; c < n_blocks; c++) parent[c] = 0;
+  for (j = 0; j < n; j++) parent[comp->var_comp[j]]++;
+  for (i = 0; i < m; i++) parent[comp->con_comp[i]]++;
+
+  target = (n + m + COMPONENTS_MAX - 1) / COMPONENTS_MAX;
+  g    = 0;
+  size = 0;
+  for (c = 0; c < n_blocks; c++) {
+    size += parent[c];
+    parent[c] = g;
+    if (size >= target && c < n_blocks - 1) {
+      g++;
+      size = 0;
+    }
+  }
+  comp->n_comp = g + 1;
+
+  for (j = 0; j < n; j++) comp->var_comp[j] = parent[comp->var_comp[j]];
+  for (i = 0; i < m; i++) comp->con_comp[i] = parent[comp->con_comp[i]];
+  c_free(parent);
+  c_free(row_var);
+
+  if (comp->n_comp == 1) return 0;
+
+  comp->var_start = (OSQPInt *) c_calloc(comp->n_comp + 1, sizeof(OSQPInt));
+  comp->con_start = (OSQPInt *) c_calloc(comp->n_comp + 1, sizeof(OSQPInt));
+  comp->P_start   = (OSQPInt *) c_calloc(comp->n_comp + 1, sizeof(OSQPInt));
+  comp->A_start   = (OSQPInt *) c_calloc(comp->n_comp + 1, sizeof(OSQPInt));
+  comp->P_comp    = (OSQPInt *) c_malloc(nnzP * sizeof(OSQPInt));
+  comp->P_idx     = (OSQPInt *) c_malloc(nnzP * sizeof(OSQPInt));
+  comp->A_comp    = (OSQPInt *) c_malloc(nnzA * sizeof(OSQPInt));
+  comp->A_idx     = (OSQPInt *) c_malloc(nnzA * sizeof(OSQPInt));
+  comp->solvers   = (OSQPSolver **) c_calloc(comp->n_comp, sizeof(OSQPSolver*));
+  comp->flags     = (OSQPInt *) c_calloc(comp->n_comp, sizeof(OSQPInt));
+  comp->x_work    = (OSQPFloat *) c_malloc(n * sizeof(OSQPFloat));
+  comp->y_work    = (OSQPFloat *) c_malloc(m * sizeof(OSQPFloat));
+  comp->z_work    = (OSQPFloat *) c_malloc(m * sizeof(OSQPFloat));
+  comp->val_work  = (OSQPFloat *) c_malloc((nnzP + nnzA) * sizeof(OSQPFloat));
+  comp->idx_work  = (OSQPInt *) c_malloc((nnzP + nnzA) * sizeof(OSQPInt));
+  comp->cnt_work  = (OSQPInt *) c_calloc(2 * (comp->n_comp + 1), sizeof(OSQPInt));
+  if (!comp->var_start || !comp->con_start || !comp->P_start || !comp->A_start ||
+      !comp->solvers || !comp->flags || !comp->x_work || !comp->cnt_work)
+    return 1;
+  if (m && (!comp->y_work || !comp->z_work))
+    return 1;
+  if (nnzP && (!comp->P_comp || !comp->P_idx))
+    return 1;
+  if (nnzA && (!comp->A_comp || !comp->A_idx))
+    return 1;
+  if ((nnzP + nnzA) && (!comp->val_work || !comp->idx_work))
+    return 1;
+
+  // Index the variables, constraints and matrix entries within their
+  // subproblems, counting them in start[c + 1]
+  for (j = 0; j < n; j++) {
+    c = comp->var_comp[j];
+    comp->var_idx[j] = comp->var_start[c + 1]++;
+    for (k = P->p[j]; k < P->p[j + 1]; k++) {
+      comp->P_comp[k] = c;
+      comp->P_idx[k]  = comp->P_start[c + 1]++;
+    }
+    for (k = A->p[j]; k < A->p[j + 1]; k++) {
+      comp->A_comp[k] = c;
+      comp->A_idx[k]  = comp->A_start[c + 1]++;
+    }
+  }
+  for (i = 0; i < m; i++) {
+    c = comp->con_comp[i];
+    comp->con_idx[i] = comp->con_start[c + 1]++;
+  }
+  counts_to_start(comp->var_start, comp->n_comp);
+  counts_to_start(comp->con_start, comp->n_comp);
+  counts_to_start(comp->P_start,   comp->n_comp);
+  counts_to_start(comp->A_start,   comp->n_comp);
+
+  return 0;
+}
+
+
+OSQPInt components_setup_solvers(OSQPComponents*      comp,
+                                 const OSQPCscMatrix* P,
+                                 const OSQPFloat*     q,
+                                 const OSQPCscMatrix* A,
+                                 const OSQPFloat*     l,
+                                 const OSQPFloat*     u,
+                                 const OSQPSettings*  settings) {
+
+  OSQPInt c, j, k, n_c, m_c, exitflag;
+  OSQPInt n_comp = comp->n_comp;
+  OSQPCscMatrix** mats;
+  OSQPCscMatrix*  Pc;
+  OSQPCscMatrix*  Ac;
+  OSQPInt*        cntP = comp->cnt_work;
+  OSQPInt*        cntA = comp->cnt_work + comp->n_comp + 1;
+  OSQPSettings    sub_settings = *settings;
+
+  sub_settings.split_components = 0;
+  sub_settings.verbose          = 0;
+
+  // Subproblem c has P = mats[c] and A = mats[n_comp + c]
+  mats = (OSQPCscMatrix **) c_calloc(2 * n_comp, sizeof(OSQPCscMatrix*));
+  if (!mats) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+
+  exitflag = 0;
+  for (c = 0; c < n_comp; c++) {
+    n_c = comp->var_start[c + 1] - comp->var_start[c];
+    m_c = comp->con_start[c + 1] - comp->con_start[c];
+    mats[c]          = csc_spalloc(n_c, n_c, comp->P_start[c + 1] - comp->P_start[c], 1, 0);
+    mats[n_comp + c] = csc_spalloc(m_c, n_c, comp->A_start[c + 1] - comp->A_start[c], 1, 0);
+    if (!mats[c] || !mats[n_comp + c]) {
+      exitflag = osqp_error(OSQP_MEM_ALLOC_ERROR);
+      break;
+    }
+  }
+
+  if (!exitflag) {
+    // The columns of a subproblem come in the order of the full problem, so
+    // its matrices are filled column by column. cntP and cntA count the
+    // entries filled so far.
+    for (j = 0; j < comp->n; j++) {
+      c  = comp->var_comp[j];
+      Pc = mats[c];
+      Ac = mats[n_comp + c];
+      Pc->p[comp->var_idx[j]] = cntP[c];
+      Ac->p[comp->var_idx[j]] = cntA[c];
+      for (k = P->p[j]; k < P->p[j + 1]; k++) {
+        Pc->i[cntP[c]] = comp->var_idx[P->i[k]];
+        Pc->x[cntP[c]] = P->x[k];
+        cntP[c]++;
+      }
+      for (k = A->p[j]; k < A->p[j + 1]; k++) {
+        Ac->i[cntA[c]] = comp->con_idx[A->i[k]];
+        Ac->x[cntA[c]] = A->x[k];
+        cntA[c]++;
+      }
+    }
+    for (c = 0; c < n_comp; c++) {
+      mats[c]->p[mats[c]->n]                   = cntP[c];
+      mats[n_comp + c]->p[mats[n_comp + c]->n] = cntA[c];
+    }
+
+    split_vec(comp->var_comp, comp->var_idx, comp->var_start, comp->n, q, comp->x_work);
+    split_vec(comp->con_comp, comp->con_idx, comp->con_start, comp->m, l, comp->y_work);
+    split_vec(comp->con_comp, comp->con_idx, comp->con_start, comp->m, u, comp->z_work);
+
+    for (c = 0; c < n_comp && !exitflag; c++) {
+      exitflag = osqp_setup(&comp->solvers[c],
+                            mats[c], comp->x_work + comp->var_start[c],
+                            mats[n_comp + c],
+                            comp->y_work + comp->con_start[c],
+                            comp->z_work + comp->con_start[c],
+                            mats[n_comp + c]->m, mats[c]->n, &sub_settings);
+      if (!exitflag) comp->solvers[c]->work->is_component = 1;
+    }
+  }
+
+  for (c = 0; c < 2 * n_comp; c++) csc_spfree(mats[c]);
+  c_free(mats);
+
+  return exitflag;
+}
+
+
+void components_free(OSQPComponents* comp) {
+  OSQPInt c;
+
+  if (comp) {
+    if (comp->solvers) {
+      for (c = 0; c < comp->n_comp; c++) {
+        if (comp->solvers[c]) osqp_cleanup(comp->solvers[c]);
+      }
+    }
+    c_free(comp->var_comp);
+    c_free(comp->var_idx);
+    c_free(comp->var_start);
+    c_free(comp->con_comp);
+    c_free(comp->con_idx);
+    c_free(comp->con_start);
+    c_free(comp->P_comp);
+    c_free(comp->P_idx);
+    c_free(comp->P_start);
+    c_free(comp->A_comp);
+    c_free(comp->A_idx);
+    c_free(comp->A_start);
+    c_free(comp->solvers);
+    c_free(comp->flags);
+    c_free(comp->x_work);
+    c_free(comp->y_work);
+    c_free(comp->z_work);
+    c_free(comp->val_work);
+    c_free(comp->idx_work);
+    c_free(comp->cnt_work);
+    c_free(comp);
+  }
+}
+
+
+OSQPInt components_solve(OSQPSolver* solver) {
+
+  OSQPInt c, i, j, status, exitflag;
+  OSQPInt prim_cert, dual_cert;
+  OSQPComponents* comp     = solver->work->comp;
+  OSQPInfo*       info     = solver->info;
+  OSQPSolution*   solution = solver->solution;
+  OSQPSolver**    solvers  = comp->solvers;
+  OSQPInfo*       sub;
+
+#ifdef OSQP_ENABLE_PROFILING
+  OSQPFloat update_time = 0.0;
+
+  osqp_tic(solver->work->timer);
+#endif /* ifdef OSQP_ENABLE_PROFILING */
+
+#ifdef OSQP_ENABLE_INTERRUPT
+  // The subproblems only check the listener, the signal handler is process wide
+  osqp_start_interrupt_listener();
+#endif /* ifdef OSQP_ENABLE_INTERRUPT */
+
+#ifdef _OPENMP
+# pragma omp parallel for schedule(dynamic)
+#endif
+  for (c = 0; c < comp->n_comp; c++) {
+    comp->flags[c] = osqp_solve(solvers[c]);
+  }
+
+#ifdef OSQP_ENABLE_INTERRUPT
+  osqp_end_interrupt_listener();
+#endif /* ifdef OSQP_ENABLE_INTERRUPT */
+
+  exitflag = 0;
+  status   = OSQP_SOLVED;
+  info->status_polish  = solvers[0]->info->status_polish;
+  info->obj_val        = 0.0;
+  info->prim_res       = 0.0;
+  info->dual_res       = 0.0;
+  info->spmv_res_error = 0.0;
+  info->iter           = 0;
+  info->rho_updates    = 0;
+  info->rho_estimate   = solvers[0]->info->rho_estimate;
+  info->scaling_iter   = 0;
+#ifdef OSQP_ENABLE_PROFILING
+  info->polish_time    = 0.0;
+#endif /* ifdef OSQP_ENABLE_PROFILING */
+
+  for (c = 0; c < comp->n_comp; c++) {
+    sub = solvers[c]->info;
+    if (!exitflag) exitflag = comp->flags[c];
+    if (status_rank(sub->status_val) > status_rank(status)) status = sub->status_val;
+
+    // Polishing is successful only if it is on every subproblem
+    info->status_polish = c_min(info->status_polish, sub->status_polish);
+
+    info->obj_val        += sub->obj_val;
+    info->prim_res        = c_max(info->prim_res, sub->prim_res);
+    info->dual_res        = c_max(info->dual_res, sub->dual_res);
+    info->spmv_res_error  = c_max(info->spmv_res_error, sub->spmv_res_error);
+    info->rho_updates    += sub->rho_updates;
+    info->scaling_iter    = c_max(info->scaling_iter, sub->scaling_iter);
+
+    // The slowest subproblem determines the iterations and the rho estimate
+    if (sub->iter > info->iter) {
+      info->iter         = sub->iter;
+      info->rho_estimate = sub->rho_estimate;
+    }
+
+#ifdef OSQP_ENABLE_PROFILING
+    update_time       += sub->update_time;
+    info->polish_time  = c_max(info->polish_time, sub->polish_time);
+#endif /* ifdef OSQP_ENABLE_PROFILING */
+  }
+  update_status(info, status);
+
+  if (has_solution(info)) {
+    // Every subproblem has a solution
+    for (j = 0; j < comp->n; j++) {
+      c = comp->var_comp[j];
+      solution->x[j]             = solvers[c]->solution->x[comp->var_idx[j]];
+      solution->dual_inf_cert[j] = OSQP_NAN;
+    }
+    for (i = 0; i < comp->m; i++) {
+      c = comp->con_comp[i];
+      solution->y[i]             = solvers[c]->solution->y[comp->con_idx[i]];
+      solution->prim_inf_cert[i] = OSQP_NAN;
+    }
+  }
+  else {
+    // The certificate of an infeasible subproblem, padded with zeros, is a
+    // certificate of the full problem
+    prim_cert = (status == OSQP_PRIMAL_INFEASIBLE || status == OSQP_PRIMAL_INFEASIBLE_INACCURATE);
+    dual_cert = (status == OSQP_DUAL_INFEASIBLE   || status == OSQP_DUAL_INFEASIBLE_INACCURATE);
+    for (j = 0; j < comp->n; j++) {
+      c = comp->var_comp[j];
+      solution->x[j] = OSQP_NAN;
+      if (!dual_cert)
+        solution->dual_inf_cert[j] = OSQP_NAN;
+      else if (solvers[c]->info->status_val == OSQP_DUAL_INFEASIBLE ||
+               solvers[c]->info->status_val == OSQP_DUAL_INFEASIBLE_INACCURATE)
+        solution->dual_inf_cert[j] = solvers[c]->solution->dual_inf_cert[comp->var_idx[j]];
+      else
+        solution->dual_inf_cert[j] = 0.0;
+    }
+    for (i = 0; i < comp->m; i++) {
+      c = comp->con_comp[i];
+      solution->y[i] = OSQP_NAN;
+      if (!prim_cert)
+        solution->prim_inf_cert[i] = OSQP_NAN;
+      else if (solvers[c]->info->status_val == OSQP_PRIMAL_INFEASIBLE ||
+               solvers[c]->info->status_val == OSQP_PRIMAL_INFEASIBLE_INACCURATE)
+        solution->prim_inf_cert[i] = solvers[c]->solution->prim_inf_cert[comp->con_idx[i]];
+      else
+        solution->prim_inf_cert[i] = 0.0;
+    }
+  }
+
+#ifdef OSQP_ENABLE_PROFILING
+  info->solve_time  = osqp_toc(solver->work->timer);
+  info->update_time = update_time;
+  if (solver->work->first_run) {
+    info->run_time = info->setup_time + info->solve_time;
+    solver->work->first_run = 0;
+  }
+  else {
+    info->run_time = info->update_time + info->solve_time;
+  }
+#endif /* ifdef OSQP_ENABLE_PROFILING */
+
+#ifdef OSQP_ENABLE_PRINTING
+  if (solver->settings->verbose) print_footer(info, solver->settings->polishing);
+#endif /* ifdef OSQP_ENABLE_PRINTING */
+
+  return exitflag;
+}
+
+
+OSQPInt components_warm_start(OSQPComponents*  comp,
+                              const OSQPFloat* x,
+                              const OSQPFloat* y) {
+  OSQPInt c;
+  OSQPInt exitflag = 0;
+
+  if (x) split_vec(comp->var_comp, comp->var_idx, comp->var_start, comp->n, x, comp->x_work);
+  if (y) split_vec(comp->con_comp, comp->con_idx, comp->con_start, comp->m, y, comp->y_work);
+
+  for (c = 0; c < comp->n_comp && !exitflag; c++) {
+    exitflag = osqp_warm_start(comp->solvers[c],
+                               x ? comp->x_work + comp->var_start[c] : OSQP_NULL,
+                               y ? comp->y_work + comp->con_start[c] : OSQP_NULL);
+  }
+  return exitflag;
+}
+
+
+void components_cold_start(OSQPComponents* comp) {
+  OSQPInt c;
+
+  for (c = 0; c < comp->n_comp; c++) osqp_cold_start(comp->solvers[c]);
+}
+
+
+OSQPInt components_update_data_vec(OSQPComponents*  comp,
+                                   const OSQPFloat* q_new,
+                                   const OSQPFloat* l_new,
+                                   const OSQPFloat* u_new) {
+  OSQPInt c, i;
+  OSQPInt exitflag = 0;
+
+  // Check the bounds up front so that no subproblem is left half updated
+  if (l_new && u_new) {
+    for (i = 0; i < comp->m; i++) {
+      if (l_new[i] > u_new[i]) return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+    }
+  }
+
+  if (q_new) split_vec(comp->var_comp, comp->var_idx, comp->var_start, comp->n, q_new, comp->x_work);
+  if (l_new) split_vec(comp->con_comp, comp->con_idx, comp->con_start, comp->m, l_new, comp->y_work);
+  if (u_new) split_vec(comp->con_comp, comp->con_idx, comp->con_start, comp->m, u_new, comp->z_work);
+
+  for (c = 0; c < comp->n_comp && !exitflag; c++) {
+    exitflag = osqp_update_data_vec(comp->solvers[c],
+                                    q_new ? comp->x_work + comp->var_start[c] : OSQP_NULL,
+                                    l_new ? comp->y_work + comp->con_start[c] : OSQP_NULL,
+                                    u_new ? comp->z_work + comp->con_start[c] : OSQP_NULL);
+  }
+  return exitflag;
+}
+
+
+OSQPInt components_update_data_mat(OSQPComponents*  comp,
+                                   const OSQPFloat* Px_new,
+                                   const OSQPInt*   Px_new_idx,
+                                   OSQPInt          P_new_n,
+                                   const OSQPFloat* Ax_new,
+                                   const OSQPInt*   Ax_new_idx,
+                                   OSQPInt          A_new_n) {
+  OSQPInt c, nP, nA;
+  OSQPInt exitflag = 0;
+  OSQPInt nnzP     = comp->P_start[comp->n_comp];
+  OSQPInt nnzA     = comp->A_start[comp->n_comp];
+  OSQPInt* cntP    = comp->cnt_work;
+  OSQPInt* cntA    = comp->cnt_work + comp->n_comp + 1;
+
+  // Same checks as for the full problem, the entries are split below
+  if (P_new_n > nnzP || P_new_n < 0) {
+    c_eprint("new number of elements (%i) out of bounds for P (%i max)",
+             (int)P_new_n, (int)nnzP);
+    return 1;
+  }
+  if (Px_new_idx == OSQP_NULL && P_new_n != 0 && P_new_n != nnzP) {
+    c_eprint("index vector is required for partial updates of P");
+    return 1;
+  }
+  if (A_new_n > nnzA || A_new_n < 0) {
+    c_eprint("new number of elements (%i) out of bounds for A (%i max)",
+             (int)A_new_n, (int)nnzA);
+    return 2;
+  }
+  if (Ax_new_idx == OSQP_NULL && A_new_n != 0 && A_new_n != nnzA) {
+    c_eprint("index vector is required for partial updates of A");
+    return 2;
+  }
+
+  split_values(comp->P_comp, comp->P_idx, comp->n_comp, Px_new, Px_new_idx, P_new_n,
+               cntP, comp->val_work, comp->idx_work);
+  split_values(comp->A_comp, comp->A_idx, comp->n_comp, Ax_new, Ax_new_idx, A_new_n,
+               cntA, comp->val_work + nnzP, comp->idx_work + nnzP);
+
+  // Only the subproblems with new entries are updated
+  for (c = 0; c < comp->n_comp && !exitflag; c++) {
+    nP = cntP[c + 1] - cntP[c];
+    nA = cntA[c + 1] - cntA[c];
+    if (!nP && !nA) continue;
+    exitflag = osqp_update_data_mat(comp->solvers[c],
+                                    nP ? comp->val_work + cntP[c] : OSQP_NULL,
+                                    nP ? comp->idx_work + cntP[c] : OSQP_NULL, nP,
+                                    nA ? comp->val_work + nnzP + cntA[c] : OSQP_NULL,
+                                    nA ? comp->idx_work + nnzP + cntA[c] : OSQP_NULL, nA);
+  }
+  return exitflag;
+}
+
+
+OSQPInt components_update_settings(OSQPComponents*     comp,
+                                   const OSQPSettings* settings) {
+  OSQPInt      c;
+  OSQPInt      exitflag     = 0;
+  OSQPSettings sub_settings = *settings;
+
+  sub_settings.split_components = 0;
+  sub_settings.verbose          = 0;
+
+  for (c = 0; c < comp->n_comp && !exitflag; c++) {
+    exitflag = osqp_update_settings(comp->solvers[c], &sub_settings);
+  }
+  return exitflag;
+}
+
+
+OSQPInt components_update_rho(OSQPComponents* comp,
+                              OSQPFloat       rho_new) {
+  OSQPInt c;
+  OSQPInt exitflag = 0;
+
+  for (c = 0; c < comp->n_comp && !exitflag; c++) {
+    exitflag = osqp_update_rho(comp->solvers[c], rho_new);
+  }
+  return exitflag;
+}
@@ -0,0 +1,728 @@
+#include "dense.h"
+#include "bounds.h"
+#include "lin_alg.h"
+#include "csc_utils.h"
+
+/* Rows and columns of A with more than max(DENSE_MIN, sqrt(n + m)) entries are dense */
+#define DENSE_MIN (16)
+
+/* At most this many rows and columns are kept out of the KKT matrix */
+#define DENSE_MAX (32)
+
+/**
+ * Linear system solver wrapping the solver of the KKT system without the
+ * dense rows and columns of A. The function pointers follow the layout of
+ * LinSysSolver.
+ *
+ * The unknowns of the KKT system are split into the inner ones (x and the
+ * duals of the remaining variables and rows) and the dense ones (the dense
+ * variables followed by the duals of the dense rows):
+ *
+ *   [ K  B ] [u_in]   [r_in]
+ *   [ B' C ] [u_d ] = [r_d ]
+ *
+ * and u_d is found from the Schur complement S = C - B' K^-1 B.
+ */
+typedef struct dense dense_solver;
+
+struct dense {
+  enum osqp_linsys_solver_type type;
+
+  const char* (*name)(struct dense* self);
+
+  OSQPInt (*solve)(struct dense* self,
+                   OSQPVectorf*  b,
+                   OSQPInt       admm_iter);
+
+  void (*update_settings)(struct dense*       self,
+                          const OSQPSettings* settings);
+
+  void (*warm_start)(struct dense*      self,
+                     const OSQPVectorf* x);
+
+  OSQPInt (*adjoint_derivative)(struct dense* self);
+
+  void (*free)(struct dense* self);
+
+  OSQPInt (*update_matrices)(struct dense*     self,
+                             const OSQPMatrix* P,
+                             const OSQPInt*    Px_new_idx,
+                             OSQPInt           P_new_n,
+                             const OSQPMatrix* A,
+                             const OSQPInt*    Ax_new_idx,
+                             OSQPInt           A_new_n);
+
+  OSQPInt (*update_rho_vec)(struct dense*      self,
+                            const OSQPVectorf* rho_vec,
+                            OSQPFloat          rho_sc);
+
+  OSQPInt nthreads;
+
+  LinSysSolver* inner;    ///< solver of the KKT system without the dense rows and columns
+  OSQPInt       n;        ///< number of variables
+  OSQPInt       m;        ///< number of constraints
+  OSQPInt       n_in;     ///< number of variables of the inner system
+  OSQPInt       m_in;     ///< number of constraints of the inner system
+  OSQPInt       d_col;    ///< number of dense columns
+  OSQPInt       d;        ///< number of dense unknowns, columns first
+  OSQPInt*      col_map;  ///< inner variable of every variable, -k-1 for dense unknown k
+  OSQPInt*      row_map;  ///< inner row of every row, -k-1 for dense unknown k
+  OSQPInt*      d_idx;    ///< variable or row of every dense unknown
+  OSQPInt*      Pmap;     ///< entry of the inner P of every entry of P, -k-2 for entry k of B, -1 for C
+  OSQPInt*      Amap;     ///< entry of the inner A of every entry of A, -k-2 for entry k of B, -1 for C
+  OSQPMatrix*   P;        ///< P of the inner variables
+  OSQPMatrix*   A;        ///< A of the inner rows and variables
+  OSQPFloat     sigma;    ///< ADMM sigma on the diagonal of the dense variables
+  OSQPFloat*    rho;      ///< rho of every row
+  OSQPVectorf*  rho_vec;  ///< rho of the inner rows (OSQP_NULL for scalar rho)
+  OSQPInt*      Bp;       ///< column pointers of the coupling B of the inner and dense unknowns
+  OSQPInt*      Bi;       ///< inner unknown of every entry of B
+  OSQPFloat*    Bx;       ///< values of B
+  OSQPFloat*    W;        ///< K^-1 B, (n_in + m_in) x d column major
+  OSQPFloat*    C;        ///< block of the dense unknowns without the rho terms, d x d
+  OSQPFloat*    S;        ///< LU factors of the Schur complement, d x d
+  OSQPInt*      piv;      ///< row pivots of the LU factors
+  OSQPFloat*    rd;       ///< right-hand side and solution of the dense unknowns
+  OSQPVectorf*  b;        ///< right-hand side of the inner KKT system
+  OSQPFloat*    val_work; ///< size max(nnz(P), nnz(A), m)
+};
+
+
+/* LU factorization with partial pivoting of the d x d column major matrix S */
+static OSQPInt lu_factor(OSQPFloat* S,
+                         OSQPInt*   piv,
+                         OSQPInt    d) {
+
+  OSQPInt   i, j, k, p;
+  OSQPFloat t;
+
+  for (k = 0; k < d; k++) {
+    p = k;
+    for (i = k + 1; i < d; i++) {
+      if (c_absval(S[i + k*d]) > c_absval(S[p + k*d])) p = i;
+    }
+    piv[k] = p;
+    if (S[p + k*d] == 0.0) return 1;
+
+    if (p != k) {
+      for (j = 0; j < d; j++) {
+        t            = S[k + j*d];
+        S[k + j*d]   = S[p + j*d];
+        S[p + j*d]   = t;
+      }
+    }
+    for (i = k + 1; i < d; i++) {
+      S[i + k*d] /= S[k + k*d];
+    }
+    for (j = k + 1; j < d; j++) {
+      for (i = k + 1; i < d; i++) {
+        S[i + j*d] -= S[i + k*d] * S[k + j*d];
+      }
+    }
+  }
+  return 0;
+}
+
+/* Solve S x = b in place with the LU factors of S */
+static void lu_solve(const OSQPFloat* S,
+                     const OSQPInt*   piv,
+                     OSQPInt          d,
+                     OSQPFloat*       x) {
+
+  OSQPInt   i, k;
+  OSQPFloat t;
+
+  for (k = 0; k < d; k++) {
+    t = x[k]; x[k] = x[piv[k]]; x[piv[k]] = t;
+  }
+  for (k = 0; k < d; k++) {
+    for (i = k + 1; i < d; i++) x[i] -= S[i + k*d] * x[k];
+  }
+  for (k = d - 1; k >= 0; k--) {
+    x[k] /= S[k + k*d];
+    for (i = 0; i < k; i++) x[i] -= S[i + k*d] * x[k];
+  }
+}
+
+/* Copy the values of P and A into the inner matrices, B and C */
+static void set_values(dense_solver*     s,
+                       const OSQPMatrix* P,
+                       const OSQPMatrix* A) {
+
+  OSQPInt i, j, k, ci, cj, ri, cnt;
+  OSQPInt d = s->d;
+
+  const OSQPInt*   Pp = OSQPMatrix_get_p(P);
+  const OSQPInt*   Pi = OSQPMatrix_get_i(P);
+  const OSQPFloat* Px = OSQPMatrix_get_x(P);
+  const OSQPInt*   Ap = OSQPMatrix_get_p(A);
+  const OSQPInt*   Ai = OSQPMatrix_get_i(A);
+  const OSQPFloat* Ax = OSQPMatrix_get_x(A);
+
+  for (k = 0; k < s->Bp[d]; k++) s->Bx[k] = 0.0;
+  for (k = 0; k < d * d; k++) s->C[k] = 0.0;
+  for (k = 0; k < s->d_col; k++) s->C[k + k*d] = s->sigma;
+
+  cnt = 0;
+  for (j = 0; j < s->n; j++) {
+    cj = s->col_map[j];
+    for (k = Pp[j]; k < Pp[j + 1]; k++) {
+      ci = s->col_map[Pi[k]];
+      if (s->Pmap[k] >= 0) {
+        s->val_work[s->Pmap[k]] = Px[k];
+        cnt++;
+      }
+      else if (s->Pmap[k] < -1) {
+        s->Bx[-s->Pmap[k] - 2] += Px[k];
+      }
+      else {
+        s->C[(-ci - 1) + (-cj - 1) * d] += Px[k];
+        if (ci != cj) s->C[(-cj - 1) + (-ci - 1) * d] += Px[k];
+      }
+    }
+  }
+  OSQPMatrix_update_values(s->P, s->val_work, OSQP_NULL, cnt);
+
+  cnt = 0;
+  for (j = 0; j < s->n; j++) {
+    cj = s->col_map[j];
+    for (k = Ap[j]; k < Ap[j + 1]; k++) {
+      i  = Ai[k];
+      ri = s->row_map[i];
+      if (s->Amap[k] >= 0) {
+        s->val_work[s->Amap[k]] = Ax[k];
+        cnt++;
+      }
+      else if (s->Amap[k] < -1) {
+        s->Bx[-s->Amap[k] - 2] = Ax[k];
+      }
+      else {
+        s->C[(-cj - 1) + (-ri - 1) * d] = Ax[k];
+        s->C[(-ri - 1) + (-cj - 1) * d] = Ax[k];
+      }
+    }
+  }
+  OSQPMatrix_update_values(s->A, s->val_work, OSQP_NULL, cnt);
+}
+
+/* Store rho of every row and gather the rho of the inner rows */
+static void set_rho(dense_solver*      s,
+                    const OSQPVectorf* rho_vec,
+                    OSQPFloat          rho_sc) {
+
+  OSQPInt i;
+
+  const OSQPFloat* rho = rho_vec ? OSQPVectorf_data(rho_vec) : OSQP_NULL;
+  OSQPFloat*       inner_rho;
+
+  for (i = 0; i < s->m; i++) {
+    s->rho[i] = rho ? rho[i] : rho_sc;
+  }
+
+  if (s->rho_vec) {
+    inner_rho = OSQPVectorf_data(s->rho_vec);
+    for (i = 0; i < s->m; i++) {
+      if (s->row_map[i] >= 0) inner_rho[s->row_map[i]] = rho[i];
+    }
+  }
+}
+
+/* Inner solve of the KKT system returning the duals of the inner rows in place of z_tilde */
+static OSQPInt inner_solve(dense_solver* s,
+                           OSQPFloat*    rz,
+                           OSQPInt       admm_iter) {
+
+  OSQPInt    i, r;
+  OSQPInt    exitflag;
+  OSQPFloat* sb = OSQPVectorf_data(s->b);
+
+  for (r = 0; r < s->m_in; r++) rz[r] = sb[s->n_in + r];
+
+  exitflag = s->inner->solve(s->inner, s->b, admm_iter);
+
+  // z_tilde = r_z + nu / rho
+  for (i = 0; i < s->m; i++) {
+    r = s->row_map[i];
+    if (r >= 0) sb[s->n_in + r] = s->rho[i] * (sb[s->n_in + r] - rz[r]);
+  }
+
+  return exitflag;
+}
+
+/* Compute W = K^-1 B and factor the Schur complement */
+static OSQPInt factor(dense_solver* s) {
+
+  OSQPInt    i, j, k, p, r;
+  OSQPInt    exitflag;
+  OSQPInt    N  = s->n_in + s->m_in;
+  OSQPInt    d  = s->d;
+  OSQPFloat* sb = OSQPVectorf_data(s->b);
+  OSQPFloat* rz = s->val_work;
+  OSQPFloat  t;
+
+  for (k = 0; k < d; k++) {
+    for (r = 0; r < N; r++) sb[r] = 0.0;
+    for (p = s->Bp[k]; p < s->Bp[k + 1]; p++) sb[s->Bi[p]] = s->Bx[p];
+    exitflag = inner_solve(s, rz, 0);
+    if (exitflag) return exitflag;
+    for (r = 0; r < N; r++) s->W[r + k*N] = sb[r];
+  }
+
+  // S = C - diag(1 / rho) for the dense rows - B' W
+  for (j = 0; j < d; j++) {
+    for (i = 0; i < d; i++) {
+      t = s->C[i + j*d];
+      for (p = s->Bp[i]; p < s->Bp[i + 1]; p++) t -= s->Bx[p] * s->W[s->Bi[p] + j*N];
+      s->S[i + j*d] = t;
+    }
+  }
+  for (k = s->d_col; k < d; k++) {
+    s->S[k + k*d] -= 1.0 / s->rho[s->d_idx[k]];
+  }
+
+  return lu_factor(s->S, s->piv, d);
+}
+
+
+static const char* name_linsys_solver_dense(dense_solver* s) {
+  return s->inner->name(s->inner);
+}
+
+static OSQPInt solve_linsys_dense(dense_solver* s,
+                                  OSQPVectorf*  b,
+                                  OSQPInt       admm_iter) {
+
+  OSQPInt i, j, k, p, r;
+  OSQPInt exitflag;
+  OSQPInt n = s->n;
+  OSQPInt N = s->n_in + s->m_in;
+  OSQPInt d = s->d;
+
+  OSQPFloat* bv = OSQPVectorf_data(b);
+  OSQPFloat* sb = OSQPVectorf_data(s->b);
+
+  // Split the right-hand side into the inner and dense unknowns
+  for (j = 0; j < n; j++) {
+    k = s->col_map[j];
+    if (k >= 0) sb[k] = bv[j];
+    else        s->rd[-k - 1] = bv[j];
+  }
+  for (i = 0; i < s->m; i++) {
+    k = s->row_map[i];
+    if (k >= 0) sb[s->n_in + k] = bv[n + i];
+    else        s->rd[-k - 1] = bv[n + i];
+  }
+
+  // v = K^-1 r_in, then S u_d = r_d - B' v and u_in = v - W u_d
+  exitflag = inner_solve(s, s->val_work, admm_iter);
+  if (exitflag) return exitflag;
+
+  for (k = 0; k < d; k++) {
+    for (p = s->Bp[k]; p < s->Bp[k + 1]; p++) s->rd[k] -= s->Bx[p] * sb[s->Bi[p]];
+  }
+  lu_solve(s->S, s->piv, d, s->rd);
+  for (k = 0; k < d; k++) {
+    for (r = 0; r < N; r++) sb[r] -= s->W[r + k*N] * s->rd[k];
+  }
+
+  // x_tilde and z_tilde = r_z + nu / rho
+  for (j = 0; j < n; j++) {
+    k = s->col_map[j];
+    bv[j] = (k >= 0) ? sb[k] : s->rd[-k - 1];
+  }
+  for (i = 0; i < s->m; i++) {
+    k = s->row_map[i];
+    bv[n + i] += ((k >= 0) ? sb[s->n_in + k] : s->rd[-k - 1]) / s->rho[i];
+  }
+
+  return 0;
+}
+
+static void update_settings_linsys_solver_dense(dense_solver*       s,
+                                                const OSQPSettings* settings) {
+  s->inner->update_settings(s->inner, settings);
+}
+
+static void warm_start_linsys_solver_dense(dense_solver*      s,
+                                           const OSQPVectorf* x) {
+  s->inner->warm_start(s->inner, x);
+}
+
+static OSQPInt adjoint_derivative_dense(dense_solver* s) {
+  return s->inner->adjoint_derivative(s->inner);
+}
+
+static void free_linsys_solver_dense(dense_solver* s) {
+
+  if (s) {
+    if (s->inner && s->inner->free) s->inner->free(s->inner);
+    OSQPMatrix_free(s->P);
+    OSQPMatrix_free(s->A);
+    OSQPVectorf_free(s->rho_vec);
+    OSQPVectorf_free(s->b);
+    c_free(s->col_map);
+    c_free(s->row_map);
+    c_free(s->d_idx);
+    c_free(s->Pmap);
+    c_free(s->Amap);
+    c_free(s->rho);
+    c_free(s->Bp);
+    c_free(s->Bi);
+    c_free(s->Bx);
+    c_free(s->W);
+    c_free(s->C);
+    c_free(s->S);
+    c_free(s->piv);
+    c_free(s->rd);
+    c_free(s->val_work);
+  }
+  c_free(s);
+}
+
+static OSQPInt update_linsys_solver_matrices_dense(dense_solver*     s,
+                                                   const OSQPMatrix* P,
+                                                   const OSQPInt*    Px_new_idx,
+                                                   OSQPInt           P_new_n,
+                                                   const OSQPMatrix* A,
+                                                   const OSQPInt*    Ax_new_idx,
+                                                   OSQPInt           A_new_n) {
+
+  OSQPInt exitflag;
+
+  // Any new value can change the Schur complement, so all values are refreshed
+  set_values(s, P, A);
+
+  exitflag = s->inner->update_matrices(s->inner,
+                                       s->P, OSQP_NULL, OSQPMatrix_get_nz(s->P),
+                                       s->A, OSQP_NULL, OSQPMatrix_get_nz(s->A));
+  if (exitflag) return exitflag;
+
+  return factor(s);
+}
+
+static OSQPInt update_linsys_solver_rho_vec_dense(dense_solver*      s,
+                                                  const OSQPVectorf* rho_vec,
+                                                  OSQPFloat          rho_sc) {
+
+  OSQPInt exitflag;
+
+  set_rho(s, rho_vec, rho_sc);
+
+  exitflag = s->inner->update_rho_vec(s->inner, s->rho_vec, rho_sc);
+  if (exitflag) return exitflag;
+
+  return factor(s);
+}
+
+
+/* Linear system solver of the settings, eliminating the singleton rows if requested */
+static OSQPInt init_inner(LinSysSolver**      sp,
+                          const OSQPMatrix*   P,
+                          const OSQPMatrix*   A,
+                          const OSQPVectorf*  rho_vec,
+                          const OSQPSettings* settings,
+                          OSQPFloat*          scaled_prim_res,
+                          OSQPFloat*          scaled_dual_res) {
+
+  if (settings->split_bounds) {
+    return init_linsys_solver_bounds(sp, P, A, rho_vec, settings,
+                                     scaled_prim_res, scaled_dual_res);
+  }
+  return osqp_algebra_init_linsys_solver(sp, P, A, rho_vec, settings,
+                                         scaled_prim_res, scaled_dual_res, 0);
+}
+
+/* Column of B of the entry between the unknowns a and b (inner unknown or -k-1
+   for dense unknown k) with the inner one in r, -1 if they are not coupled by B */
+static OSQPInt coupling(OSQPInt  a,
+                        OSQPInt  b,
+                        OSQPInt* r) {
+
+  if (a >= 0 && b < 0) { *r = a; return -b - 1; }
+  if (b >= 0 && a < 0) { *r = b; return -a - 1; }
+  return -1;
+}
+
+/* Sparsity pattern of B from the entries of P and A that are neither inner nor in C */
+static OSQPInt init_coupling(dense_solver*     s,
+                             const OSQPMatrix* P,
+                             const OSQPMatrix* A) {
+
+  OSQPInt j, k, r, ptr, pass;
+
+  const OSQPInt* Pp = OSQPMatrix_get_p(P);
+  const OSQPInt* Pi = OSQPMatrix_get_i(P);
+  const OSQPInt* Ap = OSQPMatrix_get_p(A);
+  const OSQPInt* Ai = OSQPMatrix_get_i(A);
+
+  s->Bp = (OSQPInt*) c_calloc(s->d + 1, sizeof(OSQPInt));
+  if (!s->Bp) return OSQP_MEM_ALLOC_ERROR;
+
+  // Count the entries of every column, then place them with Bp[k] as cursor
+  for (pass = 0; pass < 2; pass++) {
+    for (j = 0; j < s->n; j++) {
+      for (ptr = Pp[j]; ptr < Pp[j + 1]; ptr++) {
+        if (s->Pmap[ptr] != -1) continue;
+        k = coupling(s->col_map[Pi[ptr]], s->col_map[j], &r);
+        if (k < 0) continue;
+        if (pass) { s->Bi[s->Bp[k]] = r; s->Pmap[ptr] = -s->Bp[k]++ - 2; }
+        else      s->Bp[k + 1]++;
+      }
+      for (ptr = Ap[j]; ptr < Ap[j + 1]; ptr++) {
+        if (s->Amap[ptr] != -1) continue;
+        r = s->row_map[Ai[ptr]];
+        k = coupling((r >= 0) ? s->n_in + r : r, s->col_map[j], &r);
+        if (k < 0) continue;
+        if (pass) { s->Bi[s->Bp[k]] = r; s->Amap[ptr] = -s->Bp[k]++ - 2; }
+        else      s->Bp[k + 1]++;
+      }
+    }
+
+    if (pass) {
+      for (k = s->d; k > 0; k--) s->Bp[k] = s->Bp[k - 1];
+      s->Bp[0] = 0;
+    }
+    else {
+      for (k = 0; k < s->d; k++) s->Bp[k + 1] += s->Bp[k];
+      s->Bi = (OSQPInt*) c_malloc((s->Bp[s->d] + 1) * sizeof(OSQPInt));
+      s->Bx = (OSQPFloat*) c_malloc((s->Bp[s->d] + 1) * sizeof(OSQPFloat));
+      if (!s->Bi || !s->Bx) return OSQP_MEM_ALLOC_ERROR;
+    }
+  }
+
+  return 0;
+}
+
+/* Pick the densest entry of cnt over the threshold that is not taken yet, -1 if none */
+static OSQPInt densest(const OSQPInt* cnt,
+                       const OSQPInt* map,
+                       OSQPInt        len,
+                       OSQPFloat      thresh) {
+
+  OSQPInt i;
+  OSQPInt best = -1;
+
+  for (i = 0; i < len; i++) {
+    if (map[i] >= 0 && cnt[i] > thresh && (best < 0 || cnt[i] > cnt[best])) best = i;
+  }
+  return best;
+}
+
+
+OSQPInt init_linsys_solver_dense(LinSysSolver**      sp,
+                                 const OSQPMatrix*   P,
+                                 const OSQPMatrix*   A,
+                                 const OSQPVectorf*  rho_vec,
+                                 const OSQPSettings* settings,
+                                 OSQPFloat*          scaled_prim_res,
+                                 OSQPFloat*          scaled_dual_res,
+                                 OSQPDense*          dense) {
+
+  OSQPInt i, j, k, ptr, nz, N;
+  OSQPInt d_row;
+  OSQPInt exitflag;
+
+  OSQPInt n    = OSQPMatrix_get_n(A);
+  OSQPInt m    = OSQPMatrix_get_m(A);
+  OSQPInt nnzP = OSQPMatrix_get_nz(P);
+  OSQPInt nnzA = OSQPMatrix_get_nz(A);
+
+  const OSQPInt* Pp = OSQPMatrix_get_p(P);
+  const OSQPInt* Pi = OSQPMatrix_get_i(P);
+  const OSQPInt* Ap = OSQPMatrix_get_p(A);
+  const OSQPInt* Ai = OSQPMatrix_get_i(A);
+
+  OSQPFloat      thresh = c_max(DENSE_MIN, c_sqrt((OSQPFloat)(n + m)));
+  OSQPFloat      refactor_flops;
+  OSQPInt*       cnt;
+  OSQPCscMatrix* M;
+  dense_solver*  s;
+
+  dense->n_rows    = 0;
+  dense->n_cols    = 0;
+  dense->fill      = -1;
+  dense->fill_full = -1;
+  dense->declined  = 0;
+
+  // The inner solves of the Schur complement need an exact solver
+  if (settings->linsys_solver != OSQP_DIRECT_SOLVER) {
+    return init_inner(sp, P, A, rho_vec, settings, scaled_prim_res, scaled_dual_res);
+  }
+
+  s = c_calloc(1, sizeof(dense_solver));
+  if (!s) return OSQP_MEM_ALLOC_ERROR;
+
+  s->name               = &name_linsys_solver_dense;
+  s->solve              = &solve_linsys_dense;
+  s->update_settings    = &update_settings_linsys_solver_dense;
+  s->warm_start         = &warm_start_linsys_solver_dense;
+  s->adjoint_derivative = &adjoint_derivative_dense;
+  s->free               = &free_linsys_solver_dense;
+  s->update_matrices    = &update_linsys_solver_matrices_dense;
+  s->update_rho_vec     = &update_linsys_solver_rho_vec_dense;
+  s->type               = settings->linsys_solver;
+
+  s->n     = n;
+  s->m     = m;
+  s->sigma = settings->sigma;
+
+  s->col_map  = (OSQPInt*) c_calloc(n + 1, sizeof(OSQPInt));
+  s->row_map  = (OSQPInt*) c_calloc(m + 1, sizeof(OSQPInt));
+  s->d_idx    = (OSQPInt*) c_malloc(DENSE_MAX * sizeof(OSQPInt));
+  cnt         = (OSQPInt*) c_calloc(c_max(n, m) + 1, sizeof(OSQPInt));
+  if (!s->col_map || !s->row_map || !s->d_idx || !cnt) {
+    c_free(cnt);
+    free_linsys_solver_dense(s);
+    return OSQP_MEM_ALLOC_ERROR;
+  }
+
+  // Dense rows, then dense columns among the remaining rows (the maps hold -1 once taken)
+  for (k = 0; k < nnzA; k++) cnt[Ai[k]]++;
+  d_row = 0;
+  while (d_row < DENSE_MAX && (i = densest(cnt, s->row_map, m, thresh)) >= 0) {
+    s->row_map[i] = -1;
+    s->d_idx[DENSE_MAX - 1 - d_row++] = i;
+  }
+
+  for (j = 0; j < n; j++) {
+    cnt[j] = 0;
+    for (ptr = Ap[j]; ptr < Ap[j + 1]; ptr++) {
+      if (s->row_map[Ai[ptr]] >= 0) cnt[j]++;
+    }
+  }
+  while (s->d_col + d_row < DENSE_MAX && (j = densest(cnt, s->col_map, n, thresh)) >= 0) {
+    s->col_map[j] = -1;
+    s->d_idx[s->d_col++] = j;
+  }
+  c_free(cnt);
+
+  // Nothing to keep out
+  if (s->d_col + d_row == 0) {
+    free_linsys_solver_dense(s);
+    return init_inner(sp, P, A, rho_vec, settings, scaled_prim_res, scaled_dual_res);
+  }
+
+  // Dense unknowns: the columns followed by the rows
+  s->d = s->d_col + d_row;
+  for (k = 0; k < d_row; k++) s->d_idx[s->d_col + k] = s->d_idx[DENSE_MAX - d_row + k];
+  for (k = 0; k < s->d_col; k++) s->col_map[s->d_idx[k]] = -k - 1;
+  for (k = s->d_col; k < s->d; k++) s->row_map[s->d_idx[k]] = -k - 1;
+
+  // Number the inner variables and rows
+  for (j = 0; j < n; j++) {
+    if (s->col_map[j] >= 0) s->col_map[j] = s->n_in++;
+  }
+  for (i = 0; i < m; i++) {
+    if (s->row_map[i] >= 0) s->row_map[i] = s->m_in++;
+  }
+  N = s->n_in + s->m_in;
+
+  s->Pmap     = (OSQPInt*) c_malloc((nnzP + 1) * sizeof(OSQPInt));
+  s->Amap     = (OSQPInt*) c_malloc((nnzA + 1) * sizeof(OSQPInt));
+  s->rho      = (OSQPFloat*) c_malloc((m + 1) * sizeof(OSQPFloat));
+  s->C        = (OSQPFloat*) c_malloc(s->d * s->d * sizeof(OSQPFloat));
+  s->S        = (OSQPFloat*) c_malloc(s->d * s->d * sizeof(OSQPFloat));
+  s->piv      = (OSQPInt*) c_malloc(s->d * sizeof(OSQPInt));
+  s->rd       = (OSQPFloat*) c_malloc(s->d * sizeof(OSQPFloat));
+  s->val_work = (OSQPFloat*) c_malloc((c_max(nnzP, c_max(nnzA, m)) + 1) * sizeof(OSQPFloat));
+  if (!s->Pmap || !s->Amap || !s->rho || !s->C || !s->S ||
+      !s->piv || !s->rd || !s->val_work) {
+    free_linsys_solver_dense(s);
+    return OSQP_MEM_ALLOC_ERROR;
+  }
+
+  // Inner P keeps the order of the entries of P
+  M = csc_spalloc(s->n_in, s->n_in, nnzP, 1, 0);
+  if (!M) {
+    free_linsys_solver_dense(s);
+    return OSQP_MEM_ALLOC_ERROR;
+  }
+  nz = 0;
+  for (j = 0; j < n; j++) {
+    if (s->col_map[j] >= 0) M->p[s->col_map[j]] = nz;
+    for (ptr = Pp[j]; ptr < Pp[j + 1]; ptr++) {
+      s->Pmap[ptr] = -1;
+      if (s->col_map[j] >= 0 && s->col_map[Pi[ptr]] >= 0) {
+        M->i[nz] = s->col_map[Pi[ptr]];
+        M->x[nz] = 0.0;
+        s->Pmap[ptr] = nz++;
+      }
+    }
+  }
+  M->p[s->n_in] = nz;
+  s->P = OSQPMatrix_new_from_csc(M, 1);
+  csc_spfree(M);
+
+  // Inner A keeps the order of the entries of A
+  M = csc_spalloc(s->m_in, s->n_in, nnzA, 1, 0);
+  if (!s->P || !M) {
+    csc_spfree(M);
+    free_linsys_solver_dense(s);
+    return OSQP_MEM_ALLOC_ERROR;
+  }
+  nz = 0;
+  for (j = 0; j < n; j++) {
+    if (s->col_map[j] >= 0) M->p[s->col_map[j]] = nz;
+    for (ptr = Ap[j]; ptr < Ap[j + 1]; ptr++) {
+      s->Amap[ptr] = -1;
+      if (s->col_map[j] >= 0 && s->row_map[Ai[ptr]] >= 0) {
+        M->i[nz] = s->row_map[Ai[ptr]];
+        M->x[nz] = 0.0;
+        s->Amap[ptr] = nz++;
+      }
+    }
+  }
+  M->p[s->n_in] = nz;
+  s->A = OSQPMatrix_new_from_csc(M, 0);
+  csc_spfree(M);
+  if (!s->A || init_coupling(s, P, A)) {
+    free_linsys_solver_dense(s);
+    return OSQP_MEM_ALLOC_ERROR;
+  }
+
+  // Keep the dense unknowns out only if every solve stores and touches fewer
+  // nonzeros: the inner factor, B and the dense N x d W = K^-1 B against the
+  // full factor. Every refactorization also takes d inner solves, about
+  // 4 d fill flops, which must stay below fill_full^2 / (n + m), a lower
+  // bound of the flops of the full factorization.
+  dense->fill_full = osqp_algebra_kkt_fill(P, A);
+  dense->fill      = osqp_algebra_kkt_fill(s->P, s->A);
+  refactor_flops   = 4.0 * s->d * dense->fill;
+  if (dense->fill >= 0) dense->fill += s->Bp[s->d] + N * s->d;
+  if (dense->fill_full >= 0 &&
+      (dense->fill >= dense->fill_full ||
+       refactor_flops >= (OSQPFloat)dense->fill_full * dense->fill_full / (n + m))) {
+    dense->declined = s->d;
+    free_linsys_solver_dense(s);
+    return init_inner(sp, P, A, rho_vec, settings, scaled_prim_res, scaled_dual_res);
+  }
+
+  s->W = (OSQPFloat*) c_malloc(N * s->d * sizeof(OSQPFloat));
+  if (!s->W) {
+    free_linsys_solver_dense(s);
+    return OSQP_MEM_ALLOC_ERROR;
+  }
+  dense->n_rows = d_row;
+  dense->n_cols = s->d_col;
+
+  *sp = (LinSysSolver*) s;
+
+  // Inner vectors
+  s->b = OSQPVectorf_calloc(N);
+  if (!s->b) return OSQP_MEM_ALLOC_ERROR;
+  if (rho_vec) {
+    s->rho_vec = OSQPVectorf_malloc(s->m_in);
+    if (!s->rho_vec) return OSQP_MEM_ALLOC_ERROR;
+  }
+
+  set_rho(s, rho_vec, settings->rho);
+  set_values(s, P, A);
+
+  exitflag = init_inner(&s->inner, s->P, s->A, s->rho_vec, settings,
+                        scaled_prim_res, scaled_dual_res);
+  if (!s->inner) return exitflag;
+  s->nthreads = s->inner->nthreads;
+  if (exitflag) return exitflag;
+
+  return factor(s);
+}
@@ -1,102 +1,784 @@
 #include "derivative.h"
 #include "lin_alg.h"
 #include "error.h"
+#include "printing.h"
 #include "csc_utils.h"
 #include "csc_math.h"
 
-OSQPInt unscale_PA(OSQPSolver*  solver,
-                     OSQPMatrix*  P,
-                     OSQPMatrix*  A) {
+OSQPInt adjoint_derivative_get_mat(OSQPSolver *solver,
+                                   OSQPInt        n_seeds,
+                                   OSQPCscMatrix* dP,
+                                   OSQPCscMatrix* dA) {
 
-  OSQPMatrix_mult_scalar(P, solver->work->scaling->cinv);
-  OSQPMatrix_lmult_diag(P, solver->work->scaling->Dinv);
-  OSQPMatrix_rmult_diag(P, solver->work->scaling->Dinv);
+    // Check if solver has been initialized
+    if (!solver || !solver->work || !solver->work->derivative_data)
+      return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
 
-  OSQPMatrix_lmult_diag(A, solver->work->scaling->Einv);
-  OSQPMatrix_rmult_diag(A, solver->work->scaling->Dinv);
+    OSQPInt n = solver->work->data->n;
+    OSQPInt m = solver->work->data->m;
+    OSQPDerivativeData *derivative_data = solver->work->derivative_data;
 
-  return 0;
-}
+    if (n_seeds > derivative_data->n_seeds) {
+      c_eprint("derivatives were computed for %i seeds only", (int)derivative_data->n_seeds);
+      return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+    }
 
-OSQPInt unscale_lu(OSQPSolver*  solver,
-                     OSQPVectorf* l,
-                     OSQPVectorf* u) {
+    OSQPFloat* x_data = OSQPVectorf_data(derivative_data->x);  // unscaled solution
+    OSQPFloat* y_u_data = OSQPVectorf_data(derivative_data->y_u);
+    OSQPFloat* y_l_data = OSQPVectorf_data(derivative_data->y_l);
+
+    OSQPInt ld  = 2 * (n + 2*m);
+    OSQPInt pos = n + derivative_data->n_ineq_l + derivative_data->n_ineq_u + derivative_data->n_eq;
 
-    OSQPVectorf_ew_prod(l, l, solver->work->scaling->Einv);
-    OSQPVectorf_ew_prod(u, u, solver->work->scaling->Einv);
+    OSQPInt k, col;
+    for (k=0; k<n_seeds; k++) {
+        OSQPFloat* rx_data  = OSQPVectorf_data(derivative_data->rhs) + k * ld + pos;
+        OSQPFloat* ryu_data = OSQPVectorf_data(derivative_data->ryu) + k * m;
+        OSQPFloat* ryl_data = OSQPVectorf_data(derivative_data->ryl) + k * m;
+
+        for (col=0; col<n; col++) {
+            OSQPInt p, i;
+            for (p=dP[k].p[col]; p<dP[k].p[col+1]; p++) {
+                i = dP[k].i[p];
+                dP[k].x[p] = 0.5 * ((rx_data[i] * x_data[col]) + (rx_data[col] * x_data[i]));
+            }
+            for (p=dA[k].p[col]; p<dA[k].p[col+1]; p++) {
+                i = dA[k].i[p];
+                dA[k].x[p] = ((y_u_data[i] - y_l_data[i]) * rx_data[col]) + ((ryu_data[i] - ryl_data[i]) * x_data[col]);
+            }
+        }
+    }
 
     return 0;
 }
 
-OSQPInt adjoint_derivative_get_mat(OSQPSolver *solver,
-                                        OSQPCscMatrix* dP,
-                                        OSQPCscMatrix* dA) {
+OSQPInt adjoint_derivative_get_vec(OSQPSolver *solver,
+                                   OSQPInt        n_seeds,
+                                   OSQPFloat*     dq,
+                                   OSQPFloat*     dl,
+                                   OSQPFloat*     du) {
 
     // Check if solver has been initialized
     if (!solver || !solver->work || !solver->work->derivative_data)
       return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
 
     OSQPInt n = solver->work->data->n;
+    OSQPInt m = solver->work->data->m;
     OSQPDerivativeData *derivative_data = solver->work->derivative_data;
-    OSQPVectorf* x = OSQPVectorf_new(solver->solution->x, n);  // unscaled solution
-    OSQPFloat* x_data = OSQPVectorf_data(x);
 
-    OSQPFloat* y_u_data = OSQPVectorf_data(derivative_data->y_u);
-    OSQPFloat* y_l_data = OSQPVectorf_data(derivative_data->y_l);
-    OSQPFloat* ryu_data = OSQPVectorf_data(derivative_data->ryu);
-    OSQPFloat* ryl_data = OSQPVectorf_data(derivative_data->ryl);
+    if (n_seeds > derivative_data->n_seeds) {
+      c_eprint("derivatives were computed for %i seeds only", (int)derivative_data->n_seeds);
+      return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+    }
 
+    OSQPInt ld  = 2 * (n + 2*m);
     OSQPInt pos = n + derivative_data->n_ineq_l + derivative_data->n_ineq_u + derivative_data->n_eq;
-    OSQPVectorf* rx = OSQPVectorf_view(derivative_data->rhs, pos, n);
-    OSQPFloat* rx_data  = OSQPVectorf_data(rx);
-
-    OSQPInt col;
-    for (col=0; col<n; col++) {
-        OSQPInt p, i;
-        for (p=dP->p[col]; p<dP->p[col+1]; p++) {
-            i = dP->i[p];
-            dP->x[p] = 0.5 * ((rx_data[i] * x_data[col]) + (rx_data[col] * x_data[i]));
+
+    OSQPFloat* rhs_data = OSQPVectorf_data(derivative_data->rhs);
+    OSQPFloat* ryl_data = OSQPVectorf_data(derivative_data->ryl);
+    OSQPFloat* ryu_data = OSQPVectorf_data(derivative_data->ryu);
+
+    // Assign vector derivatives to function arguments
+    OSQPInt k, i;
+    for (k=0; k<n_seeds; k++) {
+        for (i=0; i<n; i++) dq[k*n + i] = rhs_data[k*ld + pos + i];
+        for (i=0; i<m; i++) {
+            dl[k*m + i] = ryl_data[k*m + i];
+            du[k*m + i] = -ryu_data[k*m + i];
+        }
+    }
+
+    return 0;
+}
+
+// Make room for the right-hand sides and results of n_seeds seeds
+static OSQPInt reserve_seeds(OSQPDerivativeData* derivative_data,
+                             OSQPInt             n_seeds,
+                             OSQPInt             n,
+                             OSQPInt             m) {
+
+    if (n_seeds <= derivative_data->max_seeds) return 0;
+
+    OSQPVectorf_free(derivative_data->rhs);
+    OSQPVectorf_free(derivative_data->ryl);
+    OSQPVectorf_free(derivative_data->ryu);
+    derivative_data->max_seeds = 0;
+
+    derivative_data->rhs = OSQPVectorf_malloc(n_seeds * 2 * (n + 2*m));
+    derivative_data->ryl = OSQPVectorf_malloc(n_seeds * m);
+    derivative_data->ryu = OSQPVectorf_malloc(n_seeds * m);
+    if (!derivative_data->rhs || !derivative_data->ryl || !derivative_data->ryu)
+        return OSQP_MEM_ALLOC_ERROR;
+
+    derivative_data->max_seeds = n_seeds;
+    return 0;
+}
+
+// Kinds of constraints in the partition of the rows of A
+#define DERIV_ROW_LOWER 1  ///< inequality with a finite lower bound
+#define DERIV_ROW_UPPER 2  ///< inequality with a finite upper bound
+#define DERIV_ROW_EQ    4  ///< equality
+
+// Build the matrices of the current partition of the constraints
+static OSQPInt build_partition_matrices(OSQPDerivativeData* derivative_data,
+                                        const OSQPMatrix*   A,
+                                        OSQPInt             m) {
+
+    OSQPInt n_ineq = derivative_data->n_ineq_l + derivative_data->n_ineq_u;
+    OSQPInt j;
+
+    if (derivative_data->G)           OSQPMatrix_free(derivative_data->G);
+    if (derivative_data->A_eq)        OSQPMatrix_free(derivative_data->A_eq);
+    if (derivative_data->GDiagLambda) OSQPMatrix_free(derivative_data->GDiagLambda);
+    if (derivative_data->lambda)      OSQPVectorf_free(derivative_data->lambda);
+    if (derivative_data->slacks)      OSQPVectorf_free(derivative_data->slacks);
+
+    OSQPInt* rows = (OSQPInt *) c_malloc(m * sizeof(OSQPInt));
+    OSQPVectori* rows_i = OSQPVectori_malloc(m);
+    if (!rows || !rows_i) {
+        c_free(rows);
+        if (rows_i) OSQPVectori_free(rows_i);
+        return OSQP_MEM_ALLOC_ERROR;
+    }
+
+    for (j = 0; j < m; j++) rows[j] = (derivative_data->row_type[j] & DERIV_ROW_LOWER) != 0;
+    OSQPVectori_from_raw(rows_i, rows);
+    OSQPMatrix* A_ineq_l = OSQPMatrix_submatrix_byrows(A, rows_i);
+    OSQPMatrix_mult_scalar(A_ineq_l, -1);
+
+    for (j = 0; j < m; j++) rows[j] = (derivative_data->row_type[j] & DERIV_ROW_UPPER) != 0;
+    OSQPVectori_from_raw(rows_i, rows);
+    OSQPMatrix* A_ineq_u = OSQPMatrix_submatrix_byrows(A, rows_i);
+
+    derivative_data->G = OSQPMatrix_vstack(A_ineq_l, A_ineq_u);
+    OSQPMatrix_free(A_ineq_l);
+    OSQPMatrix_free(A_ineq_u);
+
+    for (j = 0; j < m; j++) rows[j] = derivative_data->row_type[j] == DERIV_ROW_EQ;
+    OSQPVectori_from_raw(rows_i, rows);
+    derivative_data->A_eq = OSQPMatrix_submatrix_byrows(A, rows_i);
+
+    c_free(rows);
+    OSQPVectori_free(rows_i);
+
+    derivative_data->GDiagLambda = OSQPMatrix_copy_new(derivative_data->G);
+    derivative_data->lambda      = OSQPVectorf_malloc(n_ineq);
+    derivative_data->slacks      = OSQPVectorf_malloc(n_ineq);
+
+    if (!derivative_data->G || !derivative_data->A_eq || !derivative_data->GDiagLambda ||
+        !derivative_data->lambda || !derivative_data->slacks)
+        return OSQP_MEM_ALLOC_ERROR;
+
+    return 0;
+}
+
+/*
+ * Update the derivative system at the current solution. The adjoint and the
+ * forward derivatives solve with the same matrix, which is
+ *
+ *   [ I  K' ]
+ *   [ K  0  ]
+ *
+ * with K the Jacobian of the KKT conditions of the active partition
+ *
+ *   K = [ P             G'            A_eq' ]
+ *       [ diag(lambda)G diag(G x - h) 0     ]
+ *       [ A_eq          0             0     ]
+ *
+ * The system is formed on the scaled data of the workspace. Its matrix is
+ * K_s = T K S with
+ *
+ *   S = diag(D, E/c, E/c),  T = diag(c D, c I, E)
+ *
+ * so the right-hand sides and the results only need to be scaled by S and T,
+ * see scale_system_vector.
+ *
+ * The partition of the constraints is the one of the projection in the
+ * workspace. new_partition is set when it changed, in which case the
+ * structure of the system changed as well.
+ */
+static OSQPInt assemble_derivative_system(OSQPSolver* solver,
+                                          OSQPInt*    new_partition) {
+
+    OSQPInt m = solver->work->data->m;
+    OSQPWorkspace* work = solver->work;
+    OSQPDerivativeData *derivative_data = work->derivative_data;
+    OSQPInt exitflag;
+
+    // The scaled matrices only change with osqp_update_data_mat
+    if (!derivative_data->mat_valid) {
+        if (derivative_data->P_full) OSQPMatrix_free(derivative_data->P_full);
+        derivative_data->P_full = OSQPMatrix_triu_to_symm(work->data->P);
+        if (!derivative_data->P_full) return OSQP_MEM_ALLOC_ERROR;
+    }
+
+    // Note: x/y are unscaled solutions
+    OSQPVectorf_from_raw(derivative_data->x, solver->solution->x);
+    OSQPVectorf_from_raw(derivative_data->y, solver->solution->y);
+    OSQPVectorf_copy(derivative_data->x_scaled, derivative_data->x);
+    if (solver->settings->scaling)
+        OSQPVectorf_ew_prod(derivative_data->x_scaled, derivative_data->x_scaled, work->scaling->Dinv);
+
+    OSQPFloat* l_data = OSQPVectorf_data(work->data->l);
+    OSQPFloat* u_data = OSQPVectorf_data(work->data->u);
+    OSQPFloat* y_data = OSQPVectorf_data(derivative_data->y);
+
+    OSQPInt* row_type   = derivative_data->row_type;
+    OSQPInt* ineq_l_idx = derivative_data->ineq_l_idx;
+    OSQPInt* ineq_u_idx = derivative_data->ineq_u_idx;
+    OSQPInt* eq_idx     = derivative_data->eq_idx;
+    OSQPInt* nu_sign    = derivative_data->nu_sign;
+
+    // Same threshold as the projection partition
+    OSQPFloat infval = OSQP_INFTY * OSQP_MIN_SCALING;
+
+    OSQPInt n_fixed   = work->proj_n_fixed;
+    OSQPInt n_bounded = work->proj_n_bounded;
+    OSQPInt n_ineq_l  = 0;
+    OSQPInt n_ineq_u  = 0;
+
+    *new_partition = !derivative_data->G;
+
+    // The rows of the projection partition are sorted within the fixed and
+    // the bounded rows, so the partition only changed if one of the lists
+    // did. row_type is rebuilt from the lists below and holds the rows until
+    // then.
+    OSQPVectori_to_raw(row_type, work->proj_idx);
+
+    OSQPInt i, j;
+    for (j = 0; j < n_fixed; j++) {
+        i = row_type[j];
+        if (j >= derivative_data->n_eq || eq_idx[j] != i) *new_partition = 1;
+        eq_idx[j]  = i;
+        nu_sign[j] = (y_data[i] >= 0) ? 1 : -1;
+    }
+    for (j = n_fixed; j < n_fixed + n_bounded; j++) {
+        i = row_type[j];
+        if (l_data[i] >= -infval) {
+            if (n_ineq_l >= derivative_data->n_ineq_l || ineq_l_idx[n_ineq_l] != i) *new_partition = 1;
+            ineq_l_idx[n_ineq_l++] = i;
         }
-        for (p=dA->p[col]; p<dA->p[col+1]; p++) {
-            i = dA->i[p];
-            dA->x[p] = ((y_u_data[i] - y_l_data[i]) * rx_data[col]) + ((ryu_data[i] - ryl_data[i]) * x_data[col]);
+        if (u_data[i] <= infval) {
+            if (n_ineq_u >= derivative_data->n_ineq_u || ineq_u_idx[n_ineq_u] != i) *new_partition = 1;
+            ineq_u_idx[n_ineq_u++] = i;
         }
     }
+    if (n_fixed  != derivative_data->n_eq     ||
+        n_ineq_l != derivative_data->n_ineq_l ||
+        n_ineq_u != derivative_data->n_ineq_u)
+        *new_partition = 1;
+
+    derivative_data->n_ineq_l = n_ineq_l;
+    derivative_data->n_ineq_u = n_ineq_u;
+    derivative_data->n_eq     = n_fixed;
+
+    for (i = 0; i < m; i++)        row_type[i] = 0;
+    for (j = 0; j < n_ineq_l; j++) row_type[ineq_l_idx[j]] |= DERIV_ROW_LOWER;
+    for (j = 0; j < n_ineq_u; j++) row_type[ineq_u_idx[j]] |= DERIV_ROW_UPPER;
+    for (j = 0; j < n_fixed; j++)  row_type[eq_idx[j]] = DERIV_ROW_EQ;
+
+    // The structure of the derivative system only depends on the partition,
+    // so new values of P and A rebuild the matrices but keep the factorization
+    if (*new_partition || !derivative_data->mat_valid) {
+        exitflag = build_partition_matrices(derivative_data, work->data->A, m);
+        if (exitflag) return exitflag;
+        derivative_data->mat_valid = 1;
+    }
 
-    OSQPVectorf_view_free(rx);
-    OSQPVectorf_free(x);
+    // --------- lambda
+    OSQPFloat* y_l_data = OSQPVectorf_data(derivative_data->y_l);
+    OSQPFloat* y_u_data = OSQPVectorf_data(derivative_data->y_u);
+    for (j = 0; j < m; j++) {
+        y_u_data[j] = c_max(y_data[j], 0);
+        y_l_data[j] = -c_min(y_data[j], 0);
+    }
+
+    // The scaled multipliers are c Einv y
+    OSQPFloat  c    = solver->settings->scaling ? work->scaling->c : 1;
+    OSQPFloat* Einv = solver->settings->scaling ? OSQPVectorf_data(work->scaling->Einv) : OSQP_NULL;
+
+    OSQPFloat* lambda_data = OSQPVectorf_data(derivative_data->lambda);
+    OSQPFloat* slacks_data = OSQPVectorf_data(derivative_data->slacks);
+    for (j = 0; j < n_ineq_l; j++) {
+        i = ineq_l_idx[j];
+        lambda_data[j] = c * (Einv ? Einv[i] : 1) * y_l_data[i];
+        slacks_data[j] = -l_data[i];
+    }
+    for (j = 0; j < n_ineq_u; j++) {
+        i = ineq_u_idx[j];
+        lambda_data[n_ineq_l + j] = c * (Einv ? Einv[i] : 1) * y_u_data[i];
+        slacks_data[n_ineq_l + j] = u_data[i];
+    }
+    // ---------- lambda
+
+    // --------- slacks
+    OSQPMatrix_Axpy(derivative_data->G, derivative_data->x_scaled, derivative_data->slacks, 1, -1);
+
+    // ---------- GDiagLambda
+    OSQPMatrix_update_values(derivative_data->GDiagLambda,
+                             OSQPMatrix_get_x(derivative_data->G), OSQP_NULL,
+                             OSQPMatrix_get_nz(derivative_data->G));
+    OSQPMatrix_lmult_diag(derivative_data->GDiagLambda, derivative_data->lambda);
 
     return 0;
 }
 
-OSQPInt adjoint_derivative_get_vec(OSQPSolver *solver,
-                                        OSQPFloat*     dq,
-                                        OSQPFloat*     dl,
-                                        OSQPFloat*     du) {
+/*
+ * Scale a block of length n + n_ineq_l + n_ineq_u + n_eq of the derivative
+ * system in place. With use_T == 0 the block is multiplied by
+ * S = diag(D, E/c, E/c), which maps the derivatives of the scaled system to
+ * the unscaled ones and the unscaled adjoint seeds to the scaled ones. With
+ * use_T == 1 it is multiplied by T = diag(c D, c I, E), which maps unscaled
+ * residuals to scaled ones and the scaled adjoint results to unscaled ones.
+ */
+static void scale_system_vector(const OSQPSolver* solver,
+                                OSQPFloat*        v,
+                                OSQPInt           use_T) {
 
-    // Check if solver has been initialized
-    if (!solver || !solver->work || !solver->work->derivative_data)
-      return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
+    if (!solver->settings->scaling) return;
 
     OSQPInt n = solver->work->data->n;
-    OSQPDerivativeData *derivative_data = solver->work->derivative_data;
+    const OSQPDerivativeData* derivative_data = solver->work->derivative_data;
 
-    OSQPInt pos = n + derivative_data->n_ineq_l + derivative_data->n_ineq_u + derivative_data->n_eq;
-    OSQPVectorf* rx = OSQPVectorf_view(derivative_data->rhs, pos, n);
+    OSQPFloat  c = solver->work->scaling->c;
+    OSQPFloat* D = OSQPVectorf_data(solver->work->scaling->D);
+    OSQPFloat* E = OSQPVectorf_data(solver->work->scaling->E);
 
-    // Assign vector derivatives to function arguments
-    OSQPVectorf_to_raw(dq, rx);
-    OSQPVectorf_to_raw(dl, derivative_data->ryl);
-    OSQPVectorf_to_raw(du, derivative_data->ryu);
-    for (OSQPInt i=0; i<OSQPVectorf_length(derivative_data->ryu); i++) {
-        du[i] = -du[i];
+    OSQPInt n_ineq_l = derivative_data->n_ineq_l;
+    OSQPInt n_ineq_u = derivative_data->n_ineq_u;
+    OSQPInt n_eq     = derivative_data->n_eq;
+
+    OSQPInt j, pos;
+    for (j=0; j<n; j++) v[j] *= use_T ? c * D[j] : D[j];
+    pos = n;
+    for (j=0; j<n_ineq_l; j++) v[pos+j] *= use_T ? c : E[derivative_data->ineq_l_idx[j]] / c;
+    pos += n_ineq_l;
+    for (j=0; j<n_ineq_u; j++) v[pos+j] *= use_T ? c : E[derivative_data->ineq_u_idx[j]] / c;
+    pos += n_ineq_u;
+    for (j=0; j<n_eq; j++)     v[pos+j] *= use_T ? E[derivative_data->eq_idx[j]] : E[derivative_data->eq_idx[j]] / c;
+}
+
+// Restarted GMRES of the iterative derivative solve
+#define DERIV_GMRES_RESTART  (20)
+#define DERIV_GMRES_MAX_ITER (500)
+
+// Workspace of the iterative derivative solve
+typedef struct {
+    OSQPInt      N;      ///< size of K
+    OSQPVectorf *vx, *vl, *ve;  ///< blocks of the input of K, size n, n_ineq, n_eq
+    OSQPVectorf *ox, *ol, *oe;  ///< blocks of the output of K
+    OSQPVectorf *t;      ///< multipliers of the loose inequalities, size n_ineq
+    OSQPVectorf *uw;     ///< constraint part of the ADMM right-hand side, size m
+    OSQPVectorf *kkt;    ///< right-hand side and solution of the ADMM system, size n + m
+    OSQPVectorf *rho;    ///< rho of the ADMM system while it preconditions, size m
+    OSQPFloat   *V;      ///< Krylov basis, (restart + 1) * N
+    OSQPFloat   *H;      ///< Hessenberg matrix, (restart + 1) * restart
+    OSQPFloat   *cs, *sn, *g, *z, *w, *r;
+} deriv_gmres;
+
+static void deriv_gmres_free(deriv_gmres* s) {
+
+    OSQPVectorf_free(s->vx);
+    OSQPVectorf_free(s->vl);
+    OSQPVectorf_free(s->ve);
+    OSQPVectorf_free(s->ox);
+    OSQPVectorf_free(s->ol);
+    OSQPVectorf_free(s->oe);
+    OSQPVectorf_free(s->t);
+    OSQPVectorf_free(s->uw);
+    OSQPVectorf_free(s->kkt);
+    OSQPVectorf_free(s->rho);
+    c_free(s->V);
+    c_free(s->H);
+    c_free(s->cs);
+    c_free(s->sn);
+    c_free(s->g);
+    c_free(s->z);
+    c_free(s->w);
+    c_free(s->r);
+}
+
+static OSQPInt deriv_gmres_init(deriv_gmres*              s,
+                                const OSQPDerivativeData* derivative_data,
+                                OSQPInt                   n,
+                                OSQPInt                   m) {
+
+    OSQPInt n_ineq = derivative_data->n_ineq_l + derivative_data->n_ineq_u;
+    OSQPInt n_eq   = derivative_data->n_eq;
+    OSQPInt N      = n + n_ineq + n_eq;
+    OSQPInt k      = DERIV_GMRES_RESTART;
+
+    s->N   = N;
+    s->vx  = OSQPVectorf_malloc(n);
+    s->vl  = OSQPVectorf_malloc(n_ineq);
+    s->ve  = OSQPVectorf_malloc(n_eq);
+    s->ox  = OSQPVectorf_malloc(n);
+    s->ol  = OSQPVectorf_malloc(n_ineq);
+    s->oe  = OSQPVectorf_malloc(n_eq);
+    s->t   = OSQPVectorf_malloc(n_ineq);
+    s->uw  = OSQPVectorf_malloc(m);
+    s->kkt = OSQPVectorf_malloc(n + m);
+    s->rho = OSQPVectorf_malloc(m);
+    s->V   = (OSQPFloat *) c_malloc((k + 1) * N * sizeof(OSQPFloat));
+    s->H   = (OSQPFloat *) c_malloc((k + 1) * k * sizeof(OSQPFloat));
+    s->cs  = (OSQPFloat *) c_malloc(k * sizeof(OSQPFloat));
+    s->sn  = (OSQPFloat *) c_malloc(k * sizeof(OSQPFloat));
+    s->g   = (OSQPFloat *) c_malloc((k + 1) * sizeof(OSQPFloat));
+    s->z   = (OSQPFloat *) c_malloc(N * sizeof(OSQPFloat));
+    s->w   = (OSQPFloat *) c_malloc(N * sizeof(OSQPFloat));
+    s->r   = (OSQPFloat *) c_malloc(N * sizeof(OSQPFloat));
+
+    if (!s->vx || !s->vl || !s->ve || !s->ox || !s->ol || !s->oe ||
+        !s->t || !s->uw || !s->kkt || !s->rho || !s->V || !s->H || !s->cs || !s->sn ||
+        !s->g || !s->z || !s->w || !s->r)
+        return OSQP_MEM_ALLOC_ERROR;
+
+    return 0;
+}
+
+/*
+ * out = K v, or out = K' v if transpose is set, with K the scaled Jacobian of
+ * the KKT conditions of assemble_derivative_system.
+ */
+static void deriv_apply_K(const OSQPDerivativeData* derivative_data,
+                          deriv_gmres*              s,
+                          const OSQPFloat*          v,
+                          OSQPFloat*                out,
+                          OSQPInt                   transpose) {
+
+    OSQPInt n      = OSQPVectorf_length(s->vx);
+    OSQPInt n_ineq = OSQPVectorf_length(s->vl);
+    OSQPInt j;
+
+    const OSQPMatrix* G2 = transpose ? derivative_data->G : derivative_data->GDiagLambda;
+    const OSQPMatrix* G1 = transpose ? derivative_data->GDiagLambda : derivative_data->G;
+
+    OSQPVectorf_from_raw(s->vx, v);
+    OSQPVectorf_from_raw(s->vl, v + n);
+    OSQPVectorf_from_raw(s->ve, v + n + n_ineq);
+
+    // Stationarity rows
+    OSQPMatrix_Axpy(derivative_data->P_full, s->vx, s->ox, 1, 0);
+    OSQPMatrix_Atxpy(G1, s->vl, s->ox, 1, 1);
+    OSQPMatrix_Atxpy(derivative_data->A_eq, s->ve, s->ox, 1, 1);
+
+    // Complementarity rows
+    OSQPMatrix_Axpy(G2, s->vx, s->ol, 1, 0);
+    OSQPFloat* ol     = OSQPVectorf_data(s->ol);
+    OSQPFloat* slacks = OSQPVectorf_data(derivative_data->slacks);
+    for (j = 0; j < n_ineq; j++) ol[j] += slacks[j] * v[n + j];
+
+    // Equality rows
+    OSQPMatrix_Axpy(derivative_data->A_eq, s->vx, s->oe, 1, 0);
+
+    OSQPVectorf_to_raw(out, s->ox);
+    OSQPVectorf_to_raw(out + n, s->ol);
+    OSQPVectorf_to_raw(out + n + n_ineq, s->oe);
+}
+
+/*
+ * out = M^-1 v, or out = M^-T v if transpose is set, with M an approximation
+ * of K built on the KKT matrix of the ADMM iterations
+ *
+ *   [ P + sigma I  A'         ]
+ *   [ A            -diag(1/rho) ]
+ *
+ * whose factorization is in work->linsys_solver. An inequality whose
+ * multiplier is larger than its slack is treated as the row of A it comes
+ * from, with the multiplier of the row standing for its own; the multiplier
+ * of any other inequality only follows from its complementarity row. The
+ * equalities are rows of A as well. With a vector rho the system is
+ * refactored with a large rho on these rows and a small one on the others,
+ * see solve_derivative_system, which makes M close to K.
+ */
+static OSQPInt deriv_apply_prec(OSQPSolver*      solver,
+                                deriv_gmres*     s,
+                                const OSQPFloat* v,
+                                OSQPFloat*       out,
+                                OSQPInt          transpose) {
+
+    OSQPWorkspace* work = solver->work;
+    const OSQPDerivativeData* derivative_data = work->derivative_data;
+
+    OSQPInt n        = work->data->n;
+    OSQPInt m        = work->data->m;
+    OSQPInt n_ineq_l = derivative_data->n_ineq_l;
+    OSQPInt n_ineq   = n_ineq_l + derivative_data->n_ineq_u;
+    OSQPInt n_eq     = derivative_data->n_eq;
+    OSQPInt i, j, row;
+    OSQPFloat sign;
+    OSQPInt exitflag;
+
+    OSQPFloat* lambda = OSQPVectorf_data(derivative_data->lambda);
+    OSQPFloat* slacks = OSQPVectorf_data(derivative_data->slacks);
+    OSQPFloat* t      = OSQPVectorf_data(s->t);
+    OSQPFloat* uw     = OSQPVectorf_data(s->uw);
+    OSQPFloat* kkt    = OSQPVectorf_data(s->kkt);
+    OSQPFloat* rho    = solver->settings->rho_is_vec ? OSQPVectorf_data(s->rho) : OSQP_NULL;
+
+    const OSQPFloat* v2 = v + n;
+    const OSQPFloat* v3 = v + n + n_ineq;
+
+    // ---------- Right-hand side of the ADMM system
+    for (i = 0; i < m; i++) uw[i] = 0;
+    for (j = 0; j < n_ineq; j++) {
+        // Row of A of the inequality and the sign it has in G
+        row  = (j < n_ineq_l) ? derivative_data->ineq_l_idx[j] : derivative_data->ineq_u_idx[j - n_ineq_l];
+        sign = (j < n_ineq_l) ? -1 : 1;
+        t[j] = 0;
+        if (lambda[j] > -slacks[j]) {
+            uw[row] += transpose ? sign * v2[j] : sign * v2[j] / lambda[j];
+        } else if (!transpose && slacks[j] != 0) {
+            t[j] = v2[j] / slacks[j];
+        }
     }
+    for (j = 0; j < n_eq; j++) uw[derivative_data->eq_idx[j]] += v3[j];
+
+    OSQPVectorf_from_raw(s->vx, v);
+    if (!transpose) OSQPMatrix_Atxpy(derivative_data->G, s->t, s->vx, -1, 1);
+
+    OSQPVectorf_to_raw(kkt, s->vx);
+    for (i = 0; i < m; i++) kkt[n + i] = uw[i];
+
+    exitflag = work->linsys_solver->solve(work->linsys_solver, s->kkt, 1);
+    if (exitflag) return exitflag;
+
+    // The solver returns x and z = A x, the multipliers are rho (z - uw)
+    for (i = 0; i < m; i++) uw[i] = (rho ? rho[i] : solver->settings->rho) * (kkt[n + i] - uw[i]);
+
+    // ---------- Solution
+    for (j = 0; j < n; j++) out[j] = kkt[j];
+
+    if (transpose) {
+        OSQPVectorf_from_raw(s->vx, kkt);
+        OSQPMatrix_Axpy(derivative_data->G, s->vx, s->t, 1, 0);
+    }
+    for (j = 0; j < n_ineq; j++) {
+        row  = (j < n_ineq_l) ? derivative_data->ineq_l_idx[j] : derivative_data->ineq_u_idx[j - n_ineq_l];
+        sign = (j < n_ineq_l) ? -1 : 1;
+        if (lambda[j] > -slacks[j]) {
+            out[n + j] = transpose ? sign * uw[row] / lambda[j] : sign * uw[row];
+        } else if (slacks[j] != 0) {
+            out[n + j] = transpose ? (v2[j] - t[j]) / slacks[j] : t[j];
+        } else {
+            out[n + j] = 0;
+        }
+    }
+    for (j = 0; j < n_eq; j++) out[n + n_ineq + j] = uw[derivative_data->eq_idx[j]];
 
-    OSQPVectorf_view_free(rx);
     return 0;
 }
 
+static OSQPFloat deriv_dot(const OSQPFloat* a,
+                           const OSQPFloat* b,
+                           OSQPInt          N) {
+    OSQPFloat s = 0;
+    OSQPInt   j;
+    for (j = 0; j < N; j++) s += a[j] * b[j];
+    return s;
+}
+
+/*
+ * Solve K x = b, or K' x = b if transpose is set, by restarted GMRES
+ * preconditioned on the right with deriv_apply_prec. b is overwritten by x.
+ * The iterations stop once the residual is eps_abs times the norm of b, and
+ * fail if that takes more than DERIV_GMRES_MAX_ITER of them.
+ */
+static OSQPInt deriv_gmres_solve(OSQPSolver*  solver,
+                                 deriv_gmres* s,
+                                 OSQPFloat*   b,
+                                 OSQPInt      transpose) {
+
+    const OSQPDerivativeData* derivative_data = solver->work->derivative_data;
+
+    OSQPInt   N = s->N;
+    OSQPInt   k = DERIV_GMRES_RESTART;
+    OSQPInt   iter = 0;
+    OSQPInt   i, j, l, jj;
+    OSQPInt   exitflag;
+    OSQPFloat beta, tol, h, d;
+
+    OSQPFloat* r = s->r;
+    OSQPFloat* V = s->V;
+    OSQPFloat* H = s->H;
+
+    beta = c_sqrt(deriv_dot(b, b, N));
+    if (beta == 0) return 0;
+    tol = solver->settings->eps_abs * beta;
+
+    // The solution is accumulated in w, starting from zero
+    for (j = 0; j < N; j++) {
+        s->w[j] = 0;
+        r[j]    = b[j];
+    }
+
+    while (iter < DERIV_GMRES_MAX_ITER) {
+        // ---------- Arnoldi process from the residual r
+        for (j = 0; j < N; j++) V[j] = r[j] / beta;
+        s->g[0] = beta;
+
+        jj = 0;
+        while (jj < k && iter < DERIV_GMRES_MAX_ITER) {
+            OSQPFloat* vj  = V + jj * N;
+            OSQPFloat* vj1 = V + (jj + 1) * N;
+
+            exitflag = deriv_apply_prec(solver, s, vj, s->z, transpose);
+            if (exitflag) return exitflag;
+            deriv_apply_K(derivative_data, s, s->z, vj1, transpose);
+
+            for (i = 0; i <= jj; i++) {
+                h = deriv_dot(vj1, V + i * N, N);
+                H[i * k + jj] = h;
+                for (j = 0; j < N; j++) vj1[j] -= h * V[i * N + j];
+            }
+            h = c_sqrt(deriv_dot(vj1, vj1, N));
+            H[(jj + 1) * k + jj] = h;
+            if (h != 0) for (j = 0; j < N; j++) vj1[j] /= h;
+
+            // Givens rotations of the new column
+            for (i = 0; i < jj; i++) {
+                d = s->cs[i] * H[i * k + jj] + s->sn[i] * H[(i + 1) * k + jj];
+                H[(i + 1) * k + jj] = -s->sn[i] * H[i * k + jj] + s->cs[i] * H[(i + 1) * k + jj];
+                H[i * k + jj] = d;
+            }
+            d = c_sqrt(H[jj * k + jj] * H[jj * k + jj] + h * h);
+            s->cs[jj] = (d != 0) ? H[jj * k + jj] / d : 1;
+            s->sn[jj] = (d != 0) ? h / d : 0;
+            H[jj * k + jj] = d;
+            H[(jj + 1) * k + jj] = 0;
+            s->g[jj + 1] = -s->sn[jj] * s->g[jj];
+            s->g[jj]     =  s->cs[jj] * s->g[jj];
+
+            jj++;
+            iter++;
+            if (c_absval(s->g[jj]) <= tol || h == 0) break;
+        }
+
+        // ---------- Update of the solution, w += M^-1 V y with H y = g
+        for (i = jj - 1; i >= 0; i--) {
+            d = s->g[i];
+            for (l = i + 1; l < jj; l++) d -= H[i * k + l] * s->g[l];
+            s->g[i] = (H[i * k + i] != 0) ? d / H[i * k + i] : 0;
+        }
+        for (j = 0; j < N; j++) r[j] = 0;
+        for (i = 0; i < jj; i++) {
+            for (j = 0; j < N; j++) r[j] += s->g[i] * V[i * N + j];
+        }
+        exitflag = deriv_apply_prec(solver, s, r, s->z, transpose);
+        if (exitflag) return exitflag;
+        for (j = 0; j < N; j++) s->w[j] += s->z[j];
+
+        // ---------- True residual
+        deriv_apply_K(derivative_data, s, s->w, r, transpose);
+        for (j = 0; j < N; j++) r[j] = b[j] - r[j];
+        beta = c_sqrt(deriv_dot(r, r, N));
+        if (beta <= tol) break;
+    }
+
+    if (beta > tol) {
+        c_eprint("GMRES stopped at residual %.2e > %.2e after %i iterations",
+                 beta, tol, (int)iter);
+        return OSQP_ITERATIVE_SOLVE_ERROR;
+    }
+
+    for (j = 0; j < N; j++) b[j] = s->w[j];
+
+    return 0;
+}
+
+/*
+ * Solve the derivative system for nrhs right-hand sides stored ld apart in
+ * derivative_data->rhs. The adjoint derivatives (transpose set) solve
+ * K' z = b with b the first half of every column, the forward derivatives
+ * K d = -g with -g the second half. The direct solver factors the whole
+ * system and the iterative one solves with K or K' on their half.
+ */
+static OSQPInt solve_derivative_system(OSQPSolver* solver,
+                                       OSQPInt     nrhs,
+                                       OSQPInt     ld,
+                                       OSQPInt     new_partition,
+                                       OSQPInt     transpose) {
+
+    OSQPDerivativeData* derivative_data = solver->work->derivative_data;
+    OSQPInt n = solver->work->data->n;
+    OSQPInt m = solver->work->data->m;
+    OSQPInt N = n + derivative_data->n_ineq_l + derivative_data->n_ineq_u + derivative_data->n_eq;
+    OSQPInt exitflag = 0;
+    OSQPInt j, k;
+
+    if (!solver->settings->derivative_iterative) {
+        // One factorization serves all right-hand sides
+        return adjoint_derivative_linsys_solver(&derivative_data->adj_solver, solver->settings,
+                                                derivative_data->P_full, derivative_data->G,
+                                                derivative_data->A_eq, derivative_data->GDiagLambda,
+                                                derivative_data->slacks, derivative_data->rhs,
+                                                nrhs, ld, new_partition);
+    }
+
+    // The preconditioner has to solve the ADMM system exactly
+    LinSysSolver* linsys_solver = solver->work->linsys_solver;
+    if (linsys_solver->type != OSQP_DIRECT_SOLVER) {
+        c_eprint("derivative_iterative needs the direct linear system solver");
+        return OSQP_SETTINGS_VALIDATION_ERROR;
+    }
+
+    // The factorization of the direct solver would be out of date
+    adjoint_derivative_linsys_free(derivative_data->adj_solver);
+    derivative_data->adj_solver = OSQP_NULL;
+
+    deriv_gmres s = {0};
+    exitflag = deriv_gmres_init(&s, derivative_data, n, m);
+
+    // Refactor the ADMM system with the rows of the partition close to
+    // equalities and the other rows close to free. Only the values change,
+    // the symbolic factorization of the solver is kept.
+    OSQPInt refactored = 0;
+    if (!exitflag && solver->settings->rho_is_vec) {
+        OSQPFloat* rho    = OSQPVectorf_data(s.rho);
+        OSQPFloat* lambda = OSQPVectorf_data(derivative_data->lambda);
+        OSQPFloat* slacks = OSQPVectorf_data(derivative_data->slacks);
+        OSQPInt    n_ineq_l = derivative_data->n_ineq_l;
+
+        OSQPVectorf_set_scalar(s.rho, OSQP_RHO_MIN);
+        for (j = 0; j < n_ineq_l; j++) {
+            if (lambda[j] > -slacks[j]) rho[derivative_data->ineq_l_idx[j]] = OSQP_RHO_MAX;
+        }
+        for (j = 0; j < derivative_data->n_ineq_u; j++) {
+            if (lambda[n_ineq_l + j] > -slacks[n_ineq_l + j]) rho[derivative_data->ineq_u_idx[j]] = OSQP_RHO_MAX;
+        }
+        for (j = 0; j < derivative_data->n_eq; j++) rho[derivative_data->eq_idx[j]] = OSQP_RHO_MAX;
+
+        if (linsys_solver->update_rho_vec(linsys_solver, s.rho, solver->settings->rho))
+            exitflag = OSQP_NONCVX_ERROR;
+        refactored = 1;
+    }
+
+    for (k = 0; k < nrhs && !exitflag; k++) {
+        OSQPFloat* rhs_data = OSQPVectorf_data(derivative_data->rhs) + k * ld;
+
+        if (transpose) {
+            for (j = 0; j < N; j++) rhs_data[N + j] = rhs_data[j];
+            exitflag = deriv_gmres_solve(solver, &s, rhs_data + N, 1);
+            for (j = 0; j < N; j++) rhs_data[j] = 0;
+        } else {
+            for (j = 0; j < N; j++) rhs_data[j] = rhs_data[N + j];
+            exitflag = deriv_gmres_solve(solver, &s, rhs_data, 0);
+            for (j = 0; j < N; j++) rhs_data[N + j] = 0;
+        }
+    }
+
+    // Back to the factorization of the ADMM iterations
+    if (refactored &&
+        linsys_solver->update_rho_vec(linsys_solver, solver->work->rho_vec, solver->settings->rho))
+        exitflag = OSQP_NONCVX_ERROR;
+
+    deriv_gmres_free(&s);
+
+    return exitflag;
+}
+
 OSQPInt adjoint_derivative_compute(OSQPSolver *solver,
+                                   OSQPInt        n_seeds,
                                    OSQPFloat*     dx,
                                    OSQPFloat*     dy_l,
                                    OSQPFloat*     dy_u) {
@@ -108,221 +790,240 @@ OSQPInt adjoint_derivative_compute(OSQPSolver *solver,
     OSQPInt m = solver->work->data->m;
     OSQPInt n = solver->work->data->n;
     OSQPDerivativeData *derivative_data = solver->work->derivative_data;
+    OSQPInt exitflag;
 
-    OSQPMatrix*  P = OSQPMatrix_copy_new(solver->work->data->P);
-    OSQPMatrix*  A = OSQPMatrix_copy_new(solver->work->data->A);
-    OSQPVectorf* l = OSQPVectorf_copy_new(solver->work->data->l);
-    OSQPVectorf* u = OSQPVectorf_copy_new(solver->work->data->u);
-    OSQPVectorf* x = OSQPVectorf_new(solver->solution->x, n);  // Note: x/y are unscaled solutions
-    OSQPVectorf* y = OSQPVectorf_new(solver->solution->y, m);
+    exitflag = reserve_seeds(derivative_data, n_seeds, n, m);
+    if (exitflag) return osqp_error(exitflag);
+    derivative_data->n_seeds = 0;
 
-    // TODO: If we didn't have to unscale P/A/l/u we would not have to copy these
-    if (solver->settings->scaling) unscale_PA(solver, P, A);
-    if (solver->settings->scaling) unscale_lu(solver, l, u);
+    OSQPInt new_partition;
+    exitflag = assemble_derivative_system(solver, &new_partition);
+    if (exitflag) return osqp_error(exitflag);
 
-    OSQPFloat* l_data = OSQPVectorf_data(l);
-    OSQPFloat* u_data = OSQPVectorf_data(u);
-    OSQPFloat* y_data = OSQPVectorf_data(y);
+    OSQPInt n_ineq_l = derivative_data->n_ineq_l;
+    OSQPInt n_ineq_u = derivative_data->n_ineq_u;
+    OSQPInt n_eq     = derivative_data->n_eq;
 
-    OSQPInt* A_ineq_l_vec = (OSQPInt *) c_malloc(m * sizeof(OSQPInt));
-    OSQPInt* A_ineq_u_vec = (OSQPInt *) c_malloc(m * sizeof(OSQPInt));
-    OSQPInt* A_eq_vec = (OSQPInt *) c_malloc(m * sizeof(OSQPInt));
+    OSQPInt* ineq_l_idx = derivative_data->ineq_l_idx;
+    OSQPInt* ineq_u_idx = derivative_data->ineq_u_idx;
+    OSQPInt* eq_idx     = derivative_data->eq_idx;
+    OSQPInt* nu_sign    = derivative_data->nu_sign;
 
-    OSQPInt* eq_indices_vec = (OSQPInt *) c_malloc(m * sizeof(OSQPInt));
-    OSQPInt* l_noninf_indices_vec = (OSQPInt *) c_malloc(m * sizeof(OSQPInt));
-    OSQPInt* u_noninf_indices_vec = (OSQPInt *) c_malloc(m * sizeof(OSQPInt));
-    OSQPInt* nu_sign_vec = (OSQPInt *) c_malloc(m * sizeof(OSQPInt));
+    OSQPFloat* y_data   = OSQPVectorf_data(derivative_data->y);
+    OSQPFloat* y_l_data = OSQPVectorf_data(derivative_data->y_l);
+    OSQPFloat* y_u_data = OSQPVectorf_data(derivative_data->y_u);
 
-    OSQPVectorf* dy_l_vec = OSQPVectorf_new(dy_l, m);
-    OSQPVectorf* dy_u_vec = OSQPVectorf_new(dy_u, m);
+    // ---------- Assemble RHS of the linear systems, one column per seed
+    OSQPInt ld = 2 * (n + 2*m);
+    OSQPInt j, k, pos;
+    for (k=0; k<n_seeds; k++) {
+        OSQPFloat* rhs_data = OSQPVectorf_data(derivative_data->rhs) + k * ld;
+        OSQPFloat* dx_k     = dx + k * n;
+        OSQPFloat* dy_l_k   = dy_l + k * m;
+        OSQPFloat* dy_u_k   = dy_u + k * m;
 
-    // TODO: We could use constr_type in OSQPWorkspace but it only tells us whether a constraint is 'loose'
-    // not 'upper loose' or 'lower loose', which we seem to need here.
-    OSQPFloat infval = OSQP_INFTY * OSQP_MIN_SCALING;
+        pos = 0;
+        for (j=0; j<n; j++) rhs_data[j] = -dx_k[j];
+        pos += n;
+        for (j=0; j<n_ineq_l; j++) rhs_data[pos+j] = -dy_l_k[ineq_l_idx[j]];
+        pos += n_ineq_l;
+        for (j=0; j<n_ineq_u; j++) rhs_data[pos+j] = -dy_u_k[ineq_u_idx[j]];
+        pos += n_ineq_u;
+        for (j=0; j<n_eq; j++) {
+          if (nu_sign[j]==1) {
+            rhs_data[pos+j] = -dy_u_k[eq_idx[j]];
+          } else {
+            rhs_data[pos+j] = dy_l_k[eq_idx[j]];
+          }
+        }
+        pos += n_eq;
+        for (j=0; j<n + n_ineq_l + n_ineq_u + n_eq; j++) rhs_data[pos+j] = 0;
 
-    OSQPInt n_ineq_l = 0;
-    OSQPInt n_ineq_u = 0;
-    OSQPInt n_eq = 0;
+        scale_system_vector(solver, rhs_data, 0);
+    }
+    // ---------- Assemble RHS of the linear systems
 
-    OSQPInt j;
-    for (j = 0; j < m; j++) {
-        OSQPFloat _l = l_data[j];
-        OSQPFloat _u = u_data[j];
-        if (_l < _u) {
-            A_eq_vec[j] = 0;
-            if (_l > -infval) {
-                l_noninf_indices_vec[n_ineq_l] = j;
-                A_ineq_l_vec[j] = 1;
-                n_ineq_l++;
-            } else {
-                A_ineq_l_vec[j] = 0;
-            }
-            if (_u < infval) {
-                u_noninf_indices_vec[n_ineq_u] = j;
-                A_ineq_u_vec[j] = 1;
-                n_ineq_u++;
-            } else {
-                A_ineq_u_vec[j] = 0;
-            }
-        } else {
-            eq_indices_vec[n_eq] = j;
-            A_eq_vec[j] = 1;
-            A_ineq_l_vec[j] = 0;
-            A_ineq_u_vec[j] = 0;
-            if (y_data[j] >= 0) {
-                nu_sign_vec[n_eq] = 1;
+    exitflag = solve_derivative_system(solver, n_seeds, ld, new_partition, 1);
+    if (exitflag) return osqp_error(exitflag);
+
+    for (k=0; k<n_seeds; k++) {
+        OSQPFloat* rhs_data = OSQPVectorf_data(derivative_data->rhs) + k * ld;
+        OSQPFloat* r_yl = OSQPVectorf_data(derivative_data->ryl) + k * m;
+        OSQPFloat* r_yu = OSQPVectorf_data(derivative_data->ryu) + k * m;
+
+        scale_system_vector(solver, rhs_data + n + n_ineq_l + n_ineq_u + n_eq, 1);
+
+        // TODO: We shouldn't have to do this if we assemble r_yl/r_yu judiciously
+        for (j=0; j<m; j++) r_yl[j] = 0;
+        for (j=0; j<m; j++) r_yu[j] = 0;
+
+        pos = 2 * n + n_ineq_l + n_ineq_u + n_eq;
+        for (j=0; j<n_ineq_l; j++) {
+            r_yl[ineq_l_idx[j]] = -rhs_data[pos+j];
+        }
+        pos += n_ineq_l;
+        for (j=0; j<n_ineq_u; j++) {
+            r_yu[ineq_u_idx[j]] = rhs_data[pos+j];
+        }
+        pos += n_ineq_u;
+        for (j=0; j<n_eq; j++) {
+            if (nu_sign[j]==1) {
+                r_yl[eq_idx[j]] = 0;
+                r_yu[eq_idx[j]] = rhs_data[pos+j] / y_data[eq_idx[j]];
             } else {
-                nu_sign_vec[n_eq] = -1;
+                r_yl[eq_idx[j]] = -rhs_data[pos+j] / y_data[eq_idx[j]];
+                r_yu[eq_idx[j]] = 0;
             }
-            n_eq++;
+        }
+
+        for (j=0; j<m; j++) {
+            r_yl[j] *= -y_l_data[j];
+            r_yu[j] *= y_u_data[j];
         }
     }
 
-    derivative_data->n_ineq_l = n_ineq_l;
-    derivative_data->n_ineq_u = n_ineq_u;
-    derivative_data->n_eq = n_eq;
+    derivative_data->n_seeds = n_seeds;
 
-    OSQPVectori* A_ineq_l_i = OSQPVectori_new(A_ineq_l_vec, m);
-    c_free(A_ineq_l_vec);
-    OSQPMatrix*  A_ineq_l = OSQPMatrix_submatrix_byrows(A, A_ineq_l_i);
-    OSQPMatrix_mult_scalar(A_ineq_l, -1);
+    return 0;
+}
 
-    OSQPVectori* A_ineq_u_i = OSQPVectori_new(A_ineq_u_vec, m);
-    c_free(A_ineq_u_vec);
-    OSQPMatrix*  A_ineq_u = OSQPMatrix_submatrix_byrows(A, A_ineq_u_i);
+// Multiplier of row i of A in the KKT conditions of the active partition
+static OSQPFloat partition_multiplier(const OSQPDerivativeData* derivative_data,
+                                      OSQPInt                   i) {
 
-    OSQPMatrix* G = OSQPMatrix_vstack(A_ineq_l, A_ineq_u);
+    OSQPInt   type = derivative_data->row_type[i];
+    OSQPFloat w    = 0;
 
-    OSQPMatrix_free(A_ineq_l);
-    OSQPMatrix_free(A_ineq_u);
+    if (type == DERIV_ROW_EQ)    return OSQPVectorf_data(derivative_data->y)[i];
+    if (type & DERIV_ROW_UPPER)  w += OSQPVectorf_data(derivative_data->y_u)[i];
+    if (type & DERIV_ROW_LOWER)  w -= OSQPVectorf_data(derivative_data->y_l)[i];
+    return w;
+}
 
-    OSQPVectori* A_eq_i = OSQPVectori_new(A_eq_vec, m);
-    c_free(A_eq_vec);
-    OSQPMatrix*  A_eq = OSQPMatrix_submatrix_byrows(A, A_eq_i);
-    OSQPVectori_free(A_eq_i);
-    OSQPMatrix_free(A);
+OSQPInt forward_derivative_compute(OSQPSolver*          solver,
+                                   OSQPInt              n_dirs,
+                                   const OSQPCscMatrix* dP,
+                                   const OSQPFloat*     dq,
+                                   const OSQPCscMatrix* dA,
+                                   const OSQPFloat*     dl,
+                                   const OSQPFloat*     du,
+                                   OSQPFloat*           dx,
+                                   OSQPFloat*           dy) {
 
-    // --------- lambda
-    OSQPVectorf* m_zeros = OSQPVectorf_malloc(m);
-    OSQPVectorf_set_scalar(m_zeros, 0);
-    OSQPVectorf_ew_max_vec(derivative_data->y_u, y, m_zeros);
-    OSQPVectorf_ew_min_vec(derivative_data->y_l, y, m_zeros);
-    OSQPVectorf_mult_scalar(derivative_data->y_l, -1);
-    OSQPVectorf_free(m_zeros);
-
-    OSQPVectorf* y_l_ineq = OSQPVectorf_subvector_byrows(derivative_data->y_l, A_ineq_l_i);
-    OSQPVectorf* y_u_ineq = OSQPVectorf_subvector_byrows(derivative_data->y_u, A_ineq_u_i);
-    OSQPVectorf* lambda = OSQPVectorf_concat(y_l_ineq, y_u_ineq);
-
-    OSQPVectorf_free(y_l_ineq);
-    OSQPVectorf_free(y_u_ineq);
-    // ---------- lambda
+    // Check if solver has been initialized
+    if (!solver || !solver->work || !solver->work->derivative_data)
+      return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
 
-    // --------- slacks
-    OSQPVectorf* l_ineq = OSQPVectorf_subvector_byrows(l, A_ineq_l_i);
-    OSQPVectorf_free(l);
-    OSQPVectorf_mult_scalar(l_ineq, -1);
-    OSQPVectorf* u_ineq = OSQPVectorf_subvector_byrows(u, A_ineq_u_i);
-    OSQPVectorf_free(u);
-    OSQPVectorf* h = OSQPVectorf_concat(l_ineq, u_ineq);
+    OSQPInt m = solver->work->data->m;
+    OSQPInt n = solver->work->data->n;
+    OSQPDerivativeData *derivative_data = solver->work->derivative_data;
+    OSQPInt exitflag;
 
-    OSQPVectorf_free(l_ineq);
-    OSQPVectorf_free(u_ineq);
+    // The right-hand sides share the buffer of the adjoint derivatives
+    exitflag = reserve_seeds(derivative_data, n_dirs, n, m);
+    if (exitflag) return osqp_error(exitflag);
+    derivative_data->n_seeds = 0;
 
-    OSQPVectorf* slacks = OSQPVectorf_copy_new(h);
-    OSQPVectorf_free(h);
-    OSQPMatrix_Axpy(G, x, slacks, 1, -1);
-    OSQPVectorf_free(x);
+    OSQPInt new_partition;
+    exitflag = assemble_derivative_system(solver, &new_partition);
+    if (exitflag) return osqp_error(exitflag);
 
-    // ---------- GDiagLambda
-    OSQPMatrix* GDiagLambda = OSQPMatrix_copy_new(G);
-    OSQPMatrix_lmult_diag(GDiagLambda, lambda);
-    OSQPVectorf_free(lambda);
-
-    // ---------- Assemble RHS of the linear system
-    OSQPVectorf* dy_l_ineq = OSQPVectorf_subvector_byrows(dy_l_vec, A_ineq_l_i);
-    OSQPVectorf_free(dy_l_vec);
-    OSQPVectori_free(A_ineq_l_i);
-    OSQPVectorf* dy_u_ineq = OSQPVectorf_subvector_byrows(dy_u_vec, A_ineq_u_i);
-    OSQPVectorf_free(dy_u_vec);
-    OSQPVectori_free(A_ineq_u_i);
-
-    OSQPVectorf *rhs = derivative_data->rhs;
-    OSQPInt pos = 0;
-    OSQPVectorf_subvector_assign(rhs, dx, pos, n, -1);
-    pos += n;
-    OSQPVectorf_subvector_assign(rhs, OSQPVectorf_data(dy_l_ineq), pos, n_ineq_l, -1);
-    OSQPVectorf_free(dy_l_ineq);
-    pos += n_ineq_l;
-    OSQPVectorf_subvector_assign(rhs, OSQPVectorf_data(dy_u_ineq), pos, n_ineq_u, -1);
-    OSQPVectorf_free(dy_u_ineq);
-    pos += n_ineq_u;
+    OSQPInt n_ineq_l = derivative_data->n_ineq_l;
+    OSQPInt n_ineq_u = derivative_data->n_ineq_u;
+    OSQPInt n_eq     = derivative_data->n_eq;
+    OSQPInt N        = n + n_ineq_l + n_ineq_u + n_eq;
 
-    OSQPFloat* d_nu_vec = (OSQPFloat *) c_malloc(n_eq * sizeof(OSQPFloat));
-    for (j=0; j<n_eq; j++) {
-      if (nu_sign_vec[j]==1) {
-        d_nu_vec[j] = dy_u[eq_indices_vec[j]];
-      } else if (nu_sign_vec[j]==-1) {
-        d_nu_vec[j] = -dy_l[eq_indices_vec[j]];
-      } else {}  // should never happen
-    }
-    OSQPVectorf_subvector_assign(rhs, d_nu_vec, pos, n_eq, -1);
-    c_free(d_nu_vec);
-    pos += n_eq;
-
-    OSQPVectorf_subvector_assign_scalar(rhs, 0, pos, n + n_ineq_l + n_ineq_u + n_eq);
-    // ---------- Assemble RHS of the linear system
-
-    OSQPMatrix* P_full = OSQPMatrix_triu_to_symm(P);
-    OSQPMatrix_free(P);
-    adjoint_derivative_linsys_solver(solver, solver->settings, P_full, G, A_eq, GDiagLambda, slacks, rhs);
-    OSQPMatrix_free(P_full);
-    OSQPMatrix_free(G);
-    OSQPMatrix_free(A_eq);
-    OSQPMatrix_free(GDiagLambda);
-    OSQPVectorf_free(slacks);
-
-    OSQPFloat* rhs_data = OSQPVectorf_data(rhs);
-
-    OSQPFloat* r_yl = (OSQPFloat *) c_malloc(m * sizeof(OSQPFloat));
-    OSQPFloat* r_yu = (OSQPFloat *) c_malloc(m * sizeof(OSQPFloat));
-    // TODO: We shouldn't have to do this if we assemble r_yl/r_yu judiciously
-    for (j=0; j<m; j++) r_yl[j] = 0;
-    for (j=0; j<m; j++) r_yu[j] = 0;
-
-    pos += n;
-    for (j=0; j<derivative_data->n_ineq_l; j++) {
-        r_yl[l_noninf_indices_vec[j]] = -rhs_data[pos+j];
-    }
-    c_free(l_noninf_indices_vec);
-    pos += derivative_data->n_ineq_l;
-    for (j=0; j<derivative_data->n_ineq_u; j++) {
-        r_yu[u_noninf_indices_vec[j]] = rhs_data[pos+j];
-    }
-    c_free(u_noninf_indices_vec);
-    pos += derivative_data->n_ineq_u;
-    for (j=0; j<derivative_data->n_eq; j++) {
-        if (nu_sign_vec[j]==1) {
-            r_yl[eq_indices_vec[j]] = 0;
-            r_yu[eq_indices_vec[j]] = rhs_data[pos+j] / y_data[eq_indices_vec[j]];
-        } else {
-            r_yl[eq_indices_vec[j]] = -rhs_data[pos+j] / y_data[eq_indices_vec[j]];
-            r_yu[eq_indices_vec[j]] = 0;
+    OSQPInt* ineq_l_idx = derivative_data->ineq_l_idx;
+    OSQPInt* ineq_u_idx = derivative_data->ineq_u_idx;
+    OSQPInt* eq_idx     = derivative_data->eq_idx;
+    OSQPInt* nu_sign    = derivative_data->nu_sign;
+
+    OSQPFloat* x_data   = OSQPVectorf_data(derivative_data->x);
+    OSQPFloat* y_l_data = OSQPVectorf_data(derivative_data->y_l);
+    OSQPFloat* y_u_data = OSQPVectorf_data(derivative_data->y_u);
+    OSQPFloat* Adx      = OSQPVectorf_data(derivative_data->Adx);
+
+    // ---------- Assemble RHS of the linear systems, one column per direction
+    //
+    // The derivatives d = (dx, dlambda, dnu) solve K d = -g with g the
+    // perturbation of the KKT conditions
+    //
+    //   g = [ dP x + dq + dG' lambda + dA_eq' nu ]
+    //       [ diag(lambda) (dG x - dh)           ]
+    //       [ dA_eq x - db                       ]
+    //
+    // which is the first half of the solution for the right-hand side [0; -g].
+    OSQPInt ld = 2 * (n + 2*m);
+    OSQPInt i, j, k, p, pos;
+    for (k=0; k<n_dirs; k++) {
+        OSQPFloat* rhs_data = OSQPVectorf_data(derivative_data->rhs) + k * ld;
+        OSQPFloat* g        = rhs_data + N;
+        const OSQPFloat* dl_k = dl ? dl + k * m : OSQP_NULL;
+        const OSQPFloat* du_k = du ? du + k * m : OSQP_NULL;
+
+        for (j=0; j<N; j++) rhs_data[j] = 0;
+
+        for (j=0; j<n; j++) g[j] = dq ? dq[k*n + j] : 0;
+        if (dP) csc_Axpy_sym_triu(&dP[k], x_data, g, 1, 1);
+
+        for (i=0; i<m; i++) Adx[i] = 0;
+        if (dA) {
+            for (j=0; j<n; j++) {
+                for (p=dA[k].p[j]; p<dA[k].p[j+1]; p++) {
+                    i = dA[k].i[p];
+                    Adx[i] += dA[k].x[p] * x_data[j];
+                    g[j]   += dA[k].x[p] * partition_multiplier(derivative_data, i);
+                }
+            }
+        }
+
+        pos = n;
+        for (j=0; j<n_ineq_l; j++) {
+            i = ineq_l_idx[j];
+            g[pos+j] = y_l_data[i] * ((dl_k ? dl_k[i] : 0) - Adx[i]);
+        }
+        pos += n_ineq_l;
+        for (j=0; j<n_ineq_u; j++) {
+            i = ineq_u_idx[j];
+            g[pos+j] = y_u_data[i] * (Adx[i] - (du_k ? du_k[i] : 0));
+        }
+        pos += n_ineq_u;
+        for (j=0; j<n_eq; j++) {
+            // The bound that moves with the equality is the one the adjoint
+            // derivatives assign the sensitivity to
+            i = eq_idx[j];
+            if (nu_sign[j]==1) {
+                g[pos+j] = Adx[i] - (du_k ? du_k[i] : 0);
+            } else {
+                g[pos+j] = Adx[i] - (dl_k ? dl_k[i] : 0);
+            }
         }
+
+        for (j=0; j<N; j++) g[j] = -g[j];
+        scale_system_vector(solver, g, 1);
+    }
+    // ---------- Assemble RHS of the linear systems
+
+    exitflag = solve_derivative_system(solver, n_dirs, ld, new_partition, 0);
+    if (exitflag) return osqp_error(exitflag);
+
+    // dy = dy_u - dy_l on the rows of the partition and zero elsewhere
+    for (k=0; k<n_dirs; k++) {
+        OSQPFloat* rhs_data = OSQPVectorf_data(derivative_data->rhs) + k * ld;
+        OSQPFloat* dy_k     = dy + k * m;
+
+        scale_system_vector(solver, rhs_data, 0);
+
+        for (j=0; j<n; j++) dx[k*n + j] = rhs_data[j];
+        for (i=0; i<m; i++) dy_k[i] = 0;
+
+        pos = n;
+        for (j=0; j<n_ineq_l; j++) dy_k[ineq_l_idx[j]] -= rhs_data[pos+j];
+        pos += n_ineq_l;
+        for (j=0; j<n_ineq_u; j++) dy_k[ineq_u_idx[j]] += rhs_data[pos+j];
+        pos += n_ineq_u;
+        for (j=0; j<n_eq; j++)     dy_k[eq_idx[j]] = rhs_data[pos+j];
     }
-    c_free(nu_sign_vec);
-    c_free(eq_indices_vec);
-
-    OSQPVectorf_from_raw(derivative_data->ryl, r_yl);
-    c_free(r_yl);
-    OSQPVectorf_ew_prod(derivative_data->ryl, derivative_data->ryl, derivative_data->y_l);
-    OSQPVectorf_mult_scalar(derivative_data->ryl, -1);
-    OSQPVectorf_from_raw(derivative_data->ryu, r_yu);
-    c_free(r_yu);
-    OSQPVectorf_ew_prod(derivative_data->ryu, derivative_data->ryu, derivative_data->y_u);
-
-    //cleanup
-    OSQPVectorf_free(y);
 
     return 0;
 }
@@ -16,6 +16,7 @@ const char *OSQP_ERROR_MESSAGE[] = {
   "Invalid defines for codegen",
   "Vector/matrix not initialized.",
   "Function not implemented.",
+  "Iterative solve did not converge.",
 
   /* This must always be the last item in the list */
   "Unknown error code."
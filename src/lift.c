@@ -0,0 +1,239 @@
+#include "lift.h"
+#include "csc_utils.h"
+
+
+OSQPInt lift_setup(OSQPLift**           liftp,
+                   const OSQPCscMatrix* F,
+                   const OSQPFloat*     D,
+                   const OSQPFloat*     q,
+                   const OSQPCscMatrix* A,
+                   const OSQPFloat*     l,
+                   const OSQPFloat*     u,
+                   OSQPInt              m,
+                   OSQPInt              n) {
+
+  OSQPInt   i, j, c, p, nz;
+  OSQPInt   k    = F->n;
+  OSQPInt   nnzA = A->p[n];
+  OSQPInt   nnzF = F->p[k];
+  OSQPInt*  next;
+  OSQPLift* lift;
+
+  lift = c_calloc(1, sizeof(OSQPLift));
+  *liftp = lift;
+  if (!lift) return 1;
+
+  lift->n = n;
+  lift->m = m;
+  lift->k = k;
+
+  lift->F      = csc_copy(F);
+  lift->q      = (OSQPFloat *) c_malloc((n + k) * sizeof(OSQPFloat));
+  lift->l      = (OSQPFloat *) c_malloc((m + k) * sizeof(OSQPFloat));
+  lift->u      = (OSQPFloat *) c_malloc((m + k) * sizeof(OSQPFloat));
+  lift->x_work = (OSQPFloat *) c_malloc((n + k) * sizeof(OSQPFloat));
+  lift->y_work = (OSQPFloat *) c_calloc(m + k, sizeof(OSQPFloat));
+  if (!lift->F || !lift->q || !lift->l || !lift->u || !lift->x_work || !lift->y_work) return 1;
+
+  lift->sol.x             = (OSQPFloat *) c_calloc(n + k, sizeof(OSQPFloat));
+  lift->sol.y             = (OSQPFloat *) c_calloc(m + k, sizeof(OSQPFloat));
+  lift->sol.prim_inf_cert = (OSQPFloat *) c_calloc(m + k, sizeof(OSQPFloat));
+  lift->sol.dual_inf_cert = (OSQPFloat *) c_calloc(n + k, sizeof(OSQPFloat));
+  if (!lift->sol.x || !lift->sol.y || !lift->sol.prim_inf_cert || !lift->sol.dual_inf_cert) return 1;
+
+  // q = [q; 0], l = u = [l; 0] and [u; 0] for t = F' x
+  for (j = 0; j < n; j++) lift->q[j] = q[j];
+  for (i = 0; i < m; i++) {
+    lift->l[i] = l[i];
+    lift->u[i] = u[i];
+  }
+  for (c = 0; c < k; c++) {
+    lift->q[n + c] = 0.0;
+    lift->l[m + c] = 0.0;
+    lift->u[m + c] = 0.0;
+  }
+
+  // P = diag(D, I), leaving out the zero entries of D
+  nz = k;
+  if (D) {
+    for (j = 0; j < n; j++) {
+      if (D[j] != 0.0) nz++;
+    }
+  }
+  lift->P = csc_spalloc(n + k, n + k, nz, 1, 0);
+  if (!lift->P) return 1;
+
+  nz = 0;
+  for (j = 0; j < n; j++) {
+    lift->P->p[j] = nz;
+    if (D && D[j] != 0.0) {
+      lift->P->i[nz] = j;
+      lift->P->x[nz] = D[j];
+      nz++;
+    }
+  }
+  for (c = 0; c < k; c++) {
+    lift->P->p[n + c] = nz;
+    lift->P->i[nz]    = n + c;
+    lift->P->x[nz]    = 1.0;
+    nz++;
+  }
+  lift->P->p[n + k] = nz;
+
+  // A = [A 0; F' -I]; column j of F' holds row j of F
+  lift->A = csc_spalloc(m + k, n + k, nnzA + nnzF + k, 1, 0);
+  next    = (OSQPInt *) c_calloc(n + 1, sizeof(OSQPInt));
+  if (!lift->A || !next) {
+    c_free(next);
+    return 1;
+  }
+
+  for (p = 0; p < nnzF; p++) next[F->i[p] + 1]++;
+  for (j = 0; j < n; j++) {
+    lift->A->p[j] = A->p[j] + next[j];
+    next[j + 1]  += next[j];
+  }
+
+  for (j = 0; j < n; j++) {
+    nz = lift->A->p[j];
+    for (p = A->p[j]; p < A->p[j + 1]; p++) {
+      lift->A->i[nz] = A->i[p];
+      lift->A->x[nz] = A->x[p];
+      nz++;
+    }
+    next[j] = nz;
+  }
+
+  // Columns of F in order keep the row indices sorted
+  for (c = 0; c < k; c++) {
+    for (p = F->p[c]; p < F->p[c + 1]; p++) {
+      j  = F->i[p];
+      nz = next[j]++;
+      lift->A->i[nz] = m + c;
+      lift->A->x[nz] = F->x[p];
+    }
+  }
+
+  nz = nnzA + nnzF;
+  for (c = 0; c < k; c++) {
+    lift->A->p[n + c] = nz;
+    lift->A->i[nz]    = m + c;
+    lift->A->x[nz]    = -1.0;
+    nz++;
+  }
+  lift->A->p[n + k] = nz;
+
+  c_free(next);
+
+  return 0;
+}
+
+
+void lift_free_data(OSQPLift* lift) {
+  if (lift) {
+    csc_spfree(lift->P);
+    csc_spfree(lift->A);
+    lift->P = OSQP_NULL;
+    lift->A = OSQP_NULL;
+  }
+}
+
+
+void lift_free(OSQPLift* lift) {
+  if (lift) {
+    lift_free_data(lift);
+    csc_spfree(lift->F);
+    c_free(lift->q);
+    c_free(lift->l);
+    c_free(lift->u);
+    c_free(lift->x_work);
+    c_free(lift->y_work);
+    c_free(lift->sol.x);
+    c_free(lift->sol.y);
+    c_free(lift->sol.prim_inf_cert);
+    c_free(lift->sol.dual_inf_cert);
+    c_free(lift);
+  }
+}
+
+
+void lift_solution(const OSQPLift* lift,
+                   OSQPSolution*   solution,
+                   OSQPFloat*      obj_val) {
+
+  OSQPInt   i, j, c, p;
+  OSQPFloat t, diff;
+
+  const OSQPCscMatrix* F = lift->F;
+  const OSQPFloat*     x = lift->sol.x;
+
+  for (j = 0; j < lift->n; j++) {
+    solution->x[j]             = x[j];
+    solution->dual_inf_cert[j] = lift->sol.dual_inf_cert[j];
+  }
+  for (i = 0; i < lift->m; i++) {
+    solution->y[i]             = lift->sol.y[i];
+    solution->prim_inf_cert[i] = lift->sol.prim_inf_cert[i];
+  }
+
+  // 1/2 x' F F' x - 1/2 t' t
+  if (obj_val) {
+    diff = 0.0;
+    for (c = 0; c < lift->k; c++) {
+      t = 0.0;
+      for (p = F->p[c]; p < F->p[c + 1]; p++) t += F->x[p] * x[F->i[p]];
+      diff += t * t - x[lift->n + c] * x[lift->n + c];
+    }
+    *obj_val += 0.5 * diff;
+  }
+}
+
+
+void lift_point(const OSQPLift*  lift,
+                const OSQPFloat* x,
+                const OSQPFloat* y,
+                OSQPFloat*       x_lift,
+                OSQPFloat*       y_lift) {
+
+  OSQPInt   i, j, c, p;
+  OSQPFloat t;
+
+  const OSQPCscMatrix* F = lift->F;
+
+  // The dual of t = F' x equals t at the optimum
+  if (x) {
+    for (j = 0; j < lift->n; j++) x_lift[j] = x[j];
+    for (c = 0; c < lift->k; c++) {
+      t = 0.0;
+      for (p = F->p[c]; p < F->p[c + 1]; p++) t += F->x[p] * x[F->i[p]];
+      x_lift[lift->n + c] = t;
+      y_lift[lift->m + c] = t;
+    }
+  }
+
+  if (y) {
+    for (i = 0; i < lift->m; i++) y_lift[i] = y[i];
+  }
+}
+
+
+void lift_vectors(OSQPLift*         lift,
+                  const OSQPFloat** q_new,
+                  const OSQPFloat** l_new,
+                  const OSQPFloat** u_new) {
+
+  OSQPInt i, j;
+
+  if (*q_new) {
+    for (j = 0; j < lift->n; j++) lift->q[j] = (*q_new)[j];
+    *q_new = lift->q;
+  }
+  if (*l_new) {
+    for (i = 0; i < lift->m; i++) lift->l[i] = (*l_new)[i];
+    *l_new = lift->l;
+  }
+  if (*u_new) {
+    for (i = 0; i < lift->m; i++) lift->u[i] = (*u_new)[i];
+    *u_new = lift->u;
+  }
+}
@@ -17,6 +17,14 @@
 
 #ifndef OSQP_EMBEDDED_MODE
 # include "polish.h"
+# include "bounds.h"
+# include "components.h"
+# include "dense.h"
+# include "riccati.h"
+# include "lift.h"
+# include "presolve.h"
+# include "reorder.h"
+# include "csc_utils.h"
 #endif
 
 #ifdef OSQP_ENABLE_DERIVATIVES
@@ -71,10 +79,30 @@ void osqp_get_dimensions(OSQPSolver* solver,
                          OSQPInt*    n) {
 
   /* Check if the solver has been initialized */
-  if (!solver || !solver->work || !solver->work->data) {
+  if (!solver || !solver->work) {
     *m = -1;
     *n = -1;
   }
+#ifndef OSQP_EMBEDDED_MODE
+  else if (solver->work->comp) {
+    *m = solver->work->comp->m;
+    *n = solver->work->comp->n;
+  }
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+  else if (!solver->work->data) {
+    *m = -1;
+    *n = -1;
+  }
+#ifndef OSQP_EMBEDDED_MODE
+  else if (solver->work->lift) {
+    *m = solver->work->lift->m;
+    *n = solver->work->lift->n;
+  }
+  else if (solver->work->presolve) {
+    *m = solver->work->presolve->m;
+    *n = solver->work->presolve->n;
+  }
+#endif /* ifndef OSQP_EMBEDDED_MODE */
   else {
     *m = solver->work->data->m;
     *n = solver->work->data->n;
@@ -88,12 +116,16 @@ void osqp_set_default_codegen_defines(OSQPCodegenDefines* defines) {
   if (!defines)
     return;
 
-  defines->embedded_mode      = 1;  /* Default to vector updates only */
-  defines->float_type         = 0;  /* Default to double */
-  defines->printing_enable    = 0;  /* Default to no printing */
-  defines->profiling_enable   = 0;  /* Default to no timing */
-  defines->interrupt_enable   = 0;  /* Default to no interrupts */
-  defines->derivatives_enable = 0;  /* Default to no derivatives */
+  defines->embedded_mode       = 1;  /* Default to vector updates only */
+  defines->float_type          = 0;  /* Default to double */
+  defines->printing_enable     = 0;  /* Default to no printing */
+  defines->profiling_enable    = 0;  /* Default to no timing */
+  defines->interrupt_enable    = 0;  /* Default to no interrupts */
+  defines->derivatives_enable  = 0;  /* Default to no derivatives */
+  defines->unroll_enable       = 0;  /* Default to the generic sparse kernels */
+  defines->fixed_dims_enable   = 0;  /* Default to runtime vector lengths */
+  defines->rho_ladder_size     = 0;  /* Default to no adaptive rho in embedded mode 1 */
+  defines->fixed_point_enable  = 0;  /* Default to floating-point arithmetic */
 }
 
 
@@ -108,6 +140,7 @@ void osqp_set_default_settings(OSQPSettings* settings) {
   settings->verbose        = OSQP_VERBOSE;                   /* print output */
   settings->warm_starting  = OSQP_WARM_STARTING;             /* warm starting */
   settings->scaling        = OSQP_SCALING;                   /* heuristic problem scaling */
+  settings->scaling_type   = OSQP_SCALING_RUIZ_INF;          /* scaling strategy */
   settings->polishing      = OSQP_POLISHING;                 /* ADMM solution polish: 1 */
 
   settings->rho           = (OSQPFloat)OSQP_RHO;    /* ADMM step */
@@ -136,32 +169,188 @@ void osqp_set_default_settings(OSQPSettings* settings) {
 
   settings->delta              = OSQP_DELTA;                    /* regularization parameter for polishing */
   settings->polish_refine_iter = OSQP_POLISH_REFINE_ITER;       /* iterative refinement steps in polish */
+
+  settings->presolve     = OSQP_PRESOLVE;      /* remove fixed variables and redundant constraints */
+  settings->split_bounds = OSQP_SPLIT_BOUNDS;  /* constraints on a single variable out of the KKT matrix */
+  settings->split_dense  = OSQP_SPLIT_DENSE;   /* dense rows and columns of A out of the KKT matrix */
+  settings->split_components = OSQP_SPLIT_COMPONENTS; /* independent blocks as separate QPs */
+
+  settings->spmv_single = OSQP_SPMV_SINGLE;  /* single precision matrix values in matrix-vector products */
+  settings->reorder     = OSQP_REORDER;      /* bandwidth reducing reordering of the problem */
+  settings->spmv_full   = OSQP_SPMV_FULL;    /* both triangles of P in matrix-vector products */
+
+  settings->freeze_scaling = OSQP_FREEZE_SCALING; /* keep the setup scaling on matrix updates */
+
+  settings->derivative_iterative = OSQP_DERIVATIVE_ITERATIVE; /* iterative solve of the derivative system */
 }
 
+/* Copy a user vector into a vector of variables (is_x) or constraints,
+ * applying the internal reordering if there is one */
+static void vec_from_user(OSQPWorkspace*   work,
+                          OSQPVectorf*     dst,
+                          const OSQPFloat* src,
+                          OSQPInt          is_x) {
+
 #ifndef OSQP_EMBEDDED_MODE
+  if (work->reorder) {
+    reorder_gather(work->reorder->val_work, src,
+                   is_x ? work->reorder->xperm : work->reorder->cperm,
+                   OSQPVectorf_length(dst));
+    src = work->reorder->val_work;
+  }
+#endif /* ifndef OSQP_EMBEDDED_MODE */
 
+  OSQPVectorf_from_raw(dst, src);
+}
 
-OSQPInt osqp_setup(OSQPSolver**         solverp,
-                   const OSQPCscMatrix* P,
-                   const OSQPFloat*     q,
-                   const OSQPCscMatrix* A,
-                   const OSQPFloat*     l,
-                   const OSQPFloat*     u,
-                   OSQPInt              m,
-                   OSQPInt              n,
-                   const OSQPSettings*  settings) {
+#ifndef OSQP_EMBEDDED_MODE
+
+/* Number of entries in one OSQP_VECTOR_ALIGNMENT-byte block */
+#define WORK_STRIDE ((OSQPInt)(OSQP_VECTOR_ALIGNMENT / sizeof(OSQPFloat)))
+
+/* Length rounded up to a whole number of aligned blocks */
+#define WORK_ALIGNED(len) ((((len) + WORK_STRIDE - 1) / WORK_STRIDE) * WORK_STRIDE)
+
+/* Carve the next aligned vector of the given length out of the workspace block */
+static OSQPVectorf* work_view(const OSQPVectorf* slab,
+                              OSQPInt*           head,
+                              OSQPInt            length) {
+
+  OSQPVectorf* view = OSQPVectorf_view(slab, *head, length);
+  *head += WORK_ALIGNED(length);
+  return view;
+}
+
+
+/* Set up a solver that only holds the solvers of the independent subproblems */
+static OSQPInt setup_components(OSQPSolver**         solverp,
+                                OSQPComponents*      comp,
+                                const OSQPCscMatrix* P,
+                                const OSQPFloat*     q,
+                                const OSQPCscMatrix* A,
+                                const OSQPFloat*     l,
+                                const OSQPFloat*     u,
+                                const OSQPSettings*  settings) {
 
   OSQPInt exitflag;
+  OSQPInt n = comp->n;
+  OSQPInt m = comp->m;
 
   OSQPSolver*    solver;
   OSQPWorkspace* work;
 
+  // Allocate empty solver and workspace, which owns the components from here on
+  solver = c_calloc(1, sizeof(OSQPSolver));
+  work   = c_calloc(1, sizeof(OSQPWorkspace));
+  if (!(solver) || !(work)) {
+    c_free(solver);
+    c_free(work);
+    components_free(comp);
+    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  }
+  *solverp     = solver;
+  solver->work = work;
+  work->comp   = comp;
+
+  solver->info = c_calloc(1, sizeof(OSQPInfo));
+  if (!(solver->info)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+
+# ifdef OSQP_ENABLE_PROFILING
+  work->timer = OSQPTimer_new();
+  if (!(work->timer)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  osqp_tic(work->timer);
+# endif /* ifdef OSQP_ENABLE_PROFILING */
+
+  // Balance the release of the algebra libraries in osqp_cleanup
+  exitflag = osqp_algebra_init_libs(settings->device);
+  if (exitflag) return osqp_error(OSQP_ALGEBRA_LOAD_ERROR);
+
+  solver->settings = copy_settings(settings);
+  if (!(solver->settings)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+
+  solver->solution = c_calloc(1, sizeof(OSQPSolution));
+  if (!(solver->solution)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  solver->solution->x             = c_calloc(1, n * sizeof(OSQPFloat));
+  solver->solution->y             = c_calloc(1, m * sizeof(OSQPFloat));
+  solver->solution->prim_inf_cert = c_calloc(1, m * sizeof(OSQPFloat));
+  solver->solution->dual_inf_cert = c_calloc(1, n * sizeof(OSQPFloat));
+  if ( !(solver->solution->x) || !(solver->solution->dual_inf_cert) )
+    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  if ( m && (!(solver->solution->y) || !(solver->solution->prim_inf_cert)) )
+    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+
+  // The subproblems report their own errors
+  exitflag = components_setup_solvers(comp, P, q, A, l, u, settings);
+  if (exitflag == OSQP_NONCVX_ERROR) update_status(solver->info, OSQP_NON_CVX);
+  if (exitflag) return exitflag;
+
+  solver->info->status_polish = OSQP_POLISH_NOT_PERFORMED;
+  update_status(solver->info, OSQP_UNSOLVED);
+# ifdef OSQP_ENABLE_PROFILING
+  solver->info->solve_time  = 0.0;
+  solver->info->update_time = 0.0;
+  solver->info->polish_time = 0.0;
+  solver->info->run_time    = 0.0;
+  solver->info->setup_time  = osqp_toc(work->timer);
+
+  work->first_run = 1;
+# endif /* ifdef OSQP_ENABLE_PROFILING */
+  solver->info->rho_updates  = 0;
+  solver->info->rho_estimate = solver->settings->rho;
+  solver->info->obj_val      = OSQP_INFTY;
+  solver->info->prim_res     = OSQP_INFTY;
+  solver->info->dual_res     = OSQP_INFTY;
+
+# ifdef OSQP_ENABLE_PRINTING
+  if (solver->settings->verbose) print_setup_header(solver);
+# endif /* ifdef OSQP_ENABLE_PRINTING */
+
+  return 0;
+}
+
+
+/* Setup shared by osqp_setup and osqp_setup_stages, the stages are only used by the Riccati solver */
+static OSQPInt setup_solver(OSQPSolver**         solverp,
+                            const OSQPCscMatrix* P,
+                            const OSQPFloat*     q,
+                            const OSQPCscMatrix* A,
+                            const OSQPFloat*     l,
+                            const OSQPFloat*     u,
+                            OSQPInt              m,
+                            OSQPInt              n,
+                            const OSQPSettings*  settings,
+                            OSQPInt              n_stages,
+                            const OSQPInt*       stage_n,
+                            OSQPLift*            lift) {
+
+  OSQPInt exitflag;
+  OSQPInt head;
+
+  OSQPSolver*     solver;
+  OSQPWorkspace*  work;
+  OSQPComponents* comp;
+
   // Validate data
   if (validate_data(P,q,A,l,u,m,n)) return osqp_error(OSQP_DATA_VALIDATION_ERROR);
 
   // Validate settings
   if (validate_settings(settings, 1)) return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
 
+  if (settings->linsys_solver == OSQP_RICCATI_SOLVER && !stage_n) {
+    c_eprint("the Riccati solver needs the stages of the problem, see osqp_setup_stages");
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+
+  // Solve the independent blocks of the problem as separate QPs
+  if (settings->split_components) {
+    if (components_setup(&comp, P, A, m, n)) {
+      components_free(comp);
+      return osqp_error(OSQP_MEM_ALLOC_ERROR);
+    }
+    if (comp->n_comp > 1) return setup_components(solverp, comp, P, q, A, l, u, settings);
+    components_free(comp);
+  }
+
   // Allocate empty solver
   solver = c_calloc(1, sizeof(OSQPSolver));
   if (!(solver)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
@@ -172,6 +361,9 @@ OSQPInt osqp_setup(OSQPSolver**         solverp,
   if (!(work)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
   solver->work = work;
 
+  // The workspace owns the lifting of a factor model problem
+  work->lift = lift;
+
   // Allocate empty info struct
   solver->info = c_calloc(1, sizeof(OSQPInfo));
   if (!(solver->info)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
@@ -187,76 +379,122 @@ OSQPInt osqp_setup(OSQPSolver**         solverp,
   exitflag = osqp_algebra_init_libs(settings->device);
   if (exitflag) return osqp_error(OSQP_ALGEBRA_LOAD_ERROR);
 
+  // Reduce the problem and work on the reduced data from here on
+  if (settings->presolve) {
+    if (presolve_setup(&work->presolve, P, q, A, l, u)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+    P = work->presolve->P;
+    q = work->presolve->q;
+    A = work->presolve->A;
+    l = work->presolve->l;
+    u = work->presolve->u;
+    n = work->presolve->n_red;
+    m = work->presolve->m_red;
+  }
+  else {
+    work->presolve = OSQP_NULL;
+  }
+
   // Copy problem data into workspace
   work->data = c_calloc(1, sizeof(OSQPData));
   if (!(work->data)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
   work->data->m = m;
   work->data->n = n;
 
-  // objective function
-  work->data->P = OSQPMatrix_new_from_csc(P,1);   //copy assuming triu form
-  work->data->q = OSQPVectorf_new(q,n);
-  if (!(work->data->P) || !(work->data->q)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  // Copy problem matrices
+  if (settings->reorder) {
+    // Reorder the variables and constraints before copying
+    if (reorder_setup(&work->reorder, P, A)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+    work->data->P = OSQPMatrix_new_from_csc(work->reorder->P,1);
+    work->data->A = OSQPMatrix_new_from_csc(work->reorder->A,0);
+    reorder_free_data(work->reorder);
+  }
+  else {
+    work->reorder = OSQP_NULL;
+    work->data->P = OSQPMatrix_new_from_csc(P,1);   //copy assuming triu form
+    work->data->A = OSQPMatrix_new_from_csc(A,0);   //assumes non-triu form (i.e. full)
+  }
+  if (!(work->data->P) || !(work->data->A)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
 
-  // Constraints
-  work->data->A = OSQPMatrix_new_from_csc(A,0); //assumes non-triu form (i.e. full)
-  if (!(work->data->A)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
-  work->data->l = OSQPVectorf_new(l,m);
-  work->data->u = OSQPVectorf_new(u,m);
-  if (!(work->data->l) || !(work->data->u))
-    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  // Detect a zero or diagonal P (the pattern does not depend on the reordering)
+  if (init_P_struct(solver, P)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
 
   if (settings->rho_is_vec) {
-    // Vectorized rho parameter
-    work->rho_vec     = OSQPVectorf_malloc(m);
-    work->rho_inv_vec = OSQPVectorf_malloc(m);
-    if (!(work->rho_vec) || !(work->rho_inv_vec))
-      return osqp_error(OSQP_MEM_ALLOC_ERROR);
-
     // Type of constraints
     work->constr_type = OSQPVectori_calloc(m);
     if (!(work->constr_type)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
   }
+
+  // Constraint partition for the projection
+  work->proj_idx = OSQPVectori_malloc(m);
+  if (!(work->proj_idx)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+
+  // Allocate the data vectors and the ADMM vectors as aligned views into
+  // a single block. The data vectors live in the block as well since
+  // osqp_update_data_vec swaps l and u with z_prev and delta_y.
+  work->slab = OSQPVectorf_calloc(WORK_STRIDE - 1 +
+                                  8 * WORK_ALIGNED(n) +
+                                  WORK_ALIGNED(n + m) +
+                                  (settings->rho_is_vec ? 10 : 8) * WORK_ALIGNED(m));
+  if (!(work->slab)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  head = OSQPVectorf_align_offset(work->slab);
+
+  // Layout follows the order in which an ADMM iteration touches the vectors
+  work->x_prev  = work_view(work->slab, &head, n);
+  work->z_prev  = work_view(work->slab, &head, m);
+  work->data->q = work_view(work->slab, &head, n);
+  if (!(work->x_prev) || !(work->z_prev) || !(work->data->q))
+    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  if (settings->rho_is_vec) {
+    // Vectorized rho parameter
+    work->rho_vec     = work_view(work->slab, &head, m);
+    work->rho_inv_vec = work_view(work->slab, &head, m);
+    if (!(work->rho_vec) || !(work->rho_inv_vec))
+      return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  }
   else {
     work->rho_vec     = OSQP_NULL;
     work->rho_inv_vec = OSQP_NULL;
   }
-
-  // Allocate internal solver variables (ADMM steps)
-  work->x           = OSQPVectorf_calloc(n);
-  work->z           = OSQPVectorf_calloc(m);
-  work->xz_tilde    = OSQPVectorf_calloc(n + m);
+  work->y           = work_view(work->slab, &head, m);
+  work->xz_tilde    = work_view(work->slab, &head, n + m);
+  work->x           = work_view(work->slab, &head, n);
+  work->delta_x     = work_view(work->slab, &head, n);
+  work->z           = work_view(work->slab, &head, m);
+  work->data->l     = work_view(work->slab, &head, m);
+  work->data->u     = work_view(work->slab, &head, m);
+  work->delta_y     = work_view(work->slab, &head, m);
   work->xtilde_view = OSQPVectorf_view(work->xz_tilde,0,n);
   work->ztilde_view = OSQPVectorf_view(work->xz_tilde,n,m);
-  work->x_prev      = OSQPVectorf_calloc(n);
-  work->z_prev      = OSQPVectorf_calloc(m);
-  work->y           = OSQPVectorf_calloc(m);
   if (!(work->x) || !(work->z) || !(work->xz_tilde))
     return osqp_error(OSQP_MEM_ALLOC_ERROR);
   if (!(work->xtilde_view) || !(work->ztilde_view))
       return osqp_error(OSQP_MEM_ALLOC_ERROR);
-  if (!(work->x_prev) || !(work->z_prev) || !(work->y))
+  if (!(work->y) || !(work->delta_x) || !(work->delta_y))
+    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  if (!(work->data->l) || !(work->data->u))
     return osqp_error(OSQP_MEM_ALLOC_ERROR);
 
+  // Copy problem vectors
+  vec_from_user(work, work->data->q, q, 1);
+  vec_from_user(work, work->data->l, l, 0);
+  vec_from_user(work, work->data->u, u, 0);
+  presolve_free_data(work->presolve);
+
   // Primal and dual residuals variables
-  work->Ax  = OSQPVectorf_calloc(m);
-  work->Px  = OSQPVectorf_calloc(n);
-  work->Aty = OSQPVectorf_calloc(n);
+  work->Ax  = work_view(work->slab, &head, m);
+  work->Px  = work_view(work->slab, &head, n);
+  work->Aty = work_view(work->slab, &head, n);
 
   // Primal infeasibility variables
-  work->delta_y   = OSQPVectorf_calloc(m);
-  work->Atdelta_y = OSQPVectorf_calloc(n);
+  work->Atdelta_y = work_view(work->slab, &head, n);
 
   // Dual infeasibility variables
-  work->delta_x  = OSQPVectorf_calloc(n);
-  work->Pdelta_x = OSQPVectorf_calloc(n);
-  work->Adelta_x = OSQPVectorf_calloc(m);
+  work->Pdelta_x = work_view(work->slab, &head, n);
+  work->Adelta_x = work_view(work->slab, &head, m);
 
   if (!(work->Ax) || !(work->Px) || !(work->Aty))
     return osqp_error(OSQP_MEM_ALLOC_ERROR);
-  if (!(work->delta_y) || !(work->Atdelta_y))
-    return osqp_error(OSQP_MEM_ALLOC_ERROR);
-  if (!(work->delta_x) || !(work->Pdelta_x) || !(work->Adelta_x))
+  if (!(work->Atdelta_y) || !(work->Pdelta_x) || !(work->Adelta_x))
     return osqp_error(OSQP_MEM_ALLOC_ERROR);
 
   // Copy settings
@@ -293,6 +531,25 @@ OSQPInt osqp_setup(OSQPSolver**         solverp,
     work->E_temp   = OSQP_NULL;
   }
 
+  // Keep single precision copies of the (scaled) matrix values for the products
+  if (settings->spmv_single) {
+    if (OSQPMatrix_init_single_values(work->data->P) ||
+        OSQPMatrix_init_single_values(work->data->A))
+      return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  }
+
+  // Keep both triangles of P for the products in the iteration loop
+  if (settings->spmv_full) {
+    if (OSQPMatrix_init_symm_full(work->data->P))
+      return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  }
+
+  // Store the (scaled) diagonal of a diagonal P for the products with P
+  update_P_diag(solver);
+
+  // Partition the constraints for the projection of z
+  set_proj_partition(solver);
+
   if (settings->rho_is_vec) {
     // Set type of constraints.  Ignore return value
     // because we will definitely factor KKT.
@@ -304,9 +561,29 @@ OSQPInt osqp_setup(OSQPSolver**         solverp,
   }
 
   // Initialize linear system solver structure
-  exitflag = osqp_algebra_init_linsys_solver(&(work->linsys_solver), work->data->P, work->data->A,
-                                             work->rho_vec, solver->settings,
-                                             &work->scaled_prim_res, &work->scaled_dual_res, 0);
+  if (settings->linsys_solver == OSQP_RICCATI_SOLVER) {
+    // Block tridiagonal reduced KKT matrix factored stage by stage
+    exitflag = init_linsys_solver_riccati(&(work->linsys_solver), work->data->P, work->data->A,
+                                          work->rho_vec, solver->settings, n_stages, stage_n);
+  }
+  else if (settings->split_dense) {
+    // Dense rows and columns of A are eliminated through a Schur complement
+    exitflag = init_linsys_solver_dense(&(work->linsys_solver), work->data->P, work->data->A,
+                                        work->rho_vec, solver->settings,
+                                        &work->scaled_prim_res, &work->scaled_dual_res,
+                                        &work->dense);
+  }
+  else if (settings->split_bounds) {
+    // Singleton rows of A are eliminated from the KKT matrix
+    exitflag = init_linsys_solver_bounds(&(work->linsys_solver), work->data->P, work->data->A,
+                                         work->rho_vec, solver->settings,
+                                         &work->scaled_prim_res, &work->scaled_dual_res);
+  }
+  else {
+    exitflag = osqp_algebra_init_linsys_solver(&(work->linsys_solver), work->data->P, work->data->A,
+                                               work->rho_vec, solver->settings,
+                                               &work->scaled_prim_res, &work->scaled_dual_res, 0);
+  }
 
   if (exitflag == OSQP_NONCVX_ERROR) {
     update_status(solver->info, OSQP_NON_CVX);
@@ -331,6 +608,16 @@ OSQPInt osqp_setup(OSQPSolver**         solverp,
       !(work->pol->z) || !(work->pol->y))
     return osqp_error(OSQP_MEM_ALLOC_ERROR);
 
+  // The solution has the dimensions of the user problem
+  if (work->lift) {
+    n = work->lift->n;
+    m = work->lift->m;
+  }
+  else if (work->presolve) {
+    n = work->presolve->n;
+    m = work->presolve->m;
+  }
+
   // Allocate solution
   solver->solution = c_calloc(1, sizeof(OSQPSolution));
   if (!(solver->solution)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
@@ -394,15 +681,213 @@ OSQPInt osqp_setup(OSQPSolver**         solverp,
   work->derivative_data->ryl = OSQPVectorf_malloc(m);
   work->derivative_data->ryu = OSQPVectorf_malloc(m);
   work->derivative_data->rhs = OSQPVectorf_malloc(2 * (n + 2*m));
+  work->derivative_data->x = OSQPVectorf_malloc(n);
+  work->derivative_data->x_scaled = OSQPVectorf_malloc(n);
+  work->derivative_data->y = OSQPVectorf_malloc(m);
+  work->derivative_data->Adx = OSQPVectorf_malloc(m);
+  work->derivative_data->row_type   = c_malloc(m * sizeof(OSQPInt));
+  work->derivative_data->ineq_l_idx = c_malloc(m * sizeof(OSQPInt));
+  work->derivative_data->ineq_u_idx = c_malloc(m * sizeof(OSQPInt));
+  work->derivative_data->eq_idx     = c_malloc(m * sizeof(OSQPInt));
+  work->derivative_data->nu_sign    = c_malloc(m * sizeof(OSQPInt));
   if (!(work->derivative_data->y_u) || !(work->derivative_data->y_l) ||
-    !(work->derivative_data->ryl) || !(work->derivative_data->ryu))
+    !(work->derivative_data->ryl) || !(work->derivative_data->ryu) ||
+    !(work->derivative_data->rhs) || !(work->derivative_data->x) ||
+    !(work->derivative_data->x_scaled) ||
+    !(work->derivative_data->y) || !(work->derivative_data->Adx) ||
+    (m && (!(work->derivative_data->row_type) || !(work->derivative_data->ineq_l_idx) ||
+           !(work->derivative_data->ineq_u_idx) || !(work->derivative_data->eq_idx) ||
+           !(work->derivative_data->nu_sign))))
     return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  work->derivative_data->max_seeds = 1;
 # endif /* ifdef OSQP_ENABLE_DERIVATIVES */
 
   // Return exit flag
   return 0;
 }
 
+
+OSQPInt osqp_setup(OSQPSolver**         solverp,
+                   const OSQPCscMatrix* P,
+                   const OSQPFloat*     q,
+                   const OSQPCscMatrix* A,
+                   const OSQPFloat*     l,
+                   const OSQPFloat*     u,
+                   OSQPInt              m,
+                   OSQPInt              n,
+                   const OSQPSettings*  settings) {
+
+  return setup_solver(solverp, P, q, A, l, u, m, n, settings, 0, OSQP_NULL, OSQP_NULL);
+}
+
+
+OSQPInt osqp_setup_stages(OSQPSolver**         solverp,
+                          const OSQPCscMatrix* P,
+                          const OSQPFloat*     q,
+                          const OSQPCscMatrix* A,
+                          const OSQPFloat*     l,
+                          const OSQPFloat*     u,
+                          OSQPInt              m,
+                          OSQPInt              n,
+                          const OSQPSettings*  settings,
+                          OSQPInt              n_stages,
+                          const OSQPInt*       stage_n) {
+
+  OSQPInt k;
+  OSQPInt n_sum = 0;
+
+  // Validate the stages, the rest is validated in the setup
+  if (!stage_n || n_stages < 1) {
+    c_eprint("at least one stage is required");
+    return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+  }
+  for (k = 0; k < n_stages; k++) {
+    if (stage_n[k] < 1) {
+      c_eprint("stage %i has no variables", (int)k);
+      return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+    }
+    n_sum += stage_n[k];
+  }
+  if (n_sum != n) {
+    c_eprint("the stages hold %i variables instead of n = %i", (int)n_sum, (int)n);
+    return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+  }
+
+  return setup_solver(solverp, P, q, A, l, u, m, n, settings, n_stages, stage_n, OSQP_NULL);
+}
+
+
+OSQPInt osqp_setup_factor(OSQPSolver**         solverp,
+                          const OSQPCscMatrix* F,
+                          const OSQPFloat*     D,
+                          const OSQPFloat*     q,
+                          const OSQPCscMatrix* A,
+                          const OSQPFloat*     l,
+                          const OSQPFloat*     u,
+                          OSQPInt              m,
+                          OSQPInt              n,
+                          const OSQPSettings*  settings) {
+
+  OSQPInt   exitflag;
+  OSQPInt   j;
+  OSQPLift* lift;
+
+  // Validate the factor model, the rest is validated on the lifted problem
+  if (!F || !A || !q || !l || !u) {
+    c_eprint("Missing data");
+    return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+  }
+  if (F->m != n || A->n != n || A->m != m) {
+    c_eprint("Wrong dimensions of F or A");
+    return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+  }
+  if (settings && settings->split_components) {
+    c_eprint("split_components is not supported for factor model problems");
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+  if (D) {
+    for (j = 0; j < n; j++) {
+      if (D[j] < 0.0) {
+        c_eprint("D must be nonnegative: D[%i] = %.4e", (int)j, D[j]);
+        return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+      }
+    }
+  }
+
+  // Work on the lifted problem with the auxiliary variables t = F' x
+  if (lift_setup(&lift, F, D, q, A, l, u, m, n)) {
+    lift_free(lift);
+    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  }
+
+  // The solver owns the lifting once its workspace exists, even if the
+  // setup fails later on
+  *solverp = OSQP_NULL;
+  exitflag = setup_solver(solverp, lift->P, lift->q, lift->A, lift->l, lift->u,
+                          m + lift->k, n + lift->k, settings, 0, OSQP_NULL, lift);
+  lift_free_data(lift);
+  if (!*solverp || !(*solverp)->work) lift_free(lift);
+
+  return exitflag;
+}
+
+
+OSQPInt osqp_setup_box(OSQPSolver**         solverp,
+                       const OSQPCscMatrix* P,
+                       const OSQPFloat*     q,
+                       const OSQPCscMatrix* A,
+                       const OSQPFloat*     l,
+                       const OSQPFloat*     u,
+                       const OSQPFloat*     lx,
+                       const OSQPFloat*     ux,
+                       OSQPInt              m,
+                       OSQPInt              n,
+                       const OSQPSettings*  settings) {
+
+  OSQPInt        exitflag;
+  OSQPInt        i, j, k;
+  OSQPFloat*     lb;
+  OSQPFloat*     ub;
+  OSQPCscMatrix* Ab;
+  OSQPSettings   box_settings;
+
+  // Validate the bounds, the rest is validated in the setup
+  if (!A || !l || !u || !lx || !ux || !settings) {
+    c_eprint("Missing data");
+    return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+  }
+  if (A->n != n || A->m != m) {
+    c_eprint("Wrong dimensions of A");
+    return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+  }
+
+  // Constraints [A; I] with the bounds [l; lx] and [u; ux]
+  Ab = csc_spalloc(m + n, n, A->p[n] + n, 1, 0);
+  lb = (OSQPFloat *) c_malloc((m + n) * sizeof(OSQPFloat));
+  ub = (OSQPFloat *) c_malloc((m + n) * sizeof(OSQPFloat));
+  if (!Ab || !lb || !ub) {
+    csc_spfree(Ab);
+    c_free(lb);
+    c_free(ub);
+    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  }
+
+  k = 0;
+  for (j = 0; j < n; j++) {
+    Ab->p[j] = k;
+    for (i = A->p[j]; i < A->p[j + 1]; i++) {
+      Ab->i[k] = A->i[i];
+      Ab->x[k] = A->x[i];
+      k++;
+    }
+    Ab->i[k] = m + j;
+    Ab->x[k] = 1.0;
+    k++;
+  }
+  Ab->p[n] = k;
+
+  for (i = 0; i < m; i++) {
+    lb[i] = l[i];
+    ub[i] = u[i];
+  }
+  for (j = 0; j < n; j++) {
+    lb[m + j] = lx[j];
+    ub[m + j] = ux[j];
+  }
+
+  // The bounds are single-variable constraints kept out of the KKT matrix
+  box_settings              = *settings;
+  box_settings.split_bounds = 1;
+
+  exitflag = osqp_setup(solverp, P, q, Ab, lb, ub, m + n, n, &box_settings);
+
+  csc_spfree(Ab);
+  c_free(lb);
+  c_free(ub);
+
+  return exitflag;
+}
+
 #endif /* ifndef OSQP_EMBEDDED_MODE */
 
 
@@ -426,6 +911,17 @@ OSQPInt osqp_solve(OSQPSolver *solver) {
   if (!solver || !solver->work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
   work = solver->work;
 
+#ifdef OSQP_CODEGEN_BLOCK
+  // The vector operations were compiled for the dimensions of one problem
+  if (work->data->n != OSQP_CODEGEN_N || work->data->m != OSQP_CODEGEN_M)
+    return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+#endif /* ifdef OSQP_CODEGEN_BLOCK */
+
+#ifndef OSQP_EMBEDDED_MODE
+  // The subproblems are solved by their own solvers
+  if (work->comp) return components_solve(solver);
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
 #ifdef OSQP_ENABLE_PROFILING
   if (work->clear_update_time == 1)
     solver->info->update_time = 0.0;
@@ -457,7 +953,10 @@ OSQPInt osqp_solve(OSQPSolver *solver) {
 
 #ifdef OSQP_ENABLE_INTERRUPT
 
-  // initialize Ctrl-C support
+  // initialize Ctrl-C support, unless the parent solver of the subproblems did
+# ifndef OSQP_EMBEDDED_MODE
+  if (!work->is_component)
+# endif /* ifndef OSQP_EMBEDDED_MODE */
   osqp_start_interrupt_listener();
 #endif /* ifdef OSQP_ENABLE_INTERRUPT */
 
@@ -475,6 +974,13 @@ OSQPInt osqp_solve(OSQPSolver *solver) {
     swap_vectors(&(work->z), &(work->z_prev));
 
     /* ADMM STEPS */
+#if OSQP_EMBEDDED_MODE == 1
+    /* A generated solver can run all of them in fixed point */
+    if (work->admm_step) {
+      work->admm_step(work, solver->settings);
+    }
+    else {
+#endif /* if OSQP_EMBEDDED_MODE == 1 */
     /* Compute \tilde{x}^{k+1}, \tilde{z}^{k+1} */
     update_xz_tilde(solver, iter);
 
@@ -486,6 +992,9 @@ OSQPInt osqp_solve(OSQPSolver *solver) {
 
     /* Compute y^{k+1} */
     update_y(solver);
+#if OSQP_EMBEDDED_MODE == 1
+    }
+#endif /* if OSQP_EMBEDDED_MODE == 1 */
 
     /* End of ADMM Steps */
 
@@ -569,8 +1078,7 @@ OSQPInt osqp_solve(OSQPSolver *solver) {
 #endif /* ifdef OSQP_ENABLE_PRINTING */
 
 
-#if OSQP_EMBEDDED_MODE != 1
-# ifdef OSQP_ENABLE_PROFILING
+#if defined(OSQP_ENABLE_PROFILING) && OSQP_EMBEDDED_MODE != 1
 
     // If adaptive rho with automatic interval, check if the solve time is a
     // certain fraction
@@ -602,7 +1110,7 @@ OSQPInt osqp_solve(OSQPSolver *solver) {
           solver->settings->check_termination);
       } // If time condition is met
     }   // If adaptive rho enabled and interval set to auto®
-# else // OSQP_ENABLE_PROFILING
+#else // OSQP_ENABLE_PROFILING && OSQP_EMBEDDED_MODE != 1
     if (solver->settings->adaptive_rho && !solver->settings->adaptive_rho_interval) {
       // Set adaptive_rho_interval to constant value
       if (solver->settings->check_termination) {
@@ -615,27 +1123,27 @@ OSQPInt osqp_solve(OSQPSolver *solver) {
         solver->settings->adaptive_rho_interval = OSQP_ADAPTIVE_RHO_FIXED;
       }
     }
-# endif // OSQP_ENABLE_PROFILING
+#endif // OSQP_ENABLE_PROFILING && OSQP_EMBEDDED_MODE != 1
 
     // Adapt rho
     if (solver->settings->adaptive_rho &&
         solver->settings->adaptive_rho_interval &&
         (iter % solver->settings->adaptive_rho_interval == 0)) {
       // Update info with the residuals if it hasn't been done before
-# ifdef OSQP_ENABLE_PRINTING
+#ifdef OSQP_ENABLE_PRINTING
 
       if (!can_check_termination && !can_print) {
         // Information has not been computed neither for termination or printing
         // reasons
         update_info(solver, iter, compute_obj, 0);
       }
-# else /* ifdef OSQP_ENABLE_PRINTING */
+#else /* ifdef OSQP_ENABLE_PRINTING */
 
       if (!can_check_termination) {
         // Information has not been computed before for termination check
         update_info(solver, iter, compute_obj, 0);
       }
-# endif /* ifdef OSQP_ENABLE_PRINTING */
+#endif /* ifdef OSQP_ENABLE_PRINTING */
 
       // Actually update rho
       if (adapt_rho(solver)) {
@@ -644,7 +1152,6 @@ OSQPInt osqp_solve(OSQPSolver *solver) {
         goto exit;
       }
     }
-#endif // OSQP_EMBEDDED_MODE != 1
 
   }        // End of ADMM for loop
 
@@ -708,6 +1215,11 @@ OSQPInt osqp_solve(OSQPSolver *solver) {
 #endif /* ifdef OSQP_ENABLE_PROFILING */
 
 
+#ifndef OSQP_EMBEDDED_MODE
+  /* Measure the residual accuracy lost to single precision matrix values */
+  if (solver->settings->spmv_single) update_spmv_res_error(solver);
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
 #if OSQP_EMBEDDED_MODE != 1
   /* Update rho estimate */
   solver->info->rho_estimate = compute_rho_estimate(solver);
@@ -721,8 +1233,14 @@ OSQPInt osqp_solve(OSQPSolver *solver) {
 
 #ifndef OSQP_EMBEDDED_MODE
   // Polish the obtained solution
-  if (solver->settings->polishing && (solver->info->status_val == OSQP_SOLVED))
+  if (solver->settings->polishing && (solver->info->status_val == OSQP_SOLVED)) {
+    // The refinement in polish needs the full precision matrix values
+    OSQPMatrix_use_single_values(work->data->P, 0);
+    OSQPMatrix_use_single_values(work->data->A, 0);
     polish(solver);
+    OSQPMatrix_use_single_values(work->data->P, 1);
+    OSQPMatrix_use_single_values(work->data->A, 1);
+  }
 #endif /* ifndef OSQP_EMBEDDED_MODE */
 
 #ifdef OSQP_ENABLE_PROFILING
@@ -749,22 +1267,23 @@ OSQPInt osqp_solve(OSQPSolver *solver) {
   work->rho_update_from_solve = 0;
 #endif /* ifdef OSQP_ENABLE_PROFILING */
 
+  // Store solution
+  store_solution(solver);
+
 #ifdef OSQP_ENABLE_PRINTING
-  /* Print final footer */
+  /* Print final footer, with the objective of the factor model problem */
   if (solver->settings->verbose) print_footer(solver->info, solver->settings->polishing);
 #endif /* ifdef OSQP_ENABLE_PRINTING */
 
-  // Store solution
-  store_solution(solver);
-
 
 // Define exit flag for quitting function
-#if defined(OSQP_ENABLE_PROFILING) || defined(OSQP_ENABLE_INTERRUPT) || OSQP_EMBEDDED_MODE != 1
 exit:
-#endif /* if defined(OSQP_ENABLE_PROFILING) || defined(OSQP_ENABLE_INTERRUPT) || OSQP_EMBEDDED_MODE != 1 */
 
 #ifdef OSQP_ENABLE_INTERRUPT
   // Restore previous signal handler
+# ifndef OSQP_EMBEDDED_MODE
+  if (!work->is_component)
+# endif /* ifndef OSQP_EMBEDDED_MODE */
   osqp_end_interrupt_listener();
 #endif /* ifdef OSQP_ENABLE_INTERRUPT */
 
@@ -791,9 +1310,9 @@ OSQPInt osqp_cleanup(OSQPSolver* solver) {
     if (work->data) {
       OSQPMatrix_free(work->data->P);
       OSQPMatrix_free(work->data->A);
-      OSQPVectorf_free(work->data->q);
-      OSQPVectorf_free(work->data->l);
-      OSQPVectorf_free(work->data->u);
+      OSQPVectorf_view_free(work->data->q);
+      OSQPVectorf_view_free(work->data->l);
+      OSQPVectorf_view_free(work->data->u);
       c_free(work->data);
     }
 
@@ -830,27 +1349,34 @@ OSQPInt osqp_cleanup(OSQPSolver* solver) {
 #endif /* ifndef OSQP_EMBEDDED_MODE */
 
     // Free other Variables
-    OSQPVectorf_free(work->rho_vec);
-    OSQPVectorf_free(work->rho_inv_vec);
+    OSQPVectorf_view_free(work->rho_vec);
+    OSQPVectorf_view_free(work->rho_inv_vec);
 #if OSQP_EMBEDDED_MODE != 1
     OSQPVectori_free(work->constr_type);
 #endif
-    OSQPVectorf_free(work->x);
-    OSQPVectorf_free(work->z);
-    OSQPVectorf_free(work->xz_tilde);
+    OSQPVectori_free(work->proj_idx);
+    OSQPVectorf_view_free(work->x);
+    OSQPVectorf_view_free(work->z);
+    OSQPVectorf_view_free(work->xz_tilde);
     OSQPVectorf_view_free(work->xtilde_view);
     OSQPVectorf_view_free(work->ztilde_view);
-    OSQPVectorf_free(work->x_prev);
-    OSQPVectorf_free(work->z_prev);
-    OSQPVectorf_free(work->y);
-    OSQPVectorf_free(work->Ax);
-    OSQPVectorf_free(work->Px);
-    OSQPVectorf_free(work->Aty);
-    OSQPVectorf_free(work->delta_y);
-    OSQPVectorf_free(work->Atdelta_y);
-    OSQPVectorf_free(work->delta_x);
-    OSQPVectorf_free(work->Pdelta_x);
-    OSQPVectorf_free(work->Adelta_x);
+    OSQPVectorf_view_free(work->x_prev);
+    OSQPVectorf_view_free(work->z_prev);
+    OSQPVectorf_view_free(work->y);
+    OSQPVectorf_view_free(work->Ax);
+    OSQPVectorf_view_free(work->Px);
+    OSQPVectorf_view_free(work->Aty);
+    OSQPVectorf_view_free(work->delta_y);
+    OSQPVectorf_view_free(work->Atdelta_y);
+    OSQPVectorf_view_free(work->delta_x);
+    OSQPVectorf_view_free(work->Pdelta_x);
+    OSQPVectorf_view_free(work->Adelta_x);
+    OSQPVectorf_free(work->slab);
+    OSQPVectorf_free(work->P_diag);
+    reorder_free(work->reorder);
+    presolve_free(work->presolve);
+    lift_free(work->lift);
+    components_free(work->comp);
 
     // Free Settings
     if (solver->settings) c_free(solver->settings);
@@ -879,6 +1405,22 @@ OSQPInt osqp_cleanup(OSQPSolver* solver) {
           if (work->derivative_data->ryl) OSQPVectorf_free(work->derivative_data->ryl);
           if (work->derivative_data->ryu) OSQPVectorf_free(work->derivative_data->ryu);
           if (work->derivative_data->rhs) OSQPVectorf_free(work->derivative_data->rhs);
+          if (work->derivative_data->x) OSQPVectorf_free(work->derivative_data->x);
+          if (work->derivative_data->x_scaled) OSQPVectorf_free(work->derivative_data->x_scaled);
+          if (work->derivative_data->y) OSQPVectorf_free(work->derivative_data->y);
+          if (work->derivative_data->Adx) OSQPVectorf_free(work->derivative_data->Adx);
+          c_free(work->derivative_data->row_type);
+          c_free(work->derivative_data->ineq_l_idx);
+          c_free(work->derivative_data->ineq_u_idx);
+          c_free(work->derivative_data->eq_idx);
+          c_free(work->derivative_data->nu_sign);
+          if (work->derivative_data->P_full) OSQPMatrix_free(work->derivative_data->P_full);
+          if (work->derivative_data->G) OSQPMatrix_free(work->derivative_data->G);
+          if (work->derivative_data->A_eq) OSQPMatrix_free(work->derivative_data->A_eq);
+          if (work->derivative_data->GDiagLambda) OSQPMatrix_free(work->derivative_data->GDiagLambda);
+          if (work->derivative_data->lambda) OSQPVectorf_free(work->derivative_data->lambda);
+          if (work->derivative_data->slacks) OSQPVectorf_free(work->derivative_data->slacks);
+          adjoint_derivative_linsys_free(work->derivative_data->adj_solver);
           c_free(work->derivative_data);
       }
 #endif /* ifdef OSQP_ENABLE_SCALING */
@@ -916,6 +1458,30 @@ OSQPInt osqp_update_data_vec(OSQPSolver*      solver,
   if (!solver || !solver->work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
   work = solver->work;
 
+#ifndef OSQP_EMBEDDED_MODE
+  /* The reductions of the presolve depend on the bounds, but not on q */
+  if (work->presolve) {
+    if (l_new || u_new) {
+      c_eprint("bound updates are not supported with presolve enabled");
+      return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+    }
+    if (q_new) {
+      presolve_q(work->presolve, q_new, work->presolve->x_work);
+      q_new = work->presolve->x_work;
+    }
+  }
+
+  /* Extend the vectors to the lifted problem */
+  if (work->lift) lift_vectors(work->lift, &q_new, &l_new, &u_new);
+
+  /* Split the vectors between the subproblems */
+  if (work->comp) {
+    exitflag = components_update_data_vec(work->comp, q_new, l_new, u_new);
+    reset_info(solver->info);
+    return exitflag;
+  }
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
 #ifdef OSQP_ENABLE_PROFILING
   if (work->clear_update_time == 1) {
     work->clear_update_time = 0;
@@ -932,8 +1498,8 @@ OSQPInt osqp_update_data_vec(OSQPSolver*      solver,
     u_tmp = work->delta_y;
 
     /* Copy l_new and u_new to l_tmp and u_tmp */
-    if (l_new) OSQPVectorf_from_raw(l_tmp, l_new);
-    if (u_new) OSQPVectorf_from_raw(u_tmp, u_new);
+    if (l_new) vec_from_user(work, l_tmp, l_new, 0);
+    if (u_new) vec_from_user(work, u_tmp, u_new, 0);
 
     if (solver->settings->scaling) {
       if (l_new) OSQPVectorf_ew_prod(l_tmp, l_tmp, work->scaling->E);
@@ -951,6 +1517,11 @@ OSQPInt osqp_update_data_vec(OSQPSolver*      solver,
       if (l_new) swap_vectors(&work->z_prev,  &work->data->l);
       if (u_new) swap_vectors(&work->delta_y, &work->data->u);
 
+#ifndef OSQP_EMBEDDED_MODE
+      /* Bounds changed, so the projection partition may have changed */
+      set_proj_partition(solver);
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
 #if OSQP_EMBEDDED_MODE != 1
       /* Update rho_vec and refactor if constraints type changes */
       if (solver->settings->rho_is_vec) exitflag = update_rho_vec(solver);
@@ -959,7 +1530,7 @@ OSQPInt osqp_update_data_vec(OSQPSolver*      solver,
 
   /* Update linear cost vector */
   if (q_new) {
-    OSQPVectorf_from_raw(work->data->q, q_new);
+    vec_from_user(work, work->data->q, q_new, 1);
     if (solver->settings->scaling) {
       OSQPVectorf_ew_prod(work->data->q, work->data->q, work->scaling->D);
       OSQPVectorf_mult_scalar(work->data->q, work->scaling->c);
@@ -990,9 +1561,28 @@ OSQPInt osqp_warm_start(OSQPSolver*      solver,
   /* Update warm_start setting to true */
   if (!solver->settings->warm_starting) solver->settings->warm_starting = 1;
 
+#ifndef OSQP_EMBEDDED_MODE
+  /* Split the point between the subproblems */
+  if (work->comp) return components_warm_start(work->comp, x, y);
+
+  /* Map the point to the lifted problem */
+  if (work->lift) {
+    lift_point(work->lift, x, y, work->lift->x_work, work->lift->y_work);
+    if (x) x = work->lift->x_work;
+    if (y) y = work->lift->y_work;
+  }
+
+  /* Map the point to the reduced problem */
+  if (work->presolve) {
+    presolve_point(work->presolve, x, y, work->presolve->x_work, work->presolve->y_work);
+    if (x) x = work->presolve->x_work;
+    if (y) y = work->presolve->y_work;
+  }
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
   /* Copy primal and dual variables into the iterates */
-  if (x) OSQPVectorf_from_raw(work->x, x);
-  if (y) OSQPVectorf_from_raw(work->y, y);
+  if (x) vec_from_user(work, work->x, x, 1);
+  if (y) vec_from_user(work, work->y, y, 0);
 
   /* Scale iterates */
   if (solver->settings->scaling) {
@@ -1015,6 +1605,12 @@ OSQPInt osqp_warm_start(OSQPSolver*      solver,
 
 void osqp_cold_start(OSQPSolver *solver) {
   OSQPWorkspace *work = solver->work;
+#ifndef OSQP_EMBEDDED_MODE
+  if (work->comp) {
+    components_cold_start(work->comp);
+    return;
+  }
+#endif /* ifndef OSQP_EMBEDDED_MODE */
   OSQPVectorf_set_scalar(work->x, 0.);
   OSQPVectorf_set_scalar(work->z, 0.);
   OSQPVectorf_set_scalar(work->y, 0.);
@@ -1036,12 +1632,35 @@ OSQPInt osqp_update_data_mat(OSQPSolver*      solver,
 
   OSQPInt exitflag;   // Exit flag
   OSQPInt nnzP, nnzA; // Number of nonzeros in P and A
+  OSQPInt rescale;    // Recompute the scaling for the new matrices
   OSQPWorkspace *work;
 
   // Check if workspace has been initialized
   if (!solver || !solver->work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
   work = solver->work;
 
+#ifndef OSQP_EMBEDDED_MODE
+  // The reductions of the presolve depend on the problem data
+  if (work->presolve) {
+    c_eprint("data updates are not supported with presolve enabled");
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+
+  // The lifted matrices interleave the entries of A and F
+  if (work->lift) {
+    c_eprint("matrix updates are not supported for factor model problems");
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+
+  // Split the new entries between the subproblems
+  if (work->comp) {
+    exitflag = components_update_data_mat(work->comp, Px_new, Px_new_idx, P_new_n,
+                                          Ax_new, Ax_new_idx, A_new_n);
+    reset_info(solver->info);
+    return exitflag;
+  }
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
 #ifdef OSQP_ENABLE_PROFILING
   if (work->clear_update_time == 1) {
     work->clear_update_time = 0;
@@ -1079,20 +1698,59 @@ OSQPInt osqp_update_data_mat(OSQPSolver*      solver,
     return 2;
   }
 
-  if (solver->settings->scaling) unscale_data(solver);
+  // With frozen scaling only the new entries are scaled, using the
+  // existing scaling vectors
+  rescale = solver->settings->scaling && !solver->settings->freeze_scaling;
+
+  if (rescale) unscale_data(solver);
 
   if (Px_new){
+#ifndef OSQP_EMBEDDED_MODE
+    // Map the new values to the internal ordering of the entries of P
+    if (work->reorder)
+      Px_new = reorder_mat_values(work->reorder->Pmap, Px_new, Px_new_idx, P_new_n,
+                                  work->reorder->idx_work, work->reorder->val_work,
+                                  &Px_new_idx);
+#endif /* ifndef OSQP_EMBEDDED_MODE */
     OSQPMatrix_update_values(work->data->P, Px_new, Px_new_idx, P_new_n);
+    if (solver->settings->scaling && !rescale)
+      OSQPMatrix_scale_entries(work->data->P, Px_new_idx, P_new_n,
+                               work->scaling->D, work->scaling->D, work->scaling->c);
   }
   if (Ax_new){
+#ifndef OSQP_EMBEDDED_MODE
+    // Map the new values to the internal ordering of the entries of A
+    if (work->reorder)
+      Ax_new = reorder_mat_values(work->reorder->Amap, Ax_new, Ax_new_idx, A_new_n,
+                                  work->reorder->idx_work + nnzP, work->reorder->val_work,
+                                  &Ax_new_idx);
+#endif /* ifndef OSQP_EMBEDDED_MODE */
     OSQPMatrix_update_values(work->data->A, Ax_new, Ax_new_idx, A_new_n);
+    if (solver->settings->scaling && !rescale)
+      OSQPMatrix_scale_entries(work->data->A, Ax_new_idx, A_new_n,
+                               work->scaling->E, work->scaling->D, 1.0);
   }
 
-  if (solver->settings->scaling) scale_data(solver);
+  if (rescale) {
+    scale_data(solver);
+#ifndef OSQP_EMBEDDED_MODE
+    /* Rescaling l and u can move bounds across the infinity threshold */
+    set_proj_partition(solver);
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+  }
+
+#ifndef OSQP_EMBEDDED_MODE
+  if (Px_new || rescale) update_P_diag(solver);
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
+#ifdef OSQP_ENABLE_DERIVATIVES
+  // The derivative workspace keeps its own copy of the matrices
+  if (Px_new || Ax_new) work->derivative_data->mat_valid = 0;
+#endif /* ifdef OSQP_ENABLE_DERIVATIVES */
 
   // Update linear system structure with new data.
-  // If there is scaling, then a full update is needed.
-  if(solver->settings->scaling){
+  // If the scaling was recomputed, then a full update is needed.
+  if(rescale){
     exitflag = work->linsys_solver->update_matrices(
                   work->linsys_solver,
                   work->data->P, OSQP_NULL, nnzP,
@@ -1148,6 +1806,10 @@ OSQPInt osqp_update_rho(OSQPSolver* solver,
   // Update rho in settings
   solver->settings->rho = c_min(c_max(rho_new, OSQP_RHO_MIN), OSQP_RHO_MAX);
 
+#ifndef OSQP_EMBEDDED_MODE
+  if (work->comp) return components_update_rho(work->comp, rho_new);
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
   if (solver->settings->rho_is_vec) {
     // Update rho_vec and rho_inv_vec
     OSQPVectorf_set_scalar_conditional(work->rho_vec,
@@ -1226,6 +1888,26 @@ OSQPInt osqp_update_settings(OSQPSolver*         solver,
   settings->delta              = new_settings->delta;
   settings->polish_refine_iter = new_settings->polish_refine_iter;
 
+  // presolve ignored
+  // split_bounds ignored
+  // split_dense ignored
+  // split_components ignored
+
+  // spmv_single ignored
+  // reorder ignored
+  // spmv_full ignored
+
+  settings->freeze_scaling = new_settings->freeze_scaling;
+
+  settings->derivative_iterative = new_settings->derivative_iterative;
+
+  // scaling_type ignored
+
+#ifndef OSQP_EMBEDDED_MODE
+  /* Update settings in the subproblems */
+  if (solver->work->comp) return components_update_settings(solver->work->comp, settings);
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
   /* Update settings in the linear system solver */
   solver->work->linsys_solver->update_settings(solver->work->linsys_solver, settings);
 
@@ -1261,14 +1943,55 @@ OSQPInt osqp_codegen(OSQPSolver*         solver,
                     || (defines->printing_enable != 0  && defines->printing_enable != 1)
                     || (defines->profiling_enable != 0 && defines->profiling_enable != 1)
                     || (defines->interrupt_enable != 0 && defines->interrupt_enable != 1)
-                    || (defines->derivatives_enable != 0 && defines->derivatives_enable != 1)) {
+                    || (defines->derivatives_enable != 0 && defines->derivatives_enable != 1)
+                    || (defines->unroll_enable != 0    && defines->unroll_enable != 1)
+                    || (defines->fixed_dims_enable != 0 && defines->fixed_dims_enable != 1)
+                    || (defines->rho_ladder_size < 0   || defines->rho_ladder_size == 1)
+                    || (defines->rho_ladder_size > 0   && defines->embedded_mode != 1)
+                    || (defines->fixed_point_enable != 0 && defines->fixed_point_enable != 1)
+                    || (defines->fixed_point_enable == 1 && (defines->unroll_enable != 1
+                                                             || defines->embedded_mode != 1
+                                                             || defines->rho_ladder_size != 0))) {
     return osqp_error(OSQP_CODEGEN_DEFINES_ERROR);
   }
+  /* The generated code works on the user ordering of the problem */
+  else if (solver->settings->reorder) {
+    c_eprint("code generation is not supported with reorder enabled");
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+  /* The generated code works on the full problem */
+  else if (solver->settings->presolve) {
+    c_eprint("code generation is not supported with presolve enabled");
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+  /* The generated code factors the full KKT matrix */
+  else if (solver->settings->split_bounds) {
+    c_eprint("code generation is not supported with split_bounds enabled");
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+  else if (solver->settings->split_dense) {
+    c_eprint("code generation is not supported with split_dense enabled");
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+  else if (solver->settings->linsys_solver == OSQP_RICCATI_SOLVER) {
+    c_eprint("code generation is not supported with the Riccati solver");
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+  /* The generated code works on the user dimensions of the problem */
+  else if (solver->work->lift) {
+    c_eprint("code generation is not supported for factor model problems");
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+  /* The generated code solves a single problem */
+  else if (solver->work->comp) {
+    c_eprint("code generation is not supported for problems split into components");
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  }
 
-  exitflag = codegen_inc(solver, output_dir, file_prefix);
-  if (!exitflag) exitflag = codegen_src(solver, output_dir, file_prefix, defines->embedded_mode);
+  exitflag = codegen_inc(solver, output_dir, file_prefix, defines);
+  if (!exitflag) exitflag = codegen_src(solver, output_dir, file_prefix, defines);
   if (!exitflag) exitflag = codegen_example(output_dir, file_prefix);
-  if (!exitflag) exitflag = codegen_defines(output_dir, defines);
+  if (!exitflag) exitflag = codegen_defines(solver, output_dir, defines);
 #else
   exitflag = OSQP_FUNC_NOT_IMPLEMENTED;
 #endif /* ifdef OSQP_CODEGEN */
@@ -1301,14 +2024,84 @@ void csc_set_data(OSQPCscMatrix* M,
 /****************************
 * Derivative functions
 ****************************/
+#ifdef OSQP_ENABLE_DERIVATIVES
+/* Check that the derivatives support the way the solver was set up */
+static OSQPInt check_derivatives(const OSQPSolver* solver) {
+
+  if (solver && solver->settings && solver->settings->reorder) {
+    c_eprint("derivatives are not supported with reorder enabled");
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+  if (solver && solver->settings && solver->settings->presolve) {
+    c_eprint("derivatives are not supported with presolve enabled");
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+# ifndef OSQP_EMBEDDED_MODE
+  if (solver && solver->work && solver->work->lift) {
+    c_eprint("derivatives are not supported for factor model problems");
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+  if (solver && solver->work && solver->work->comp) {
+    c_eprint("derivatives are not supported for problems split into components");
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+# endif /* ifndef OSQP_EMBEDDED_MODE */
+
+  return 0;
+}
+#endif /* ifdef OSQP_ENABLE_DERIVATIVES */
+
 OSQPInt osqp_adjoint_derivative_compute(OSQPSolver* solver,
                                         OSQPFloat*  dx,
                                         OSQPFloat*  dy_l,
                                         OSQPFloat*  dy_u) {
+  return osqp_adjoint_derivative_compute_batch(solver, 1, dx, dy_l, dy_u);
+}
+
+OSQPInt osqp_adjoint_derivative_get_mat(OSQPSolver*    solver,
+                                        OSQPCscMatrix* dP,
+                                        OSQPCscMatrix* dA) {
+  return osqp_adjoint_derivative_get_mat_batch(solver, 1, dP, dA);
+}
+
+OSQPInt osqp_adjoint_derivative_get_vec(OSQPSolver* solver,
+                                        OSQPFloat*  dq,
+                                        OSQPFloat*  dl,
+                                        OSQPFloat*  du) {
+  return osqp_adjoint_derivative_get_vec_batch(solver, 1, dq, dl, du);
+}
+
+OSQPInt osqp_forward_derivative_compute(OSQPSolver*          solver,
+                                        const OSQPCscMatrix* dP,
+                                        const OSQPFloat*     dq,
+                                        const OSQPCscMatrix* dA,
+                                        const OSQPFloat*     dl,
+                                        const OSQPFloat*     du,
+                                        OSQPFloat*           dx,
+                                        OSQPFloat*           dy) {
+  return osqp_forward_derivative_compute_batch(solver, 1, dP, dq, dA, dl, du, dx, dy);
+}
+
+OSQPInt osqp_forward_derivative_compute_batch(OSQPSolver*          solver,
+                                              OSQPInt              n_dirs,
+                                              const OSQPCscMatrix* dP,
+                                              const OSQPFloat*     dq,
+                                              const OSQPCscMatrix* dA,
+                                              const OSQPFloat*     dl,
+                                              const OSQPFloat*     du,
+                                              OSQPFloat*           dx,
+                                              OSQPFloat*           dy) {
   OSQPInt status = 0;
 
 #ifdef OSQP_ENABLE_DERIVATIVES
-  status = adjoint_derivative_compute(solver, dx, dy_l, dy_u);
+  status = check_derivatives(solver);
+  if (status) return status;
+
+  if (n_dirs < 1) {
+    c_eprint("number of directions must be positive");
+    return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+  }
+  status = forward_derivative_compute(solver, n_dirs, dP, dq, dA, dl, du, dx, dy);
 #else
   status = OSQP_FUNC_NOT_IMPLEMENTED;
 #endif
@@ -1316,13 +2109,22 @@ OSQPInt osqp_adjoint_derivative_compute(OSQPSolver* solver,
   return status;
 }
 
-OSQPInt osqp_adjoint_derivative_get_mat(OSQPSolver*    solver,
-                                        OSQPCscMatrix* dP,
-                                        OSQPCscMatrix* dA) {
+OSQPInt osqp_adjoint_derivative_compute_batch(OSQPSolver* solver,
+                                              OSQPInt     n_seeds,
+                                              OSQPFloat*  dx,
+                                              OSQPFloat*  dy_l,
+                                              OSQPFloat*  dy_u) {
   OSQPInt status = 0;
 
 #ifdef OSQP_ENABLE_DERIVATIVES
-  status = adjoint_derivative_get_mat(solver, dP, dA);
+  status = check_derivatives(solver);
+  if (status) return status;
+
+  if (n_seeds < 1) {
+    c_eprint("number of seeds must be positive");
+    return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+  }
+  status = adjoint_derivative_compute(solver, n_seeds, dx, dy_l, dy_u);
 #else
   status = OSQP_FUNC_NOT_IMPLEMENTED;
 #endif
@@ -1330,14 +2132,36 @@ OSQPInt osqp_adjoint_derivative_get_mat(OSQPSolver*    solver,
   return status;
 }
 
-OSQPInt osqp_adjoint_derivative_get_vec(OSQPSolver* solver,
-                                        OSQPFloat*  dq,
-                                        OSQPFloat*  dl,
-                                        OSQPFloat*  du) {
+OSQPInt osqp_adjoint_derivative_get_mat_batch(OSQPSolver*    solver,
+                                              OSQPInt        n_seeds,
+                                              OSQPCscMatrix* dP,
+                                              OSQPCscMatrix* dA) {
+  OSQPInt status = 0;
+
+#ifdef OSQP_ENABLE_DERIVATIVES
+  status = check_derivatives(solver);
+  if (status) return status;
+
+  status = adjoint_derivative_get_mat(solver, n_seeds, dP, dA);
+#else
+  status = OSQP_FUNC_NOT_IMPLEMENTED;
+#endif
+
+  return status;
+}
+
+OSQPInt osqp_adjoint_derivative_get_vec_batch(OSQPSolver* solver,
+                                              OSQPInt     n_seeds,
+                                              OSQPFloat*  dq,
+                                              OSQPFloat*  dl,
+                                              OSQPFloat*  du) {
   OSQPInt status = 0;
 
 #ifdef OSQP_ENABLE_DERIVATIVES
-  status = adjoint_derivative_get_vec(solver, dq, dl, du);
+  status = check_derivatives(solver);
+  if (status) return status;
+
+  status = adjoint_derivative_get_vec(solver, n_seeds, dq, dl, du);
 #else
   status = OSQP_FUNC_NOT_IMPLEMENTED;
 #endif
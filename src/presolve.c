@@ -0,0 +1,656 @@
+#include "presolve.h"
+#include "csc_utils.h"
+
+/* Bounds beyond this magnitude are infinite, as for the constraint types */
+#define PRESOLVE_INF (OSQP_INFTY * OSQP_MIN_SCALING)
+
+/* Relative tolerance on the proportionality of constraints and on the
+ * feasibility of constraints left without variables */
+#define PRESOLVE_TOL (1e-12)
+
+
+/* Bound of x from the bound b of a*x, keeping infinite bounds infinite */
+static OSQPFloat bound_div(OSQPFloat b,
+                           OSQPFloat a) {
+
+  if (b >=  PRESOLVE_INF) return a > 0 ?  OSQP_INFTY : -OSQP_INFTY;
+  if (b <= -PRESOLVE_INF) return a > 0 ? -OSQP_INFTY :  OSQP_INFTY;
+  return b / a;
+}
+
+/* Bounds [lo, hi] of x from l <= a*x <= u */
+static void bounds_div(OSQPFloat  l,
+                       OSQPFloat  u,
+                       OSQPFloat  a,
+                       OSQPFloat* lo,
+                       OSQPFloat* hi) {
+
+  if (a > 0) {
+    *lo = bound_div(l, a);
+    *hi = bound_div(u, a);
+  }
+  else {
+    *lo = bound_div(u, a);
+    *hi = bound_div(l, a);
+  }
+}
+
+/**
+ * Sort a list of constraints by increasing hash value (shell sort).
+ * @param list Constraints to sort
+ * @param len  Number of constraints
+ * @param hash Hash values of the constraints
+ */
+static void sort_by_hash(OSQPInt*             list,
+                         OSQPInt              len,
+                         const unsigned long* hash) {
+
+  OSQPInt gap, i, j, v;
+
+  for (gap = len / 2; gap > 0; gap /= 2) {
+    for (i = gap; i < len; i++) {
+      v = list[i];
+      for (j = i; j >= gap && hash[list[j - gap]] > hash[v]; j -= gap) {
+        list[j] = list[j - gap];
+      }
+      list[j] = v;
+    }
+  }
+}
+
+/**
+ * Check whether row k of a row-wise matrix is a multiple of row r.
+ * @param  rp    Row pointers
+ * @param  ci    Column indices
+ * @param  cv    Values
+ * @param  r     First row
+ * @param  k     Second row
+ * @param  ratio Factor t such that row k = t * row r
+ * @return       1 if the rows are proportional, 0 otherwise
+ */
+static OSQPInt rows_proportional(const OSQPInt*   rp,
+                                 const OSQPInt*   ci,
+                                 const OSQPFloat* cv,
+                                 OSQPInt          r,
+                                 OSQPInt          k,
+                                 OSQPFloat*       ratio) {
+
+  OSQPInt   p, s;
+  OSQPInt   len = rp[r + 1] - rp[r];
+  OSQPFloat t;
+
+  if (rp[k + 1] - rp[k] != len) return 0;
+
+  t = cv[rp[k]] / cv[rp[r]];
+  for (p = rp[r], s = rp[k]; p < rp[r + 1]; p++, s++) {
+    if (ci[p] != ci[s]) return 0;
+    if (c_absval(cv[s] - t * cv[p]) > PRESOLVE_TOL * c_absval(cv[s])) return 0;
+  }
+
+  *ratio = t;
+  return 1;
+}
+
+
+OSQPInt presolve_setup(OSQPPresolve**       presolvep,
+                       const OSQPCscMatrix* P,
+                       const OSQPFloat*     q,
+                       const OSQPCscMatrix* A,
+                       const OSQPFloat*     l,
+                       const OSQPFloat*     u) {
+
+  OSQPInt i, j, k, p, r, a, b, nz, len;
+  OSQPInt n    = P->n;
+  OSQPInt m    = A->m;
+  OSQPInt nnzA = A->p[n];
+
+  OSQPFloat t, lo_k, hi_k, tol;
+
+  OSQPInt*       iwork;
+  OSQPFloat*     fwork;
+  unsigned long* hash;  // hash of the sparsity pattern of every constraint
+  OSQPInt*       rcnt;  // nonzeros of every constraint
+  OSQPInt*       rcol;  // variable of a singleton constraint
+  OSQPInt*       rp;    // row pointers of the constraints left
+  OSQPInt*       ci;    // column indices of the constraints left
+  OSQPInt*       list;  // constraints checked for duplicates
+  OSQPFloat*     rval;  // coefficient of a singleton constraint
+  OSQPFloat*     cv;    // values of the constraints left
+  OSQPFloat*     lr;    // bounds of the constraints shifted by the fixed variables
+  OSQPFloat*     ur;
+  OSQPFloat*     lo;    // bounds of the variables from singleton constraints
+  OSQPFloat*     hi;
+  OSQPFloat*     shift; // contribution of the fixed variables to the constraints
+  OSQPPresolve*  presolve;
+
+  presolve = c_calloc(1, sizeof(OSQPPresolve));
+  *presolvep = presolve;
+  if (!presolve) return 1;
+
+  presolve->n = n;
+  presolve->m = m;
+
+  presolve->col_map    = (OSQPInt *)   c_malloc(n * sizeof(OSQPInt));
+  presolve->row_map    = (OSQPInt *)   c_malloc((m + 1) * sizeof(OSQPInt));
+  presolve->row_rep    = (OSQPInt *)   c_malloc((m + 1) * sizeof(OSQPInt));
+  presolve->row_ratio  = (OSQPFloat *) c_malloc((m + 1) * sizeof(OSQPFloat));
+  presolve->lo_src     = (OSQPInt *)   c_malloc((m + 1) * sizeof(OSQPInt));
+  presolve->up_src     = (OSQPInt *)   c_malloc((m + 1) * sizeof(OSQPInt));
+  presolve->fix_lo_src = (OSQPInt *)   c_malloc(n * sizeof(OSQPInt));
+  presolve->fix_up_src = (OSQPInt *)   c_malloc(n * sizeof(OSQPInt));
+  presolve->x_fix      = (OSQPFloat *) c_calloc(n, sizeof(OSQPFloat));
+  presolve->x_work     = (OSQPFloat *) c_malloc(n * sizeof(OSQPFloat));
+  presolve->y_work     = (OSQPFloat *) c_malloc((m + 1) * sizeof(OSQPFloat));
+  if (!presolve->col_map || !presolve->row_map || !presolve->row_rep ||
+      !presolve->row_ratio || !presolve->lo_src || !presolve->up_src ||
+      !presolve->fix_lo_src || !presolve->fix_up_src || !presolve->x_fix ||
+      !presolve->x_work || !presolve->y_work)
+    return 1;
+
+  iwork = (OSQPInt *)       c_malloc((3 * m + nnzA + 2) * sizeof(OSQPInt));
+  fwork = (OSQPFloat *)     c_malloc((4 * m + 2 * n + nnzA + 1) * sizeof(OSQPFloat));
+  hash  = (unsigned long *) c_malloc((m + 1) * sizeof(unsigned long));
+  if (!iwork || !fwork || !hash) {
+    c_free(iwork);
+    c_free(fwork);
+    c_free(hash);
+    return 1;
+  }
+  rcnt  = iwork;
+  list  = iwork + m;
+  rp    = iwork + 2 * m;
+  ci    = iwork + 3 * m + 1;
+  rval  = fwork;
+  lr    = fwork + m;
+  ur    = fwork + 2 * m;
+  shift = fwork + 3 * m;
+  lo    = fwork + 4 * m;
+  hi    = fwork + 4 * m + n;
+  cv    = fwork + 4 * m + 2 * n;
+  rcol  = presolve->row_map;  // not needed once the constraints are classified
+
+  // Nonzeros of every constraint
+  for (i = 0; i < m; i++) rcnt[i] = 0;
+  for (j = 0; j < n; j++) {
+    for (p = A->p[j]; p < A->p[j + 1]; p++) {
+      if (A->x[p] != 0.0) {
+        i       = A->i[p];
+        rcol[i] = j;
+        rval[i] = A->x[p];
+        rcnt[i]++;
+      }
+    }
+  }
+
+  // Bounds of the variables from the singleton constraints
+  for (j = 0; j < n; j++) {
+    lo[j] = -OSQP_INFTY;
+    hi[j] =  OSQP_INFTY;
+    presolve->fix_lo_src[j] = -1;
+    presolve->fix_up_src[j] = -1;
+  }
+  for (i = 0; i < m; i++) {
+    if (rcnt[i] != 1) continue;
+    j = rcol[i];
+    bounds_div(l[i], u[i], rval[i], &lo_k, &hi_k);
+    if (presolve->fix_lo_src[j] < 0 || lo_k > lo[j]) {
+      lo[j] = lo_k;
+      presolve->fix_lo_src[j] = i;
+    }
+    if (presolve->fix_up_src[j] < 0 || hi_k < hi[j]) {
+      hi[j] = hi_k;
+      presolve->fix_up_src[j] = i;
+    }
+  }
+
+  // Variables fixed by equal bounds. At least one variable is kept.
+  for (j = 0; j < n; j++) {
+    presolve->col_map[j] = 0;
+    if (presolve->fix_lo_src[j] >= 0 && lo[j] == hi[j] &&
+        c_absval(lo[j]) < PRESOLVE_INF &&
+        presolve->n_fixed < n - 1) {
+      presolve->col_map[j] = -1;
+      presolve->x_fix[j]   = lo[j];
+      presolve->n_fixed++;
+    }
+  }
+  for (j = 0, k = 0; j < n; j++) {
+    if (presolve->col_map[j] == 0) presolve->col_map[j] = k++;
+  }
+  presolve->n_red = k;
+
+  // Singleton constraints of the fixed variables are removed with them
+  for (i = 0; i < m; i++) {
+    presolve->row_rep[i]   = -1;
+    presolve->row_ratio[i] = 1.0;
+    presolve->lo_src[i]    = i;
+    presolve->up_src[i]    = i;
+
+    if (rcnt[i] == 1 && presolve->col_map[rcol[i]] < 0) {
+      presolve->row_rep[i]   = -2;
+      presolve->row_ratio[i] = rval[i];
+    }
+  }
+
+  // Contribution of the fixed variables to the constraints
+  for (i = 0; i < m; i++) shift[i] = 0.0;
+  for (j = 0; j < n; j++) {
+    if (presolve->col_map[j] >= 0) continue;
+    for (p = A->p[j]; p < A->p[j + 1]; p++) {
+      if (A->x[p] != 0.0) {
+        i         = A->i[p];
+        shift[i] += A->x[p] * presolve->x_fix[j];
+        rcnt[i]--;
+      }
+    }
+  }
+  for (i = 0; i < m; i++) {
+    lr[i] = l[i] <= -PRESOLVE_INF ? l[i] : l[i] - shift[i];
+    ur[i] = u[i] >=  PRESOLVE_INF ? u[i] : u[i] - shift[i];
+  }
+
+  // Classify the other constraints
+  len = 0;
+  for (i = 0; i < m; i++) {
+    if (presolve->row_rep[i] == -2) {
+      presolve->n_singleton++;
+    }
+    else if (rcnt[i] == 0) {
+      // Empty constraints are kept when infeasible
+      tol = PRESOLVE_TOL * (1.0 + c_absval(shift[i]));
+      if (lr[i] <= tol && ur[i] >= -tol) {
+        presolve->row_rep[i] = -2;
+        presolve->n_empty++;
+      }
+    }
+    else if (lr[i] <= -PRESOLVE_INF && ur[i] >= PRESOLVE_INF) {
+      presolve->row_rep[i] = -2;
+      presolve->n_free++;
+    }
+    else {
+      list[len++] = i;
+    }
+  }
+
+  // Constraints left in row-wise form, restricted to the free variables
+  for (i = 0; i <= m; i++) rp[i] = 0;
+  for (j = 0; j < n; j++) {
+    if (presolve->col_map[j] < 0) continue;
+    for (p = A->p[j]; p < A->p[j + 1]; p++) {
+      if (A->x[p] != 0.0) rp[A->i[p] + 1]++;
+    }
+  }
+  for (i = 0; i < m; i++) rp[i + 1] += rp[i];
+  for (i = 0; i < m; i++) {
+    rcnt[i] = rp[i];
+    hash[i] = (unsigned long)(rp[i + 1] - rp[i]);
+  }
+  for (j = 0; j < n; j++) {
+    if (presolve->col_map[j] < 0) continue;
+    for (p = A->p[j]; p < A->p[j + 1]; p++) {
+      if (A->x[p] != 0.0) {
+        i           = A->i[p];
+        k           = rcnt[i]++;
+        ci[k]       = j;
+        cv[k]       = A->x[p];
+        hash[i]     = hash[i] * 31UL + (unsigned long)j;
+      }
+    }
+  }
+
+  // Merge constraints that are multiples of another one, as long as the
+  // merged bounds stay consistent
+  sort_by_hash(list, len, hash);
+  for (a = 0; a < len; a++) {
+    r = list[a];
+    if (presolve->row_rep[r] >= 0) continue;
+
+    for (b = a + 1; b < len && hash[list[b]] == hash[r]; b++) {
+      k = list[b];
+      if (presolve->row_rep[k] >= 0) continue;
+      if (!rows_proportional(rp, ci, cv, r, k, &t)) continue;
+
+      bounds_div(lr[k], ur[k], t, &lo_k, &hi_k);
+      if (c_max(lo_k, lr[r]) > c_min(hi_k, ur[r])) continue;
+
+      if (lo_k > lr[r]) {
+        lr[r] = lo_k;
+        presolve->lo_src[r] = k;
+      }
+      if (hi_k < ur[r]) {
+        ur[r] = hi_k;
+        presolve->up_src[r] = k;
+      }
+      presolve->row_rep[k]   = r;
+      presolve->row_ratio[k] = t;
+      presolve->n_dup++;
+    }
+  }
+
+  // Singleton constraints left become bounds on their variable. The
+  // coefficient moves into the bounds, and into the ratios of the
+  // constraints merged into them.
+  for (a = 0; a < len; a++) {
+    r = list[a];
+    if (presolve->row_rep[r] != -1 || rp[r + 1] - rp[r] != 1) continue;
+
+    t = cv[rp[r]];
+    bounds_div(lr[r], ur[r], t, &lr[r], &ur[r]);
+    if (t < 0) {
+      k                   = presolve->lo_src[r];
+      presolve->lo_src[r] = presolve->up_src[r];
+      presolve->up_src[r] = k;
+    }
+    presolve->row_ratio[r] = t;
+    presolve->n_bound++;
+  }
+  for (i = 0; i < m; i++) {
+    r = presolve->row_rep[i];
+    if (r >= 0) presolve->row_ratio[i] *= presolve->row_ratio[r];
+  }
+
+  // Constraints of the reduced problem
+  for (i = 0, k = 0; i < m; i++) {
+    if (presolve->row_rep[i] == -1) {
+      presolve->row_map[i]   = k;
+      presolve->lo_src[k]    = presolve->lo_src[i];
+      presolve->up_src[k]    = presolve->up_src[i];
+      lr[k]                  = lr[i];
+      ur[k]                  = ur[i];
+      k++;
+    }
+    else {
+      presolve->row_map[i] = -1;
+    }
+  }
+  presolve->m_red = k;
+
+  // Removed constraints have no representative
+  for (i = 0; i < m; i++) {
+    if (presolve->row_rep[i] == -2) presolve->row_rep[i] = -1;
+  }
+
+  // Reduced vectors
+  presolve->q = (OSQPFloat *) c_malloc((presolve->n_red + 1) * sizeof(OSQPFloat));
+  presolve->l = (OSQPFloat *) c_malloc((presolve->m_red + 1) * sizeof(OSQPFloat));
+  presolve->u = (OSQPFloat *) c_malloc((presolve->m_red + 1) * sizeof(OSQPFloat));
+  if (presolve->q && presolve->l && presolve->u) {
+    for (i = 0; i < presolve->m_red; i++) {
+      presolve->l[i] = lr[i];
+      presolve->u[i] = ur[i];
+    }
+  }
+
+  c_free(iwork);
+  c_free(fwork);
+  c_free(hash);
+
+  if (!presolve->q || !presolve->l || !presolve->u) return 1;
+
+  // Gradient of the cost at the fixed variables, P * x_fix
+  if (presolve->n_fixed) {
+    presolve->Px_fix = (OSQPFloat *) c_calloc(n, sizeof(OSQPFloat));
+    if (!presolve->Px_fix) return 1;
+    for (j = 0; j < n; j++) {
+      for (p = P->p[j]; p < P->p[j + 1]; p++) {
+        i                    = P->i[p];
+        presolve->Px_fix[i] += P->x[p] * presolve->x_fix[j];
+        if (i != j) presolve->Px_fix[j] += P->x[p] * presolve->x_fix[i];
+      }
+    }
+  }
+
+  // Reduced cost and the cost of the fixed variables
+  presolve_q(presolve, q, presolve->q);
+
+  // Reduced matrices
+  nz = 0;
+  for (j = 0; j < n; j++) {
+    if (presolve->col_map[j] < 0) continue;
+    for (p = A->p[j]; p < A->p[j + 1]; p++) {
+      if (presolve->row_map[A->i[p]] >= 0) nz++;
+    }
+  }
+  presolve->A = csc_spalloc(presolve->m_red, presolve->n_red, nz, 1, 0);
+  if (!presolve->A) return 1;
+
+  nz = 0;
+  for (j = 0; j < n; j++) {
+    if (presolve->col_map[j] < 0) continue;
+    presolve->A->p[presolve->col_map[j]] = nz;
+    for (p = A->p[j]; p < A->p[j + 1]; p++) {
+      r = presolve->row_map[A->i[p]];
+      if (r >= 0) {
+        presolve->A->i[nz] = r;
+        presolve->A->x[nz] = A->x[p] / presolve->row_ratio[A->i[p]];
+        nz++;
+      }
+    }
+  }
+  presolve->A->p[presolve->n_red] = nz;
+
+  nz = 0;
+  for (j = 0; j < n; j++) {
+    if (presolve->col_map[j] < 0) continue;
+    for (p = P->p[j]; p < P->p[j + 1]; p++) {
+      if (presolve->col_map[P->i[p]] >= 0) nz++;
+    }
+  }
+  presolve->P = csc_spalloc(presolve->n_red, presolve->n_red, nz, 1, 0);
+  if (!presolve->P) return 1;
+
+  nz = 0;
+  for (j = 0; j < n; j++) {
+    if (presolve->col_map[j] < 0) continue;
+    presolve->P->p[presolve->col_map[j]] = nz;
+    for (p = P->p[j]; p < P->p[j + 1]; p++) {
+      r = presolve->col_map[P->i[p]];
+      if (r >= 0) {
+        presolve->P->i[nz] = r;
+        presolve->P->x[nz] = P->x[p];
+        nz++;
+      }
+    }
+  }
+  presolve->P->p[presolve->n_red] = nz;
+
+  // User data needed to recover the duals of the singletons of fixed variables
+  if (presolve->n_fixed) {
+    presolve->P_user = csc_copy(P);
+    presolve->A_user = csc_copy(A);
+    presolve->q_user = (OSQPFloat *) c_malloc(n * sizeof(OSQPFloat));
+    if (!presolve->P_user || !presolve->A_user || !presolve->q_user) return 1;
+    for (j = 0; j < n; j++) presolve->q_user[j] = q[j];
+  }
+
+  return 0;
+}
+
+
+void presolve_q(OSQPPresolve*    presolve,
+                const OSQPFloat* q,
+                OSQPFloat*       q_red) {
+
+  OSQPInt j;
+
+  presolve->obj_const = 0.0;
+  for (j = 0; j < presolve->n; j++) {
+    if (presolve->col_map[j] >= 0) {
+      q_red[presolve->col_map[j]] = presolve->Px_fix ? q[j] + presolve->Px_fix[j] : q[j];
+    }
+    else {
+      presolve->obj_const += presolve->x_fix[j] * (q[j] + 0.5 * presolve->Px_fix[j]);
+    }
+  }
+
+  if (presolve->q_user) {
+    for (j = 0; j < presolve->n; j++) presolve->q_user[j] = q[j];
+  }
+}
+
+
+void presolve_free_data(OSQPPresolve* presolve) {
+  if (presolve) {
+    csc_spfree(presolve->P);
+    csc_spfree(presolve->A);
+    c_free(presolve->q);
+    c_free(presolve->l);
+    c_free(presolve->u);
+    presolve->P = OSQP_NULL;
+    presolve->A = OSQP_NULL;
+    presolve->q = OSQP_NULL;
+    presolve->l = OSQP_NULL;
+    presolve->u = OSQP_NULL;
+  }
+}
+
+
+void presolve_free(OSQPPresolve* presolve) {
+  if (presolve) {
+    presolve_free_data(presolve);
+    csc_spfree(presolve->P_user);
+    csc_spfree(presolve->A_user);
+    c_free(presolve->q_user);
+    c_free(presolve->Px_fix);
+    c_free(presolve->col_map);
+    c_free(presolve->row_map);
+    c_free(presolve->row_rep);
+    c_free(presolve->row_ratio);
+    c_free(presolve->lo_src);
+    c_free(presolve->up_src);
+    c_free(presolve->fix_lo_src);
+    c_free(presolve->fix_up_src);
+    c_free(presolve->x_fix);
+    c_free(presolve->x_work);
+    c_free(presolve->y_work);
+    c_free(presolve);
+  }
+}
+
+
+void presolve_point(const OSQPPresolve* presolve,
+                    const OSQPFloat*    x,
+                    const OSQPFloat*    y,
+                    OSQPFloat*          x_red,
+                    OSQPFloat*          y_red) {
+
+  OSQPInt i, j, r;
+
+  if (x) {
+    for (j = 0; j < presolve->n; j++) {
+      if (presolve->col_map[j] >= 0) x_red[presolve->col_map[j]] = x[j];
+    }
+  }
+
+  // Constraints contribute a_i y_i = row_ratio[i] a_red y_i
+  if (y) {
+    for (r = 0; r < presolve->m_red; r++) y_red[r] = 0.0;
+    for (i = 0; i < presolve->m; i++) {
+      if (presolve->row_map[i] >= 0) {
+        y_red[presolve->row_map[i]] += presolve->row_ratio[i] * y[i];
+      }
+      else if (presolve->row_rep[i] >= 0) {
+        y_red[presolve->row_map[presolve->row_rep[i]]] += presolve->row_ratio[i] * y[i];
+      }
+    }
+  }
+}
+
+/**
+ * Recover a dual vector of the user problem from the reduced one.
+ *
+ * The dual of every reduced constraint goes to the user constraint giving
+ * its active bound. The dual of the singleton constraints of fixed variables
+ * restores stationarity for those variables, where grad holds the gradient
+ * of the cost at the solution (OSQP_NULL for infeasibility certificates).
+ */
+static void postsolve_dual(OSQPPresolve*    presolve,
+                           OSQPFloat*       y,
+                           const OSQPFloat* grad) {
+
+  OSQPInt   i, j, p, r;
+  OSQPFloat v;
+  OSQPInt   m_red = presolve->m_red;
+  OSQPFloat* y_red = presolve->y_work;
+
+  for (r = 0; r < m_red; r++) {
+    y_red[r] = y[r];
+    if (y_red[r] != y_red[r]) {
+      // No dual available
+      for (i = 0; i < presolve->m; i++) y[i] = OSQP_NAN;
+      return;
+    }
+  }
+
+  for (i = 0; i < presolve->m; i++) y[i] = 0.0;
+
+  for (i = 0; i < presolve->m; i++) {
+    r = presolve->row_map[i];
+    if (r < 0 || y_red[r] == 0.0) continue;
+    j = y_red[r] > 0 ? presolve->up_src[r] : presolve->lo_src[r];
+    y[j] = y_red[r] / presolve->row_ratio[j];
+  }
+
+  if (!presolve->n_fixed) return;
+
+  for (j = 0; j < presolve->n; j++) {
+    if (presolve->col_map[j] >= 0) continue;
+
+    // Stationarity of the fixed variable: grad_j + a_j' y = 0
+    v = grad ? grad[j] : 0.0;
+    for (p = presolve->A_user->p[j]; p < presolve->A_user->p[j + 1]; p++) {
+      v += presolve->A_user->x[p] * y[presolve->A_user->i[p]];
+    }
+    if (v == 0.0) continue;
+
+    i    = v < 0 ? presolve->fix_up_src[j] : presolve->fix_lo_src[j];
+    y[i] = -v / presolve->row_ratio[i];
+  }
+}
+
+/* Expand a primal vector of the reduced problem, fill is used for the fixed variables */
+static void postsolve_primal(OSQPPresolve*    presolve,
+                             OSQPFloat*       x,
+                             const OSQPFloat* fill) {
+
+  OSQPInt j;
+
+  if (x[0] != x[0]) {
+    // No primal vector available
+    for (j = 0; j < presolve->n; j++) x[j] = OSQP_NAN;
+    return;
+  }
+
+  for (j = 0; j < presolve->n_red; j++) presolve->x_work[j] = x[j];
+  for (j = presolve->n - 1; j >= 0; j--) {
+    x[j] = presolve->col_map[j] >= 0 ? presolve->x_work[presolve->col_map[j]]
+                                     : (fill ? fill[j] : 0.0);
+  }
+}
+
+
+void presolve_solution(OSQPPresolve* presolve,
+                       OSQPSolution* solution) {
+
+  OSQPInt   i, j, p;
+  OSQPFloat* grad = presolve->x_work;
+  const OSQPCscMatrix* P = presolve->P_user;
+
+  postsolve_primal(presolve, solution->x, presolve->x_fix);
+  postsolve_primal(presolve, solution->dual_inf_cert, OSQP_NULL);
+
+  // Gradient of the cost at the solution, P x + q
+  if (presolve->n_fixed) {
+    for (j = 0; j < presolve->n; j++) grad[j] = presolve->q_user[j];
+    for (j = 0; j < presolve->n; j++) {
+      for (p = P->p[j]; p < P->p[j + 1]; p++) {
+        i        = P->i[p];
+        grad[i] += P->x[p] * solution->x[j];
+        if (i != j) grad[j] += P->x[p] * solution->x[i];
+      }
+    }
+  }
+
+  postsolve_dual(presolve, solution->y, grad);
+  postsolve_dual(presolve, solution->prim_inf_cert, OSQP_NULL);
+}
@@ -0,0 +1,383 @@
+#include "reorder.h"
+#include "csc_utils.h"
+
+/**
+ * Sort a list of graph nodes by increasing degree (shell sort).
+ * @param list Nodes to sort
+ * @param len  Number of nodes
+ * @param deg  Node degrees
+ */
+static void sort_by_degree(OSQPInt*       list,
+                           OSQPInt        len,
+                           const OSQPInt* deg) {
+
+  OSQPInt gap, i, j, v;
+
+  for (gap = len / 2; gap > 0; gap /= 2) {
+    for (i = gap; i < len; i++) {
+      v = list[i];
+      for (j = i; j >= gap && deg[list[j - gap]] > deg[v]; j -= gap) {
+        list[j] = list[j - gap];
+      }
+      list[j] = v;
+    }
+  }
+}
+
+/**
+ * Reverse Cuthill-McKee ordering of the graph of the KKT matrix [P A'; A 0].
+ * Nodes 0..n-1 are the variables and nodes n..n+m-1 the constraints.
+ * Every connected component is started from its node of lowest degree.
+ * @param  P     Upper triangular part of the cost matrix
+ * @param  A     Constraint matrix
+ * @param  order Ordering of the n+m nodes
+ * @return       Exitflag: 0 on success, 1 if out of memory
+ */
+static OSQPInt rcm_order(const OSQPCscMatrix* P,
+                         const OSQPCscMatrix* A,
+                         OSQPInt*             order) {
+
+  OSQPInt i, j, k, p, v, w, head, tail, first, start;
+  OSQPInt n  = P->n;
+  OSQPInt nn = P->n + A->m;
+
+  OSQPInt* deg;   // node degrees
+  OSQPInt* adjp;  // adjacency list pointers
+  OSQPInt* adji;  // adjacency lists
+  OSQPInt* next;  // fill position of each adjacency list
+  OSQPInt* nodes; // nodes sorted by degree
+  OSQPInt* mark;  // visited nodes
+
+  deg   = (OSQPInt *) c_calloc(nn + 1, sizeof(OSQPInt));
+  adjp  = (OSQPInt *) c_malloc((nn + 1) * sizeof(OSQPInt));
+  adji  = (OSQPInt *) c_malloc((2 * (P->p[n] + A->p[n]) + 1) * sizeof(OSQPInt));
+  next  = (OSQPInt *) c_calloc(nn + 1, sizeof(OSQPInt));
+  nodes = (OSQPInt *) c_malloc((nn + 1) * sizeof(OSQPInt));
+  mark  = (OSQPInt *) c_calloc(nn + 1, sizeof(OSQPInt));
+
+  if (!deg || !adjp || !adji || !next || !nodes || !mark) {
+    c_free(deg);
+    c_free(adjp);
+    c_free(adji);
+    c_free(next);
+    c_free(nodes);
+    c_free(mark);
+    return 1;
+  }
+
+  // Count the off-diagonal entries of every node
+  for (j = 0; j < n; j++) {
+    for (p = P->p[j]; p < P->p[j + 1]; p++) {
+      i = P->i[p];
+      if (i == j) continue;
+      deg[i]++;
+      deg[j]++;
+    }
+    for (p = A->p[j]; p < A->p[j + 1]; p++) {
+      deg[n + A->i[p]]++;
+      deg[j]++;
+    }
+  }
+
+  adjp[0] = 0;
+  for (v = 0; v < nn; v++) {
+    adjp[v + 1] = adjp[v] + deg[v];
+    next[v]     = adjp[v];
+  }
+
+  // Fill the adjacency lists
+  for (j = 0; j < n; j++) {
+    for (p = P->p[j]; p < P->p[j + 1]; p++) {
+      i = P->i[p];
+      if (i == j) continue;
+      adji[next[i]++] = j;
+      adji[next[j]++] = i;
+    }
+    for (p = A->p[j]; p < A->p[j + 1]; p++) {
+      i = n + A->i[p];
+      adji[next[i]++] = j;
+      adji[next[j]++] = i;
+    }
+  }
+
+  // Bucket the nodes by degree to find the start of each component
+  for (v = 0; v <= nn; v++) next[v] = 0;
+  for (v = 0; v < nn; v++) next[deg[v]]++;
+  for (v = 0, k = 0; v <= nn; v++) {
+    p       = next[v];
+    next[v] = k;
+    k      += p;
+  }
+  for (v = 0; v < nn; v++) nodes[next[deg[v]]++] = v;
+
+  // Breadth first search, visiting neighbours by increasing degree
+  head  = 0;
+  tail  = 0;
+  start = 0;
+  while (tail < nn) {
+    while (mark[nodes[start]]) start++;
+    order[tail++]       = nodes[start];
+    mark[nodes[start]] = 1;
+
+    while (head < tail) {
+      v     = order[head++];
+      first = tail;
+      for (p = adjp[v]; p < adjp[v + 1]; p++) {
+        w = adji[p];
+        if (!mark[w]) {
+          mark[w]         = 1;
+          order[tail++] = w;
+        }
+      }
+      sort_by_degree(order + first, tail - first, deg);
+    }
+  }
+
+  // Reverse the ordering
+  for (i = 0, j = nn - 1; i < j; i++, j--) {
+    v        = order[i];
+    order[i] = order[j];
+    order[j] = v;
+  }
+
+  c_free(deg);
+  c_free(adjp);
+  c_free(adji);
+  c_free(next);
+  c_free(nodes);
+  c_free(mark);
+
+  return 0;
+}
+
+/**
+ * Permute the rows and columns of a matrix, C = M(rperm, cperm).
+ * The columns of C are sorted by row index.
+ * @param  M    Matrix to permute
+ * @param  rinv Inverse row permutation (row i of M is row rinv[i] of C)
+ * @param  cinv Inverse column permutation (column j of M is column cinv[j] of C)
+ * @param  triu Boolean; keep the permuted matrix upper triangular
+ * @param  map  Position in C of every entry of M
+ * @return      Permuted matrix, OSQP_NULL if out of memory
+ */
+static OSQPCscMatrix* permute_csc(const OSQPCscMatrix* M,
+                                  const OSQPInt*       rinv,
+                                  const OSQPInt*       cinv,
+                                  OSQPInt              triu,
+                                  OSQPInt*             map) {
+
+  OSQPInt i, j, k, p, q, t;
+  OSQPInt nz = M->p[M->n];
+
+  OSQPInt* row;
+  OSQPInt* col;
+  OSQPInt* sorted;
+  OSQPInt* w;
+  OSQPCscMatrix* C;
+
+  C      = csc_spalloc(M->m, M->n, nz, 1, 0);
+  row    = (OSQPInt *) c_malloc((nz + 1) * sizeof(OSQPInt));
+  col    = (OSQPInt *) c_malloc((nz + 1) * sizeof(OSQPInt));
+  sorted = (OSQPInt *) c_malloc((nz + 1) * sizeof(OSQPInt));
+  w      = (OSQPInt *) c_calloc(c_max(M->m, M->n) + 1, sizeof(OSQPInt));
+
+  if (!C || !row || !col || !sorted || !w) {
+    csc_spfree(C);
+    C = OSQP_NULL;
+  }
+  else {
+    // New position of every entry
+    for (j = 0; j < M->n; j++) {
+      for (p = M->p[j]; p < M->p[j + 1]; p++) {
+        i = rinv[M->i[p]];
+        k = cinv[j];
+        if (triu && i > k) {
+          t = i;
+          i = k;
+          k = t;
+        }
+        row[p] = i;
+        col[p] = k;
+      }
+    }
+
+    // Stable counting sort by row ...
+    for (p = 0; p < nz; p++) w[row[p]]++;
+    for (i = 0, q = 0; i < M->m; i++) {
+      t    = w[i];
+      w[i] = q;
+      q   += t;
+    }
+    for (p = 0; p < nz; p++) sorted[w[row[p]]++] = p;
+
+    // ... followed by a stable counting sort by column
+    for (j = 0; j <= M->n; j++) w[j] = 0;
+    for (p = 0; p < nz; p++) w[col[p]]++;
+    for (j = 0, q = 0; j < M->n; j++) {
+      C->p[j] = q;
+      t       = w[j];
+      w[j]    = q;
+      q      += t;
+    }
+    C->p[M->n] = q;
+
+    for (k = 0; k < nz; k++) {
+      p       = sorted[k];
+      q       = w[col[p]]++;
+      C->i[q] = row[p];
+      C->x[q] = M->x[p];
+      map[p]  = q;
+    }
+  }
+
+  c_free(row);
+  c_free(col);
+  c_free(sorted);
+  c_free(w);
+
+  return C;
+}
+
+
+OSQPInt reorder_setup(OSQPReorder**        reorderp,
+                      const OSQPCscMatrix* P,
+                      const OSQPCscMatrix* A) {
+
+  OSQPInt k, v, nx, nc;
+  OSQPInt n    = P->n;
+  OSQPInt m    = A->m;
+  OSQPInt nnzP = P->p[n];
+  OSQPInt nnzA = A->p[n];
+
+  OSQPInt* order;
+  OSQPInt* inv;
+  OSQPReorder* reorder;
+
+  reorder = c_calloc(1, sizeof(OSQPReorder));
+  *reorderp = reorder;
+  if (!reorder) return 1;
+
+  reorder->xperm    = (OSQPInt *) c_malloc(n * sizeof(OSQPInt));
+  reorder->cperm    = (OSQPInt *) c_malloc((m + 1) * sizeof(OSQPInt));
+  reorder->Pmap     = (OSQPInt *) c_malloc((nnzP + 1) * sizeof(OSQPInt));
+  reorder->Amap     = (OSQPInt *) c_malloc((nnzA + 1) * sizeof(OSQPInt));
+  reorder->idx_work = (OSQPInt *) c_malloc((nnzP + nnzA + 1) * sizeof(OSQPInt));
+  reorder->val_work = (OSQPFloat *) c_malloc(c_max(c_max(n, m), c_max(nnzP, nnzA)) * sizeof(OSQPFloat));
+  if (!reorder->xperm || !reorder->cperm || !reorder->Pmap ||
+      !reorder->Amap  || !reorder->idx_work || !reorder->val_work)
+    return 1;
+
+  order = (OSQPInt *) c_malloc((n + m) * sizeof(OSQPInt));
+  inv   = (OSQPInt *) c_malloc((n + m) * sizeof(OSQPInt));
+  if (!order || !inv || rcm_order(P, A, order)) {
+    c_free(order);
+    c_free(inv);
+    return 1;
+  }
+
+  // Split the ordering of the KKT nodes into variables and constraints
+  nx = 0;
+  nc = 0;
+  for (k = 0; k < n + m; k++) {
+    v = order[k];
+    if (v < n) {
+      reorder->xperm[nx] = v;
+      inv[v] = nx++;
+    }
+    else {
+      reorder->cperm[nc] = v - n;
+      inv[v] = nc++;
+    }
+  }
+
+  reorder->P = permute_csc(P, inv,     inv, 1, reorder->Pmap);
+  reorder->A = permute_csc(A, inv + n, inv, 0, reorder->Amap);
+
+  c_free(order);
+  c_free(inv);
+
+  if (!reorder->P || !reorder->A) return 1;
+
+  return 0;
+}
+
+
+void reorder_free_data(OSQPReorder* reorder) {
+  if (reorder) {
+    csc_spfree(reorder->P);
+    csc_spfree(reorder->A);
+    reorder->P = OSQP_NULL;
+    reorder->A = OSQP_NULL;
+  }
+}
+
+
+void reorder_free(OSQPReorder* reorder) {
+  if (reorder) {
+    reorder_free_data(reorder);
+    c_free(reorder->xperm);
+    c_free(reorder->cperm);
+    c_free(reorder->Pmap);
+    c_free(reorder->Amap);
+    c_free(reorder->idx_work);
+    c_free(reorder->val_work);
+    c_free(reorder);
+  }
+}
+
+
+void reorder_gather(OSQPFloat*       dst,
+                    const OSQPFloat* src,
+                    const OSQPInt*   perm,
+                    OSQPInt          len) {
+
+  OSQPInt i;
+
+  for (i = 0; i < len; i++) dst[i] = src[perm[i]];
+}
+
+
+const OSQPFloat* reorder_mat_values(const OSQPInt*   map,
+                                    const OSQPFloat* Mx_new,
+                                    const OSQPInt*   Mx_idx,
+                                    OSQPInt          M_new_n,
+                                    OSQPInt*         idx_work,
+                                    OSQPFloat*       val_work,
+                                    const OSQPInt**  Mx_idx_p) {
+
+  OSQPInt k;
+
+  if (Mx_idx) {
+    for (k = 0; k < M_new_n; k++) idx_work[k] = map[Mx_idx[k]];
+    *Mx_idx_p = idx_work;
+    return Mx_new;
+  }
+
+  for (k = 0; k < M_new_n; k++) val_work[map[k]] = Mx_new[k];
+  *Mx_idx_p = OSQP_NULL;
+  return val_work;
+}
+
+/* Scatter an internally ordered vector back to the user ordering in place */
+static void scatter_inplace(OSQPFloat*     v,
+                            const OSQPInt* perm,
+                            OSQPInt        len,
+                            OSQPFloat*     work) {
+
+  OSQPInt i;
+
+  for (i = 0; i < len; i++) work[i] = v[i];
+  for (i = 0; i < len; i++) v[perm[i]] = work[i];
+}
+
+
+void reorder_solution(OSQPReorder*  reorder,
+                      OSQPSolution* solution,
+                      OSQPInt       n,
+                      OSQPInt       m) {
+
+  scatter_inplace(solution->x,             reorder->xperm, n, reorder->val_work);
+  scatter_inplace(solution->dual_inf_cert, reorder->xperm, n, reorder->val_work);
+  scatter_inplace(solution->y,             reorder->cperm, m, reorder->val_work);
+  scatter_inplace(solution->prim_inf_cert, reorder->cperm, m, reorder->val_work);
+}
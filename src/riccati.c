@@ -0,0 +1,466 @@
+#include "riccati.h"
+#include "lin_alg.h"
+#include "printing.h"
+
+/**
+ * Linear system solver factoring the block tridiagonal reduced KKT matrix
+ * stage by stage. The function pointers follow the layout of LinSysSolver.
+ *
+ * The diagonal block of stage k is s_k x s_k and the coupling block of the
+ * stages k and k+1 is stored as H_k+1,k, s_k+1 x s_k, both column major.
+ */
+typedef struct riccati riccati_solver;
+
+struct riccati {
+  enum osqp_linsys_solver_type type;
+
+  const char* (*name)(struct riccati* self);
+
+  OSQPInt (*solve)(struct riccati* self,
+                   OSQPVectorf*    b,
+                   OSQPInt         admm_iter);
+
+  void (*update_settings)(struct riccati*     self,
+                          const OSQPSettings* settings);
+
+  void (*warm_start)(struct riccati*    self,
+                     const OSQPVectorf* x);
+
+  OSQPInt (*adjoint_derivative)(struct riccati* self);
+
+  void (*free)(struct riccati* self);
+
+  OSQPInt (*update_matrices)(struct riccati*   self,
+                             const OSQPMatrix* P,
+                             const OSQPInt*    Px_new_idx,
+                             OSQPInt           P_new_n,
+                             const OSQPMatrix* A,
+                             const OSQPInt*    Ax_new_idx,
+                             OSQPInt           A_new_n);
+
+  OSQPInt (*update_rho_vec)(struct riccati*    self,
+                            const OSQPVectorf* rho_vec,
+                            OSQPFloat          rho_sc);
+
+  OSQPInt nthreads;
+
+  OSQPInt           n;      ///< number of variables
+  OSQPInt           m;      ///< number of constraints
+  OSQPInt           T;      ///< number of stages
+  OSQPInt*          start;  ///< first variable of every stage, size T + 1
+  OSQPInt*          stage;  ///< stage of every variable
+  OSQPInt*          doff;   ///< offset of the diagonal block of every stage in D
+  OSQPInt*          goff;   ///< offset of the coupling block of every stage in G
+  OSQPFloat*        D;      ///< diagonal blocks H_kk, then the Cholesky factors L_k of S_k
+  OSQPFloat*        G;      ///< coupling blocks H_k+1,k, then L_k+1^-1 H_k+1,k
+  OSQPInt*          row_p;  ///< start of the entries of every row in row_k, size m + 1
+  OSQPInt*          row_k;  ///< entries of A row by row in increasing column order
+  OSQPInt*          row_j;  ///< column of every entry in row_k
+  const OSQPMatrix* P;      ///< cost matrix
+  const OSQPMatrix* A;      ///< constraint matrix
+  OSQPFloat         sigma;  ///< ADMM sigma
+  OSQPFloat*        rho;    ///< rho of every row
+  OSQPFloat*        x;      ///< right-hand side and solution of the reduced system
+};
+
+
+/* Cholesky factorization of the lower triangle of the s x s column major matrix M */
+static OSQPInt chol(OSQPFloat* M,
+                    OSQPInt    s) {
+
+  OSQPInt   i, j, k;
+  OSQPFloat d;
+
+  for (j = 0; j < s; j++) {
+    d = M[j + j*s];
+    for (k = 0; k < j; k++) d -= M[j + k*s] * M[j + k*s];
+    if (d <= 0.0) return 1;
+    d = c_sqrt(d);
+    M[j + j*s] = d;
+    for (i = j + 1; i < s; i++) {
+      for (k = 0; k < j; k++) M[i + j*s] -= M[i + k*s] * M[j + k*s];
+      M[i + j*s] /= d;
+    }
+  }
+  return 0;
+}
+
+/* Solve L y = b in place */
+static void lower_solve(const OSQPFloat* L,
+                        OSQPInt          s,
+                        OSQPFloat*       y) {
+
+  OSQPInt i, j;
+
+  for (j = 0; j < s; j++) {
+    y[j] /= L[j + j*s];
+    for (i = j + 1; i < s; i++) y[i] -= L[i + j*s] * y[j];
+  }
+}
+
+/* Solve L' x = y in place */
+static void upper_solve(const OSQPFloat* L,
+                        OSQPInt          s,
+                        OSQPFloat*       x) {
+
+  OSQPInt i, j;
+
+  for (j = s - 1; j >= 0; j--) {
+    for (i = j + 1; i < s; i++) x[j] -= L[i + j*s] * x[i];
+    x[j] /= L[j + j*s];
+  }
+}
+
+/* Add v to the entries (i,j) and (j,i) of H for the variables i <= j */
+static void add_pair(riccati_solver* s,
+                     OSQPInt         i,
+                     OSQPInt         j,
+                     OSQPFloat       v) {
+
+  OSQPInt ki = s->stage[i];
+  OSQPInt kj = s->stage[j];
+  OSQPInt si = s->start[ki + 1] - s->start[ki];
+  OSQPInt sj = s->start[kj + 1] - s->start[kj];
+
+  i -= s->start[ki];
+  j -= s->start[kj];
+
+  if (ki == kj) {
+    s->D[s->doff[ki] + i + j*si] += v;
+    if (i != j) s->D[s->doff[ki] + j + i*si] += v;
+  }
+  else {
+    s->G[s->goff[ki] + j + i*sj] += v;
+  }
+}
+
+/* Assemble the blocks of H = P + sigma I + A' diag(rho) A */
+static void set_values(riccati_solver* s) {
+
+  OSQPInt i, j, k, p, q;
+
+  const OSQPInt*   Pp = OSQPMatrix_get_p(s->P);
+  const OSQPInt*   Pi = OSQPMatrix_get_i(s->P);
+  const OSQPFloat* Px = OSQPMatrix_get_x(s->P);
+  const OSQPFloat* Ax = OSQPMatrix_get_x(s->A);
+
+  for (k = 0; k < s->doff[s->T]; k++) s->D[k] = 0.0;
+  for (k = 0; k < s->goff[s->T]; k++) s->G[k] = 0.0;
+
+  for (j = 0; j < s->n; j++) {
+    add_pair(s, j, j, s->sigma);
+    for (k = Pp[j]; k < Pp[j + 1]; k++) {
+      add_pair(s, Pi[k], j, Px[k]);
+    }
+  }
+
+  for (i = 0; i < s->m; i++) {
+    for (p = s->row_p[i]; p < s->row_p[i + 1]; p++) {
+      for (q = p; q < s->row_p[i + 1]; q++) {
+        add_pair(s, s->row_j[p], s->row_j[q],
+                 s->rho[i] * Ax[s->row_k[p]] * Ax[s->row_k[q]]);
+      }
+    }
+  }
+}
+
+/* Store rho of every row */
+static void set_rho(riccati_solver*    s,
+                    const OSQPVectorf* rho_vec,
+                    OSQPFloat          rho_sc) {
+
+  OSQPInt i;
+
+  const OSQPFloat* rho = rho_vec ? OSQPVectorf_data(rho_vec) : OSQP_NULL;
+
+  for (i = 0; i < s->m; i++) {
+    s->rho[i] = rho ? rho[i] : rho_sc;
+  }
+}
+
+/* Backward recursion S_k = H_kk - H_k,k+1 S_k+1^-1 H_k+1,k with S_k = L_k L_k' */
+static OSQPInt factor(riccati_solver* s) {
+
+  OSQPInt    a, b, k, r, sk, s1;
+  OSQPFloat* Dk;
+  OSQPFloat* Gk;
+  OSQPFloat  t;
+
+  for (k = s->T - 1; k >= 0; k--) {
+    sk = s->start[k + 1] - s->start[k];
+    Dk = s->D + s->doff[k];
+
+    if (k < s->T - 1) {
+      // G_k = L_k+1^-1 H_k+1,k and S_k = H_kk - G_k' G_k (lower triangle)
+      s1 = s->start[k + 2] - s->start[k + 1];
+      Gk = s->G + s->goff[k];
+      for (b = 0; b < sk; b++) {
+        lower_solve(s->D + s->doff[k + 1], s1, Gk + b*s1);
+      }
+      for (b = 0; b < sk; b++) {
+        for (a = b; a < sk; a++) {
+          t = 0.0;
+          for (r = 0; r < s1; r++) t += Gk[r + a*s1] * Gk[r + b*s1];
+          Dk[a + b*sk] -= t;
+        }
+      }
+    }
+
+    if (chol(Dk, sk)) return OSQP_NONCVX_ERROR;
+  }
+
+  return 0;
+}
+
+
+static const char* name_linsys_solver_riccati(riccati_solver* s) {
+  return "Riccati";
+}
+
+static OSQPInt solve_linsys_riccati(riccati_solver* s,
+                                    OSQPVectorf*    b,
+                                    OSQPInt         admm_iter) {
+
+  OSQPInt    a, c, j, k, ptr, sk, s1;
+  OSQPInt    n  = s->n;
+  OSQPFloat* bv = OSQPVectorf_data(b);
+  OSQPFloat* x  = s->x;
+  OSQPFloat* xk;
+  OSQPFloat* Gk;
+  OSQPFloat  t;
+
+  const OSQPInt*   Ap = OSQPMatrix_get_p(s->A);
+  const OSQPInt*   Ai = OSQPMatrix_get_i(s->A);
+  const OSQPFloat* Ax = OSQPMatrix_get_x(s->A);
+
+  // Right-hand side r_x + A' diag(rho) r_z of the reduced system
+  for (j = 0; j < n; j++) {
+    t = bv[j];
+    for (ptr = Ap[j]; ptr < Ap[j + 1]; ptr++) {
+      t += Ax[ptr] * s->rho[Ai[ptr]] * bv[n + Ai[ptr]];
+    }
+    x[j] = t;
+  }
+
+  // Backward pass: v_k = L_k^-1 (b_k - G_k' v_k+1)
+  for (k = s->T - 1; k >= 0; k--) {
+    sk = s->start[k + 1] - s->start[k];
+    xk = x + s->start[k];
+    if (k < s->T - 1) {
+      s1 = s->start[k + 2] - s->start[k + 1];
+      Gk = s->G + s->goff[k];
+      for (c = 0; c < sk; c++) {
+        t = 0.0;
+        for (a = 0; a < s1; a++) t += Gk[a + c*s1] * xk[sk + a];
+        xk[c] -= t;
+      }
+    }
+    lower_solve(s->D + s->doff[k], sk, xk);
+  }
+
+  // Forward pass: x_k = L_k^-T (v_k - G_k-1 x_k-1)
+  for (k = 0; k < s->T; k++) {
+    sk = s->start[k + 1] - s->start[k];
+    xk = x + s->start[k];
+    if (k > 0) {
+      s1 = s->start[k] - s->start[k - 1];
+      Gk = s->G + s->goff[k - 1];
+      for (c = 0; c < s1; c++) {
+        t = xk[c - s1];
+        for (a = 0; a < sk; a++) xk[a] -= Gk[a + c*sk] * t;
+      }
+    }
+    upper_solve(s->D + s->doff[k], sk, xk);
+  }
+
+  // x_tilde and z_tilde = A x_tilde
+  for (j = 0; j < s->m; j++) bv[n + j] = 0.0;
+  for (j = 0; j < n; j++) {
+    bv[j] = x[j];
+    for (ptr = Ap[j]; ptr < Ap[j + 1]; ptr++) {
+      bv[n + Ai[ptr]] += Ax[ptr] * x[j];
+    }
+  }
+
+  return 0;
+}
+
+static void update_settings_linsys_solver_riccati(riccati_solver*     s,
+                                                  const OSQPSettings* settings) {
+  // Nothing to update
+}
+
+static void warm_start_linsys_solver_riccati(riccati_solver*    s,
+                                             const OSQPVectorf* x) {
+  // Direct solver, nothing to warm start
+}
+
+static OSQPInt adjoint_derivative_riccati(riccati_solver* s) {
+  // The derivatives factor their own KKT matrix
+  return 0;
+}
+
+static void free_linsys_solver_riccati(riccati_solver* s) {
+
+  if (s) {
+    c_free(s->start);
+    c_free(s->stage);
+    c_free(s->doff);
+    c_free(s->goff);
+    c_free(s->D);
+    c_free(s->G);
+    c_free(s->row_p);
+    c_free(s->row_k);
+    c_free(s->row_j);
+    c_free(s->rho);
+    c_free(s->x);
+  }
+  c_free(s);
+}
+
+static OSQPInt update_linsys_solver_matrices_riccati(riccati_solver*   s,
+                                                     const OSQPMatrix* P,
+                                                     const OSQPInt*    Px_new_idx,
+                                                     OSQPInt           P_new_n,
+                                                     const OSQPMatrix* A,
+                                                     const OSQPInt*    Ax_new_idx,
+                                                     OSQPInt           A_new_n) {
+
+  // Every block touched by a new value is refactored anyway, so all values are refreshed
+  s->P = P;
+  s->A = A;
+  set_values(s);
+
+  return factor(s);
+}
+
+static OSQPInt update_linsys_solver_rho_vec_riccati(riccati_solver*    s,
+                                                    const OSQPVectorf* rho_vec,
+                                                    OSQPFloat          rho_sc) {
+
+  set_rho(s, rho_vec, rho_sc);
+  set_values(s);
+
+  return factor(s);
+}
+
+
+OSQPInt init_linsys_solver_riccati(LinSysSolver**      sp,
+                                   const OSQPMatrix*   P,
+                                   const OSQPMatrix*   A,
+                                   const OSQPVectorf*  rho_vec,
+                                   const OSQPSettings* settings,
+                                   OSQPInt             n_stages,
+                                   const OSQPInt*      stage_n) {
+
+  OSQPInt i, j, k, ptr, sk, s1;
+
+  OSQPInt n    = OSQPMatrix_get_n(A);
+  OSQPInt m    = OSQPMatrix_get_m(A);
+  OSQPInt nnzA = OSQPMatrix_get_nz(A);
+
+  const OSQPInt* Pp = OSQPMatrix_get_p(P);
+  const OSQPInt* Pi = OSQPMatrix_get_i(P);
+  const OSQPInt* Ap = OSQPMatrix_get_p(A);
+  const OSQPInt* Ai = OSQPMatrix_get_i(A);
+
+  OSQPInt*        first;
+  OSQPInt*        last;
+  riccati_solver* s;
+
+  s = c_calloc(1, sizeof(riccati_solver));
+  if (!s) return OSQP_MEM_ALLOC_ERROR;
+  *sp = (LinSysSolver*) s;
+
+  s->name               = &name_linsys_solver_riccati;
+  s->solve              = &solve_linsys_riccati;
+  s->update_settings    = &update_settings_linsys_solver_riccati;
+  s->warm_start         = &warm_start_linsys_solver_riccati;
+  s->adjoint_derivative = &adjoint_derivative_riccati;
+  s->free               = &free_linsys_solver_riccati;
+  s->update_matrices    = &update_linsys_solver_matrices_riccati;
+  s->update_rho_vec     = &update_linsys_solver_rho_vec_riccati;
+  s->type               = OSQP_RICCATI_SOLVER;
+  s->nthreads           = 1;
+
+  s->n     = n;
+  s->m     = m;
+  s->T     = n_stages;
+  s->P     = P;
+  s->A     = A;
+  s->sigma = settings->sigma;
+
+  s->start = (OSQPInt*) c_malloc((n_stages + 1) * sizeof(OSQPInt));
+  s->stage = (OSQPInt*) c_malloc((n + 1) * sizeof(OSQPInt));
+  s->doff  = (OSQPInt*) c_malloc((n_stages + 1) * sizeof(OSQPInt));
+  s->goff  = (OSQPInt*) c_malloc((n_stages + 1) * sizeof(OSQPInt));
+  s->row_p = (OSQPInt*) c_calloc(m + 1, sizeof(OSQPInt));
+  s->row_k = (OSQPInt*) c_malloc((nnzA + 1) * sizeof(OSQPInt));
+  s->row_j = (OSQPInt*) c_malloc((nnzA + 1) * sizeof(OSQPInt));
+  s->rho   = (OSQPFloat*) c_malloc((m + 1) * sizeof(OSQPFloat));
+  s->x     = (OSQPFloat*) c_malloc((n + 1) * sizeof(OSQPFloat));
+  if (!s->start || !s->stage || !s->doff || !s->goff || !s->row_p ||
+      !s->row_k || !s->row_j || !s->rho || !s->x) {
+    return OSQP_MEM_ALLOC_ERROR;
+  }
+
+  // Stage of every variable and the block offsets
+  s->start[0] = 0;
+  s->doff[0]  = 0;
+  s->goff[0]  = 0;
+  for (k = 0; k < n_stages; k++) {
+    sk = stage_n[k];
+    s1 = (k < n_stages - 1) ? stage_n[k + 1] : 0;
+    s->start[k + 1] = s->start[k] + sk;
+    s->doff[k + 1]  = s->doff[k] + sk * sk;
+    s->goff[k + 1]  = s->goff[k] + sk * s1;
+    for (j = s->start[k]; j < s->start[k + 1]; j++) s->stage[j] = k;
+  }
+
+  // P may only couple consecutive stages
+  for (j = 0; j < n; j++) {
+    for (ptr = Pp[j]; ptr < Pp[j + 1]; ptr++) {
+      if (s->stage[j] - s->stage[Pi[ptr]] > 1) {
+        c_eprint("P couples the nonconsecutive stages %i and %i",
+                 (int)s->stage[Pi[ptr]], (int)s->stage[j]);
+        return OSQP_DATA_VALIDATION_ERROR;
+      }
+    }
+  }
+
+  // Entries of A row by row (visiting the columns in order keeps them sorted)
+  for (k = 0; k < nnzA; k++) s->row_p[Ai[k] + 1]++;
+  for (i = 0; i < m; i++) s->row_p[i + 1] += s->row_p[i];
+  first = (OSQPInt*) c_malloc((m + 1) * sizeof(OSQPInt));
+  if (!first) return OSQP_MEM_ALLOC_ERROR;
+  for (i = 0; i < m; i++) first[i] = s->row_p[i];
+  for (j = 0; j < n; j++) {
+    for (ptr = Ap[j]; ptr < Ap[j + 1]; ptr++) {
+      k = first[Ai[ptr]]++;
+      s->row_k[k] = ptr;
+      s->row_j[k] = j;
+    }
+  }
+  c_free(first);
+
+  // Every row of A may only couple consecutive stages
+  for (i = 0; i < m; i++) {
+    if (s->row_p[i + 1] > s->row_p[i]) {
+      last = s->row_j + s->row_p[i + 1] - 1;
+      if (s->stage[*last] - s->stage[s->row_j[s->row_p[i]]] > 1) {
+        c_eprint("row %i of A couples the nonconsecutive stages %i and %i", (int)i,
+                 (int)s->stage[s->row_j[s->row_p[i]]], (int)s->stage[*last]);
+        return OSQP_DATA_VALIDATION_ERROR;
+      }
+    }
+  }
+
+  s->D = (OSQPFloat*) c_malloc((s->doff[n_stages] + 1) * sizeof(OSQPFloat));
+  s->G = (OSQPFloat*) c_malloc((s->goff[n_stages] + 1) * sizeof(OSQPFloat));
+  if (!s->D || !s->G) return OSQP_MEM_ALLOC_ERROR;
+
+  set_rho(s, rho_vec, settings->rho);
+  set_values(s);
+
+  return factor(s);
+}
@@ -17,33 +17,94 @@ void limit_scaling_vector(OSQPVectorf* v) {
 }
 
 /**
- * Compute infinite norm of the columns of the KKT matrix without forming it
+ * Compute the measure of the columns of the KKT matrix used by the
+ * equilibration step, without forming it.
  *
- * The norm is stored in the vector v = (D, E)
+ * The measure is stored in the vectors D (first n columns) and E (last m
+ * columns). For the infinity norm the norms taken while applying the
+ * previous step can be passed in: the column norms of P in x_prev, the column
+ * norms of A in D_temp_A and the row norms of A in z_prev.
  *
- * @param P        Cost matrix
- * @param A        Constraints matrix
- * @param D        Norm of columns related to variables
- * @param D_temp_A Temporary vector for norm of columns of A
- * @param E        Norm of columns related to constraints
- * @param n        Dimension of KKT matrix
+ * @param work        Workspace
+ * @param type        Scaling strategy of the step
+ * @param norms_given Boolean; the infinity norms of P and A are given
+ * @param c           Cost scaling not yet applied to the values of P
  */
-void compute_inf_norm_cols_KKT(const OSQPMatrix*  P,
-                               const OSQPMatrix*  A,
-                                     OSQPVectorf* D,
-                                     OSQPVectorf* D_temp_A,
-                                     OSQPVectorf* E) {
-  // First half
-  //  [ P ]
-  //  [ A ]
-  OSQPMatrix_col_norm_inf(P,D);
-  OSQPMatrix_col_norm_inf(A, D_temp_A);
-  OSQPVectorf_ew_max_vec(D, D_temp_A, D);
-
-  // Second half
-  //  [ A']
-  //  [ 0 ]
-  OSQPMatrix_row_norm_inf(A,E);
+static void compute_measure_cols_KKT(OSQPWorkspace*    work,
+                                     osqp_scaling_type type,
+                                     OSQPInt           norms_given,
+                                     OSQPFloat         c) {
+
+  const OSQPMatrix* P = work->data->P;
+  const OSQPMatrix* A = work->data->A;
+
+  OSQPVectorf* D        = work->D_temp;
+  OSQPVectorf* D_temp_A = work->D_temp_A;
+  OSQPVectorf* E        = work->E_temp;
+
+  switch (type) {
+  case OSQP_SCALING_RUIZ_2:
+    // ||[P; A](:,j)||_2 = sqrt(||P(:,j)||_2^2 + ||A(:,j)||_2^2)
+    OSQPMatrix_col_norm_2(P, D);
+    OSQPVectorf_mult_scalar(D, c);
+    OSQPMatrix_col_norm_2(A, D_temp_A);
+    OSQPVectorf_ew_prod(D, D, D);
+    OSQPVectorf_ew_prod(D_temp_A, D_temp_A, D_temp_A);
+    OSQPVectorf_plus(D, D, D_temp_A);
+    OSQPVectorf_ew_sqrt(D);
+
+    OSQPMatrix_row_norm_2(A, E);
+    break;
+
+  case OSQP_SCALING_GEOMETRIC:
+  case OSQP_SCALING_HYBRID:
+    // sqrt(max * min) of the nonzero magnitudes in each column, with the
+    // maxima of A in x_prev and z_prev
+    OSQPMatrix_col_min_abs(P, D);
+    OSQPVectorf_mult_scalar(D, c);
+    OSQPMatrix_col_min_abs(A, D_temp_A);
+    OSQPVectorf_ew_min_vec(D, D_temp_A, D);
+
+    OSQPMatrix_row_norm_inf(P, D_temp_A);
+    OSQPVectorf_mult_scalar(D_temp_A, c);
+    OSQPMatrix_col_norm_inf(A, work->x_prev);
+    OSQPVectorf_ew_max_vec(D_temp_A, work->x_prev, D_temp_A);
+
+    // Columns without nonzeros give 0 * OSQP_INFTY = 0 here
+    OSQPVectorf_ew_prod(D, D, D_temp_A);
+    OSQPVectorf_ew_sqrt(D);
+
+    OSQPMatrix_row_min_abs(A, E);
+    OSQPMatrix_row_norm_inf(A, work->z_prev);
+    OSQPVectorf_ew_prod(E, E, work->z_prev);
+    OSQPVectorf_ew_sqrt(E);
+    break;
+
+  default:
+    // First half
+    //  [ P ]
+    //  [ A ]
+    if (norms_given) {
+      OSQPVectorf_copy(D, work->x_prev);
+      OSQPVectorf_mult_scalar(D, c);
+    }
+    else {
+      OSQPMatrix_col_norm_inf(P, D);
+      OSQPMatrix_col_norm_inf(A, D_temp_A);
+    }
+    OSQPVectorf_ew_max_vec(D, D_temp_A, D);
+
+    // Second half
+    //  [ A']
+    //  [ 0 ]
+    if (norms_given) {
+      OSQPVectorf_copy(E, work->z_prev);
+    }
+    else {
+      OSQPMatrix_row_norm_inf(A, E);
+    }
+    break;
+  }
 }
 
 OSQPInt scale_data(OSQPSolver* solver) {
@@ -60,7 +121,11 @@ OSQPInt scale_data(OSQPSolver* solver) {
 
   OSQPInt   i;          // Iterations index
   OSQPInt   n, m;       // Number of constraints and variables
+  OSQPInt   converged;  // Are the D/E updates within tolerance of 1?
+
+  osqp_scaling_type step_type; // Scaling strategy of the current iteration
   OSQPFloat c_temp;     // Objective function scaling
+  OSQPFloat c_pending;  // Cost scaling not yet applied to the values of P
   OSQPFloat inf_norm_q; // Infinity norm of q
 
   OSQPSettings*  settings = solver->settings;
@@ -76,17 +141,24 @@ OSQPInt scale_data(OSQPSolver* solver) {
   OSQPVectorf_set_scalar(work->scaling->E,    1.);
   OSQPVectorf_set_scalar(work->scaling->Einv, 1.);
 
+  c_temp    = 1.0;
+  c_pending = 1.0;
 
   for (i = 0; i < settings->scaling; i++) {
+    // The hybrid strategy runs geometric mean steps in the first half of the
+    // iterations and Ruiz steps with infinity norms in the second one
+    step_type = settings->scaling_type;
+    if (step_type == OSQP_SCALING_HYBRID && i >= (settings->scaling + 1) / 2)
+      step_type = OSQP_SCALING_RUIZ_INF;
+
     //
-    // First Ruiz step
+    // Equilibration step
     //
 
-    // Compute norm of KKT columns
-    compute_inf_norm_cols_KKT(work->data->P, work->data->A,
-                              work->D_temp,
-                              work->D_temp_A,
-                              work->E_temp);
+    // Compute measure of KKT columns. After the first iteration the infinity
+    // norms are the ones taken while applying the previous step, and the
+    // ones of P only differ by the cost scaling.
+    compute_measure_cols_KKT(work, step_type, i > 0, c_pending);
 
     // Set to 1 values with 0 norms (avoid crazy scaling)
     limit_scaling_vector(work->D_temp);
@@ -96,18 +168,29 @@ OSQPInt scale_data(OSQPSolver* solver) {
     OSQPVectorf_ew_sqrt(work->D_temp);
     OSQPVectorf_ew_sqrt(work->E_temp);
 
+    // Stop after this iteration if it barely changes the scaling, i.e. if
+    // the positive updates and their inverses are all below 1 + tolerance
+    converged = OSQPVectorf_norm_inf(work->D_temp) < 1. + OSQP_SCALING_TOL &&
+                OSQPVectorf_norm_inf(work->E_temp) < 1. + OSQP_SCALING_TOL;
+
     // Copy inverses of D/E over themselves
     OSQPVectorf_ew_reciprocal(work->D_temp, work->D_temp);
     OSQPVectorf_ew_reciprocal(work->E_temp, work->E_temp);
 
-    // Equilibrate matrices P and A and vector q
-    // P <- DPD
-    OSQPMatrix_lmult_diag(work->data->P,work->D_temp);
-    OSQPMatrix_rmult_diag(work->data->P,work->D_temp);
+    converged = converged &&
+                OSQPVectorf_norm_inf(work->D_temp) < 1. + OSQP_SCALING_TOL &&
+                OSQPVectorf_norm_inf(work->E_temp) < 1. + OSQP_SCALING_TOL;
+
+    // Equilibrate matrices P and A in a single pass over their values,
+    // together with the cost scaling of the previous iteration, and take
+    // the infinity norms of the result in the same pass
+    // P <- c*DPD
+    OSQPMatrix_scale_entries_norm_inf(work->data->P, work->D_temp, work->D_temp,
+                                      c_pending, work->x_prev, OSQP_NULL);
 
     // A <- EAD
-    OSQPMatrix_lmult_diag(work->data->A,work->E_temp);
-    OSQPMatrix_rmult_diag(work->data->A,work->D_temp);
+    OSQPMatrix_scale_entries_norm_inf(work->data->A, work->E_temp, work->D_temp,
+                                      1.0, work->D_temp_A, work->z_prev);
 
     // q <- Dq
     OSQPVectorf_ew_prod(work->data->q, work->data->q, work->D_temp);
@@ -120,9 +203,8 @@ OSQPInt scale_data(OSQPSolver* solver) {
     // Cost normalization step
     //
 
-    // Compute avg norm of cols of P.
-    OSQPMatrix_col_norm_inf(work->data->P, work->D_temp);
-    c_temp = OSQPVectorf_norm_1(work->D_temp);
+    // Compute avg norm of cols of P, taken by the equilibration pass
+    c_temp = OSQPVectorf_norm_1(work->x_prev);
     c_temp = c_temp / n;
 
     // Compute inf norm of q
@@ -141,16 +223,28 @@ OSQPInt scale_data(OSQPSolver* solver) {
     // Invert scaling c = 1 / cost_measure
     c_temp = 1. / c_temp;
 
-    // Scale P
-    OSQPMatrix_mult_scalar(work->data->P,c_temp);
+    // Scale P with the next equilibration pass
+    c_pending = c_temp;
 
     // Scale q
     OSQPVectorf_mult_scalar(work->data->q, c_temp);
 
     // Update cost scaling
     work->scaling->c *= c_temp;
+
+    // The geometric mean steps of the hybrid strategy always hand over to
+    // the Ruiz steps
+    if (converged && step_type != OSQP_SCALING_HYBRID) {
+      i++;
+      break;
+    }
   }
 
+  // Apply the cost scaling of the last iteration
+  if (c_pending != 1.0) OSQPMatrix_mult_scalar(work->data->P, c_pending);
+
+  solver->info->scaling_iter = i;
+
 
   // Store cinv, Dinv, Einv
   work->scaling->cinv = 1. / work->scaling->c;
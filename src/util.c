@@ -58,7 +58,9 @@ void print_setup_header(const OSQPSolver* solver) {
   OSQPWorkspace* work;
   OSQPData*      data;
   OSQPSettings*  settings;
+  LinSysSolver*  linsys;
 
+  OSQPInt n, m;
   OSQPInt nnz; // Number of nonzeros in the problem
 
 #define NAMEBUFLEN 30
@@ -74,8 +76,30 @@ void print_setup_header(const OSQPSolver* solver) {
   data     = solver->work->data;
   settings = solver->settings;
 
-  // Number of nonzeros
-  nnz = OSQPMatrix_get_nz(data->P) + OSQPMatrix_get_nz(data->A);
+#ifndef OSQP_EMBEDDED_MODE
+  if (work->comp) {
+    // The subproblems are set up without printing, the first one stands for all
+    n      = work->comp->n;
+    m      = work->comp->m;
+    nnz    = work->comp->P_start[work->comp->n_comp] + work->comp->A_start[work->comp->n_comp];
+    linsys = work->comp->solvers[0]->work->linsys_solver;
+  }
+  else
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+  {
+    n      = data->n;
+    m      = data->m;
+    nnz    = OSQPMatrix_get_nz(data->P) + OSQPMatrix_get_nz(data->A);
+    linsys = work->linsys_solver;
+  }
+
+#ifndef OSQP_EMBEDDED_MODE
+  // Dimensions of the factor model problem before the lifting
+  if (work->lift) {
+    n = work->lift->n;
+    m = work->lift->m;
+  }
+#endif /* ifndef OSQP_EMBEDDED_MODE */
 
   print_line();
   c_print("           OSQP v%s  -  Operator Splitting QP Solver\n"
@@ -87,10 +111,55 @@ void print_setup_header(const OSQPSolver* solver) {
   // Print variables and constraints
   c_print("problem:  ");
   c_print("variables n = %i, constraints m = %i\n          ",
-                                    (int)data->n,
-          (int)data->m);
+                                    (int)n,
+          (int)m);
   c_print("nnz(P) + nnz(A) = %i\n", (int)nnz);
 
+#ifndef OSQP_EMBEDDED_MODE
+  if (work->lift) {
+    c_print("factor:   P = F F' + D with k = %i, lifted to n = %i, m = %i\n",
+            (int)work->lift->k, (int)(n + work->lift->k), (int)(m + work->lift->k));
+  }
+
+  if (work->presolve) {
+    c_print("presolve: removed %i of %i variables, %i of %i constraints\n          ",
+            (int)(work->presolve->n - work->presolve->n_red), (int)work->presolve->n,
+            (int)(work->presolve->m - work->presolve->m_red), (int)work->presolve->m);
+    c_print("(fixed %i, singleton %i, empty %i, free %i, duplicate %i),\n          ",
+            (int)work->presolve->n_fixed, (int)work->presolve->n_singleton,
+            (int)work->presolve->n_empty, (int)work->presolve->n_free,
+            (int)work->presolve->n_dup);
+    c_print("%i singleton constraints as variable bounds\n",
+            (int)work->presolve->n_bound);
+  }
+
+  if (work->dense.n_rows || work->dense.n_cols) {
+    c_print("dense:    %i rows and %i columns of A out of the KKT matrix",
+            (int)work->dense.n_rows, (int)work->dense.n_cols);
+    if (work->dense.fill >= 0) {
+      c_print(",\n          nnz(L) = %i with the %i x %i coupling instead of %i",
+              (int)work->dense.fill,
+              (int)(work->data->n + work->data->m - work->dense.n_rows - work->dense.n_cols),
+              (int)(work->dense.n_rows + work->dense.n_cols), (int)work->dense.fill_full);
+    }
+    c_print("\n");
+  }
+  else if (work->dense.declined) {
+    c_print("dense:    %i rows and columns of A kept in the KKT matrix,\n          ",
+            (int)work->dense.declined);
+    c_print("nnz(L) = %i instead of %i with them out\n",
+            (int)work->dense.fill_full, (int)work->dense.fill);
+  }
+
+  if (work->comp) {
+    c_print("split:    %i independent subproblems", (int)work->comp->n_comp);
+# ifdef _OPENMP
+    c_print(", solved in parallel");
+# endif /* ifdef _OPENMP */
+    c_print("\n");
+  }
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
   // Print Settings
   c_print("settings: ");
 
@@ -107,10 +176,10 @@ void print_setup_header(const OSQPSolver* solver) {
   }
 #endif
 
-  c_print("linear system solver = %s", work->linsys_solver->name(work->linsys_solver));
+  c_print("linear system solver = %s", linsys->name(linsys));
 
-  if (work->linsys_solver->nthreads != 1) {
-    c_print(" (%d threads)", (int)work->linsys_solver->nthreads);
+  if (linsys->nthreads != 1) {
+    c_print(" (%d threads)", (int)linsys->nthreads);
   }
   c_print(",\n          ");
 
@@ -277,6 +346,7 @@ OSQPSettings* copy_settings(const OSQPSettings *settings) {
   new->verbose       = settings->verbose;
   new->warm_starting = settings->warm_starting;
   new->scaling       = settings->scaling;
+  new->scaling_type  = settings->scaling_type;
   new->polishing     = settings->polishing;
 
   new->rho        = settings->rho;
@@ -306,6 +376,19 @@ OSQPSettings* copy_settings(const OSQPSettings *settings) {
   new->delta              = settings->delta;
   new->polish_refine_iter = settings->polish_refine_iter;
 
+  new->presolve     = settings->presolve;
+  new->split_bounds = settings->split_bounds;
+  new->split_dense  = settings->split_dense;
+  new->split_components = settings->split_components;
+
+  new->spmv_single = settings->spmv_single;
+  new->reorder     = settings->reorder;
+  new->spmv_full   = settings->spmv_full;
+
+  new->freeze_scaling = settings->freeze_scaling;
+
+  new->derivative_iterative = settings->derivative_iterative;
+
   return new;
 }
 
@@ -4,6 +4,8 @@
 #include "osqp_tester.h" /* Tester helpers */
 #include "test_utils.h"  /* Testing Helper functions */
 
+#include "auxil.h"
+
 #include "basic_lp_data.h"
 
 
@@ -41,6 +43,10 @@ TEST_CASE_METHOD(basic_lp_test_fixture, "Basic LP", "[solve][lp]")
   // Setup correct
   mu_assert("Basic LP test solve: Setup error!", exitflag == 0);
 
+  // The products with P are skipped
+  mu_assert("Basic LP test solve: Error in P structure!",
+      solver->work->P_struct == OSQP_P_ZERO);
+
   // Solve Problem
   osqp_solve(solver.get());
 
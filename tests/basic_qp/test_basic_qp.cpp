@@ -4,6 +4,8 @@
 #include "osqp_tester.h" /* Tester helpers */
 #include "test_utils.h"  /* Testing Helper functions */
 
+#include "auxil.h"
+
 #include "basic_qp_data.h"
 
 
@@ -19,7 +21,10 @@ TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Solve", "[solve][qp]")
   /* Test all possible linear system solvers in this test case */
   settings->linsys_solver = GENERATE(filter(&isLinsysSupported, values({OSQP_DIRECT_SOLVER, OSQP_INDIRECT_SOLVER})));
 
-  CAPTURE(settings->linsys_solver);
+  /* Three of the four constraints bound a single variable */
+  settings->split_bounds = GENERATE(0, 1);
+
+  CAPTURE(settings->linsys_solver, settings->split_bounds);
 
   // Setup solver
   exitflag = osqp_setup(&tmpSolver, data->P, data->q,
@@ -54,6 +59,468 @@ TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Solve", "[solve][qp]")
       TESTS_TOL);
 }
 
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Single precision matrix values", "[solve][qp]")
+{
+  OSQPInt exitflag;
+
+  // Test-specific options
+  settings->polishing   = GENERATE(0, 1);
+  settings->spmv_single = 1;
+
+  CAPTURE(settings->polishing);
+
+  // Setup solver
+  exitflag = osqp_setup(&tmpSolver, data->P, data->q,
+                        data->A, data->l, data->u,
+                        data->m, data->n, settings.get());
+  solver.reset(tmpSolver);
+
+  // Setup correct
+  mu_assert("Basic QP test single values: Setup error!", exitflag == 0);
+
+  // Solve Problem
+  osqp_solve(solver.get());
+
+  // Compare solver statuses
+  mu_assert("Basic QP test single values: Error in solver status!",
+      solver->info->status_val == sols_data->status_test);
+
+  // Compare primal solutions
+  mu_assert("Basic QP test single values: Error in primal solution!",
+      vec_norm_inf_diff(solver->solution->x, sols_data->x_test,
+            data->n) < TESTS_TOL);
+
+  // Compare dual solutions
+  mu_assert("Basic QP test single values: Error in dual solution!",
+      vec_norm_inf_diff(solver->solution->y, sols_data->y_test,
+            data->m) < TESTS_TOL);
+
+  // The single precision values only perturb the residuals slightly
+  mu_assert("Basic QP test single values: Error in residual accuracy report!",
+      (solver->info->spmv_res_error >= 0.0 &&
+       solver->info->spmv_res_error < settings->eps_abs));
+}
+
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Scaling iterations", "[solve][qp]")
+{
+  OSQPInt exitflag;
+
+  // Test-specific options
+  settings->scaling      = GENERATE(0, 1, 10, 100);
+  settings->scaling_type = GENERATE(OSQP_SCALING_RUIZ_INF, OSQP_SCALING_RUIZ_2,
+                                    OSQP_SCALING_GEOMETRIC, OSQP_SCALING_HYBRID);
+
+  CAPTURE(settings->scaling, settings->scaling_type);
+
+  // Setup solver
+  exitflag = osqp_setup(&tmpSolver, data->P, data->q,
+                        data->A, data->l, data->u,
+                        data->m, data->n, settings.get());
+  solver.reset(tmpSolver);
+
+  // Setup correct
+  mu_assert("Basic QP test scaling iterations: Setup error!", exitflag == 0);
+
+  // Scaling stops early once the equilibration has converged
+  if (settings->scaling == 0) {
+    mu_assert("Basic QP test scaling iterations: Scaling should be disabled!",
+        solver->info->scaling_iter == 0);
+  }
+  else {
+    mu_assert("Basic QP test scaling iterations: Error in number of scaling iterations!",
+        (solver->info->scaling_iter >= 1 &&
+         solver->info->scaling_iter <= settings->scaling));
+  }
+
+  if (settings->scaling == 100 && settings->scaling_type == OSQP_SCALING_RUIZ_INF) {
+    mu_assert("Basic QP test scaling iterations: Scaling did not stop early!",
+        solver->info->scaling_iter < settings->scaling);
+  }
+
+  // Solve Problem
+  osqp_solve(solver.get());
+
+  // Compare solver statuses
+  mu_assert("Basic QP test scaling iterations: Error in solver status!",
+      solver->info->status_val == sols_data->status_test);
+
+  // Compare primal solutions
+  mu_assert("Basic QP test scaling iterations: Error in primal solution!",
+      vec_norm_inf_diff(solver->solution->x, sols_data->x_test,
+            data->n) < TESTS_TOL);
+
+  // Compare dual solutions
+  mu_assert("Basic QP test scaling iterations: Error in dual solution!",
+      vec_norm_inf_diff(solver->solution->y, sols_data->y_test,
+            data->m) < TESTS_TOL);
+}
+
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Presolve", "[solve][qp]")
+{
+  OSQPInt exitflag;
+  OSQPInt m, n;
+
+  /* Basic QP extended with a fixed variable and redundant constraints
+   *   row 0:  x0 + x1      = 1
+   *   row 1:  0 <= x0      <= 0.7   (bound on x0)
+   *   row 2:  0 <= 2 x1    <= 1.4   (bound on x1)
+   *   row 3:  x2           = 0.5    (fixes x2)
+   *   row 4:  2 x0 + 2 x1  <= 3     (multiple of row 0)
+   *   row 5:  -1 <= 0      <= 1     (empty)
+   *   row 6:  x1 + x2               (free)
+   *   row 7:  0.5 <= x0 + x2 <= 2   (singleton on x0 once x2 is fixed)
+   */
+  OSQPFloat P_x[4] = { 4.0, 1.0, 2.0, 1.0, };
+  OSQPInt   P_i[4] = { 0, 0, 1, 2, };
+  OSQPInt   P_p[4] = { 0, 1, 3, 4, };
+  OSQPFloat q[3]   = { 1.0, 1.0, -1.0, };
+
+  OSQPFloat A_x[11] = { 1.0, 1.0, 2.0, 1.0,  1.0, 2.0, 2.0, 1.0,  1.0, 1.0, 1.0, };
+  OSQPInt   A_i[11] = { 0, 1, 4, 7,  0, 2, 4, 6,  3, 6, 7, };
+  OSQPInt   A_p[4]  = { 0, 4, 8, 11, };
+  OSQPFloat l[8] = { 1.0, 0.0, 0.0, 0.5, -OSQP_INFTY, -1.0, -OSQP_INFTY, 0.5, };
+  OSQPFloat u[8] = { 1.0, 0.7, 1.4, 0.5,  3.0,        1.0,  OSQP_INFTY,  2.0, };
+
+  OSQPFloat xopt[3] = { 0.3, 0.7, 0.5, };
+  OSQPFloat yopt[8] = { -2.9, 0.0, 0.1, 0.5, 0.0, 0.0, 0.0, 0.0, };
+  OSQPFloat objopt  = 1.88 - 0.375;
+
+  // Solution with the cost vector q_new
+  OSQPFloat q_new[3]    = { -3.0, 1.0, 2.0, };
+  OSQPFloat xopt_new[3] = { 0.7, 0.3, 0.5, };
+  OSQPFloat yopt_new[8] = { -2.3, 2.2, 0.0, -2.5, 0.0, 0.0, 0.0, 0.0, };
+  OSQPFloat objopt_new  = 0.605;
+
+  OSQPCscMatrix Pmat;
+  OSQPCscMatrix Amat;
+
+  csc_set_data(&Pmat, 3, 3, 4, P_x, P_i, P_p);
+  csc_set_data(&Amat, 8, 3, 11, A_x, A_i, A_p);
+
+  // Test-specific options
+  settings->presolve  = GENERATE(0, 1);
+  settings->polishing = 1;
+  settings->eps_abs   = 1e-5;
+  settings->eps_rel   = 1e-5;
+
+  CAPTURE(settings->presolve);
+
+  // Setup solver
+  exitflag = osqp_setup(&tmpSolver, &Pmat, q, &Amat, l, u, 8, 3, settings.get());
+  solver.reset(tmpSolver);
+
+  // Setup correct
+  mu_assert("Basic QP test presolve: Setup error!", exitflag == 0);
+
+  // The user dimensions are reported in any case
+  osqp_get_dimensions(solver.get(), &m, &n);
+  mu_assert("Basic QP test presolve: Error in problem dimensions!",
+      (m == 8 && n == 3));
+
+  if (settings->presolve) {
+    mu_assert("Basic QP test presolve: Error in reduced dimensions!",
+        (solver->work->presolve->n_red == 2 && solver->work->presolve->m_red == 3));
+    mu_assert("Basic QP test presolve: Error in reduction counts!",
+        (solver->work->presolve->n_fixed     == 1 &&
+         solver->work->presolve->n_singleton == 1 &&
+         solver->work->presolve->n_empty     == 1 &&
+         solver->work->presolve->n_free      == 1 &&
+         solver->work->presolve->n_dup       == 2 &&
+         solver->work->presolve->n_bound     == 2));
+
+    // Bound updates would change the reductions
+    mu_assert("Basic QP test presolve: Bound update should fail!",
+        osqp_update_data_vec(solver.get(), OSQP_NULL, l, u) == OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+
+  // Solve Problem
+  osqp_solve(solver.get());
+
+  // Compare solver statuses
+  mu_assert("Basic QP test presolve: Error in solver status!",
+      solver->info->status_val == OSQP_SOLVED);
+
+  // Compare primal solutions
+  mu_assert("Basic QP test presolve: Error in primal solution!",
+      vec_norm_inf_diff(solver->solution->x, xopt, 3) < TESTS_TOL);
+
+  // Compare dual solutions
+  mu_assert("Basic QP test presolve: Error in dual solution!",
+      vec_norm_inf_diff(solver->solution->y, yopt, 8) < TESTS_TOL);
+
+  // Compare objective values
+  mu_assert("Basic QP test presolve: Error in objective value!",
+      c_absval(solver->info->obj_val - objopt) < TESTS_TOL);
+
+  // Cost updates keep the reductions
+  exitflag = osqp_update_data_vec(solver.get(), q_new, OSQP_NULL, OSQP_NULL);
+  mu_assert("Basic QP test presolve: Cost update error!", exitflag == 0);
+
+  osqp_solve(solver.get());
+
+  mu_assert("Basic QP test presolve: Error in solver status after the cost update!",
+      solver->info->status_val == OSQP_SOLVED);
+
+  mu_assert("Basic QP test presolve: Error in primal solution after the cost update!",
+      vec_norm_inf_diff(solver->solution->x, xopt_new, 3) < TESTS_TOL);
+
+  mu_assert("Basic QP test presolve: Error in dual solution after the cost update!",
+      vec_norm_inf_diff(solver->solution->y, yopt_new, 8) < TESTS_TOL);
+
+  mu_assert("Basic QP test presolve: Error in objective value after the cost update!",
+      c_absval(solver->info->obj_val - objopt_new) < TESTS_TOL);
+}
+
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Box bounds", "[solve][qp]")
+{
+  OSQPInt exitflag;
+  OSQPInt m, n;
+
+  /* Basic QP with the constraint x0 + x1 = 1 and the box 0 <= x <= 0.7 */
+  OSQPFloat P_x[3] = { 4.0, 1.0, 2.0, };
+  OSQPInt   P_i[3] = { 0, 0, 1, };
+  OSQPInt   P_p[3] = { 0, 1, 3, };
+  OSQPFloat q[2]   = { 1.0, 1.0, };
+
+  OSQPFloat A_x[2] = { 1.0, 1.0, };
+  OSQPInt   A_i[2] = { 0, 0, };
+  OSQPInt   A_p[3] = { 0, 1, 2, };
+  OSQPFloat l[1]   = { 1.0, };
+  OSQPFloat u[1]   = { 1.0, };
+  OSQPFloat lx[2]  = { 0.0, 0.0, };
+  OSQPFloat ux[2]  = { 0.7, 0.7, };
+
+  OSQPFloat xopt[2] = { 0.3, 0.7, };
+  OSQPFloat yopt[3] = { -2.9, 0.0, 0.2, };
+  OSQPFloat objopt  = 1.88;
+
+  OSQPCscMatrix Pmat;
+  OSQPCscMatrix Amat;
+
+  csc_set_data(&Pmat, 2, 2, 3, P_x, P_i, P_p);
+  csc_set_data(&Amat, 1, 2, 2, A_x, A_i, A_p);
+
+  // Test-specific options
+  settings->linsys_solver = GENERATE(filter(&isLinsysSupported, values({OSQP_DIRECT_SOLVER, OSQP_INDIRECT_SOLVER})));
+  settings->rho_is_vec    = GENERATE(0, 1);
+  settings->eps_abs       = 1e-5;
+  settings->eps_rel       = 1e-5;
+
+  CAPTURE(settings->linsys_solver, settings->rho_is_vec);
+
+  // Setup solver
+  exitflag = osqp_setup_box(&tmpSolver, &Pmat, q, &Amat, l, u, lx, ux, 1, 2, settings.get());
+  solver.reset(tmpSolver);
+
+  // Setup correct
+  mu_assert("Basic QP test box bounds: Setup error!", exitflag == 0);
+
+  // The bounds are the last n constraints
+  osqp_get_dimensions(solver.get(), &m, &n);
+  mu_assert("Basic QP test box bounds: Error in problem dimensions!",
+      (m == 3 && n == 2));
+
+  // Solve with the setup rho, and again after a rho update
+  for (OSQPInt k = 0; k < 2; k++) {
+    if (k == 1) {
+      exitflag = osqp_update_rho(solver.get(), 10 * settings->rho);
+      mu_assert("Basic QP test box bounds: Rho update error!", exitflag == 0);
+      osqp_warm_start(solver.get(), OSQP_NULL, OSQP_NULL);
+    }
+
+    osqp_solve(solver.get());
+
+    // Compare solver statuses
+    mu_assert("Basic QP test box bounds: Error in solver status!",
+        solver->info->status_val == OSQP_SOLVED);
+
+    // Compare primal solutions
+    mu_assert("Basic QP test box bounds: Error in primal solution!",
+        vec_norm_inf_diff(solver->solution->x, xopt, 2) < TESTS_TOL);
+
+    // Compare dual solutions
+    mu_assert("Basic QP test box bounds: Error in dual solution!",
+        vec_norm_inf_diff(solver->solution->y, yopt, 3) < TESTS_TOL);
+
+    // Compare objective values
+    mu_assert("Basic QP test box bounds: Error in objective value!",
+        c_absval(solver->info->obj_val - objopt) < TESTS_TOL);
+  }
+}
+
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Diagonal P", "[solve][qp]")
+{
+  OSQPInt exitflag;
+
+  /* Basic QP with the off-diagonal entry of P set to zero, either dropped
+   * from the pattern (diagonal P) or stored explicitly (general P) */
+  OSQPFloat P_x[3] = { 4.0, 0.0, 2.0, };
+  OSQPInt   P_i[3] = { 0, 0, 1, };
+  OSQPInt   P_p[3] = { 0, 1, 3, };
+
+  OSQPFloat Pd_x[2] = { 4.0, 2.0, };
+  OSQPInt   Pd_i[2] = { 0, 1, };
+  OSQPInt   Pd_p[3] = { 0, 1, 2, };
+
+  OSQPFloat xopt[2] = { 1.0/3.0, 2.0/3.0, };
+  OSQPFloat yopt[3] = { -7.0/3.0, 0.0, 0.0, };
+  OSQPFloat objopt  = 5.0/3.0;
+
+  OSQPInt diag = GENERATE(0, 1);
+
+  OSQPCscMatrix Pmat;
+
+  if (diag)
+    csc_set_data(&Pmat, 2, 2, 2, Pd_x, Pd_i, Pd_p);
+  else
+    csc_set_data(&Pmat, 2, 2, 3, P_x, P_i, P_p);
+
+  // Test-specific options
+  settings->polishing = 1;
+  settings->eps_abs   = 1e-5;
+  settings->eps_rel   = 1e-5;
+
+  CAPTURE(diag);
+
+  // Setup solver
+  exitflag = osqp_setup(&tmpSolver, &Pmat, data->q, data->A, data->l, data->u,
+                        data->m, data->n, settings.get());
+  solver.reset(tmpSolver);
+
+  // Setup correct
+  mu_assert("Basic QP test diagonal P: Setup error!", exitflag == 0);
+
+  mu_assert("Basic QP test diagonal P: Error in P structure!",
+      solver->work->P_struct == (diag ? OSQP_P_DIAG : OSQP_P_GENERAL));
+
+  // Solve Problem
+  osqp_solve(solver.get());
+
+  // Compare solver statuses
+  mu_assert("Basic QP test diagonal P: Error in solver status!",
+      solver->info->status_val == OSQP_SOLVED);
+
+  // Compare primal solutions
+  mu_assert("Basic QP test diagonal P: Error in primal solution!",
+      vec_norm_inf_diff(solver->solution->x, xopt, 2) < TESTS_TOL);
+
+  // Compare dual solutions
+  mu_assert("Basic QP test diagonal P: Error in dual solution!",
+      vec_norm_inf_diff(solver->solution->y, yopt, 3) < TESTS_TOL);
+
+  // Compare objective values
+  mu_assert("Basic QP test diagonal P: Error in objective value!",
+      c_absval(solver->info->obj_val - objopt) < TESTS_TOL);
+}
+
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Factor model", "[solve][qp]")
+{
+  OSQPInt exitflag;
+  OSQPInt m, n;
+
+  /* P = F F' + D for the basic QP */
+  OSQPFloat F_x[2] = { 1.0, 1.0, };
+  OSQPInt   F_i[2] = { 0, 1, };
+  OSQPInt   F_p[2] = { 0, 2, };
+  OSQPFloat D[2]   = { 3.0, 1.0, };
+
+  OSQPFloat q_new[2] = { -2.0, 1.0, };
+
+  OSQPCscMatrix Fmat;
+
+  csc_set_data(&Fmat, 2, 1, 2, F_x, F_i, F_p);
+
+  // Test-specific options
+  settings->polishing         = GENERATE(0, 1);
+  settings->check_termination = 1;
+  settings->adaptive_rho      = 0;
+  settings->eps_abs           = 1e-5;
+  settings->eps_rel           = 1e-5;
+
+  CAPTURE(settings->polishing);
+
+  // Setup solver
+  exitflag = osqp_setup_factor(&tmpSolver, &Fmat, D, data->q, data->A, data->l, data->u,
+                               data->m, data->n, settings.get());
+  solver.reset(tmpSolver);
+
+  // Setup correct
+  mu_assert("Basic QP test factor model: Setup error!", exitflag == 0);
+
+  // The user dimensions are reported
+  osqp_get_dimensions(solver.get(), &m, &n);
+  mu_assert("Basic QP test factor model: Error in problem dimensions!",
+      (m == data->m && n == data->n));
+
+  // The lifted cost matrix is diagonal
+  mu_assert("Basic QP test factor model: Error in P structure!",
+      solver->work->P_struct == OSQP_P_DIAG);
+
+  // Solve Problem
+  osqp_solve(solver.get());
+
+  // Compare solver statuses
+  mu_assert("Basic QP test factor model: Error in solver status!",
+      solver->info->status_val == sols_data->status_test);
+
+  // Compare primal solutions
+  mu_assert("Basic QP test factor model: Error in primal solution!",
+      vec_norm_inf_diff(solver->solution->x, sols_data->x_test,
+                        data->n) < TESTS_TOL);
+
+  // Compare dual solutions
+  mu_assert("Basic QP test factor model: Error in dual solution!",
+      vec_norm_inf_diff(solver->solution->y, sols_data->y_test,
+                        data->m) < TESTS_TOL);
+
+  // Compare objective values
+  mu_assert("Basic QP test factor model: Error in objective value!",
+      c_absval(solver->info->obj_val - sols_data->obj_value_test) < TESTS_TOL);
+
+  // The objective is the one of the user problem at the returned x
+  OSQPFloat* xs  = solver->solution->x;
+  OSQPFloat  Fx  = F_x[0] * xs[0] + F_x[1] * xs[1];
+  OSQPFloat  obj = 0.5 * (Fx * Fx + D[0] * xs[0] * xs[0] + D[1] * xs[1] * xs[1]) +
+                   data->q[0] * xs[0] + data->q[1] * xs[1];
+  mu_assert("Basic QP test factor model: Objective of the lifted problem reported!",
+      c_absval(solver->info->obj_val - obj) < 1e-9);
+
+  // Matrix updates are not supported
+  mu_assert("Basic QP test factor model: Matrix update should fail!",
+      osqp_update_data_mat(solver.get(), F_x, OSQP_NULL, 1, OSQP_NULL, OSQP_NULL, 0) ==
+      OSQP_SETTINGS_VALIDATION_ERROR);
+
+  SECTION( "Warm start from solution" ) {
+    // Warm start from the solution of the user problem and solve again
+    osqp_warm_start(solver.get(), sols_data->x_test, OSQP_NULL);
+    osqp_warm_start(solver.get(), OSQP_NULL, sols_data->y_test);
+    osqp_solve(solver.get());
+
+    mu_assert("Basic QP test factor model: Warm start error!", solver->info->iter == 1);
+  }
+
+  SECTION( "Linear cost update" ) {
+    // Update q with the user dimensions and compare with the explicit P
+    exitflag = osqp_update_data_vec(solver.get(), q_new, OSQP_NULL, OSQP_NULL);
+    mu_assert("Basic QP test factor model: Error in data update!", exitflag == 0);
+    osqp_solve(solver.get());
+
+    OSQPSolver_ptr refSolver{nullptr};
+
+    exitflag = osqp_setup(&tmpSolver, data->P, q_new, data->A, data->l, data->u,
+                          data->m, data->n, settings.get());
+    refSolver.reset(tmpSolver);
+    mu_assert("Basic QP test factor model: Reference setup error!", exitflag == 0);
+    osqp_solve(refSolver.get());
+
+    mu_assert("Basic QP test factor model: Error in updated primal solution!",
+        vec_norm_inf_diff(solver->solution->x, refSolver->solution->x,
+                          data->n) < TESTS_TOL);
+    mu_assert("Basic QP test factor model: Error in updated objective value!",
+        c_absval(solver->info->obj_val - refSolver->info->obj_val) < TESTS_TOL);
+  }
+}
+
 TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Settings", "[solve][qp]")
 {
   OSQPInt        exitflag;
@@ -197,6 +664,17 @@ TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Settings", "[solve][qp]")
             exitflag == OSQP_SETTINGS_VALIDATION_ERROR);
   settings->scaling = tmp_int;
 
+  // Setup solver with a wrong scaling strategy
+  tmp_int = settings->scaling_type;
+  settings->scaling_type = (osqp_scaling_type)10;
+  exitflag = osqp_setup(&tmpSolver, data->P, data->q,
+                        data->A, data->l, data->u,
+                        data->m, data->n, settings.get());
+  solver.reset(tmpSolver);
+  mu_assert("Basic QP test solve: Setup should result in error due to an unknown scaling strategy",
+            exitflag == OSQP_SETTINGS_VALIDATION_ERROR);
+  settings->scaling_type = (osqp_scaling_type)tmp_int;
+
   // Setup solver with wrong settings->adaptive_rho
   tmp_int = settings->adaptive_rho;
   settings->adaptive_rho = 2;
@@ -409,6 +887,17 @@ TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Settings", "[solve][qp]")
             exitflag == OSQP_SETTINGS_VALIDATION_ERROR);
   settings->warm_starting = tmp_int;
 
+  // Setup solver with wrong settings->spmv_single
+  tmp_int = settings->spmv_single;
+  settings->spmv_single = 2;
+  exitflag = osqp_setup(&tmpSolver, data->P, data->q,
+                        data->A, data->l, data->u,
+                        data->m, data->n, settings.get());
+  solver.reset(tmpSolver);
+  mu_assert("Basic QP test solve: Setup should result in error due to non-boolean settings->spmv_single",
+            exitflag == OSQP_SETTINGS_VALIDATION_ERROR);
+  settings->spmv_single = tmp_int;
+
 #ifdef OSQP_ENABLE_PROFILING
   // Setup solver with wrong settings->time_limit
   tmp_float = settings->time_limit;
@@ -898,6 +1387,12 @@ TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Warm start", "[solve][qp][war
   settings->check_termination = 1;
   settings->adaptive_rho = 0;
 
+  // The warm start point is given in the user ordering and dimensions
+  settings->reorder  = GENERATE(0, 1);
+  settings->presolve = GENERATE(0, 1);
+
+  CAPTURE(settings->reorder, settings->presolve);
+
   // Setup solver
   exitflag = osqp_setup(&tmpSolver, data->P, data->q,
                         data->A, data->l, data->u,
@@ -930,3 +1425,427 @@ TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Warm start", "[solve][qp][war
     mu_assert("Basic QP test warm start: Warm start error!", solver->info->iter == 1);
   }
 }
+
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Repeated derivatives", "[solve][qp][derivative]")
+{
+  if (!(osqp_capabilities() & OSQP_CAPABILITY_DERIVATIVES))
+    return;
+
+  OSQPInt exitflag;
+  OSQPInt n = data->n;
+  OSQPInt m = data->m;
+  OSQPInt nnzP = data->P->p[n];
+  OSQPInt nnzA = data->A->p[n];
+
+  OSQPSolver_ptr refSolver{nullptr};
+
+  // Test-specific options
+  settings->polishing = 1;
+  settings->eps_abs   = 1e-9;
+  settings->eps_rel   = 1e-9;
+
+  OSQPFloat dx1[2]  = {1.0, -0.5};
+  OSQPFloat dy1[4]  = {0.2, 0.1, -0.3, 0.0};
+  OSQPFloat dx2[2]  = {-0.7, 0.4};
+  OSQPFloat dy2[4]  = {0.5, -0.2, 0.1, 0.3};
+  OSQPFloat zeros[4] = {0.0, 0.0, 0.0, 0.0};
+  OSQPFloat Px_new[3] = {5.0, 1.5, 3.0};
+
+  std::vector<OSQPFloat> dq(n), dl(m), du(m), dPx(nnzP), dAx(nnzA);
+  std::vector<OSQPFloat> dq_ref(n), dl_ref(m), du_ref(m), dPx_ref(nnzP), dAx_ref(nnzA);
+  std::vector<OSQPInt>   dPi(data->P->i, data->P->i + nnzP), dPp(data->P->p, data->P->p + n + 1);
+  std::vector<OSQPInt>   dAi(data->A->i, data->A->i + nnzA), dAp(data->A->p, data->A->p + n + 1);
+
+  OSQPCscMatrix dP;
+  OSQPCscMatrix dA;
+
+  auto setup_and_solve = [&](OSQPSolver** s) {
+    OSQPInt flag = osqp_setup(s, data->P, data->q,
+                              data->A, data->l, data->u,
+                              m, n, settings.get());
+    mu_assert("Repeated derivatives: Setup error!", flag == 0);
+    osqp_solve(*s);
+    mu_assert("Repeated derivatives: Error in solver status!",
+              (*s)->info->status_val == OSQP_SOLVED);
+  };
+
+  auto derivatives = [&](OSQPSolver* s, OSQPFloat* dx, OSQPFloat* dy,
+                         OSQPFloat* q, OSQPFloat* l, OSQPFloat* u, OSQPFloat* Px, OSQPFloat* Ax) {
+    csc_set_data(&dP, n, n, nnzP, Px, dPi.data(), dPp.data());
+    csc_set_data(&dA, m, n, nnzA, Ax, dAi.data(), dAp.data());
+    mu_assert("Repeated derivatives: Error computing the derivatives!",
+              osqp_adjoint_derivative_compute(s, dx, zeros, dy) == 0);
+    mu_assert("Repeated derivatives: Error in the vector derivatives!",
+              osqp_adjoint_derivative_get_vec(s, q, l, u) == 0);
+    mu_assert("Repeated derivatives: Error in the matrix derivatives!",
+              osqp_adjoint_derivative_get_mat(s, &dP, &dA) == 0);
+  };
+
+  auto compare = [&]() {
+    mu_assert("Repeated derivatives: Error in dq!",
+              vec_norm_inf_diff(dq.data(), dq_ref.data(), n) < TESTS_TOL);
+    mu_assert("Repeated derivatives: Error in dl!",
+              vec_norm_inf_diff(dl.data(), dl_ref.data(), m) < TESTS_TOL);
+    mu_assert("Repeated derivatives: Error in du!",
+              vec_norm_inf_diff(du.data(), du_ref.data(), m) < TESTS_TOL);
+    mu_assert("Repeated derivatives: Error in dP!",
+              vec_norm_inf_diff(dPx.data(), dPx_ref.data(), nnzP) < TESTS_TOL);
+    mu_assert("Repeated derivatives: Error in dA!",
+              vec_norm_inf_diff(dAx.data(), dAx_ref.data(), nnzA) < TESTS_TOL);
+  };
+
+  setup_and_solve(&tmpSolver);
+  solver.reset(tmpSolver);
+
+  // The second call reuses the factorization of the first one
+  derivatives(solver.get(), dx1, dy1, dq.data(), dl.data(), du.data(), dPx.data(), dAx.data());
+  derivatives(solver.get(), dx2, dy2, dq.data(), dl.data(), du.data(), dPx.data(), dAx.data());
+
+  setup_and_solve(&tmpSolver);
+  refSolver.reset(tmpSolver);
+  derivatives(refSolver.get(), dx2, dy2, dq_ref.data(), dl_ref.data(), du_ref.data(), dPx_ref.data(), dAx_ref.data());
+
+  compare();
+
+  SECTION( "New partition of the constraints" ) {
+    exitflag = osqp_update_data_vec(solver.get(), OSQP_NULL, sols_data->l_new, sols_data->u_new);
+    mu_assert("Repeated derivatives: Error updating bounds!", exitflag == 0);
+    exitflag = osqp_update_data_vec(refSolver.get(), OSQP_NULL, sols_data->l_new, sols_data->u_new);
+    mu_assert("Repeated derivatives: Error updating bounds!", exitflag == 0);
+  }
+
+  SECTION( "New matrix values" ) {
+    exitflag = osqp_update_data_mat(solver.get(), Px_new, OSQP_NULL, nnzP, OSQP_NULL, OSQP_NULL, 0);
+    mu_assert("Repeated derivatives: Error updating P!", exitflag == 0);
+    exitflag = osqp_update_data_mat(refSolver.get(), Px_new, OSQP_NULL, nnzP, OSQP_NULL, OSQP_NULL, 0);
+    mu_assert("Repeated derivatives: Error updating P!", exitflag == 0);
+  }
+
+  osqp_solve(solver.get());
+  osqp_solve(refSolver.get());
+
+  derivatives(solver.get(), dx1, dy1, dq.data(), dl.data(), du.data(), dPx.data(), dAx.data());
+  derivatives(refSolver.get(), dx1, dy1, dq_ref.data(), dl_ref.data(), du_ref.data(), dPx_ref.data(), dAx_ref.data());
+
+  compare();
+}
+
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Batched derivatives", "[solve][qp][derivative]")
+{
+  if (!(osqp_capabilities() & OSQP_CAPABILITY_DERIVATIVES))
+    return;
+
+  OSQPInt exitflag;
+  OSQPInt n = data->n;
+  OSQPInt m = data->m;
+  OSQPInt nnzP = data->P->p[n];
+  OSQPInt nnzA = data->A->p[n];
+
+  const OSQPInt K = 3;
+
+  // Test-specific options
+  settings->polishing = 1;
+  settings->eps_abs   = 1e-9;
+  settings->eps_rel   = 1e-9;
+
+  OSQPFloat dx[K*2]   = {1.0, -0.5, -0.7, 0.4, 0.0, 2.0};
+  OSQPFloat dy_l[K*4] = {0.2, 0.0, 0.1, 0.0, -0.4, 0.3, 0.0, 0.1, 0.0, 0.0, 0.0, 0.0};
+  OSQPFloat dy_u[K*4] = {0.0, 0.1, -0.3, 0.0, 0.5, -0.2, 0.1, 0.3, 1.0, 0.0, 0.0, 0.2};
+
+  std::vector<OSQPFloat> dq(K*n), dl(K*m), du(K*m), dPx(K*nnzP), dAx(K*nnzA);
+  std::vector<OSQPFloat> dq_ref(n), dl_ref(m), du_ref(m), dPx_ref(nnzP), dAx_ref(nnzA);
+
+  OSQPCscMatrix dP[K];
+  OSQPCscMatrix dA[K];
+  OSQPCscMatrix dP_ref;
+  OSQPCscMatrix dA_ref;
+
+  for (OSQPInt k = 0; k < K; k++) {
+    csc_set_data(&dP[k], n, n, nnzP, dPx.data() + k*nnzP, data->P->i, data->P->p);
+    csc_set_data(&dA[k], m, n, nnzA, dAx.data() + k*nnzA, data->A->i, data->A->p);
+  }
+  csc_set_data(&dP_ref, n, n, nnzP, dPx_ref.data(), data->P->i, data->P->p);
+  csc_set_data(&dA_ref, m, n, nnzA, dAx_ref.data(), data->A->i, data->A->p);
+
+  // Setup solver
+  exitflag = osqp_setup(&tmpSolver, data->P, data->q,
+                        data->A, data->l, data->u,
+                        m, n, settings.get());
+  solver.reset(tmpSolver);
+
+  mu_assert("Batched derivatives: Setup error!", exitflag == 0);
+
+  osqp_solve(solver.get());
+
+  mu_assert("Batched derivatives: Error in solver status!",
+            solver->info->status_val == OSQP_SOLVED);
+
+  // The results cannot be read before they are computed
+  mu_assert("Batched derivatives: Missing error for results of an uncomputed seed!",
+            osqp_adjoint_derivative_get_vec_batch(solver.get(), 1, dq.data(), dl.data(), du.data()) != 0);
+
+  exitflag = osqp_adjoint_derivative_compute_batch(solver.get(), K, dx, dy_l, dy_u);
+  mu_assert("Batched derivatives: Error computing the derivatives!", exitflag == 0);
+
+  exitflag = osqp_adjoint_derivative_get_vec_batch(solver.get(), K, dq.data(), dl.data(), du.data());
+  mu_assert("Batched derivatives: Error in the vector derivatives!", exitflag == 0);
+
+  exitflag = osqp_adjoint_derivative_get_mat_batch(solver.get(), K, dP, dA);
+  mu_assert("Batched derivatives: Error in the matrix derivatives!", exitflag == 0);
+
+  mu_assert("Batched derivatives: Missing error for too many seeds!",
+            osqp_adjoint_derivative_get_vec_batch(solver.get(), K+1, dq.data(), dl.data(), du.data()) != 0);
+
+  // Every seed gives the derivatives of a single computation
+  for (OSQPInt k = 0; k < K; k++) {
+    CAPTURE(k);
+
+    exitflag = osqp_adjoint_derivative_compute(solver.get(), dx + k*n, dy_l + k*m, dy_u + k*m);
+    mu_assert("Batched derivatives: Error computing the derivatives!", exitflag == 0);
+
+    osqp_adjoint_derivative_get_vec(solver.get(), dq_ref.data(), dl_ref.data(), du_ref.data());
+    osqp_adjoint_derivative_get_mat(solver.get(), &dP_ref, &dA_ref);
+
+    mu_assert("Batched derivatives: Error in dq!",
+              vec_norm_inf_diff(dq.data() + k*n, dq_ref.data(), n) < TESTS_TOL);
+    mu_assert("Batched derivatives: Error in dl!",
+              vec_norm_inf_diff(dl.data() + k*m, dl_ref.data(), m) < TESTS_TOL);
+    mu_assert("Batched derivatives: Error in du!",
+              vec_norm_inf_diff(du.data() + k*m, du_ref.data(), m) < TESTS_TOL);
+    mu_assert("Batched derivatives: Error in dP!",
+              vec_norm_inf_diff(dPx.data() + k*nnzP, dPx_ref.data(), nnzP) < TESTS_TOL);
+    mu_assert("Batched derivatives: Error in dA!",
+              vec_norm_inf_diff(dAx.data() + k*nnzA, dAx_ref.data(), nnzA) < TESTS_TOL);
+  }
+}
+
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Forward derivatives", "[solve][qp][derivative]")
+{
+  if (!(osqp_capabilities() & OSQP_CAPABILITY_DERIVATIVES))
+    return;
+
+  OSQPInt exitflag;
+  OSQPInt n = data->n;
+  OSQPInt m = data->m;
+  OSQPInt nnzP = data->P->p[n];
+  OSQPInt nnzA = data->A->p[n];
+
+  const OSQPInt   K = 4;
+  const OSQPFloat t = 1e-4;
+
+  // Test-specific options
+  settings->polishing = 1;
+  settings->eps_abs   = 1e-10;
+  settings->eps_rel   = 1e-10;
+  settings->verbose   = 0;
+
+  // The derivative system is formed on the scaled data
+  settings->scaling = GENERATE(0, 10);
+  settings->derivative_iterative = GENERATE(0, 1);
+  CAPTURE(settings->scaling, settings->derivative_iterative);
+
+  // One direction for every part of the data
+  OSQPFloat dq[K*2]   = {1.0, -0.5, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+  OSQPFloat dl[K*4]   = {0.0, 0.0, 0.0, 0.0, 0.5, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+  OSQPFloat du[K*4]   = {0.0, 0.0, 0.0, 0.0, 0.5, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+  OSQPFloat dPx[K*3]  = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, -0.5, 2.0};
+  OSQPFloat dAx[K*5]  = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.3, 0.0, -0.2, 0.5, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+
+  mu_assert("Forward derivatives: Unexpected problem size!", ((nnzP == 3) && (nnzA == 5)));
+
+  OSQPCscMatrix dP[K];
+  OSQPCscMatrix dA[K];
+  for (OSQPInt k = 0; k < K; k++) {
+    csc_set_data(&dP[k], n, n, nnzP, dPx + k*nnzP, data->P->i, data->P->p);
+    csc_set_data(&dA[k], m, n, nnzA, dAx + k*nnzA, data->A->i, data->A->p);
+  }
+
+  std::vector<OSQPFloat> dx(K*n), dy(K*m), dx1(n), dy1(m);
+
+  // Solution of the problem moved by s along direction k
+  auto solve_moved = [&](OSQPInt k, OSQPFloat s, std::vector<OSQPFloat>& x, std::vector<OSQPFloat>& y) {
+    std::vector<OSQPFloat> Px(data->P->x, data->P->x + nnzP), Ax(data->A->x, data->A->x + nnzA);
+    std::vector<OSQPFloat> q(data->q, data->q + n), l(data->l, data->l + m), u(data->u, data->u + m);
+
+    for (OSQPInt j = 0; j < nnzP; j++) Px[j] += s * dPx[k*nnzP + j];
+    for (OSQPInt j = 0; j < nnzA; j++) Ax[j] += s * dAx[k*nnzA + j];
+    for (OSQPInt j = 0; j < n; j++)    q[j]  += s * dq[k*n + j];
+    for (OSQPInt j = 0; j < m; j++)    l[j]  += s * dl[k*m + j];
+    for (OSQPInt j = 0; j < m; j++)    u[j]  += s * du[k*m + j];
+
+    OSQPCscMatrix Pmat;
+    OSQPCscMatrix Amat;
+    csc_set_data(&Pmat, n, n, nnzP, Px.data(), data->P->i, data->P->p);
+    csc_set_data(&Amat, m, n, nnzA, Ax.data(), data->A->i, data->A->p);
+
+    OSQPSolver* s_tmp = nullptr;
+    OSQPInt flag = osqp_setup(&s_tmp, &Pmat, q.data(), &Amat, l.data(), u.data(), m, n, settings.get());
+    OSQPSolver_ptr s_moved{s_tmp};
+    mu_assert("Forward derivatives: Setup error!", flag == 0);
+
+    osqp_solve(s_moved.get());
+    mu_assert("Forward derivatives: Error in solver status!",
+              s_moved->info->status_val == OSQP_SOLVED);
+
+    x.assign(s_moved->solution->x, s_moved->solution->x + n);
+    y.assign(s_moved->solution->y, s_moved->solution->y + m);
+  };
+
+  // Setup solver
+  exitflag = osqp_setup(&tmpSolver, data->P, data->q,
+                        data->A, data->l, data->u,
+                        m, n, settings.get());
+  solver.reset(tmpSolver);
+
+  mu_assert("Forward derivatives: Setup error!", exitflag == 0);
+
+  osqp_solve(solver.get());
+
+  exitflag = osqp_forward_derivative_compute_batch(solver.get(), K, dP, dq, dA, dl, du, dx.data(), dy.data());
+  mu_assert("Forward derivatives: Error computing the derivatives!", exitflag == 0);
+
+  for (OSQPInt k = 0; k < K; k++) {
+    CAPTURE(k);
+
+    std::vector<OSQPFloat> x_p, y_p, x_m, y_m, dx_fd(n), dy_fd(m);
+    solve_moved(k, t, x_p, y_p);
+    solve_moved(k, -t, x_m, y_m);
+
+    // Central differences
+    for (OSQPInt j = 0; j < n; j++) dx_fd[j] = (x_p[j] - x_m[j]) / (2 * t);
+    for (OSQPInt j = 0; j < m; j++) dy_fd[j] = (y_p[j] - y_m[j]) / (2 * t);
+
+    mu_assert("Forward derivatives: Error in dx!",
+              vec_norm_inf_diff(dx.data() + k*n, dx_fd.data(), n) < 1e-5);
+    mu_assert("Forward derivatives: Error in dy!",
+              vec_norm_inf_diff(dy.data() + k*m, dy_fd.data(), m) < 1e-5);
+
+    // A single direction gives the same derivatives
+    exitflag = osqp_forward_derivative_compute(solver.get(), &dP[k], dq + k*n, &dA[k],
+                                               dl + k*m, du + k*m, dx1.data(), dy1.data());
+    mu_assert("Forward derivatives: Error computing the derivatives!", exitflag == 0);
+
+    mu_assert("Forward derivatives: Error in dx of a single direction!",
+              vec_norm_inf_diff(dx.data() + k*n, dx1.data(), n) < TESTS_TOL);
+    mu_assert("Forward derivatives: Error in dy of a single direction!",
+              vec_norm_inf_diff(dy.data() + k*m, dy1.data(), m) < TESTS_TOL);
+  }
+
+  // Only q moves
+  exitflag = osqp_forward_derivative_compute(solver.get(), OSQP_NULL, dq, OSQP_NULL,
+                                             OSQP_NULL, OSQP_NULL, dx1.data(), dy1.data());
+  mu_assert("Forward derivatives: Error computing the derivatives!", exitflag == 0);
+
+  mu_assert("Forward derivatives: Error in dx without matrix perturbations!",
+            vec_norm_inf_diff(dx.data(), dx1.data(), n) < TESTS_TOL);
+}
+
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Iterative derivatives", "[solve][qp][derivative]")
+{
+  if (!(osqp_capabilities() & OSQP_CAPABILITY_DERIVATIVES))
+    return;
+
+  OSQPInt exitflag;
+  OSQPInt n = data->n;
+  OSQPInt m = data->m;
+  OSQPInt nnzP = data->P->p[n];
+  OSQPInt nnzA = data->A->p[n];
+
+  const OSQPInt K = 2;
+
+  // Test-specific options
+  settings->polishing = 1;
+  settings->eps_abs   = 1e-10;
+  settings->eps_rel   = 1e-10;
+  settings->verbose   = 0;
+
+  // The preconditioner refactors the KKT matrix only with a vector rho
+  settings->rho_is_vec = GENERATE(0, 1);
+  CAPTURE(settings->rho_is_vec);
+
+  OSQPFloat dx[K*2]   = {1.0, -0.5, -0.7, 0.4};
+  OSQPFloat dy_l[K*4] = {0.2, 0.0, 0.1, 0.0, -0.4, 0.3, 0.0, 0.1};
+  OSQPFloat dy_u[K*4] = {0.0, 0.1, -0.3, 0.0, 0.5, -0.2, 0.1, 0.3};
+
+  std::vector<OSQPFloat> dq(K*n), dl(K*m), du(K*m), dPx(K*nnzP), dAx(K*nnzA);
+  std::vector<OSQPFloat> dq_ref(K*n), dl_ref(K*m), du_ref(K*m), dPx_ref(K*nnzP), dAx_ref(K*nnzA);
+
+  OSQPCscMatrix dP[K];
+  OSQPCscMatrix dA[K];
+
+  auto derivatives = [&](OSQPFloat* q, OSQPFloat* l, OSQPFloat* u, OSQPFloat* Px, OSQPFloat* Ax) {
+    for (OSQPInt k = 0; k < K; k++) {
+      csc_set_data(&dP[k], n, n, nnzP, Px + k*nnzP, data->P->i, data->P->p);
+      csc_set_data(&dA[k], m, n, nnzA, Ax + k*nnzA, data->A->i, data->A->p);
+    }
+    mu_assert("Iterative derivatives: Error computing the derivatives!",
+              osqp_adjoint_derivative_compute_batch(solver.get(), K, dx, dy_l, dy_u) == 0);
+    mu_assert("Iterative derivatives: Error in the vector derivatives!",
+              osqp_adjoint_derivative_get_vec_batch(solver.get(), K, q, l, u) == 0);
+    mu_assert("Iterative derivatives: Error in the matrix derivatives!",
+              osqp_adjoint_derivative_get_mat_batch(solver.get(), K, dP, dA) == 0);
+  };
+
+  auto compare = [&]() {
+    mu_assert("Iterative derivatives: Error in dq!",
+              vec_norm_inf_diff(dq.data(), dq_ref.data(), K*n) < TESTS_TOL);
+    mu_assert("Iterative derivatives: Error in dl!",
+              vec_norm_inf_diff(dl.data(), dl_ref.data(), K*m) < TESTS_TOL);
+    mu_assert("Iterative derivatives: Error in du!",
+              vec_norm_inf_diff(du.data(), du_ref.data(), K*m) < TESTS_TOL);
+    mu_assert("Iterative derivatives: Error in dP!",
+              vec_norm_inf_diff(dPx.data(), dPx_ref.data(), K*nnzP) < TESTS_TOL);
+    mu_assert("Iterative derivatives: Error in dA!",
+              vec_norm_inf_diff(dAx.data(), dAx_ref.data(), K*nnzA) < TESTS_TOL);
+  };
+
+  // Setup solver
+  exitflag = osqp_setup(&tmpSolver, data->P, data->q,
+                        data->A, data->l, data->u,
+                        m, n, settings.get());
+  solver.reset(tmpSolver);
+
+  mu_assert("Iterative derivatives: Setup error!", exitflag == 0);
+
+  osqp_solve(solver.get());
+
+  mu_assert("Iterative derivatives: Error in solver status!",
+            solver->info->status_val == OSQP_SOLVED);
+
+  // Reference from the factorization of the derivative system
+  derivatives(dq_ref.data(), dl_ref.data(), du_ref.data(), dPx_ref.data(), dAx_ref.data());
+
+  settings->derivative_iterative = 1;
+  exitflag = osqp_update_settings(solver.get(), settings.get());
+  mu_assert("Iterative derivatives: Error updating the settings!", exitflag == 0);
+
+  derivatives(dq.data(), dl.data(), du.data(), dPx.data(), dAx.data());
+  compare();
+
+  // GMRES reports that it cannot reach a zero residual
+  settings->eps_abs = 0.0;
+  exitflag = osqp_update_settings(solver.get(), settings.get());
+  mu_assert("Iterative derivatives: Error updating the settings!", exitflag == 0);
+
+  exitflag = osqp_adjoint_derivative_compute_batch(solver.get(), K, dx, dy_l, dy_u);
+  mu_assert("Iterative derivatives: Error in the GMRES failure!",
+            exitflag == OSQP_ITERATIVE_SOLVE_ERROR);
+
+  settings->eps_abs = 1e-10;
+  exitflag = osqp_update_settings(solver.get(), settings.get());
+  mu_assert("Iterative derivatives: Error updating the settings!", exitflag == 0);
+
+  // Back to the direct solve after a new partition of the constraints
+  exitflag = osqp_update_data_vec(solver.get(), OSQP_NULL, sols_data->l_new, sols_data->u_new);
+  mu_assert("Iterative derivatives: Error updating bounds!", exitflag == 0);
+  osqp_solve(solver.get());
+
+  derivatives(dq.data(), dl.data(), du.data(), dPx.data(), dAx.data());
+
+  settings->derivative_iterative = 0;
+  exitflag = osqp_update_settings(solver.get(), settings.get());
+  mu_assert("Iterative derivatives: Error updating the settings!", exitflag == 0);
+
+  derivatives(dq_ref.data(), dl_ref.data(), du_ref.data(), dPx_ref.data(), dAx_ref.data());
+  compare();
+}
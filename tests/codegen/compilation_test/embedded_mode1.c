@@ -8,6 +8,15 @@
 #include "rho_is_vec_0_embedded_1_workspace.h"
 #include "rho_is_vec_1_embedded_1_workspace.h"
 
+#include "unroll_rho_is_vec_0_embedded_1_workspace.h"
+#include "unroll_rho_is_vec_1_embedded_1_workspace.h"
+
+#include "fixed_point_0_workspace.h"
+#include "fixed_point_1_workspace.h"
+
+#include "rho_ladder_rho_is_vec_0_workspace.h"
+#include "rho_ladder_rho_is_vec_1_workspace.h"
+
 #include "scaling_0_embedded_1_workspace.h"
 #include "scaling_1_embedded_1_workspace.h"
 
@@ -15,8 +24,13 @@
 #include "data_nonconvex_2_embedded_1_workspace.h"
 #include "data_unconstrained_embedded_1_workspace.h"
 
+/* Variables of the large QP of the fixed-point ADMM step */
+#define FIXED_POINT_N 160
+
 int main() {
-  OSQPInt exitflag;
+  OSQPInt   exitflag;
+  OSQPInt   i;
+  OSQPFloat obj_err, x_err, x_max, d;
 
   printf( "Embedded test program for embedded mode 1 settings.\n");
 
@@ -46,6 +60,116 @@ int main() {
   }
 
 
+  /*
+   * Unrolled kernels with rho_is_vec = 0, same iterates as the generic ones
+   */
+  exitflag = osqp_solve( &unroll_rho_is_vec_0_embedded_1_solver );
+
+  if( exitflag > 0 ) {
+    printf( "  OSQP errored on unroll_rho_is_vec_0: %s\n", osqp_error_message(exitflag));
+    return (int)exitflag;
+  } else if( unroll_rho_is_vec_0_embedded_1_solver.info->iter != rho_is_vec_0_embedded_1_solver.info->iter ) {
+    printf( "  Unrolled kernels changed the iterations on rho_is_vec_0.\n" );
+    return 1;
+  } else {
+    printf( "  Solved unroll_rho_is_vec_0 with no error.\n" );
+  }
+
+
+  /*
+   * Unrolled kernels with rho_is_vec = 1, same iterates as the generic ones
+   */
+  exitflag = osqp_solve( &unroll_rho_is_vec_1_embedded_1_solver );
+
+  if( exitflag > 0 ) {
+    printf( "  OSQP errored on unroll_rho_is_vec_1: %s\n", osqp_error_message(exitflag));
+    return (int)exitflag;
+  } else if( unroll_rho_is_vec_1_embedded_1_solver.info->iter != rho_is_vec_1_embedded_1_solver.info->iter ) {
+    printf( "  Unrolled kernels changed the iterations on rho_is_vec_1.\n" );
+    return 1;
+  } else {
+    printf( "  Solved unroll_rho_is_vec_1 with no error.\n" );
+  }
+
+
+  /*
+   * Adaptive rho along the precomputed factorizations
+   */
+  exitflag = osqp_solve( &rho_ladder_rho_is_vec_0_solver );
+
+  if( exitflag > 0 ) {
+    printf( "  OSQP errored on rho_ladder_rho_is_vec_0: %s\n", osqp_error_message(exitflag));
+    return (int)exitflag;
+  } else if( rho_ladder_rho_is_vec_0_solver.info->status_val != OSQP_SOLVED ) {
+    printf( "  Adaptive rho did not solve rho_ladder_rho_is_vec_0.\n" );
+    return 1;
+  } else {
+    printf( "  Solved rho_ladder_rho_is_vec_0 with no error.\n" );
+  }
+
+  exitflag = osqp_solve( &rho_ladder_rho_is_vec_1_solver );
+
+  if( exitflag > 0 ) {
+    printf( "  OSQP errored on rho_ladder_rho_is_vec_1: %s\n", osqp_error_message(exitflag));
+    return (int)exitflag;
+  } else if( rho_ladder_rho_is_vec_1_solver.info->status_val != OSQP_SOLVED ) {
+    printf( "  Adaptive rho did not solve rho_ladder_rho_is_vec_1.\n" );
+    return 1;
+  } else {
+    printf( "  Solved rho_ladder_rho_is_vec_1 with no error.\n" );
+  }
+
+
+  /*
+   * Fixed-point ADMM step, same solution as the floating-point one up to the
+   * precision of float
+   */
+  exitflag = osqp_solve( &fixed_point_0_solver );
+
+  if( exitflag > 0 ) {
+    printf( "  OSQP errored on fixed_point_0: %s\n", osqp_error_message(exitflag));
+    return (int)exitflag;
+  }
+
+  exitflag = osqp_solve( &fixed_point_1_solver );
+
+  obj_err = (fixed_point_1_solver.info->obj_val - fixed_point_0_solver.info->obj_val) /
+            fixed_point_0_solver.info->obj_val;
+  if( obj_err < 0 ) obj_err = -obj_err;
+
+  /* Largest difference of the primal solutions relative to the largest entry */
+  x_err = 0;
+  x_max = 0;
+  for( i = 0; i < FIXED_POINT_N; i++ ) {
+    d = fixed_point_1_solver.solution->x[i] - fixed_point_0_solver.solution->x[i];
+    if( d < 0 ) d = -d;
+    if( d > x_err ) x_err = d;
+    d = fixed_point_0_solver.solution->x[i];
+    if( d < 0 ) d = -d;
+    if( d > x_max ) x_max = d;
+  }
+  if( x_max > 1 ) x_err /= x_max;
+
+  if( exitflag > 0 ) {
+    printf( "  OSQP errored on fixed_point_1: %s\n", osqp_error_message(exitflag));
+    return (int)exitflag;
+  } else if( fixed_point_1_solver.info->status_val != OSQP_SOLVED ) {
+    printf( "  Fixed-point step did not solve fixed_point_1.\n" );
+    return 1;
+  } else if( obj_err > 1e-6 ) {
+    printf( "  Fixed-point step changed the objective: %e instead of %e.\n",
+            fixed_point_1_solver.info->obj_val, fixed_point_0_solver.info->obj_val );
+    return 1;
+  } else if( x_err > 2e-5 ) {
+    printf( "  Fixed-point step changed the primal solution by %e.\n", x_err );
+    return 1;
+  } else {
+    printf( "  Solved fixed_point_1 with no error (iterations %d and %d, objective error %e, primal error %e).\n",
+            (int)fixed_point_1_solver.info->iter, (int)fixed_point_0_solver.info->iter,
+            obj_err, x_err );
+  }
+
+
   /*
    * scaling = 0
    */
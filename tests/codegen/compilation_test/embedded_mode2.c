@@ -8,6 +8,9 @@
 #include "rho_is_vec_0_embedded_2_workspace.h"
 #include "rho_is_vec_1_embedded_2_workspace.h"
 
+#include "unroll_rho_is_vec_0_embedded_2_workspace.h"
+#include "unroll_rho_is_vec_1_embedded_2_workspace.h"
+
 #include "scaling_0_embedded_2_workspace.h"
 #include "scaling_1_embedded_2_workspace.h"
 
@@ -46,6 +49,38 @@ int main() {
   }
 
 
+  /*
+   * Unrolled kernels with rho_is_vec = 0, same iterates as the generic ones
+   */
+  exitflag = osqp_solve( &unroll_rho_is_vec_0_embedded_2_solver );
+
+  if( exitflag > 0 ) {
+    printf( "  OSQP errored on unroll_rho_is_vec_0: %s\n", osqp_error_message(exitflag));
+    return (int)exitflag;
+  } else if( unroll_rho_is_vec_0_embedded_2_solver.info->iter != rho_is_vec_0_embedded_2_solver.info->iter ) {
+    printf( "  Unrolled kernels changed the iterations on rho_is_vec_0.\n" );
+    return 1;
+  } else {
+    printf( "  Solved unroll_rho_is_vec_0 with no error.\n" );
+  }
+
+
+  /*
+   * Unrolled kernels with rho_is_vec = 1, same iterates as the generic ones
+   */
+  exitflag = osqp_solve( &unroll_rho_is_vec_1_embedded_2_solver );
+
+  if( exitflag > 0 ) {
+    printf( "  OSQP errored on unroll_rho_is_vec_1: %s\n", osqp_error_message(exitflag));
+    return (int)exitflag;
+  } else if( unroll_rho_is_vec_1_embedded_2_solver.info->iter != rho_is_vec_1_embedded_2_solver.info->iter ) {
+    printf( "  Unrolled kernels changed the iterations on rho_is_vec_1.\n" );
+    return 1;
+  } else {
+    printf( "  Solved unroll_rho_is_vec_1 with no error.\n" );
+  }
+
+
   /*
    * scaling = 0
    */
@@ -0,0 +1,29 @@
+/*
+ * Test file to compile a generated workspace with the dimensions of its
+ * problem fixed in the vector operations.
+ */
+
+#include <stdio.h>
+#include "osqp.h"
+
+#include "fixed_dims_workspace.h"
+
+int main() {
+  OSQPInt exitflag;
+
+  printf( "Embedded test program with fixed dimensions.\n");
+
+  exitflag = osqp_solve( &fixed_dims_solver );
+
+  if( exitflag > 0 ) {
+    printf( "  OSQP errored on fixed_dims: %s\n", osqp_error_message(exitflag));
+    return (int)exitflag;
+  } else if( fixed_dims_solver.info->status_val != OSQP_SOLVED ) {
+    printf( "  Fixed dimensions did not solve fixed_dims.\n" );
+    return 1;
+  } else {
+    printf( "  Solved fixed_dims with no error.\n" );
+  }
+
+  return 0;
+}
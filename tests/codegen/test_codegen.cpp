@@ -1,15 +1,171 @@
 #include <catch2/catch.hpp>
 
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <regex>
+#include <string>
+#include <vector>
+
 #include "osqp_api.h"    /* OSQP API wrapper (public + some private) */
 #include "osqp_tester.h" /* Tester helpers */
 #include "test_utils.h"  /* Testing Helper functions */
 
 #include "codegen_data.h"
 #include "basic_lp_data.h"
+#include "basic_qp2_data.h"
+#include "large_qp_data.h"
 #include "non_cvx_data.h"
 #include "unconstrained_data.h"
 
 #ifdef OSQP_CODEGEN
+/* Read the values of the array name of a generated workspace file */
+static std::vector<OSQPFloat> read_codegen_vecf(const std::string& file,
+                                                const std::string& name) {
+  std::ifstream          in(file);
+  std::string            line;
+  std::string            decl = "OSQPFloat " + name + "[";
+  std::vector<OSQPFloat> vec;
+
+  while (std::getline(in, line) && line.find(decl) == std::string::npos) {}
+  while (std::getline(in, line) && line != "};") {
+    vec.push_back((OSQPFloat)std::strtod(line.c_str() + line.find(')') + 1, nullptr));
+  }
+
+  return vec;
+}
+
+/* Arithmetic operators (+, -, *, /, << and >>, also as compound assignments)
+ * of a statement of generated code, without the casts, the indices, the
+ * literals and the shifts of the constant 1 */
+static OSQPInt count_statement_ops(std::string stmt) {
+  static const std::regex skip("->|\\(\\((int64_t)\\)1 << \\d+\\)|\\((int64_t|int32_t|OSQPFloat)\\)|\\[[^\\]]*\\]");
+  static const std::regex literal("\\d+(\\.\\d+)?([eE][+-]?\\d+)?");
+
+  OSQPInt ops  = 0;
+  char    prev = ' ';
+
+  stmt = std::regex_replace(stmt, skip, " ");
+  stmt = std::regex_replace(stmt, literal, "0");
+
+  for (size_t i = 0; i < stmt.size(); i++) {
+    char c = stmt[i];
+
+    if ((c == '<' || c == '>') && i + 1 < stmt.size() && stmt[i+1] == c) {
+      ops++;
+      i++;
+    }
+    else if ((c == '+' || c == '-' || c == '*' || c == '/') &&
+             (std::isalnum(prev) || prev == '_' || prev == ')')) {
+      ops++;
+    }
+    if (c != ' ') prev = c;
+  }
+
+  return ops;
+}
+
+/* Floating-point and integer operations of one call of the generated function
+ * whose definition starts with head, with the vector length n of fx_to_q. The
+ * loops count every iteration, the while loops of the scales count their
+ * condition once as when the scale stays put, in integers for the shifts of
+ * the step, and the calls of fx_to_q count the operations of its body for
+ * their length.
+ */
+static void count_function_ops(const std::vector<std::string>& lines,
+                               const std::string&              head,
+                               OSQPInt                         n,
+                               OSQPInt*                        float_ops,
+                               OSQPInt*                        int_ops) {
+  static const std::regex decl("^\\s*(const\\s+)?(OSQPFloat|OSQPInt|int64_t|int32_t)\\s*\\*?\\s+");
+  static const std::regex loop("^\\s*for \\(i = 0; i < (\\w+); i\\+\\+\\)\\s*(.*)$");
+  static const std::regex cond("^\\s*(if|while) \\((.*)$");
+  static const std::regex call("fx_to_q\\(\\w+, \\w+, (\\d+), [^)]*\\)");
+
+  std::vector<OSQPInt> trips{1};
+  std::smatch          match;
+  std::string          stmt;
+  bool                 int_t = false;
+  size_t               l     = 0;
+
+  *float_ops = 0;
+  *int_ops   = 0;
+
+  while (l < lines.size() && lines[l].compare(0, head.size(), head) != 0) l++;
+  REQUIRE(l < lines.size());
+
+  for (l++; l < lines.size() && lines[l] != "}"; l++) {
+    std::string line = lines[l];
+    OSQPInt     trip = trips.back();
+
+    if (line.find("int64_t   t;") != std::string::npos) int_t = true;
+
+    // Statements continue over the lines of the sums
+    stmt += line;
+    if (!stmt.empty() && stmt.back() != ';' && stmt.back() != '{' && stmt.back() != '}' &&
+        stmt.find("/*") == std::string::npos && stmt.find_first_not_of(' ') != std::string::npos) {
+      continue;
+    }
+    line = stmt;
+    stmt.clear();
+
+    if (line.find("/*") != std::string::npos || line.find("(void)") != std::string::npos) continue;
+    if (line.find('}') != std::string::npos) {
+      trips.pop_back();
+      continue;
+    }
+
+    if (std::regex_search(line, match, loop)) {
+      trip *= (match[1] == "n") ? n : std::stoi(match[1]);
+      line  = match[2];
+    }
+    else if (std::regex_search(line, match, cond)) {
+      // Split the condition from the statement at its closing parenthesis
+      std::string rest  = match[2];
+      size_t      close = 0;
+      int         depth = 1;
+
+      while (depth > 0) {
+        if (rest[close] == '(') depth++;
+        if (rest[close] == ')') depth--;
+        close++;
+      }
+      if (match[1] == "while") {
+        std::string test = rest.substr(0, close - 1);
+
+        if (test.find("fx_") != std::string::npos) *int_ops   += count_statement_ops(test);
+        else                                       *float_ops += count_statement_ops(test);
+        continue;
+      }
+      line = rest.substr(close);
+    }
+    if (!line.empty() && line.back() == '{') {
+      trips.push_back(trip);
+      continue;
+    }
+    if (line.find('=') == std::string::npos && line.find("return") == std::string::npos) continue;
+
+    // Calls of the conversion to fixed point
+    if (std::regex_search(line, match, call)) {
+      std::vector<OSQPInt> ops(2);
+      count_function_ops(lines, "static OSQPFloat fx_to_q(", std::stoi(match[1]), &ops[0], &ops[1]);
+      *float_ops += ops[0];
+      *int_ops   += ops[1];
+      line = std::regex_replace(line, call, "q");
+    }
+
+    line = std::regex_replace(line, decl, "");
+    std::string lhs = line.substr(0, line.find('='));
+    lhs.erase(lhs.find_last_not_of(" +-*/") + 1);
+    lhs.erase(0, lhs.find_first_not_of(' '));
+
+    if ((lhs == "t" && int_t) || lhs.compare(0, 3, "fx_") == 0) *int_ops += trip * count_statement_ops(line);
+    else                                                         *float_ops += trip * count_statement_ops(line);
+  }
+}
+
 TEST_CASE_METHOD(codegen_test_fixture, "Basic codegen", "[codegen]")
 {
   OSQPInt exitflag;
@@ -215,6 +371,220 @@ TEST_CASE_METHOD(non_cvx_test_fixture, "Codegen: Data export", "[codegen],[nonco
             exitflag == expected_error);
 }
 
+/* Fixed point pays off with many more matrix entries than variables, so the
+ * compilation test compares both options on the large QP. The operations of
+ * an ADMM step and of the products are counted in the generated code, with
+ * the vector operations of the library around the KKT solve of the
+ * floating-point step. */
+TEST_CASE_METHOD(OSQPTestFixture, "Codegen: Fixed-point ADMM step", "[codegen],[qp]")
+{
+  OSQPInt exitflag;
+
+  // Codegen defines
+  OSQPCodegenDefines_ptr defines{(OSQPCodegenDefines *)c_malloc(sizeof(OSQPCodegenDefines))};
+
+  // Define codegen settings
+  osqp_set_default_codegen_defines(defines.get());
+  defines->embedded_mode = 1;      // vector update
+  defines->float_type    = 1;      // floats
+  defines->unroll_enable = 1;
+
+  // Setup solver
+  exitflag = osqp_setup(&tmpSolver, &prob1_data_P_csc, prob1_data_q_val,
+                        &prob1_data_A_csc, prob1_data_l_val, prob1_data_u_val,
+                        prob1_data_m, prob1_data_n, settings.get());
+  solver.reset(tmpSolver);
+
+  // Setup correct
+  mu_assert("Setup error!", exitflag == 0);
+
+  OSQPInt n = prob1_data_n;
+  OSQPInt m = prob1_data_m;
+
+  // Floating-point and integer operations of the step and of the products
+  OSQPInt counted[2][4];
+
+  for (OSQPInt fixed_point = 0; fixed_point < 2; fixed_point++) {
+    char name[100];
+    snprintf(name, 100, "fixed_point_%d_", fixed_point);
+
+    CAPTURE(fixed_point);
+
+    defines->fixed_point_enable = fixed_point;
+
+    exitflag = osqp_codegen(solver.get(), CODEGEN1_DIR, name, defines.get());
+
+    // Codegen should work
+    mu_assert("fixed_point_enable not handled properly!",
+              exitflag == OSQP_NO_ERROR);
+
+    std::ifstream            in(std::string(CODEGEN1_DIR) + name + "workspace.c");
+    std::vector<std::string> lines;
+    std::string              line;
+    OSQPInt                  ops[2];
+
+    while (std::getline(in, line)) lines.push_back(line);
+
+    // The fixed-point step replaces the KKT solve and the vector operations
+    if (fixed_point) {
+      count_function_ops(lines, std::string("static void ") + name + "admm_step(", 0, &counted[1][0], &counted[1][1]);
+    }
+    else {
+      count_function_ops(lines, std::string("static void ") + name + "linsys_ldl_solve(", 0, &counted[0][0], &counted[0][1]);
+      counted[0][0] += 7*n + 17*m + 3 + (settings->rho_is_vec ? m : 0);
+    }
+
+    counted[fixed_point][2] = 0;
+    counted[fixed_point][3] = 0;
+    for (const char* product : {"data_P_Axpy", "data_A_Axpy", "data_A_Atxpy"}) {
+      count_function_ops(lines, std::string("static void ") + name + product + "(", 0, &ops[0], &ops[1]);
+      counted[fixed_point][2] += ops[0];
+      counted[fixed_point][3] += ops[1];
+    }
+
+    // The header reports the operations of the generated code
+    std::ifstream header(std::string(CODEGEN1_DIR) + name + "workspace.h");
+    std::regex    define("^#define \\w+_(STEP|PRODUCT)_(FLOAT|INT)_OPS (\\d+)$");
+    std::smatch   match;
+    OSQPInt       reported[4] = {-1, -1, -1, -1};
+
+    while (std::getline(header, line)) {
+      if (std::regex_search(line, match, define)) {
+        reported[(match[1] == "STEP" ? 0 : 2) + (match[2] == "FLOAT" ? 0 : 1)] = std::stoi(match[3]);
+      }
+    }
+
+    for (int i = 0; i < 4; i++) {
+      CAPTURE(i, counted[fixed_point][i], reported[i]);
+      mu_assert("Reported operations of the generated code are wrong!",
+                reported[i] == counted[fixed_point][i]);
+    }
+  }
+
+  // Fixed point moves the operations of an iteration to integers
+  OSQPInt float_ops[2] = {counted[0][0] + counted[0][2], counted[1][0] + counted[1][2]};
+
+  CAPTURE(counted[0][0], counted[1][0], counted[1][1], float_ops[0], float_ops[1]);
+  mu_assert("Floating-point code uses integer operations!",
+            (counted[0][1] == 0 && counted[0][3] == 0));
+  mu_assert("Fixed-point step does not reduce the floating-point operations!",
+            4*counted[1][0] < counted[0][0]);
+  mu_assert("Fixed-point code does not reduce the floating-point operations!",
+            4*float_ops[1] < float_ops[0]);
+}
+
+TEST_CASE_METHOD(codegen_test_fixture, "Codegen: Read-only arrays", "[codegen]")
+{
+  OSQPInt exitflag;
+
+  // Codegen defines
+  OSQPCodegenDefines_ptr defines{(OSQPCodegenDefines *)c_malloc(sizeof(OSQPCodegenDefines))};
+
+  osqp_set_default_codegen_defines(defines.get());
+
+  OSQPInt embedded;
+  OSQPInt fixed_point;
+
+  std::tie( embedded, fixed_point ) =
+    GENERATE( table<OSQPInt, OSQPInt>(
+        { /* first is embedded mode, second is fixed_point_enable */
+          std::make_tuple( 1, 0 ),
+          std::make_tuple( 2, 0 ),
+          std::make_tuple( 1, 1 ) } ) );
+
+  CAPTURE(embedded, fixed_point);
+
+  char name[100];
+  snprintf(name, 100, "rom_embedded_%d_fixed_point_%d_", embedded, fixed_point);
+
+  defines->embedded_mode       = embedded;
+  defines->unroll_enable       = fixed_point;
+  defines->fixed_point_enable  = fixed_point;
+
+  // Setup solver
+  exitflag = osqp_setup(&tmpSolver, data->P, data->q,
+                        data->A, data->l, data->u,
+                        data->m, data->n, settings.get());
+  solver.reset(tmpSolver);
+
+  // Setup correct
+  mu_assert("Setup error!", exitflag == 0);
+
+  exitflag = osqp_codegen(solver.get(), CODEGEN_DIR, name, defines.get());
+
+  // Codegen should work
+  mu_assert("Codegen error!", exitflag == OSQP_NO_ERROR);
+
+  std::ifstream in(std::string(CODEGEN_DIR) + name + "workspace.c");
+  std::string   line;
+  std::smatch   match;
+
+  // Declarations of the arrays, and the total row of the footprint report
+  std::regex decl("^(static )?(OSQP_CODEGEN_ROM const )?(\\w+)\\s+(\\w+)\\[(\\d+)\\]");
+  std::regex total("^ \\*   total\\s+(\\d+)\\s+(\\d+)\\s+(\\d+)\\s+(\\d+)\\s+(\\d+)$");
+
+  // Entries of the declared arrays: ROM float, ROM int, RAM float, RAM int, RAM bytes
+  OSQPInt declared[5] = {0, 0, 0, 0, 0};
+  OSQPInt reported[5] = {-1, -1, -1, -1, -1};
+  std::vector<std::string> rom;
+  std::vector<std::string> ram;
+
+  while (std::getline(in, line)) {
+    if (std::regex_search(line, match, decl)) {
+      bool        is_rom = match[2].matched;
+      std::string type   = match[3];
+      OSQPInt     len    = std::stoi(match[5]);
+
+      mu_assert("const array outside of OSQP_CODEGEN_ROM!",
+                (line.find("const ") == std::string::npos || is_rom));
+
+      if (type == "OSQPFloat" || type == "QDLDL_float") declared[is_rom ? 0 : 2] += len;
+      else if (type == "OSQPInt" || type == "QDLDL_int") declared[is_rom ? 1 : 3] += len;
+      else if (type == "QDLDL_bool")                     declared[4] += len;
+      else if (type == "int32_t")                        declared[4] += 4*len;
+      else if (type == "int64_t")                        declared[4] += 8*len;
+      else FAIL("Unexpected array type " << type);
+
+      (is_rom ? rom : ram).push_back(match[4]);
+    }
+    else if (std::regex_search(line, match, total)) {
+      for (int i = 0; i < 5; i++) reported[i] = std::stoi(match[i+1]);
+    }
+  }
+
+  // The report counts every declared array in its memory
+  for (int i = 0; i < 5; i++) {
+    CAPTURE(i, declared[i], reported[i]);
+    mu_assert("Footprint report does not match the declared arrays!",
+              declared[i] == reported[i]);
+  }
+
+  auto in_rom = [&](const char* array) {
+    return std::find(rom.begin(), rom.end(), std::string(name) + array) != rom.end();
+  };
+  auto in_ram = [&](const char* array) {
+    return std::find(ram.begin(), ram.end(), std::string(name) + array) != ram.end();
+  };
+
+  // The sparsity patterns and the permutation never change
+  mu_assert("P pattern not in ROM!",           in_rom("data_P_csc_i"));
+  mu_assert("A pattern not in ROM!",           in_rom("data_A_csc_i"));
+  mu_assert("KKT pattern not in ROM!",         (embedded == 1 || in_rom("linsys_KKT_i")));
+  mu_assert("KKT permutation not in ROM!",     in_rom("linsys_P"));
+
+  // The values of the matrices, the factors and the scaling only in mode 1,
+  // where the factorization does not write the pattern of L either
+  mu_assert("L pattern in the wrong memory!",  (embedded == 1 ? in_rom("linsys_L_i")   : in_ram("linsys_L_i")));
+  mu_assert("P values in the wrong memory!",   (embedded == 1 ? in_rom("data_P_csc_x") : in_ram("data_P_csc_x")));
+  mu_assert("A values in the wrong memory!",   (embedded == 1 ? in_rom("data_A_csc_x") : in_ram("data_A_csc_x")));
+  mu_assert("L values in the wrong memory!",   (embedded == 1 ? in_rom("linsys_L_x")   : in_ram("linsys_L_x")));
+  mu_assert("Scaling in the wrong memory!",    (embedded == 1 ? in_rom("scaling_D_val") : in_ram("scaling_D_val")));
+
+  // The vectors of the problem and the solution always change
+  mu_assert("q not in RAM!",                   in_ram("data_q_val"));
+  mu_assert("Solution not in RAM!",            in_ram("sol_x"));
+}
+
 TEST_CASE_METHOD(codegen_test_fixture, "Codegen: defines", "[codegen]")
 {
   OSQPInt exitflag;
@@ -373,6 +743,104 @@ TEST_CASE_METHOD(codegen_test_fixture, "Codegen: defines", "[codegen]")
     mu_assert("Non Convex codegen: derivative define should have worked!",
               exitflag == expected_flag);
   }
+
+  SECTION( "codegen define: unroll" ) {
+    OSQPInt test_input;
+    OSQPInt expected_flag;
+    std::tie( test_input, expected_flag ) =
+        GENERATE( table<OSQPInt, OSQPInt>(
+            { /* first is input, second is expected error */
+              std::make_tuple( -1, OSQP_CODEGEN_DEFINES_ERROR ),
+              std::make_tuple(  0, OSQP_NO_ERROR ),
+              std::make_tuple(  1, OSQP_NO_ERROR ),
+              std::make_tuple(  2, OSQP_CODEGEN_DEFINES_ERROR ) } ) );
+
+    defines->unroll_enable = test_input;
+
+    CAPTURE(defines->unroll_enable);
+
+    exitflag = osqp_codegen(solver.get(), CODEGEN_DIR, "defines_unroll_", defines.get());
+
+    // Codegen should work or error as appropriate
+    mu_assert("unroll_enable define should have worked!",
+              exitflag == expected_flag);
+  }
+
+  SECTION( "codegen define: fixed dimensions" ) {
+    OSQPInt test_input;
+    OSQPInt expected_flag;
+    std::tie( test_input, expected_flag ) =
+        GENERATE( table<OSQPInt, OSQPInt>(
+            { /* first is input, second is expected error */
+              std::make_tuple( -1, OSQP_CODEGEN_DEFINES_ERROR ),
+              std::make_tuple(  0, OSQP_NO_ERROR ),
+              std::make_tuple(  1, OSQP_NO_ERROR ),
+              std::make_tuple(  2, OSQP_CODEGEN_DEFINES_ERROR ) } ) );
+
+    defines->fixed_dims_enable = test_input;
+
+    CAPTURE(defines->fixed_dims_enable);
+
+    exitflag = osqp_codegen(solver.get(), CODEGEN_DIR, "defines_fixed_dims_", defines.get());
+
+    // Codegen should work or error as appropriate
+    mu_assert("fixed_dims_enable define should have worked!",
+              exitflag == expected_flag);
+  }
+
+  SECTION( "codegen define: rho ladder" ) {
+    OSQPInt test_input;
+    OSQPInt embedded;
+    OSQPInt expected_flag;
+    std::tie( test_input, embedded, expected_flag ) =
+        GENERATE( table<OSQPInt, OSQPInt, OSQPInt>(
+            { /* first is input, second is embedded mode, third is expected error */
+              std::make_tuple( -1, 1, OSQP_CODEGEN_DEFINES_ERROR ),
+              std::make_tuple(  0, 1, OSQP_NO_ERROR ),
+              std::make_tuple(  1, 1, OSQP_CODEGEN_DEFINES_ERROR ),
+              std::make_tuple(  5, 1, OSQP_NO_ERROR ),
+              std::make_tuple(  0, 2, OSQP_NO_ERROR ),
+              std::make_tuple(  5, 2, OSQP_CODEGEN_DEFINES_ERROR ) } ) );
+
+    defines->rho_ladder_size = test_input;
+    defines->embedded_mode   = embedded;
+
+    CAPTURE(defines->rho_ladder_size, defines->embedded_mode);
+
+    exitflag = osqp_codegen(solver.get(), CODEGEN_DIR, "defines_rho_ladder_", defines.get());
+
+    // Codegen should work or error as appropriate
+    mu_assert("rho_ladder_size define should have worked!",
+              exitflag == expected_flag);
+  }
+
+  SECTION( "codegen define: fixed point" ) {
+    OSQPInt test_input;
+    OSQPInt unroll;
+    OSQPInt embedded;
+    OSQPInt expected_flag;
+    std::tie( test_input, unroll, embedded, expected_flag ) =
+        GENERATE( table<OSQPInt, OSQPInt, OSQPInt, OSQPInt>(
+            { /* first is input, second is unroll, third is embedded mode, fourth is expected error */
+              std::make_tuple( -1, 1, 1, OSQP_CODEGEN_DEFINES_ERROR ),
+              std::make_tuple(  0, 0, 1, OSQP_NO_ERROR ),
+              std::make_tuple(  1, 1, 1, OSQP_NO_ERROR ),
+              std::make_tuple(  1, 0, 1, OSQP_CODEGEN_DEFINES_ERROR ),
+              std::make_tuple(  1, 1, 2, OSQP_CODEGEN_DEFINES_ERROR ),
+              std::make_tuple(  2, 1, 1, OSQP_CODEGEN_DEFINES_ERROR ) } ) );
+
+    defines->fixed_point_enable = test_input;
+    defines->unroll_enable      = unroll;
+    defines->embedded_mode      = embedded;
+
+    CAPTURE(defines->fixed_point_enable, defines->unroll_enable, defines->embedded_mode);
+
+    exitflag = osqp_codegen(solver.get(), CODEGEN_DIR, "defines_fixed_point_", defines.get());
+
+    // Codegen should work or error as appropriate
+    mu_assert("fixed_point_enable define should have worked!",
+              exitflag == expected_flag);
+  }
 }
 
 TEST_CASE_METHOD(codegen_test_fixture, "Codegen: Error propgatation", "[codegen]")
@@ -564,6 +1032,193 @@ TEST_CASE_METHOD(codegen_test_fixture, "Codegen: Settings", "[codegen],[settings
     mu_assert("rho_is_vec not handled properly!",
               exitflag == OSQP_NO_ERROR);
   }
+
+  // unrolled kernels replace the products and the KKT solve in the workspace
+  SECTION( "unroll_enable define" ) {
+    OSQPInt rho_is_vec = GENERATE(0, 1);
+    OSQPInt embedded;
+    std::string dir;
+
+    std::tie( embedded, dir ) =
+      GENERATE( table<OSQPInt, std::string>(
+          { /* first is embedded mode, second is output directory */
+            std::make_tuple( 1, CODEGEN1_DIR ),
+            std::make_tuple( 2, CODEGEN2_DIR ) } ) );
+
+    char name[100];
+    snprintf(name, 100, "unroll_rho_is_vec_%d_embedded_%d_", rho_is_vec, embedded);
+
+    CAPTURE(embedded, rho_is_vec);
+
+    settings->rho_is_vec   = rho_is_vec;
+    defines->embedded_mode = embedded;
+    defines->unroll_enable = 1;
+
+    // Setup solver
+    exitflag = osqp_setup(&tmpSolver, data->P, data->q,
+                          data->A, data->l, data->u,
+                          data->m, data->n, settings.get());
+    solver.reset(tmpSolver);
+
+    // Setup correct
+    mu_assert("Setup error!", exitflag == 0);
+
+    exitflag = osqp_codegen(solver.get(), dir.c_str(), name, defines.get());
+
+    // Codegen should work
+    mu_assert("unroll_enable not handled properly!",
+              exitflag == OSQP_NO_ERROR);
+  }
+
+  // Embedded mode 1 adapts rho along the precomputed factorizations
+  SECTION( "rho_ladder_size define" ) {
+    OSQPInt rho_is_vec = GENERATE(0, 1);
+
+    char name[100];
+    snprintf(name, 100, "rho_ladder_rho_is_vec_%d_", rho_is_vec);
+
+    CAPTURE(rho_is_vec);
+
+    settings->rho_is_vec     = rho_is_vec;
+    defines->embedded_mode   = 1;
+    defines->rho_ladder_size = 5;
+
+    // Setup solver
+    exitflag = osqp_setup(&tmpSolver, data->P, data->q,
+                          data->A, data->l, data->u,
+                          data->m, data->n, settings.get());
+    solver.reset(tmpSolver);
+
+    // Setup correct
+    mu_assert("Setup error!", exitflag == 0);
+
+    OSQPFloat rho = solver->settings->rho;
+
+    exitflag = osqp_codegen(solver.get(), CODEGEN1_DIR, name, defines.get());
+
+    // Codegen should work and leave the solver at its rho
+    mu_assert("rho_ladder_size not handled properly!",
+              exitflag == OSQP_NO_ERROR);
+    mu_assert("rho_ladder_size changed rho!",
+              solver->settings->rho == rho);
+
+    // Every rho of the ladder has the rho_vec and rho_inv_vec of the solver
+    // at that rho, including the current one after switching away and back
+    if (rho_is_vec) {
+      std::string file   = std::string(CODEGEN1_DIR) + name + "workspace.c";
+      std::string prefix = std::string(name) + "rho_ladder";
+      std::vector<OSQPFloat> ladder = read_codegen_vecf(file, prefix);
+      std::vector<OSQPFloat> rho_vec;
+      std::vector<OSQPFloat> rho_inv_vec;
+      OSQPInt m = data->m;
+
+      mu_assert("rho ladder not written!", ladder.size() > 1);
+
+      for (size_t i = 0; i <= ladder.size(); i++) {
+        // Move away from rho along the ladder, then back to it
+        OSQPFloat rho_i = (i < ladder.size()) ? ladder[i] : rho;
+        size_t    k     = 0;
+
+        while (k < ladder.size() - 1 && ladder[k] != rho_i) k++;
+
+        rho_vec     = read_codegen_vecf(file, prefix + "_rho_vec_" + std::to_string(k));
+        rho_inv_vec = read_codegen_vecf(file, prefix + "_rho_inv_vec_" + std::to_string(k));
+
+        exitflag = osqp_update_rho(solver.get(), rho_i);
+        mu_assert("Update rho error!", exitflag == OSQP_NO_ERROR);
+
+        CAPTURE(i, k);
+        mu_assert("Wrong number of rho_vec values!",
+                  (rho_vec.size() == (size_t)m && rho_inv_vec.size() == (size_t)m));
+        mu_assert("Wrong rho_vec on the ladder!",
+                  vec_norm_inf_diff(rho_vec.data(), OSQPVectorf_data(solver->work->rho_vec), m) < TESTS_TOL * rho_i);
+        mu_assert("Wrong rho_inv_vec on the ladder!",
+                  vec_norm_inf_diff(rho_inv_vec.data(), OSQPVectorf_data(solver->work->rho_inv_vec), m) < TESTS_TOL / rho_i);
+      }
+    }
+  }
+
+  // The library of a configuration with fixed dimensions only runs workspaces
+  // of that size, so every embedded mode gets a directory of its own
+  SECTION( "fixed_dims_enable define" ) {
+    OSQPInt embedded;
+    std::string dir;
+
+    std::tie( embedded, dir ) =
+      GENERATE( table<OSQPInt, std::string>(
+          { /* first is embedded mode, second is output directory */
+            std::make_tuple( 1, CODEGEN_FIXED_DIMS1_DIR ),
+            std::make_tuple( 2, CODEGEN_FIXED_DIMS2_DIR ) } ) );
+
+    CAPTURE(embedded);
+
+    defines->embedded_mode     = embedded;
+    defines->fixed_dims_enable = 1;
+
+    // Setup solver
+    exitflag = osqp_setup(&tmpSolver, data->P, data->q,
+                          data->A, data->l, data->u,
+                          data->m, data->n, settings.get());
+    solver.reset(tmpSolver);
+
+    // Setup correct
+    mu_assert("Setup error!", exitflag == 0);
+
+    exitflag = osqp_codegen(solver.get(), dir.c_str(), "fixed_dims_", defines.get());
+
+    // Codegen should work
+    mu_assert("fixed_dims_enable not handled properly!",
+              exitflag == OSQP_NO_ERROR);
+  }
+}
+
+// With n = 2 and m = 5 the vector loops get no block to unroll, and the
+// generated library must still solve the problem
+TEST_CASE_METHOD(basic_qp2_test_fixture, "Codegen: Coprime fixed dimensions", "[codegen]")
+{
+  OSQPInt exitflag;
+  OSQPInt embedded;
+  std::string dir;
+
+  std::tie( embedded, dir ) =
+    GENERATE( table<OSQPInt, std::string>(
+        { /* first is embedded mode, second is output directory */
+          std::make_tuple( 1, CODEGEN_COPRIME_DIMS1_DIR ),
+          std::make_tuple( 2, CODEGEN_COPRIME_DIMS2_DIR ) } ) );
+
+  CAPTURE(embedded);
+
+  // Codegen defines
+  OSQPCodegenDefines_ptr defines{(OSQPCodegenDefines *)c_malloc(sizeof(OSQPCodegenDefines))};
+
+  // Define codegen settings
+  osqp_set_default_codegen_defines(defines.get());
+  defines->embedded_mode     = embedded;
+  defines->fixed_dims_enable = 1;
+
+  // Embedded mode 1 keeps rho fixed, at a value that converges for this problem
+  settings->rho = 1.0;
+
+  // Setup solver
+  exitflag = osqp_setup(&tmpSolver, data->P, data->q,
+                        data->A, data->l, data->u,
+                        data->m, data->n, settings.get());
+  solver.reset(tmpSolver);
+
+  // Setup correct
+  mu_assert("Setup error!", exitflag == 0);
+
+  exitflag = osqp_codegen(solver.get(), dir.c_str(), "fixed_dims_", defines.get());
+
+  // Codegen should work
+  mu_assert("fixed_dims_enable not handled properly!",
+            exitflag == OSQP_NO_ERROR);
+
+  std::ifstream in(dir + "osqp_configure.h");
+  std::string   config((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+  mu_assert("Coprime dimensions should give blocks of one entry!",
+            config.find("#define OSQP_CODEGEN_BLOCK 1\n") != std::string::npos);
 }
 
 #endif
@@ -36,3 +36,500 @@ TEST_CASE_METHOD(OSQPTestFixture, "Large QP solve", "[solve],[qp]")
   mu_assert("Large QP test solve: Error in objective value!",
             c_absval(solver->info->obj_val - prob1_obj_val)/(c_absval(prob1_obj_val)) < TESTS_TOL);
 }
+
+TEST_CASE_METHOD(OSQPTestFixture, "Large QP: Dense rows and columns", "[solve],[qp]")
+{
+  OSQPInt exitflag;
+  OSQPInt i, j, k, nz;
+  OSQPInt g, d, stride, split;
+
+  /* Grid Laplacian cost, box constraints, dense rows and one dense column.
+   * Rows touching a ninth of the variables of a small grid stay in the KKT
+   * matrix, while keeping a budget row over all the variables of a larger
+   * grid out gives a smaller factor. */
+  std::tie( g, d, stride, split ) =
+    GENERATE( table<OSQPInt, OSQPInt, OSQPInt, OSQPInt>(
+        { /* grid size, dense rows, stride of their entries, split expected */
+          std::make_tuple( 30, 6, 9, 0 ),
+          std::make_tuple( 60, 1, 1, 1 ) } ) );
+
+  const OSQPInt n = g * g;
+  const OSQPInt m = n + d;
+
+  std::unique_ptr<OSQPFloat[]> P_x(new OSQPFloat[3*n]);
+  std::unique_ptr<OSQPInt[]>   P_i(new OSQPInt[3*n]);
+  std::unique_ptr<OSQPInt[]>   P_p(new OSQPInt[n+1]);
+  std::unique_ptr<OSQPFloat[]> A_x(new OSQPFloat[n*(d+2)]);
+  std::unique_ptr<OSQPInt[]>   A_i(new OSQPInt[n*(d+2)]);
+  std::unique_ptr<OSQPInt[]>   A_p(new OSQPInt[n+1]);
+  std::unique_ptr<OSQPFloat[]> q(new OSQPFloat[n]);
+  std::unique_ptr<OSQPFloat[]> l(new OSQPFloat[m]);
+  std::unique_ptr<OSQPFloat[]> u(new OSQPFloat[m]);
+
+  nz = 0;
+  for (j = 0; j < n; j++) {
+    P_p[j] = nz;
+    if (j >= g)    { P_i[nz] = j - g; P_x[nz++] = -1.0; }
+    if (j % g)     { P_i[nz] = j - 1; P_x[nz++] = -1.0; }
+    P_i[nz] = j; P_x[nz++] = 4.0;
+  }
+  P_p[n] = nz;
+
+  nz = 0;
+  for (j = 0; j < n; j++) {
+    A_p[j] = nz;
+    A_i[nz] = j; A_x[nz++] = 1.0;
+
+    // The first variable couples every third box constraint
+    if (j == 0) {
+      for (i = 3; i < n; i += 3) { A_i[nz] = i; A_x[nz++] = 0.5; }
+    }
+
+    // Each dense row touches one in stride of the variables
+    for (k = 0; k < d; k++) {
+      if ((j * 7 + k * 31) % stride == 0) { A_i[nz] = n + k; A_x[nz++] = 1.0 + 0.1*k; }
+    }
+  }
+  A_p[n] = nz;
+
+  for (j = 0; j < n; j++) {
+    q[j] = (OSQPFloat)(j % 5) - 2.0;
+    l[j] = -1.0;
+    u[j] =  1.0;
+  }
+  for (k = 0; k < d; k++) {
+    l[n + k] = -2.0;
+    u[n + k] =  2.0;
+  }
+
+  OSQPCscMatrix Pmat;
+  OSQPCscMatrix Amat;
+
+  csc_set_data(&Pmat, n, n, P_p[n], P_x.get(), P_i.get(), P_p.get());
+  csc_set_data(&Amat, m, n, A_p[n], A_x.get(), A_i.get(), A_p.get());
+
+  // Test-specific options
+  settings->linsys_solver = OSQP_DIRECT_SOLVER;
+  settings->polishing     = GENERATE(0, 1);
+  settings->split_bounds  = GENERATE(0, 1);
+  settings->eps_abs       = 1e-6;
+  settings->eps_rel       = 1e-6;
+
+  CAPTURE(g, d, settings->polishing, settings->split_bounds);
+
+  // Reference solver factoring the full KKT matrix
+  OSQPSolver_ptr refSolver{nullptr};
+
+  exitflag = osqp_setup(&tmpSolver, &Pmat, q.get(), &Amat, l.get(), u.get(), m, n, settings.get());
+  refSolver.reset(tmpSolver);
+  mu_assert("Large QP test dense: Reference setup error!", exitflag == 0);
+
+  // Setup solver with the dense rows and columns out of the KKT matrix
+  settings->split_dense = 1;
+
+  exitflag = osqp_setup(&tmpSolver, &Pmat, q.get(), &Amat, l.get(), u.get(), m, n, settings.get());
+  solver.reset(tmpSolver);
+  mu_assert("Large QP test dense: Setup error!", exitflag == 0);
+
+  // Without the fill from the backend the split is always kept
+  if (solver->work->dense.fill_full < 0) split = 1;
+
+  CAPTURE(solver->work->dense.fill, solver->work->dense.fill_full);
+
+  // The dense rows and the dense column are kept out with a smaller factor,
+  // or all of them stay in
+  if (split) {
+    mu_assert("Large QP test dense: Error in dense rows and columns!",
+              (solver->work->dense.n_rows == d && solver->work->dense.n_cols == 1));
+    mu_assert("Large QP test dense: Error in factor fill!",
+              (solver->work->dense.fill < solver->work->dense.fill_full ||
+               solver->work->dense.fill_full < 0));
+  }
+  else {
+    mu_assert("Large QP test dense: Error in dense rows and columns!",
+              (solver->work->dense.n_rows == 0 && solver->work->dense.n_cols == 0));
+    mu_assert("Large QP test dense: Error in declined rows and columns!",
+              solver->work->dense.declined == d + 1);
+  }
+
+  osqp_solve(refSolver.get());
+  osqp_solve(solver.get());
+
+  mu_assert("Large QP test dense: Error in solver status!",
+            solver->info->status_val == OSQP_SOLVED);
+
+  mu_assert("Large QP test dense: Error in primal solution!",
+            vec_norm_inf_diff(solver->solution->x, refSolver->solution->x, n) < TESTS_TOL);
+
+  mu_assert("Large QP test dense: Error in dual solution!",
+            vec_norm_inf_diff(solver->solution->y, refSolver->solution->y, m) < TESTS_TOL);
+
+  mu_assert("Large QP test dense: Error in objective value!",
+            c_absval(solver->info->obj_val - refSolver->info->obj_val) < TESTS_TOL);
+
+  SECTION( "Matrix update" ) {
+    // Scale all constraints, which changes the dense rows and column as well
+    for (k = 0; k < A_p[n]; k++) A_x[k] *= 2.0;
+
+    osqp_update_data_mat(refSolver.get(), OSQP_NULL, OSQP_NULL, 0, A_x.get(), OSQP_NULL, A_p[n]);
+    exitflag = osqp_update_data_mat(solver.get(), OSQP_NULL, OSQP_NULL, 0, A_x.get(), OSQP_NULL, A_p[n]);
+    mu_assert("Large QP test dense: Error in matrix update!", exitflag == 0);
+
+    osqp_solve(refSolver.get());
+    osqp_solve(solver.get());
+
+    mu_assert("Large QP test dense: Error in updated primal solution!",
+              vec_norm_inf_diff(solver->solution->x, refSolver->solution->x, n) < TESTS_TOL);
+
+    mu_assert("Large QP test dense: Error in updated dual solution!",
+              vec_norm_inf_diff(solver->solution->y, refSolver->solution->y, m) < TESTS_TOL);
+
+    mu_assert("Large QP test dense: Error in updated objective value!",
+              c_absval(solver->info->obj_val - refSolver->info->obj_val) < TESTS_TOL);
+  }
+
+  SECTION( "Rho update" ) {
+    // Refactor the inner matrix and the coupling with a new rho
+    osqp_update_rho(refSolver.get(), 1.0);
+    exitflag = osqp_update_rho(solver.get(), 1.0);
+    mu_assert("Large QP test dense: Error in rho update!", exitflag == 0);
+
+    osqp_solve(refSolver.get());
+    osqp_solve(solver.get());
+
+    mu_assert("Large QP test dense: Error in primal solution after rho update!",
+              vec_norm_inf_diff(solver->solution->x, refSolver->solution->x, n) < TESTS_TOL);
+
+    mu_assert("Large QP test dense: Error in dual solution after rho update!",
+              vec_norm_inf_diff(solver->solution->y, refSolver->solution->y, m) < TESTS_TOL);
+
+    mu_assert("Large QP test dense: Error in objective value after rho update!",
+              c_absval(solver->info->obj_val - refSolver->info->obj_val) < TESTS_TOL);
+  }
+}
+
+TEST_CASE_METHOD(OSQPTestFixture, "Large QP: Riccati solver", "[solve],[qp]")
+{
+  OSQPInt exitflag;
+  OSQPInt c, j, k, r, nz;
+
+  /* Double integrator MPC with the stages (u_k, x_k+1) */
+  const OSQPInt   T  = 20;
+  const OSQPInt   n  = 3 * T;
+  const OSQPInt   m  = 3 * T;
+  const OSQPFloat dt = 0.1;
+
+  const OSQPFloat Ad[2][2] = { { 1.0, dt, }, { 0.0, 1.0, }, };
+  const OSQPFloat Bd[2]    = { 0.5 * dt * dt, dt, };
+  const OSQPFloat x0[2]    = { 1.0, 0.0, };
+
+  std::unique_ptr<OSQPFloat[]> P_x(new OSQPFloat[2*n]);
+  std::unique_ptr<OSQPInt[]>   P_i(new OSQPInt[2*n]);
+  std::unique_ptr<OSQPInt[]>   P_p(new OSQPInt[n+1]);
+  std::unique_ptr<OSQPFloat[]> A_x(new OSQPFloat[4*n]);
+  std::unique_ptr<OSQPInt[]>   A_i(new OSQPInt[4*n]);
+  std::unique_ptr<OSQPInt[]>   A_p(new OSQPInt[n+1]);
+  std::unique_ptr<OSQPFloat[]> q(new OSQPFloat[n]);
+  std::unique_ptr<OSQPFloat[]> l(new OSQPFloat[m]);
+  std::unique_ptr<OSQPFloat[]> u(new OSQPFloat[m]);
+  std::unique_ptr<OSQPInt[]>   stage_n(new OSQPInt[n]);
+
+  // Dynamics rows 2k, 2k+1 and input bound rows 2T+k
+  nz = 0;
+  for (k = 0; k < T; k++) {
+    // u_k, coupled in the cost with the velocity of the previous stage
+    j = 3 * k;
+    P_p[j] = nz;
+    if (k > 0) { P_i[nz] = j - 1; P_x[nz++] = 0.05; }
+    P_i[nz] = j; P_x[nz++] = 0.5;
+
+    // x_k+1
+    for (c = 0; c < 2; c++) {
+      P_p[j + 1 + c] = nz;
+      if (c == 0) { P_i[nz] = j; P_x[nz++] = 0.05; }
+      P_i[nz] = j + 1 + c; P_x[nz++] = (k == T - 1) ? 10.0 : 1.0;
+    }
+  }
+  P_p[n] = nz;
+
+  nz = 0;
+  for (k = 0; k < T; k++) {
+    j = 3 * k;
+    A_p[j] = nz;
+    for (r = 0; r < 2; r++) { A_i[nz] = 2*k + r; A_x[nz++] = -Bd[r]; }
+    A_i[nz] = 2*T + k; A_x[nz++] = 1.0;
+
+    for (c = 0; c < 2; c++) {
+      A_p[j + 1 + c] = nz;
+      A_i[nz] = 2*k + c; A_x[nz++] = 1.0;
+      if (k < T - 1) {
+        for (r = 0; r < 2; r++) { A_i[nz] = 2*(k + 1) + r; A_x[nz++] = -Ad[r][c]; }
+      }
+    }
+  }
+  A_p[n] = nz;
+
+  for (j = 0; j < n; j++) q[j] = 0.0;
+  for (r = 0; r < 2*T; r++) {
+    l[r] = (r < 2) ? Ad[r][0] * x0[0] + Ad[r][1] * x0[1] : 0.0;
+    u[r] = l[r];
+  }
+  for (k = 0; k < T; k++) {
+    l[2*T + k] = -1.0;
+    u[2*T + k] =  0.5;
+    stage_n[k] = 3;
+  }
+
+  OSQPCscMatrix Pmat;
+  OSQPCscMatrix Amat;
+
+  csc_set_data(&Pmat, n, n, P_p[n], P_x.get(), P_i.get(), P_p.get());
+  csc_set_data(&Amat, m, n, A_p[n], A_x.get(), A_i.get(), A_p.get());
+
+  // Test-specific options
+  settings->polishing  = GENERATE(0, 1);
+  settings->rho_is_vec = GENERATE(0, 1);
+  settings->eps_abs    = 1e-6;
+  settings->eps_rel    = 1e-6;
+
+  CAPTURE(settings->polishing, settings->rho_is_vec);
+
+  // Reference solver with the default linear system solver
+  OSQPSolver_ptr refSolver{nullptr};
+
+  exitflag = osqp_setup_stages(&tmpSolver, &Pmat, q.get(), &Amat, l.get(), u.get(), m, n,
+                               settings.get(), T, stage_n.get());
+  refSolver.reset(tmpSolver);
+  mu_assert("Large QP test Riccati: Reference setup error!", exitflag == 0);
+
+  settings->linsys_solver = OSQP_RICCATI_SOLVER;
+  tmpSolver = nullptr;
+
+  // The Riccati solver needs the stages
+  exitflag = osqp_setup(&tmpSolver, &Pmat, q.get(), &Amat, l.get(), u.get(), m, n, settings.get());
+  solver.reset(tmpSolver);
+  mu_assert("Large QP test Riccati: Setup without stages should fail!",
+            exitflag == OSQP_SETTINGS_VALIDATION_ERROR);
+
+  // The stages must hold all the variables
+  for (k = 0; k < 3*T/2; k++) stage_n[k] = 2;
+  exitflag = osqp_setup_stages(&tmpSolver, &Pmat, q.get(), &Amat, l.get(), u.get(), m, n,
+                               settings.get(), T, stage_n.get());
+  solver.reset(tmpSolver);
+  mu_assert("Large QP test Riccati: Setup with wrong stage sizes should fail!",
+            exitflag == OSQP_DATA_VALIDATION_ERROR);
+
+  // Stages of two variables make the dynamics couple nonconsecutive stages
+  exitflag = osqp_setup_stages(&tmpSolver, &Pmat, q.get(), &Amat, l.get(), u.get(), m, n,
+                               settings.get(), 3*T/2, stage_n.get());
+  solver.reset(tmpSolver);
+  mu_assert("Large QP test Riccati: Setup with a wrong stage structure should fail!",
+            exitflag == OSQP_DATA_VALIDATION_ERROR);
+
+  // Setup solver
+  for (k = 0; k < T; k++) stage_n[k] = 3;
+  exitflag = osqp_setup_stages(&tmpSolver, &Pmat, q.get(), &Amat, l.get(), u.get(), m, n,
+                               settings.get(), T, stage_n.get());
+  solver.reset(tmpSolver);
+  mu_assert("Large QP test Riccati: Setup error!", exitflag == 0);
+
+  osqp_solve(refSolver.get());
+  osqp_solve(solver.get());
+
+  mu_assert("Large QP test Riccati: Error in solver status!",
+            solver->info->status_val == OSQP_SOLVED);
+
+  mu_assert("Large QP test Riccati: Error in primal solution!",
+            vec_norm_inf_diff(solver->solution->x, refSolver->solution->x, n) < TESTS_TOL);
+
+  mu_assert("Large QP test Riccati: Error in dual solution!",
+            vec_norm_inf_diff(solver->solution->y, refSolver->solution->y, m) < TESTS_TOL);
+
+  mu_assert("Large QP test Riccati: Error in objective value!",
+            c_absval(solver->info->obj_val - refSolver->info->obj_val) < TESTS_TOL);
+
+  SECTION( "Rho update" ) {
+    osqp_update_rho(refSolver.get(), 1.0);
+    exitflag = osqp_update_rho(solver.get(), 1.0);
+    mu_assert("Large QP test Riccati: Error in rho update!", exitflag == 0);
+
+    osqp_solve(refSolver.get());
+    osqp_solve(solver.get());
+
+    mu_assert("Large QP test Riccati: Error in primal solution after rho update!",
+              vec_norm_inf_diff(solver->solution->x, refSolver->solution->x, n) < TESTS_TOL);
+  }
+
+  SECTION( "Matrix update" ) {
+    // Double the input gain and the input weight
+    for (k = 0; k < T; k++) {
+      A_x[A_p[3*k]]     *= 2.0;
+      A_x[A_p[3*k] + 1] *= 2.0;
+      P_x[P_p[3*k + 1] - 1] *= 2.0;
+    }
+
+    osqp_update_data_mat(refSolver.get(), P_x.get(), OSQP_NULL, P_p[n], A_x.get(), OSQP_NULL, A_p[n]);
+    exitflag = osqp_update_data_mat(solver.get(), P_x.get(), OSQP_NULL, P_p[n], A_x.get(), OSQP_NULL, A_p[n]);
+    mu_assert("Large QP test Riccati: Error in matrix update!", exitflag == 0);
+
+    osqp_solve(refSolver.get());
+    osqp_solve(solver.get());
+
+    mu_assert("Large QP test Riccati: Error in updated primal solution!",
+              vec_norm_inf_diff(solver->solution->x, refSolver->solution->x, n) < TESTS_TOL);
+
+    mu_assert("Large QP test Riccati: Error in updated objective value!",
+              c_absval(solver->info->obj_val - refSolver->info->obj_val) < TESTS_TOL);
+  }
+}
+
+TEST_CASE_METHOD(OSQPTestFixture, "Large QP: Independent components", "[solve],[qp]")
+{
+  OSQPInt exitflag;
+  OSQPInt b, g, j, nz, m_out, n_out;
+
+  /* K chains with interleaved variables, a free variable and an empty row */
+  const OSQPInt K  = 4;
+  const OSQPInt nb = 40;
+  const OSQPInt n  = K * nb + 1;
+  const OSQPInt m  = K * nb + K + 1;
+
+  std::unique_ptr<OSQPFloat[]> P_x(new OSQPFloat[2*n]);
+  std::unique_ptr<OSQPInt[]>   P_i(new OSQPInt[2*n]);
+  std::unique_ptr<OSQPInt[]>   P_p(new OSQPInt[n+1]);
+  std::unique_ptr<OSQPFloat[]> A_x(new OSQPFloat[2*n]);
+  std::unique_ptr<OSQPInt[]>   A_i(new OSQPInt[2*n]);
+  std::unique_ptr<OSQPInt[]>   A_p(new OSQPInt[n+1]);
+  std::unique_ptr<OSQPFloat[]> q(new OSQPFloat[n]);
+  std::unique_ptr<OSQPFloat[]> l(new OSQPFloat[m]);
+  std::unique_ptr<OSQPFloat[]> u(new OSQPFloat[m]);
+
+  // Variable j of chain b is g = j*K + b, with the box row g and the sum row K*nb + b
+  nz = 0;
+  for (g = 0; g < K * nb; g++) {
+    b = g % K;
+    j = g / K;
+    P_p[g] = nz;
+    if (j > 0) { P_i[nz] = g - K; P_x[nz++] = -1.0; }
+    P_i[nz] = g; P_x[nz++] = 2.0 + 0.1 * b;
+    q[g] = 0.3 * ((7 * g) % 11 - 5);
+  }
+  P_p[K * nb] = nz;
+  P_i[nz] = K * nb; P_x[nz++] = 1.0;
+  q[K * nb] = -0.5;
+  P_p[n] = nz;
+
+  nz = 0;
+  for (g = 0; g < K * nb; g++) {
+    A_p[g] = nz;
+    A_i[nz] = g;              A_x[nz++] = 1.0;
+    A_i[nz] = K * nb + g % K; A_x[nz++] = 1.0;
+    l[g] = -1.0;
+    u[g] =  1.0;
+  }
+  A_p[K * nb] = nz;
+  A_p[n]      = nz;
+  for (b = 0; b < K; b++) {
+    l[K * nb + b] = 1.0 + b;
+    u[K * nb + b] = OSQP_INFTY;
+  }
+  l[m - 1] = -1.0;
+  u[m - 1] =  1.0;
+
+  OSQPCscMatrix Pmat;
+  OSQPCscMatrix Amat;
+
+  csc_set_data(&Pmat, n, n, P_p[n], P_x.get(), P_i.get(), P_p.get());
+  csc_set_data(&Amat, m, n, A_p[n], A_x.get(), A_i.get(), A_p.get());
+
+  // Test-specific options
+  settings->polishing  = GENERATE(0, 1);
+  settings->rho_is_vec = GENERATE(0, 1);
+  settings->eps_abs    = 1e-6;
+  settings->eps_rel    = 1e-6;
+
+  CAPTURE(settings->polishing, settings->rho_is_vec);
+
+  // Reference solver on the full problem
+  OSQPSolver_ptr refSolver{nullptr};
+
+  exitflag = osqp_setup(&tmpSolver, &Pmat, q.get(), &Amat, l.get(), u.get(), m, n, settings.get());
+  refSolver.reset(tmpSolver);
+  mu_assert("Large QP test components: Reference setup error!", exitflag == 0);
+
+  // Setup solver
+  settings->split_components = 1;
+  exitflag = osqp_setup(&tmpSolver, &Pmat, q.get(), &Amat, l.get(), u.get(), m, n, settings.get());
+  solver.reset(tmpSolver);
+  mu_assert("Large QP test components: Setup error!", exitflag == 0);
+
+  osqp_get_dimensions(solver.get(), &m_out, &n_out);
+  mu_assert("Large QP test components: Error in problem dimensions!",
+            ((m_out == m) && (n_out == n)));
+
+  osqp_solve(refSolver.get());
+  osqp_solve(solver.get());
+
+  mu_assert("Large QP test components: Error in solver status!",
+            solver->info->status_val == OSQP_SOLVED);
+
+  mu_assert("Large QP test components: Error in primal solution!",
+            vec_norm_inf_diff(solver->solution->x, refSolver->solution->x, n) < TESTS_TOL);
+
+  mu_assert("Large QP test components: Error in dual solution!",
+            vec_norm_inf_diff(solver->solution->y, refSolver->solution->y, m) < TESTS_TOL);
+
+  mu_assert("Large QP test components: Error in objective value!",
+            c_absval(solver->info->obj_val - refSolver->info->obj_val) < TESTS_TOL);
+
+  SECTION( "Vector update" ) {
+    // Flip the linear cost and tighten the sum rows
+    for (g = 0; g < n; g++) q[g] = -q[g];
+    for (b = 0; b < K; b++) l[K * nb + b] += 0.5;
+
+    osqp_update_data_vec(refSolver.get(), q.get(), l.get(), OSQP_NULL);
+    exitflag = osqp_update_data_vec(solver.get(), q.get(), l.get(), OSQP_NULL);
+    mu_assert("Large QP test components: Error in vector update!", exitflag == 0);
+
+    osqp_solve(refSolver.get());
+    osqp_solve(solver.get());
+
+    mu_assert("Large QP test components: Error in updated primal solution!",
+              vec_norm_inf_diff(solver->solution->x, refSolver->solution->x, n) < TESTS_TOL);
+
+    mu_assert("Large QP test components: Error in updated dual solution!",
+              vec_norm_inf_diff(solver->solution->y, refSolver->solution->y, m) < TESTS_TOL);
+  }
+
+  SECTION( "Matrix update" ) {
+    // Scale the diagonal of P and the sum row of the second chain
+    std::unique_ptr<OSQPFloat[]> Px_new(new OSQPFloat[n]);
+    std::unique_ptr<OSQPInt[]>   Px_new_idx(new OSQPInt[n]);
+    std::unique_ptr<OSQPFloat[]> Ax_new(new OSQPFloat[nb]);
+    std::unique_ptr<OSQPInt[]>   Ax_new_idx(new OSQPInt[nb]);
+
+    for (g = 0; g < n; g++) {
+      Px_new_idx[g] = P_p[g + 1] - 1;
+      Px_new[g]     = 1.5 * P_x[P_p[g + 1] - 1];
+    }
+    for (j = 0; j < nb; j++) {
+      Ax_new_idx[j] = A_p[j * K + 1] + 1;
+      Ax_new[j]     = 2.0;
+    }
+
+    osqp_update_data_mat(refSolver.get(), Px_new.get(), Px_new_idx.get(), n,
+                         Ax_new.get(), Ax_new_idx.get(), nb);
+    exitflag = osqp_update_data_mat(solver.get(), Px_new.get(), Px_new_idx.get(), n,
+                                    Ax_new.get(), Ax_new_idx.get(), nb);
+    mu_assert("Large QP test components: Error in matrix update!", exitflag == 0);
+
+    osqp_solve(refSolver.get());
+    osqp_solve(solver.get());
+
+    mu_assert("Large QP test components: Error in updated primal solution!",
+              vec_norm_inf_diff(solver->solution->x, refSolver->solution->x, n) < TESTS_TOL);
+
+    mu_assert("Large QP test components: Error in updated objective value!",
+              c_absval(solver->info->obj_val - refSolver->info->obj_val) < TESTS_TOL);
+  }
+}
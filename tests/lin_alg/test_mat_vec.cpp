@@ -68,6 +68,49 @@ TEST_CASE("Matrix-vector: multiplication", "[mat-vec][operation]") {
   OSQPVectorf_norm_inf_diff(result.get(), ref.get()) < TESTS_TOL);
 }
 
+TEST_CASE("Matrix-vector: Symmetric multiplication with both triangles", "[mat-vec][operation]") {
+  lin_alg_sols_data_ptr data{generate_problem_lin_alg_sols_data()};
+
+  // Import data
+  OSQPMatrix_ptr  Pu{OSQPMatrix_new_from_csc(data->test_mat_vec_Pu, 1)};   //symmetric
+  OSQPVectorf_ptr x{OSQPVectorf_new(data->test_mat_vec_x, data->test_mat_vec_n)};
+
+  OSQPVectorf_ptr ref{nullptr};
+  OSQPVectorf_ptr result{nullptr};
+
+  mu_assert("Linear algebra tests: error in forming both triangles of P",
+            OSQPMatrix_init_symm_full(Pu.get()) == 0);
+
+  // Symmetric-matrix-vector multiplication
+  ref.reset(OSQPVectorf_new(data->test_mat_vec_Px, data->test_mat_vec_n));
+  result.reset(OSQPVectorf_malloc(data->test_mat_vec_n));
+
+  OSQPMatrix_Axpy(Pu.get(), x.get(), result.get(), 1.0, 0.0);
+  mu_assert(
+    "Linear algebra tests: error in matrix-vector operation, full symmetric matrix-vector multiplication",
+    OSQPVectorf_norm_inf_diff(result.get(), ref.get()) < TESTS_TOL);
+
+  // Cumulative symmetric-matrix-vector multiplication x += Px
+  ref.reset(OSQPVectorf_new(data->test_mat_vec_Px_cum, data->test_mat_vec_n));
+  result.reset(OSQPVectorf_new(data->test_mat_vec_x, data->test_mat_vec_n));
+
+  OSQPMatrix_Atxpy(Pu.get(), x.get(), result.get(), 1.0, 1.0);
+  mu_assert(
+    "Linear algebra tests: error in matrix-vector operation, cumulative full symmetric matrix-vector multiplication",
+    OSQPVectorf_norm_inf_diff(result.get(), ref.get()) < TESTS_TOL);
+
+  // Changes to the values of P carry over to both triangles
+  ref.reset(OSQPVectorf_new(data->test_mat_vec_Px, data->test_mat_vec_n));
+  OSQPVectorf_mult_scalar(ref.get(), 2.0);
+  result.reset(OSQPVectorf_malloc(data->test_mat_vec_n));
+
+  OSQPMatrix_mult_scalar(Pu.get(), 2.0);
+  OSQPMatrix_Axpy(Pu.get(), x.get(), result.get(), 1.0, 0.0);
+  mu_assert(
+    "Linear algebra tests: error in matrix-vector operation, full symmetric matrix-vector multiplication after scaling",
+    OSQPVectorf_norm_inf_diff(result.get(), ref.get()) < TESTS_TOL);
+}
+
 TEST_CASE("Matrix-vector: Empty matrix multiplication", "[mat-vec][operation]") {
   lin_alg_sols_data_ptr data{generate_problem_lin_alg_sols_data()};
 
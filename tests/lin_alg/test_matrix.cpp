@@ -279,6 +279,8 @@ TEST_CASE("Matrix: Operations", "[matrix][operation]")  {
   OSQPMatrix_ptr Ad{OSQPMatrix_new_from_csc(data->test_mat_ops_A,0)}; //asymmetric
   OSQPMatrix_ptr dA{OSQPMatrix_new_from_csc(data->test_mat_ops_A,0)}; //asymmetric
   OSQPMatrix_ptr sA{OSQPMatrix_new_from_csc(data->test_mat_ops_A,0)}; //asymmetric
+  OSQPMatrix_ptr eA{OSQPMatrix_new_from_csc(data->test_mat_ops_A,0)}; //asymmetric
+  OSQPMatrix_ptr Ae{OSQPMatrix_new_from_csc(data->test_mat_ops_A,0)}; //asymmetric
 
   OSQPVectorf_ptr d{OSQPVectorf_new(data->test_mat_ops_d, data->test_mat_ops_n)};
 
@@ -313,6 +315,31 @@ TEST_CASE("Matrix: Operations", "[matrix][operation]")  {
     "Linear algebra tests: error in matrix operation, postmultiply diagonal",
     OSQPMatrix_is_eq(Ad.get(), refM.get(), TESTS_TOL));
 
+  // Entrywise scaling, all entries
+  OSQPInt nnz = OSQPMatrix_get_nz(eA.get());
+  OSQPVectorf_ptr ones{OSQPVectorf_malloc(data->test_mat_ops_n)};
+  OSQPVectorf_set_scalar(ones.get(), 1.0);
+
+  refM.reset(OSQPMatrix_new_from_csc(data->test_mat_ops_prem_diag, 0)); //asymmetric
+
+  OSQPMatrix_scale_entries(eA.get(), OSQP_NULL, nnz, d.get(), ones.get(), 1.0);
+  mu_assert(
+    "Linear algebra tests: error in matrix operation, entrywise scaling of all entries",
+    OSQPMatrix_is_eq(eA.get(), refM.get(), TESTS_TOL));
+
+  // Entrywise scaling, indexed entries
+  std::unique_ptr<OSQPInt[]> idx(new OSQPInt[nnz]);
+  for (OSQPInt i = 0; i < nnz; i++) {
+    idx[i] = nnz - 1 - i;
+  }
+
+  refM.reset(OSQPMatrix_new_from_csc(data->test_mat_ops_postm_diag, 0)); //asymmetric
+
+  OSQPMatrix_scale_entries(Ae.get(), idx.get(), nnz, ones.get(), d.get(), 1.0);
+  mu_assert(
+    "Linear algebra tests: error in matrix operation, entrywise scaling of indexed entries",
+    OSQPMatrix_is_eq(Ae.get(), refM.get(), TESTS_TOL));
+
 #endif /* ifndef OSQP_ALGEBRA_CUDA */
 
   // Maximum norm over columns
@@ -333,3 +360,117 @@ TEST_CASE("Matrix: Operations", "[matrix][operation]")  {
     "Linear algebra tests: error in matrix operation, max norm over rows",
     OSQPVectorf_norm_inf_diff(refv.get(), resultv.get()) < TESTS_TOL);
 }
+
+#ifndef OSQP_ALGEBRA_CUDA
+
+TEST_CASE("Matrix: Column and row measures", "[matrix][operation]")  {
+  lin_alg_sols_data_ptr data{generate_problem_lin_alg_sols_data()};
+
+  OSQPCscMatrix* Acsc = data->test_mat_vec_A;
+  OSQPInt        m    = Acsc->m;
+  OSQPInt        n    = Acsc->n;
+
+  OSQPMatrix_ptr A{OSQPMatrix_new_from_csc(Acsc, 0)}; //asymmetric
+
+  // Reference 2-norms and smallest nonzero magnitudes from the csc data
+  std::unique_ptr<OSQPFloat[]> cnorm(new OSQPFloat[n]);
+  std::unique_ptr<OSQPFloat[]> rnorm(new OSQPFloat[m]);
+  std::unique_ptr<OSQPFloat[]> cmin(new OSQPFloat[n]);
+  std::unique_ptr<OSQPFloat[]> rmin(new OSQPFloat[m]);
+
+  for (OSQPInt j = 0; j < n; j++) {
+    cnorm[j] = 0.0;
+    cmin[j]  = OSQP_INFTY;
+  }
+  for (OSQPInt i = 0; i < m; i++) {
+    rnorm[i] = 0.0;
+    rmin[i]  = OSQP_INFTY;
+  }
+  for (OSQPInt j = 0; j < n; j++) {
+    for (OSQPInt k = Acsc->p[j]; k < Acsc->p[j+1]; k++) {
+      OSQPFloat v = c_absval(Acsc->x[k]);
+      OSQPInt   i = Acsc->i[k];
+
+      cnorm[j] += v * v;
+      rnorm[i] += v * v;
+      if (v > 0.0) {
+        cmin[j] = c_min(cmin[j], v);
+        rmin[i] = c_min(rmin[i], v);
+      }
+    }
+  }
+  for (OSQPInt j = 0; j < n; j++) cnorm[j] = c_sqrt(cnorm[j]);
+  for (OSQPInt i = 0; i < m; i++) rnorm[i] = c_sqrt(rnorm[i]);
+
+  OSQPVectorf_ptr refv{nullptr};
+  OSQPVectorf_ptr resultv{nullptr};
+
+  // 2-norm over columns
+  refv.reset(OSQPVectorf_new(cnorm.get(), n));
+  resultv.reset(OSQPVectorf_malloc(n));
+
+  OSQPMatrix_col_norm_2(A.get(), resultv.get());
+  mu_assert(
+    "Linear algebra tests: error in matrix operation, 2-norm over columns",
+    OSQPVectorf_norm_inf_diff(refv.get(), resultv.get()) < TESTS_TOL);
+
+  // 2-norm over rows
+  refv.reset(OSQPVectorf_new(rnorm.get(), m));
+  resultv.reset(OSQPVectorf_malloc(m));
+
+  OSQPMatrix_row_norm_2(A.get(), resultv.get());
+  mu_assert(
+    "Linear algebra tests: error in matrix operation, 2-norm over rows",
+    OSQPVectorf_norm_inf_diff(refv.get(), resultv.get()) < TESTS_TOL);
+
+  // Smallest nonzero magnitude over columns
+  refv.reset(OSQPVectorf_new(cmin.get(), n));
+  resultv.reset(OSQPVectorf_malloc(n));
+
+  OSQPMatrix_col_min_abs(A.get(), resultv.get());
+  mu_assert(
+    "Linear algebra tests: error in matrix operation, min magnitude over columns",
+    OSQPVectorf_norm_inf_diff(refv.get(), resultv.get()) < TESTS_TOL);
+
+  // Smallest nonzero magnitude over rows
+  refv.reset(OSQPVectorf_new(rmin.get(), m));
+  resultv.reset(OSQPVectorf_malloc(m));
+
+  OSQPMatrix_row_min_abs(A.get(), resultv.get());
+  mu_assert(
+    "Linear algebra tests: error in matrix operation, min magnitude over rows",
+    OSQPVectorf_norm_inf_diff(refv.get(), resultv.get()) < TESTS_TOL);
+
+  // Symmetric matrix with only the upper triangle stored
+  OSQPInt nP = data->test_mat_extr_triu_n;
+
+  OSQPMatrix_ptr P{OSQPMatrix_new_from_csc(data->test_mat_extr_triu_P, 0)};  //full
+  OSQPMatrix_ptr Pu{OSQPMatrix_new_from_csc(data->test_mat_extr_triu_Pu, 1)}; //triu
+
+  refv.reset(OSQPVectorf_malloc(nP));
+  resultv.reset(OSQPVectorf_malloc(nP));
+
+  OSQPMatrix_col_norm_2(P.get(), refv.get());
+  OSQPMatrix_col_norm_2(Pu.get(), resultv.get());
+  mu_assert(
+    "Linear algebra tests: error in matrix operation, 2-norm over columns of symmetric matrix",
+    OSQPVectorf_norm_inf_diff(refv.get(), resultv.get()) < TESTS_TOL);
+
+  OSQPMatrix_row_norm_2(Pu.get(), resultv.get());
+  mu_assert(
+    "Linear algebra tests: error in matrix operation, 2-norm over rows of symmetric matrix",
+    OSQPVectorf_norm_inf_diff(refv.get(), resultv.get()) < TESTS_TOL);
+
+  OSQPMatrix_col_min_abs(P.get(), refv.get());
+  OSQPMatrix_col_min_abs(Pu.get(), resultv.get());
+  mu_assert(
+    "Linear algebra tests: error in matrix operation, min magnitude over columns of symmetric matrix",
+    OSQPVectorf_norm_inf_diff(refv.get(), resultv.get()) < TESTS_TOL);
+
+  OSQPMatrix_row_min_abs(Pu.get(), resultv.get());
+  mu_assert(
+    "Linear algebra tests: error in matrix operation, min magnitude over rows of symmetric matrix",
+    OSQPVectorf_norm_inf_diff(refv.get(), resultv.get()) < TESTS_TOL);
+}
+
+#endif /* ifndef OSQP_ALGEBRA_CUDA */
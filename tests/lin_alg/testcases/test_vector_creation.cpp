@@ -439,4 +439,23 @@ TEST_CASE("Vector: Subvector creation", "[vector],[creation]")
               OSQPVectorf_is_eq(res.get(), v.get(), TESTS_TOL));
   }
 }
+
+TEST_CASE("Vector: Aligned view", "[vector],[creation]")
+{
+  OSQPInt stride = OSQP_VECTOR_ALIGNMENT / sizeof(OSQPFloat);
+
+  OSQPVectorf_ptr v{OSQPVectorf_calloc(4 * stride)};
+
+  OSQPInt offset = OSQPVectorf_align_offset(v.get());
+
+  mu_assert("Alignment offset out of range",
+            (offset >= 0 && offset < stride));
+
+  OSQPVectorf* view = OSQPVectorf_view(v.get(), offset, stride);
+
+  mu_assert("View not aligned",
+            ((size_t)OSQPVectorf_data(view)) % OSQP_VECTOR_ALIGNMENT == 0);
+
+  OSQPVectorf_view_free(view);
+}
 #endif
@@ -426,6 +426,53 @@ TEST_CASE("Vector: Elementwise bound vector", "[vector],[operation]")
   }
 }
 
+TEST_CASE("Vector: Partitioned bound vector", "[vector],[operation]")
+{
+  // Fixed, loose, lower bounded, upper bounded, boxed and fixed rows
+  OSQPFloat l[6] = { 1.0, -OSQP_INFTY, -1.0, -OSQP_INFTY, -2.0, -3.0};
+  OSQPFloat u[6] = { 1.0,  OSQP_INFTY,  OSQP_INFTY,  1.0,  2.0, -3.0};
+  OSQPFloat z[6] = { 5.0, -7.0, -4.0,  4.0,  1.5,  0.0};
+
+  OSQPVectorf_ptr lb{OSQPVectorf_new(l, 6)};
+  OSQPVectorf_ptr ub{OSQPVectorf_new(u, 6)};
+  OSQPVectorf_ptr ref{OSQPVectorf_new(z, 6)};
+  OSQPVectorf_ptr res{OSQPVectorf_new(z, 6)};
+  OSQPVectori_ptr idx{OSQPVectori_malloc(6)};
+
+  OSQPInt n_fixed;
+  OSQPInt n_bounded;
+
+  OSQPVectorf_bounds_partition(idx.get(), &n_fixed, &n_bounded,
+                               lb.get(), ub.get(), OSQP_INFTY * OSQP_MIN_SCALING);
+
+#ifdef OSQP_ALGEBRA_CUDA
+  // The GPU projects every row as a single bounded block
+  mu_assert("Partition sizes not computed properly",
+            ((n_fixed == 0) && (n_bounded == 6)));
+#else
+  // Rows 0 and 5 are fixed, rows 2 to 4 bounded and row 1 is left out
+  OSQPInt idx_ref[5] = {0, 5, 2, 3, 4};
+  OSQPInt idx_res[6];
+  OSQPInt i;
+
+  mu_assert("Partition sizes not computed properly",
+            ((n_fixed == 2) && (n_bounded == 3)));
+
+  OSQPVectori_to_raw(idx_res, idx.get());
+  for (i = 0; i < n_fixed + n_bounded; i++) {
+    CAPTURE(i);
+    mu_assert("Partition indices not computed properly",
+              idx_res[i] == idx_ref[i]);
+  }
+#endif
+
+  OSQPVectorf_ew_bound_vec(ref.get(), ref.get(), lb.get(), ub.get());
+  OSQPVectorf_ew_bound_vec_part(res.get(), lb.get(), ub.get(), idx.get(), n_fixed, n_bounded);
+
+  mu_assert("Bounds not computed properly",
+            OSQPVectorf_is_eq(res.get(), ref.get(), TESTS_TOL));
+}
+
 TEST_CASE("Vector: Norms")
 {
   lin_alg_sols_data_ptr data{generate_problem_lin_alg_sols_data()};
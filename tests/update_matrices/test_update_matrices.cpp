@@ -107,7 +107,19 @@ TEST_CASE_METHOD(OSQPTestFixture, "Test updating P and A", "[update]")
   /* Test all possible linear system solvers in this test case */
   settings->linsys_solver = GENERATE(filter(&isLinsysSupported, values({OSQP_DIRECT_SOLVER, OSQP_INDIRECT_SOLVER})));
 
+  /* Updates are given in the user ordering of the matrix entries */
+  settings->reorder = GENERATE(0, 1);
+
+  /* Rescale the whole problem or only the new entries */
+  settings->freeze_scaling = GENERATE(0, 1);
+
+  /* Singleton rows of A are kept out of the KKT matrix */
+  settings->split_bounds = GENERATE(0, 1);
+
   CAPTURE(settings->linsys_solver);
+  CAPTURE(settings->reorder);
+  CAPTURE(settings->freeze_scaling);
+  CAPTURE(settings->split_bounds);
 
   // Setup solver
   exitflag = osqp_setup(&tmpSolver, data->test_solve_Pu, data->test_solve_q,